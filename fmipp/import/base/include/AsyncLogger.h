@@ -0,0 +1,147 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_ASYNCLOGGER_H
+#define _FMIPP_ASYNCLOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+
+
+/**
+ * \file AsyncLogger.h
+ * \class AsyncLogger AsyncLogger.h
+ * Global asynchronous logger for all FMU callback loggers.
+ *
+ * When active, the callback loggers (see CallbackFunctions.h) pass their messages to this
+ * logger instead of printing them or writing them to the LogBuffer. Messages are filtered
+ * by severity and category, formatted into the slot of a bounded lock-free ring buffer
+ * (multiple producers, single consumer) and written to a file by a background thread.
+ * Messages that do not fit into the ring buffer are dropped (and counted), i.e., logging
+ * never blocks the calling thread and the memory used for logging is bounded. Messages,
+ * instance names and categories that are too long are truncated.
+ *
+ * When the logger is not active, the only overhead for the callback loggers is checking
+ * a flag. Calls of log register themselves as producers before checking the flag again,
+ * functions start and stop wait for all registered producers before they touch the ring
+ * buffer, i.e., they may be called concurrently with logging. The functions for setting
+ * the filters must not be called concurrently with logging.
+ */
+
+class __FMI_DLL AsyncLogger
+{
+
+public:
+
+	/// Maximum length of a message (longer messages are truncated).
+	static const fmippSize maxMessageLength = 512;
+
+	/// Maximum length of an instance name (longer names are truncated).
+	static const fmippSize maxInstanceNameLength = 64;
+
+	/// Maximum length of a category (longer categories are truncated).
+	static const fmippSize maxCategoryLength = 32;
+
+	/// Destructor, stops the logger (all pending messages are written).
+	~AsyncLogger();
+
+	/// Get singleton instance of the logger.
+	static AsyncLogger& getAsyncLogger();
+
+	/**
+	 * Start logging to a file.
+	 *
+	 * @param[in]  fileName  name of the log file (messages are appended)
+	 * @param[in]  capacity  number of messages the ring buffer can hold (rounded up to a power of 2)
+	 * @return  false if the logger is already active or the file cannot be opened
+	 */
+	fmippBoolean start( const fmippString& fileName, fmippSize capacity = 4096 );
+
+	/// Stop logging, all pending messages are written before the file is closed.
+	void stop();
+
+	/// Check if the logger is active.
+	fmippBoolean isActive() const { return active_.load( std::memory_order_relaxed ); }
+
+	/// Only log messages with at least the given severity (default: all messages).
+	void setMinimumSeverity( fmippStatus severity ) { minimumSeverity_ = severity; }
+
+	/// Only log messages of the given categories (empty: all categories).
+	void setCategories( const std::vector<fmippString>& categories ) { categories_ = categories; }
+
+	/// Check if a message with the given severity and category passes the filters.
+	fmippBoolean accepts( int severity, const char* category ) const;
+
+	/// Log a message (printf-style format with arguments). The message is ignored if the logger is not active.
+	void log( const char* instanceName, int severity, const char* category, const char* format, va_list args );
+
+	/// Number of messages dropped because the ring buffer was full.
+	fmippSize getDroppedMessages() const { return dropped_.load( std::memory_order_relaxed ); }
+
+private:
+
+	/// Slot of the ring buffer.
+	struct Slot
+	{
+		std::atomic<fmippSize> sequence; ///< Sequence number for synchronizing producers and consumer.
+		int severity;
+		char instanceName[maxInstanceNameLength];
+		char category[maxCategoryLength];
+		char message[maxMessageLength];
+	};
+
+	/// Default constructor. Private so that it can not be called.
+	AsyncLogger();
+
+	AsyncLogger( const AsyncLogger& ); ///< Prevent calling the copy constructor.
+	AsyncLogger& operator=( const AsyncLogger& ); ///< Prevent calling the assignment operator.
+
+	/// Write a message into the next free slot of the ring buffer (or drop it if the ring buffer is full).
+	void enqueue( const char* instanceName, int severity, const char* category, const char* format, va_list args );
+
+	/// Main loop of the background thread.
+	void run();
+
+	/// Write all messages available in the ring buffer to the file, returns the number of messages.
+	fmippSize drain();
+
+	/// Wait until no call of log is writing to the ring buffer.
+	void waitForProducers() const;
+
+	/// Singleton instance of the logger.
+	static AsyncLogger* asyncLogger_;
+
+	std::atomic<fmippBoolean> active_; ///< Flag indicating if the logger is active.
+	std::atomic<fmippSize> producers_; ///< Number of calls of log in progress.
+
+	std::unique_ptr<Slot[]> slots_; ///< Ring buffer.
+	fmippSize mask_; ///< Capacity of the ring buffer minus one.
+	std::atomic<fmippSize> enqueuePos_; ///< Position for the next message (shared by all producers).
+	fmippSize dequeuePos_; ///< Position of the next message to be written (only used by the consumer).
+
+	std::atomic<fmippSize> dropped_; ///< Number of dropped messages.
+
+	fmippStatus minimumSeverity_;
+	std::vector<fmippString> categories_;
+
+	FILE* file_;
+	std::thread thread_; ///< Background thread writing the messages to the file.
+	fmippBoolean stopRequested_;
+	std::mutex mutex_; ///< Protects stopRequested_ (for waking up the background thread).
+	std::condition_variable wakeUp_;
+
+};
+
+
+#endif // _FMIPP_ASYNCLOGGER_H
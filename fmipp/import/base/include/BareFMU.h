@@ -20,7 +20,10 @@
 #include "common/fmi_v1.0/fmi_cs.h"
 #include "common/fmi_v2.0/fmi_2.h"
 
+#include <memory>
+
 class ModelDescription;
+class VariableIndex;
 
 /// FMI ME 1.0
 struct BareFMUModelExchange
@@ -60,9 +63,15 @@ struct BareFMU2
 	/// Parsed XML model description.
 	ModelDescription* description;
 
+	/// URI to (unzipped) FMU archive.
+	std::string fmuLocation;
+
 	/// URI to FMU resources directory.
 	std::string fmuResourceLocation;
 
+	/// Lookup table for model variables, shared by all instances (created on first use).
+	std::shared_ptr<const VariableIndex> variableIndex;
+
 	/// Destructor.
 	~BareFMU2();
 };
@@ -71,8 +80,6 @@ struct BareFMU2
 // Define smart pointers to bare FMUs.
 //
 
-#include <memory>
-
 typedef std::shared_ptr<BareFMUModelExchange> BareFMUModelExchangePtr;
 typedef std::shared_ptr<BareFMUCoSimulation> BareFMUCoSimulationPtr;
 typedef std::shared_ptr<BareFMU2> BareFMU2Ptr;
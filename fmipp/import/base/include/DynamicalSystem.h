@@ -9,6 +9,7 @@
 //#include "import/integrators/include/IntegratorProperties.h"
 #include "common/fmi_v1.0/fmiModelTypes.h"
 #include "import/integrators/include/Integrator.h"
+#include "import/integrators/include/NumericalJacobian.h"
 
 
 /**
@@ -96,9 +97,15 @@ public:
 	 *
 	 *        \f[ J[ NEQ*i + j ]   =    \frac{\partial f_i( x )}{\partial x_j},\ i{,} j = 0,...,NEQ-1 \f]
 	 *
+	 * See NumericalJacobian for the available finite-difference schemes and the use of sparsity patterns.
 	 */
 	virtual void getNumericalJacobian( fmippReal* J, const fmippReal* x, fmippReal* dfdt, const fmippTime t );
 
+	/// Set the finite-difference scheme for the numerical Jacobian (default: 6th order central differences).
+	void setNumericalJacobianMethod( NumericalJacobian::Method method ){
+		numericalJacobian_->setMethod( method );
+	}
+
 	/// check whether the sign of at least one event indicator changed since the last call
 	/// to saveEventIndicators()
 	fmippBoolean checkStateEvent();
@@ -122,13 +129,33 @@ public:
 		return integrator_->getProperties();
 	}
 
+	/**
+	 * Enable or disable the integrator statistics (disabled by default).
+	 *
+	 * Enabling the statistics starts with all counters set to zero (or keeps the counters if they
+	 * are already enabled). Without statistics, updating the counters costs a check of a pointer.
+	 */
+	void enableIntegratorStatistics( fmippBoolean enable = true );
+
+	/// Get the integrator statistics (null if disabled).
+	Integrator::Statistics* getIntegratorStatistics() { return statistics_; }
+
+	/// Get the integrator statistics (null if disabled).
+	const Integrator::Statistics* getIntegratorStatistics() const { return statistics_; }
+
 protected:
 	/// Integrator Instance
 	Integrator* integrator_;
 
+	/// Finite-difference approximation of the Jacobian (see getNumericalJacobian).
+	NumericalJacobian* numericalJacobian_;
+
 	/// Flag indicating whether the jacobian can be computed by the fmu
 	fmippBoolean providesJacobian_;
 
+	/// Performance counters (null if disabled, see enableIntegratorStatistics).
+	Integrator::Statistics* statistics_;
+
 	/// save current event indicators for later calls to checkStateEvent()
 	void saveEventIndicators();
 
@@ -10,9 +10,11 @@
 #include <cstdio>
 #include <map>
 #include <stdexcept>
+#include <vector>
 
 #include "import/base/include/BareFMU.h"
 #include "import/base/include/FMUCoSimulationBase.h"
+#include "import/base/include/VariableIndex.h"
 
 class ModelDescription;
 
@@ -55,6 +57,18 @@ public:
 		const fmippBoolean loggingOn = fmippFalse,
 		const fmippTime timeDiffResolution = 1e-9 );
 
+	/**
+	 * Constructor. Uses the given bare FMU, e.g., with an isolated copy of the
+	 * shared library (see ModelManager::getIsolatedInstance).
+	 *
+	 * @param[in]  bareFMU               bare FMU (FMI 2.0)
+	 * @param[in]  loggingOn             if true, tell the FMU to log all calls to the fmiXXX functons
+	 * @param[in]  timeDiffResolution    resolution for comparing the master time with the slave time.
+	 */
+	FMUCoSimulation( BareFMU2Ptr bareFMU,
+		const fmippBoolean loggingOn = fmippFalse,
+		const fmippTime timeDiffResolution = 1e-9 );
+
 	/// Copy constructor.
 	FMUCoSimulation( const FMUCoSimulation& fmu );
 
@@ -167,6 +181,39 @@ public:
 	/// \copydoc FMUBase::getStringValue( const fmippString& name )
 	virtual fmippString getStringValue( const fmippString& name );
 
+	/**
+	 * Resolve a variable name to a handle, which can be used to access the variable
+	 * without any further name lookup.
+	 *
+	 * @param[in] name  name of the variable
+	 * @return handle to the variable (invalid if no variable with this name exists)
+	 */
+	VariableHandle getVariableHandle( const fmippString& name ) const;
+
+	/// Set the value of a real variable via its handle (discarded if the variable is not of type real).
+	fmippStatus setValue( const VariableHandle& handle, const fmippReal& val );
+
+	/// Set the value of an integer variable via its handle (discarded if the variable is not of type integer).
+	fmippStatus setValue( const VariableHandle& handle, const fmippInteger& val );
+
+	/// Set the value of a boolean variable via its handle (discarded if the variable is not of type boolean).
+	fmippStatus setValue( const VariableHandle& handle, const fmippBoolean& val );
+
+	/// Set the value of a string variable via its handle (discarded if the variable is not of type string).
+	fmippStatus setValue( const VariableHandle& handle, const fmippString& val );
+
+	/// Get the value of a real variable via its handle (discarded if the variable is not of type real).
+	fmippStatus getValue( const VariableHandle& handle, fmippReal& val );
+
+	/// Get the value of an integer variable via its handle (discarded if the variable is not of type integer).
+	fmippStatus getValue( const VariableHandle& handle, fmippInteger& val );
+
+	/// Get the value of a boolean variable via its handle (discarded if the variable is not of type boolean).
+	fmippStatus getValue( const VariableHandle& handle, fmippBoolean& val );
+
+	/// Get the value of a string variable via its handle (discarded if the variable is not of type string).
+	fmippStatus getValue( const VariableHandle& handle, fmippString& val );
+
 	/// \copydoc FMUBase::getLastStatus
 	virtual fmippStatus getLastStatus() const;
 
@@ -237,11 +284,47 @@ public:
 		callbacks_.componentEnvironment = env;
 	}
 
+	/// Check if the FMU supports getting and setting its internal state.
+	fmippBoolean canGetAndSetFMUstate() const;
+
+	/// Check if the FMU supports serializing its internal state.
+	fmippBoolean canSerializeFMUstate() const;
+
+	/// Get a copy of the FMU's internal state (to be released via freeFMUState).
+	fmippStatus getFMUState( fmi2FMUstate* fmuState );
+
+	/// Set the FMU's internal state.
+	fmippStatus setFMUState( fmi2FMUstate fmuState );
+
+	/// Release a copy of the FMU's internal state.
+	fmippStatus freeFMUState( fmi2FMUstate* fmuState );
+
+	/**
+	 * Serialize the FMU's internal state.
+	 *
+	 * @param[out] buffer  serialized state (resized as needed)
+	 * @return the most severe status returned by the FMU
+	 */
+	fmippStatus serializeState( std::vector<fmippByte>& buffer );
+
+	/**
+	 * Restore the FMU's internal state from a serialized state. Requires the FMU
+	 * to be instantiated.
+	 *
+	 * @param[in] buffer  serialized state (as returned by serializeState)
+	 * @param[in] time  FMU time corresponding to the serialized state
+	 * @return the most severe status returned by the FMU
+	 */
+	fmippStatus deSerializeState( const std::vector<fmippByte>& buffer, fmippTime time );
+
 private:
 
 	/// Internal helper function to retrieve attributes from model description.
 	template<typename Type>
 	Type getCoSimToolCapabilities( const fmippString& attributeName ) const;
+
+	/// Internal helper function to retrieve optional boolean attributes from model description.
+	fmippBoolean getOptionalCoSimToolCapability( const fmippString& attributeName ) const;
 	
 	FMUCoSimulation(); ///< Prevent calling the default constructor.
 
@@ -253,10 +336,8 @@ private:
 
 	fmi2::fmi2CallbackFunctions callbacks_; ///< Internal struct to callback functions.
 
-	/// \FIXME Maps should be handled via ModelManager, to avoid duplication 
-	///        of this (potentially large) map with every instance.
-	std::map<fmippString,fmippValueReference> varMap_;  ///< Maps variable names and value references.
-	std::map<fmippString,FMIPPVariableType> varTypeMap_; ///< Maps variable names and their types.
+	/// Maps variable names to value references and types (shared by all instances of the model).
+	std::shared_ptr<const VariableIndex> varIndex_;
 
 	fmippTime time_; ///< Internal time.
 	const fmippTime timeDiffResolution_; ///< Internal time resolution.
@@ -265,6 +346,12 @@ private:
 
 	void readModelDescription(); ///< Read the model description.
 
+	/// Find a variable by name (NULL if no variable with this name exists).
+	const VariableHandle* findVariable( const fmippString& name ) const;
+
+	/// Check the type of a variable handle, log a warning and set the status to discard in case of a mismatch.
+	fmippBoolean checkHandle( const VariableHandle& handle, FMIPPVariableType type );
+
 };
 
 } // namespace fmi_2_0
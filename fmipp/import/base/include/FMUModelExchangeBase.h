@@ -162,6 +162,22 @@ public:
 		return integrator_->getProperties();
 	}
 
+	/**
+	 * Get the continuous states at a time within the last step of the integrator (dense output).
+	 *
+	 * The states are interpolated (see Integrator::getInterpolatedStates), i.e., results can be sampled
+	 * between the accepted steps of the integrator without additional derivative evaluations and
+	 * without changing the states of the FMU.
+	 *
+	 * @param[in]  t  time within the last step of the integrator
+	 * @param[out]  x  interpolated continuous states
+	 * @return  fmippDiscard if the integrator has no dense output or t is not within its last step
+	 */
+	fmippStatus getInterpolatedContinuousStates( fmippTime t, fmippReal* x ){
+		assert( integrator_ );
+		return integrator_->getInterpolatedStates( t, x ) ? fmippOK : fmippDiscard;
+	}
+
  protected:
 
 	const fmippBoolean loggingOn_;
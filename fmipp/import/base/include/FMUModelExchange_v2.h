@@ -13,6 +13,7 @@
 #include "import/base/include/BareFMU.h"
 #include "import/base/include/FMUModelExchangeBase.h"
 #include "import/integrators/include/Integrator.h"
+#include "import/integrators/include/NumericalJacobian.h"
 
 struct BareFMU2;
 
@@ -105,9 +106,20 @@ public:
 	/// Retrieve vector containing the names of the derivatives vector elements.
 	virtual std::vector<fmippString> getDerivativesNames() const;
 
-	/// \copydoc DynamicalSystem::getJac( fmippReal* J )
+	/**
+	 * \copydoc DynamicalSystem::getJac( fmippReal* J )
+	 *
+	 * The Jacobian is assembled from directional derivatives. Using the dependencies listed in the
+	 * model structure, structurally independent states are seeded together (one call per color, see
+	 * JacobianColoring) and only the derivatives depending on them are requested. If the model
+	 * structure reports all dependencies on the states as constant or fixed, the Jacobian is only
+	 * assembled once after initialization.
+	 */
 	virtual	fmippStatus getJac( fmippReal* J );
 
+	/// Number of calls to getDirectionalDerivative for the last call to getJac (0 if the Jacobian was reused).
+	fmippSize getJacobianEvaluations() const { return jacobianEvaluations_; }
+
 	/// \copydoc FMUModelExchangeBase::getEventIndicators
 	virtual fmippStatus getEventIndicators( fmippReal* eventsind );
 
@@ -305,6 +317,25 @@ public:
 
 	fmippBoolean stepOverEvent(); ///< Make a step from tLower_ to tUpper_ using explicit euler here, tLower and tUpper are provided by the Integrator.
 
+	/// Check if the FMU supports getting and setting its internal state.
+	fmippBoolean canGetAndSetFMUstate() const;
+
+	/// Get a copy of the FMU's internal state (to be released via freeFMUState). If *fmuState
+	/// refers to a previously retrieved state, this state is overwritten (instead of allocating a new one).
+	fmippStatus getFMUState( fmi2FMUstate* fmuState );
+
+	/// Set the FMU's internal state. The event indicators are saved afterwards (for the detection of state events).
+	fmippStatus setFMUState( fmi2FMUstate fmuState );
+
+	/// Release a copy of the FMU's internal state.
+	fmippStatus freeFMUState( fmi2FMUstate* fmuState );
+
+	/// Get the event info returned by the last call to newDiscreteStates (not part of the FMU's internal state).
+	const fmi2EventInfo& getEventInfo() const { return *eventinfo_; }
+
+	/// Set the event info, e.g., when restoring the FMU's internal state (see setFMUState).
+	void setEventInfo( const fmi2EventInfo& eventInfo );
+
 private:
 
 	fmi2Status enterContinuousTimeMode(); ///< Change the mode of the FMU to ContinuousTimeMode.
@@ -361,6 +392,17 @@ private:
 
 	fmi2Status lastStatus_; ///< Last status returned from an FMI function.
 
+	JacobianColoring jacobianColoring_; ///< Coloring of the Jacobian (for seeding several states per call of getDirectionalDerivative).
+	std::vector<fmippValueReference> jacobianKnowns_; ///< Value references of the states seeded together.
+	std::vector<fmippValueReference> jacobianUnknowns_; ///< Value references of the derivatives depending on them.
+	std::vector<fmippSize> jacobianRows_; ///< Indices of the derivatives depending on them.
+	std::vector<fmippSize> jacobianRowPositions_; ///< Position of each derivative in jacobianUnknowns_ (or nStateVars_).
+	std::vector<fmippReal> jacobianSeeds_; ///< Seed vector (all ones).
+	std::vector<fmippReal> jacobianValues_; ///< Directional derivatives returned by the FMU.
+	fmippBoolean constantJacobian_; ///< Flag indicating that the Jacobian does not change after initialization.
+	std::vector<fmippReal> cachedJacobian_; ///< Jacobian assembled after initialization (if constant).
+	fmippSize jacobianEvaluations_; ///< Number of calls to getDirectionalDerivative for the last Jacobian.
+
 	void readModelDescription(); ///< Extract specific information from the mode description.
 
 	static const fmippSize maxEventIterations_ = 5; ///< Maximum number of internal event iterations.
@@ -14,12 +14,24 @@
  *  The FMI standard defines an XML model description scheme. This class 
  *  provides the utilities to parse and store this information dynamically
  *  during run-time. It uses Boost's PropertyTree internally.
+ *
+ *  The XML file is read with a streaming parser, which stores the model
+ *  variables in a compact table (see getScalarVariables) and only keeps the
+ *  remaining elements (i.e., everything except the contents of elements
+ *  ModelVariables and ModelStructure) in a PropertyTree. The result is stored
+ *  in a versioned binary cache next to the XML file (keyed by the hash of the
+ *  XML file), which is memory-mapped by later runs instead of parsing the XML
+ *  file again. The complete PropertyTree is only built on demand, i.e., when
+ *  calling getModelVariables.
  */
 
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
 
 #include "common/FMIPPConfig.h"
+#include "common/FMIPPVariableType.h"
 #include "common/FMUType.h"
 
 class __FMI_DLL ModelDescription
@@ -29,6 +41,27 @@ public:
 
 	typedef boost::property_tree::ptree Properties;
 
+	/// Compact description of a scalar variable.
+	struct ScalarVariable
+	{
+		fmippString name;
+		fmippValueReference valueReference;
+		FMIPPVariableType type; ///< Type of the variable (fmippTypeUnknown for enumerations).
+		fmippSize derivative; ///< Index (starting at 1) of the variable this variable is the derivative of (0 if none).
+	};
+
+	/// Table of scalar variables (in the order of the model description).
+	typedef std::vector<ScalarVariable> ScalarVariables;
+
+	/// Kind of the dependency of a derivative on a variable (attribute dependenciesKind, FMI 2.0).
+	enum DependencyKind {
+		dependent, ///< No particular structure (default).
+		constant, ///< Linear with constant factor.
+		fixed, ///< Linear with factor that is fixed after initialization.
+		tunable, ///< Linear with factor that may change at events (tunable parameters).
+		discrete ///< Linear with factor that may change at events.
+	};
+
 public:
 	/// Constructor
 	ModelDescription( const fmippString& xmlDescriptionFilePath );
@@ -61,9 +94,12 @@ public:
 	/// Get vendor annotations.
 	const Properties& getVendorAnnotations() const;
 
-	/// Get description of model variables.
+	/// Get description of model variables (parses the complete XML model description on first call).
 	const Properties& getModelVariables() const;
 
+	/// Get compact descriptions of all scalar variables.
+	const ScalarVariables& getScalarVariables() const { return variables_; }
+
 	/// Get information concerning implementation of co-simulation tool (FMI CS feature).
 	const Properties& getImplementation() const;
 
@@ -130,12 +166,48 @@ public:
 	/// Get the value references for all states and derivatives
 	void getStatesAndDerivativesReferences( fmippValueReference* state_ref, fmippValueReference* der_ref ) const;
 
+	/**
+	 * Get the structural dependencies of the derivatives on the continuous states (FMI 2.0).
+	 *
+	 * @param[out]  dependencies  for each derivative, the (sorted) indices of the states it depends on
+	 * @return  false if the model structure provides no dependencies at all
+	 */
+	fmippBoolean getStateDependencies( std::vector< std::vector<fmippSize> >& dependencies ) const;
+
+	/// Check if all derivatives depend on the states with constant factors, i.e., if the Jacobian does not change after initialization (FMI 2.0).
+	fmippBoolean hasConstantStateJacobian() const;
+
 	/// Return the type of the FMU.
 	FMUType getFMUType() const { return fmuType_; }
+
+	/// Enable or disable the binary cache for all model descriptions parsed afterwards (enabled by default, thread-safe).
+	static void setBinaryCacheEnabled( fmippBoolean enabled );
+
+	/// Check if the binary cache is enabled.
+	static fmippBoolean isBinaryCacheEnabled();
 	
 private:
 
-	Properties data_; ///< This data structure (a Boost PropertyTree) holds the parsed model description.
+	/// Read the model description from the binary cache or parse the XML file.
+	void read( const fmippString& xmlDescriptionFilePath );
+
+	Properties data_; ///< This data structure (a Boost PropertyTree) holds the parsed model description (without model variables and model structure).
+
+	ScalarVariables variables_; ///< Compact descriptions of all scalar variables.
+
+	std::vector<fmippSize> derivatives_; ///< Indices (starting at 1) of the derivatives listed in the model structure (FMI 2.0).
+
+	std::vector< std::vector<fmippSize> > dependencies_; ///< Indices (starting at 1) of the variables each derivative depends on (FMI 2.0).
+
+	std::vector<char> hasDependencies_; ///< Flags for derivatives with explicitly listed dependencies (FMI 2.0).
+
+	std::vector< std::vector<char> > dependenciesKinds_; ///< Kinds of the dependencies of each derivative (FMI 2.0).
+
+	fmippString xmlDescriptionFilePath_; ///< Path to the XML file (for building the complete PropertyTree on demand).
+
+	mutable std::unique_ptr<Properties> completeData_; ///< Complete PropertyTree (built on demand).
+
+	mutable std::mutex completeDataMutex_; ///< Protects completeData_.
 
 	fmippBoolean isValid_; ///< True if the XML model description file has been parsed successfully.
 
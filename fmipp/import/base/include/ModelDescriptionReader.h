@@ -0,0 +1,63 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_MODELDESCRIPTIONREADER_H
+#define _FMIPP_MODELDESCRIPTIONREADER_H
+
+/**
+ *  \file ModelDescriptionReader.h
+ *  Streaming parser and binary cache for FMI model descriptions (used by class ModelDescription).
+ *
+ *  The streaming parser builds the compact table of scalar variables and the list of
+ *  derivatives (with their dependencies) directly while reading the XML file. All other elements are stored in a
+ *  PropertyTree (like Boost's XML parser with options trim_whitespace and no_comments
+ *  would do). The contents of elements ModelVariables and ModelStructure are omitted.
+ *
+ *  The binary cache stores the same contents. It starts with a header holding a magic
+ *  number, the format version and the size and hash of the XML file it was created from.
+ *  A cache file that does not match is ignored (and overwritten).
+ */
+
+#include <vector>
+
+#include "import/base/include/ModelDescription.h"
+
+
+/// Namespace containing the streaming parser and the binary cache for model descriptions.
+namespace ModelDescriptionReader
+{
+	/// Version of the binary cache format (increase whenever the format changes).
+	const fmippUInt32 cacheVersion = 4;
+
+	/// Contents of a model description.
+	struct Contents
+	{
+		ModelDescription::Properties data; ///< All elements except the contents of ModelVariables and ModelStructure.
+		ModelDescription::ScalarVariables variables; ///< Compact descriptions of all scalar variables.
+		std::vector<fmippSize> derivatives; ///< Indices of the derivatives listed in the model structure.
+		std::vector< std::vector<fmippSize> > dependencies; ///< Indices of the variables each derivative depends on.
+		std::vector<char> hasDependencies; ///< Flags for derivatives with attribute dependencies (otherwise they depend on everything).
+		std::vector< std::vector<char> > dependenciesKinds; ///< Kinds of the dependencies (see ModelDescription::DependencyKind, empty if not listed).
+	};
+
+	/// Compute the hash (64-bit FNV-1a) of the contents of the XML file.
+	__FMI_DLL fmippUInt64 computeHash( const char* begin, const char* end );
+
+	/// Parse the contents of the XML file, returns false if the XML is malformed.
+	__FMI_DLL fmippBoolean parseXml( const char* begin, const char* end, Contents& contents );
+
+	/// Read the binary cache (memory-mapped), returns false if it does not exist or does not match the XML file.
+	__FMI_DLL fmippBoolean readCache( const fmippString& cacheFilePath,
+		fmippUInt64 xmlSize, fmippUInt64 xmlHash, Contents& contents );
+
+	/// Write the binary cache (atomically replacing an existing one), returns false in case of failure.
+	__FMI_DLL fmippBoolean writeCache( const fmippString& cacheFilePath,
+		fmippUInt64 xmlSize, fmippUInt64 xmlHash, const Contents& contents );
+
+	/// Path of the binary cache belonging to an XML model description.
+	__FMI_DLL fmippString getCacheFilePath( const fmippString& xmlDescriptionFilePath );
+}
+
+#endif // _FMIPP_MODELDESCRIPTIONREADER_H
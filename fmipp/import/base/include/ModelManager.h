@@ -15,13 +15,21 @@
  * 1. is privately constructed and cannot be externally instantiated 
  * 2. provides FMI functions of any FMU given (FMUs have to be already unzipped)
  * 3. loads FMUs only once, which is very time-saving in case several instances of the same FMU are used
+ *
+ * All functions of the model manager are thread-safe. The collections of loaded FMUs are replaced as a whole
+ * whenever they are modified (copy-on-write), i.e., lookups (getInstance, getSlave, etc.) only take an atomic
+ * snapshot of the collections and never wait for FMUs being loaded or unloaded. Concurrent calls of loadFMU for the same FMU directory are
+ * deduplicated, i.e., the FMU is loaded by the first caller and the others wait for it (and return duplicate).
  */ 
 
 #ifndef _FMIPP_MODELMANAGER_H
 #define _FMIPP_MODELMANAGER_H
 
+#include <chrono>
 #include <string>
 #include <map>
+#include <memory>
+#include <utility>
 
 #include "common/FMUType.h"
 #include "import/base/include/BareFMU.h"
@@ -49,6 +57,22 @@ public:
 		unknown ///< Unknown error.
 	};
 
+	/// Wall-clock durations (in seconds) of the individual steps of loading an FMU.
+	struct LoadTimings {
+		fmippTime parseModelDescription; ///< Time spent parsing the XML model description.
+		fmippTime loadSharedLibrary; ///< Time spent loading the shared library and resolving its functions.
+	};
+
+	/// Statistics about the bare FMUs held by the model manager (see getResidentStatistics).
+	struct ResidentStatistics {
+		fmippSize residentModels; ///< Number of loaded models (without isolated copies).
+		fmippSize isolatedCopies; ///< Number of isolated copies of shared libraries (see getIsolatedInstance).
+		fmippSize unusedModels; ///< Number of loaded models and isolated copies not used by any FMU instance.
+		fmippSize sharedLibraryBytes; ///< Total size (in bytes) of the files of all loaded shared libraries.
+		fmippSize descriptionBytes; ///< Total size (in bytes) of the XML files of all parsed model descriptions.
+		fmippSize unloadedModels; ///< Number of models and isolated copies unloaded automatically so far.
+	};
+
 	/// Destructor. 
 	~ModelManager();
 
@@ -95,7 +119,8 @@ public:
 		const fmippBoolean loggingOn, FMUType& type, std::string& modelIdentifier );
 
 	/**
-	 * Unload an FMU from the model manager. It must not be in use. 
+	 * Unload an FMU from the model manager. It must not be in use. An FMU that is looked up
+	 * concurrently is considered to be in use.
 	 * @param[in] modelIdentifier model identifier associated to the "bare FMU" to be unloaded
 	 * @return status of the unload process
 	 */
@@ -147,10 +172,75 @@ public:
 	 */
 	static BareFMU2Ptr getInstance( const std::string& modelIdentifier );
 
+	/**
+	 * Get instance (FMI ME/CS 2.0) with an isolated copy of the shared library, i.e., the
+	 * library's global variables are not shared with instances retrieved via getInstance
+	 * or with instances of other isolation groups. This allows to step FMUs that are not
+	 * thread-safe in parallel (one isolation group per thread). On Linux, the library is
+	 * loaded into a new linker namespace (dlmopen). Since the number of namespaces is
+	 * limited, a private temporary copy of the library is loaded as fallback, which is also
+	 * the default on other POSIX systems. On Windows, the library is not isolated.
+	 * The corresponding FMU has to be loaded before.
+	 * @param[in] modelIdentifier The unique ID of the model
+	 * @param[in] isolationGroup Instances requested for the same group share one copy of the library
+	 * @return smart pointer to "bare" FMU (empty in case of failure)
+	 */
+	static BareFMU2Ptr getIsolatedInstance( const std::string& modelIdentifier,
+		const std::string& isolationGroup );
+
+	/**
+	 * Get the durations of the individual steps of loading a model. The timings are
+	 * recorded when the model is loaded successfully for the first time.
+	 * @param[in] modelIdentifier The unique ID of the model to query
+	 * @param[out] timings The recorded durations (not touched if the model is unknown)
+	 * @return true if timings have been recorded for the model
+	 */
+	static fmippBoolean getLoadTimings( const std::string& modelIdentifier, LoadTimings& timings );
+
+	/**
+	 * Enable or disable the automatic unloading of FMUs (disabled by default). When enabled,
+	 * a model (or an isolated copy of its shared library) is unloaded once the last FMU instance
+	 * using it has been destroyed and the grace period has expired, i.e., its model description
+	 * is freed and its shared library is closed. Models whose grace period has expired are
+	 * unloaded by the next call of releaseFMU, loadFMU or collectUnusedFMUs. Models that have
+	 * been unloaded automatically are loaded again on demand (by getModel, getSlave and
+	 * getInstance). A grace period avoids loading a model again when its instances are
+	 * frequently destroyed and recreated.
+	 * Automatic unloading should be turned off again before the end of the program, since the
+	 * order of static destructors at exit is unspecified (FMUs released by them would otherwise
+	 * access the model manager while it is being destroyed). The model manager turns it off
+	 * when it is destroyed, i.e., FMUs released afterwards are not unloaded.
+	 * @param[in] enabled Flag for turning automatic unloading on/off.
+	 * @param[in] gracePeriod Wall-clock time (in seconds) an unused model is kept loaded.
+	 */
+	static void setAutoUnload( fmippBoolean enabled, fmippTime gracePeriod = 0. );
+
+	/**
+	 * Release a bare FMU that is no longer used by the caller (the smart pointer is reset). This is
+	 * called by the destructors of the FMU classes. In case automatic unloading is enabled (see
+	 * setAutoUnload) and the bare FMU is not used anymore, it is unloaded after the grace period.
+	 */
+	static void releaseFMU( BareFMUModelExchangePtr& bareFMU );
+
+	/// \copydoc releaseFMU(BareFMUModelExchangePtr&)
+	static void releaseFMU( BareFMUCoSimulationPtr& bareFMU );
+
+	/// \copydoc releaseFMU(BareFMUModelExchangePtr&)
+	static void releaseFMU( BareFMU2Ptr& bareFMU );
+
+	/**
+	 * Unload all released FMUs whose grace period has expired (see setAutoUnload).
+	 * @return number of unloaded models and isolated copies
+	 */
+	static fmippSize collectUnusedFMUs();
+
+	/// Get statistics about the loaded models and their memory (estimated from the sizes of their files).
+	static ResidentStatistics getResidentStatistics();
+
 private:
 
 	/// Private constructor (singleton). 
-	ModelManager() {}
+	ModelManager() : collections_( std::make_shared<const Collections>() ) {}
 
 	/**
 	 * Instantiates the appropriate bare FMU and adds it to the internal 
@@ -166,10 +256,12 @@ private:
 	 * object will be consumed and ownership is transferred to the bare FMU.
 	 * @param[in] fmuDirUrl The base URL of the FMU directory
 	 * @param[in] modelIdentifier Specifies the model to load from the given FMU.
+	 * @param[in] parseTime Time spent parsing the model description (for the load timings).
 	 */
 	static LoadFMUStatus loadBareFMU(
 		std::unique_ptr<ModelDescription> description, 
-		const std::string& fmuDirUrl, const std::string& modelIdentifier);
+		const std::string& fmuDirUrl, const std::string& modelIdentifier,
+		fmippTime parseTime);
 
 	/// Helper function for loading a bare FMU shared library (FMI ME Version 1.0).
 	static int loadDll( std::string dllPath, BareFMUModelExchangePtr bareFMU );
@@ -177,8 +269,8 @@ private:
 	/// Helper function for loading a bare FMU shared library (FMI CS Version 1.0).
 	static int loadDll( std::string dllPath, BareFMUCoSimulationPtr bareFMU );
 
-	/// Helper function for loading a bare FMU shared library (FMI Version 1.0, ME & CS).
-	static int loadDll( std::string dllPath, BareFMU2Ptr bareFMU );
+	/// Helper function for loading a bare FMU shared library (FMI Version 2.0, ME & CS), optionally isolated.
+	static int loadDll( std::string dllPath, BareFMU2Ptr bareFMU, fmippBoolean isolated = fmippFalse );
 
 	/**
 	 * @brief Loads all function pointers which are common to ME and CS
@@ -229,6 +321,16 @@ private:
 	 */
 	static HANDLE openDLL( int* status, const std::string& dllPath );
 
+	/**
+	 * @brief Tries to open the DLL/SO file such that its global variables are
+	 * not shared with any other handle of the same file (see getIsolatedInstance).
+	 * @details In case the file cannot be opened, the status variable is set to
+	 * 0 and an arbitrary value is returned.
+	 * @param status A valid reference to the status variable
+	 * @param dllPath The path to the dll file
+	 */
+	static HANDLE openIsolatedDLL( int* status, const std::string& dllPath );
+
 	/** 
 	 * @brief Helper function for loading FMU 1.0 shared library function
 	 * @details The function will load the address of the given function from the
@@ -334,20 +436,80 @@ private:
 	/// Define container for bare FMU ME collection. 
 	typedef std::map<std::string, BareFMUModelExchangePtr > BareModelCollection;
 
-	/// Collection of bare ME FMUs.
-	BareModelCollection modelCollection_;
-
 	/// Define container for bare FMU CS collection. 
 	typedef std::map<std::string, BareFMUCoSimulationPtr > BareSlaveCollection;
 
-	/// Collection of bare CS FMUs.
-	BareSlaveCollection slaveCollection_;
-
 	/// Define container for bare FMU 2 collection.
 	typedef std::map<std::string, BareFMU2Ptr > BareInstanceCollection;
 
-	/// Collection of bare 2.0 FMUs.
-	BareInstanceCollection instanceCollection_;
+	/// Define container for isolated bare FMU 2 instances (key: model identifier and isolation group).
+	typedef std::map<std::pair<std::string, std::string>, BareFMU2Ptr > IsolatedInstanceCollection;
+
+	/// Define container for the load timings of all models.
+	typedef std::map<std::string, LoadTimings> LoadTimingsCollection;
+
+	/// Information about a bare FMU held by the model manager (for automatic unloading and statistics).
+	struct ResidentInfo {
+		std::string fmuDirUrl; ///< Path to the extracted FMU directory (given as URL).
+		fmippSize sharedLibraryBytes; ///< Size of the shared library file.
+		fmippSize descriptionBytes; ///< Size of the XML model description file.
+		fmippBoolean released; ///< Flag indicating that the bare FMU has been released by a user.
+		std::chrono::steady_clock::time_point releaseTime; ///< Time when the bare FMU has been released.
+	};
+
+	/// Define container for the information about all bare FMUs (key: address of the bare FMU).
+	typedef std::map<const void*, ResidentInfo> ResidentCollection;
+
+	/// Define container for the FMU directories of the models unloaded automatically (key: model identifier).
+	typedef std::map<std::string, std::string> UnloadedCollection;
+
+	/// All collections of the model manager (never modified once published, see collections_).
+	struct Collections
+	{
+		Collections() : unloadedCount( 0 ) {}
+
+		BareModelCollection modelCollection; ///< Collection of bare ME FMUs.
+		BareSlaveCollection slaveCollection; ///< Collection of bare CS FMUs.
+		BareInstanceCollection instanceCollection; ///< Collection of bare 2.0 FMUs.
+		IsolatedInstanceCollection isolatedCollection; ///< Collection of isolated bare 2.0 FMUs.
+		LoadTimingsCollection loadTimingsCollection; ///< Load timings of all successfully loaded models.
+		ResidentCollection residentCollection; ///< Information about all bare FMUs in the other collections.
+		UnloadedCollection unloadedCollection; ///< FMU directories of the models unloaded automatically.
+		fmippSize unloadedCount; ///< Number of bare FMUs unloaded automatically.
+	};
+
+	/// Get a snapshot of the current collections (does not wait for modifications).
+	static std::shared_ptr<const Collections> getCollections();
+
+	/**
+	 * Modify a copy of the current collections and publish it. Modifications are serialized.
+	 * The modification is passed a reference to the copy and returns a value of type Result.
+	 */
+	template<typename Result, typename Modification>
+	static Result updateCollections( Modification modify );
+
+	/// Release a bare FMU (see releaseFMU).
+	template<typename BareFMUPtrType>
+	static void releaseBareFMU( BareFMUPtrType& bareFMU );
+
+	/**
+	 * Unload all released bare FMUs of the given collections that are still unused and whose grace
+	 * period has expired (to be called from within updateCollections).
+	 * @return number of unloaded bare FMUs
+	 */
+	static fmippSize unloadReleasedFMUs( Collections& collections );
+
+	/// Load a model again that has been unloaded automatically, returns false if it is unknown.
+	static fmippBoolean reloadFMU( const std::string& modelIdentifier );
+
+	/// Remove the information about bare FMUs that are no longer in the collections.
+	static void pruneResidentInfos( Collections& collections );
+
+	/// Get the information about a newly loaded bare FMU (sizes of its files).
+	static ResidentInfo getResidentInfo( const std::string& dllPath, const std::string& fmuDirUrl );
+
+	/// Current collections (accessed atomically, replaced as a whole when modified).
+	std::shared_ptr<const Collections> collections_;
 
 };
 
@@ -0,0 +1,102 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file VariableIndex.h
+ * Lookup table for model variables (name -> value reference and type).
+ */
+
+#ifndef _FMIPP_VARIABLEINDEX_H
+#define _FMIPP_VARIABLEINDEX_H
+
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+#include "common/FMIPPVariableType.h"
+
+
+/**
+ * \struct VariableHandle VariableIndex.h
+ * Resolved model variable. A handle is retrieved once (by name) and can then be used
+ * repeatedly to access the variable without any further name lookup.
+ */
+struct __FMI_DLL VariableHandle
+{
+	/// Default constructor, creates an invalid handle.
+	VariableHandle() : valueReference( fmippUndefinedValueReference ), type( fmippTypeUnknown ) {}
+
+	/// Constructor.
+	VariableHandle( fmippValueReference valref, FMIPPVariableType t ) : valueReference( valref ), type( t ) {}
+
+	/// Check if the handle refers to an existing variable.
+	fmippBoolean isValid() const { return fmippTypeUnknown != type; }
+
+	fmippValueReference valueReference; ///< Value reference of the variable.
+	FMIPPVariableType type; ///< Type of the variable.
+};
+
+
+/**
+ * \class VariableIndex VariableIndex.h
+ * Maps variable names to value references and types. The index is implemented as
+ * hash table with open addressing (linear probing), which keeps all entries in one
+ * contiguous array. Once built, the index is never modified and can be shared by
+ * all instances of the same model.
+ */
+class __FMI_DLL VariableIndex
+{
+
+public:
+
+	/// Constructor, reserves space for the expected number of variables.
+	VariableIndex( fmippSize expectedSize = 0 );
+
+	/**
+	 * Add a variable to the index.
+	 *
+	 * @param[in] name  name of the variable
+	 * @param[in] handle  value reference and type of the variable
+	 * @return false if a variable with the same name already exists (the index is not changed)
+	 */
+	fmippBoolean insert( const fmippString& name, const VariableHandle& handle );
+
+	/**
+	 * Find a variable by name.
+	 *
+	 * @param[in] name  name of the variable
+	 * @return pointer to the handle of the variable, NULL if no variable with this name exists
+	 */
+	const VariableHandle* find( const fmippString& name ) const;
+
+	/// Number of variables in the index.
+	fmippSize size() const { return size_; }
+
+private:
+
+	/// Entry of the hash table.
+	struct Entry
+	{
+		Entry() : hash( 0 ), used( false ) {}
+
+		fmippString name;
+		VariableHandle handle;
+		fmippSize hash;
+		fmippBoolean used;
+	};
+
+	/// Hash function for variable names (FNV-1a).
+	static fmippSize hash( const fmippString& name );
+
+	/// Resize the table to the given capacity (power of 2) and rehash all entries.
+	void rehash( fmippSize capacity );
+
+	std::vector<Entry> entries_; ///< Hash table (capacity is always a power of 2).
+
+	fmippSize size_; ///< Number of used entries.
+
+};
+
+
+#endif // _FMIPP_VARIABLEINDEX_H
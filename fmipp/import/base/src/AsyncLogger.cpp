@@ -0,0 +1,229 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file AsyncLogger.cpp
+ * Provide a global asynchronous logger for all FMU callback loggers.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdint.h>
+
+#include "import/base/include/AsyncLogger.h"
+
+using namespace std;
+
+AsyncLogger* AsyncLogger::asyncLogger_ = 0;
+
+
+namespace {
+
+	// Interval for checking the ring buffer for new messages.
+	const chrono::milliseconds pollInterval( 10 );
+
+	// Copy a string, truncating it if necessary.
+	void copyTruncated( char* dest, const char* src, fmippSize capacity )
+	{
+		if ( 0 == src ) src = "";
+		strncpy( dest, src, capacity - 1 );
+		dest[capacity - 1] = 0;
+	}
+
+	// Name of a severity level (FMI status).
+	const char* getSeverityName( int severity )
+	{
+		static const char* names[] = { "OK", "WARNING", "DISCARD", "ERROR", "FATAL", "PENDING" };
+		return ( ( severity >= 0 ) && ( severity < 6 ) ) ? names[severity] : "UNKNOWN";
+	}
+
+}
+
+
+AsyncLogger::AsyncLogger() :
+	active_( false ),
+	producers_( 0 ),
+	mask_( 0 ),
+	enqueuePos_( 0 ),
+	dequeuePos_( 0 ),
+	dropped_( 0 ),
+	minimumSeverity_( fmippOK ),
+	file_( 0 ),
+	stopRequested_( false )
+{}
+
+
+AsyncLogger::~AsyncLogger()
+{
+	stop();
+}
+
+
+AsyncLogger&
+AsyncLogger::getAsyncLogger()
+{
+	// Singleton instance
+	static AsyncLogger asyncLoggerInstance;
+	if ( 0 == asyncLogger_ ) {
+		asyncLogger_ = &asyncLoggerInstance;
+	}
+	return *asyncLogger_;
+}
+
+
+fmippBoolean
+AsyncLogger::start( const fmippString& fileName, fmippSize capacity )
+{
+	if ( isActive() ) return false;
+
+	file_ = fopen( fileName.c_str(), "a" );
+	if ( 0 == file_ ) return false;
+
+	// Calls of log that started while the logger was not active may still be checking the flag.
+	waitForProducers();
+
+	fmippSize size = 2;
+	while ( size < capacity ) size <<= 1;
+
+	slots_.reset( new Slot[size] );
+	for ( fmippSize i = 0; i < size; ++i ) slots_[i].sequence.store( i, memory_order_relaxed );
+	mask_ = size - 1;
+	enqueuePos_.store( 0, memory_order_relaxed );
+	dequeuePos_ = 0;
+	dropped_.store( 0, memory_order_relaxed );
+
+	stopRequested_ = false;
+	thread_ = thread( &AsyncLogger::run, this );
+
+	active_.store( true, memory_order_seq_cst );
+	return true;
+}
+
+
+void
+AsyncLogger::stop()
+{
+	if ( false == isActive() ) return;
+
+	// Calls of log either see the cleared flag or are waited for (both sides use sequentially
+	// consistent operations on active_ and producers_).
+	active_.store( false, memory_order_seq_cst );
+	waitForProducers();
+
+	{
+		lock_guard<mutex> lock( mutex_ );
+		stopRequested_ = true;
+	}
+	wakeUp_.notify_one();
+	thread_.join();
+
+	// Write the messages enqueued while stopping.
+	drain();
+
+	fmippSize dropped = getDroppedMessages();
+	if ( dropped > 0 ) fprintf( file_, "[WARNING] AsyncLogger: %lu message(s) dropped\n", static_cast<unsigned long>( dropped ) );
+
+	fclose( file_ );
+	file_ = 0;
+}
+
+
+fmippBoolean
+AsyncLogger::accepts( int severity, const char* category ) const
+{
+	if ( severity < minimumSeverity_ ) return false;
+	if ( categories_.empty() ) return true;
+	return ( 0 != category ) && ( categories_.end() != find( categories_.begin(), categories_.end(), category ) );
+}
+
+
+void
+AsyncLogger::log( const char* instanceName, int severity, const char* category, const char* format, va_list args )
+{
+	// Do not register while stopped, stop and start wait until no producer is registered.
+	if ( false == isActive() ) return;
+
+	// Register as producer before checking the flag again (see stop).
+	producers_.fetch_add( 1, memory_order_seq_cst );
+	if ( active_.load( memory_order_seq_cst ) ) enqueue( instanceName, severity, category, format, args );
+	producers_.fetch_sub( 1, memory_order_release );
+}
+
+
+void
+AsyncLogger::enqueue( const char* instanceName, int severity, const char* category, const char* format, va_list args )
+{
+	// Reserve a slot (bounded multi-producer queue, see D. Vyukov's bounded MPMC queue).
+	Slot* slot = 0;
+	fmippSize pos = enqueuePos_.load( memory_order_relaxed );
+	while ( true )
+	{
+		slot = &slots_[pos & mask_];
+		fmippSize sequence = slot->sequence.load( memory_order_acquire );
+		intptr_t diff = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( pos );
+
+		if ( 0 == diff ) {
+			if ( enqueuePos_.compare_exchange_weak( pos, pos + 1, memory_order_relaxed ) ) break;
+		} else if ( diff < 0 ) { // Ring buffer is full.
+			dropped_.fetch_add( 1, memory_order_relaxed );
+			return;
+		} else {
+			pos = enqueuePos_.load( memory_order_relaxed );
+		}
+	}
+
+	slot->severity = severity;
+	copyTruncated( slot->instanceName, instanceName, maxInstanceNameLength );
+	copyTruncated( slot->category, category, maxCategoryLength );
+	if ( vsnprintf( slot->message, maxMessageLength, format, args ) < 0 ) slot->message[0] = 0;
+
+	// Publish the message.
+	slot->sequence.store( pos + 1, memory_order_release );
+}
+
+
+void
+AsyncLogger::run()
+{
+	unique_lock<mutex> lock( mutex_ );
+	while ( false == stopRequested_ )
+	{
+		lock.unlock();
+		fmippSize n = drain();
+		if ( n > 0 ) fflush( file_ );
+		lock.lock();
+
+		if ( 0 == n ) wakeUp_.wait_for( lock, pollInterval );
+	}
+}
+
+
+void
+AsyncLogger::waitForProducers() const
+{
+	while ( 0 != producers_.load( memory_order_acquire ) ) this_thread::yield();
+}
+
+
+fmippSize
+AsyncLogger::drain()
+{
+	fmippSize n = 0;
+	while ( true )
+	{
+		Slot& slot = slots_[dequeuePos_ & mask_];
+		if ( slot.sequence.load( memory_order_acquire ) != dequeuePos_ + 1 ) break; // No message available.
+
+		fprintf( file_, "[%s] %s [%s]: %s\n", getSeverityName( slot.severity ),
+			slot.instanceName, slot.category, slot.message );
+
+		// Release the slot for the next round.
+		slot.sequence.store( dequeuePos_ + mask_ + 1, memory_order_release );
+		++dequeuePos_;
+		++n;
+	}
+	return n;
+}
@@ -13,7 +13,7 @@
 // Helper function for deleting bare FMUs.
 template<typename BareFMUType> void deleteBareFMUContent( BareFMUType* bareFMU )
 {
-		if ( 0 != bareFMU->functions->dllHandle ) {
+		if ( ( 0 != bareFMU->functions ) && ( 0 != bareFMU->functions->dllHandle ) ) {
 #if defined(MINGW)
 			FreeLibrary( static_cast<HMODULE>( bareFMU->functions->dllHandle ) );
 #elif defined(_MSC_VER)
@@ -14,10 +14,28 @@
 #include <sstream>
 #include <iostream>
 
+#include "import/base/include/AsyncLogger.h"
 #include "import/base/include/CallbackFunctions.h"
 #include "import/base/include/LogBuffer.h"
 
 
+namespace {
+
+	// Pass a message to the asynchronous logger (if active), returns false otherwise.
+	bool logAsync( const char* instanceName, int status, const char* category, const char* message, va_list ap )
+	{
+		AsyncLogger& asyncLogger = AsyncLogger::getAsyncLogger();
+		if ( false == asyncLogger.isActive() ) return false;
+
+		if ( asyncLogger.accepts( status, category ) ) {
+			asyncLogger.log( instanceName, status, category, message, ap );
+		}
+		return true;
+	}
+
+}
+
+
 namespace callback {
 
 	// This is a very verbose logger that prints out all messages it receives.
@@ -29,6 +47,11 @@ namespace callback {
 
 		va_list ap;
 		va_start( ap, message );
+
+		if ( logAsync( instanceName, status, category, message, ap ) ) {
+			va_end( ap );
+			return;
+		}
 		
 		int length = vsnprintf( msgBuffer, capacity, message, ap );
 
@@ -66,6 +89,11 @@ namespace callback {
 
 		va_list ap;
 		va_start( ap, message );
+
+		if ( logAsync( instanceName, status, category, message, ap ) ) {
+			va_end( ap );
+			return;
+		}
 		
 		int length = vsnprintf( msgBuffer, capacity, message, ap );
 
@@ -125,6 +153,11 @@ namespace callback2 {
 
 		va_list ap;
 		va_start( ap, message );
+
+		if ( logAsync( instanceName, status, category, message, ap ) ) {
+			va_end( ap );
+			return;
+		}
 		
 		int length = vsnprintf( msgBuffer, capacity, message, ap );
 
@@ -163,6 +196,11 @@ namespace callback2 {
 		va_list ap;
 		va_start( ap, message );
 
+		if ( logAsync( instanceName, status, category, message, ap ) ) {
+			va_end( ap );
+			return;
+		}
+
 		int length = vsnprintf( msgBuffer, capacity, message, ap );
 
 		if ( length < 0 ) {
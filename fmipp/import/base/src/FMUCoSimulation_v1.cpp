@@ -182,6 +182,9 @@ FMUCoSimulation::~FMUCoSimulation()
 		fmu_->functions->terminateSlave( instance_ );
 		fmu_->functions->freeSlaveInstance( instance_ );
 	}
+
+	// Let the model manager unload the FMU if it is not used anymore.
+	ModelManager::releaseFMU( fmu_ );
 }
 
 void
@@ -197,12 +200,10 @@ void FMUCoSimulation::readModelDescription()
 {
 	using namespace ModelDescriptionUtilities;
 
-	typedef ModelDescription::Properties Properties;
 	const ModelDescription* description = fmu_->description;
 
-	const Properties& modelVariables = description->getModelVariables();
-	Properties::const_iterator itVar = modelVariables.begin();
-	Properties::const_iterator itEnd = modelVariables.end();
+	typedef ModelDescription::ScalarVariables ScalarVariables;
+	const ScalarVariables& variables = description->getScalarVariables();
 
 	// List of all variable names -> check if names are unique.
 	set<fmippString> allVariableNames;
@@ -212,12 +213,10 @@ void FMUCoSimulation::readModelDescription()
 	set<fmippValueReference> allVariableValRefs; 
 	pair< set<fmippValueReference>::iterator, fmippBoolean > varValRefsInsert;
 
-	for ( ; itVar != itEnd; ++itVar )
+	for ( ScalarVariables::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar )
 	{
-		const Properties& varAttributes = getAttributes( itVar );
-
-		fmippString varName = varAttributes.get<fmippString>( "name" );
-		fmippValueReference varValRef = varAttributes.get<fmippValueReference>( "valueReference" );
+		const fmippString& varName = itVar->name;
+		fmippValueReference varValRef = itVar->valueReference;
 		varNamesInsert = allVariableNames.insert( varName );
 
 		if ( false == varNamesInsert.second ) { // Check if variable name is unique.
@@ -239,17 +238,7 @@ void FMUCoSimulation::readModelDescription()
 		varMap_.insert( make_pair( varName, varValRef ) );
 
 		// Map name to value type.
-		if ( hasChild( itVar, "Real" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeReal ) );
-		} else if ( hasChild( itVar, "Integer" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeInteger ) );
-		} else if ( hasChild( itVar, "fmippBooleanean" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeBoolean ) );
-		} else if ( hasChild( itVar, "String" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeString ) );
-		} else {
-			varTypeMap_.insert( make_pair( varName, fmippTypeUnknown ) );
-		}
+		varTypeMap_.insert( make_pair( varName, itVar->type ) );
 	}
 	//nValueRefs_ = varMap_.size();
 }
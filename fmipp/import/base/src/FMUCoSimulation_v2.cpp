@@ -7,6 +7,7 @@
  * \file FMUCoSimulation_v2.cpp
  */
 
+#include <algorithm>
 #include <assert.h>
 #include <set>
 #include <sstream>
@@ -145,13 +146,37 @@ FMUCoSimulation::FMUCoSimulation( const fmippString& modelIdentifier,
 	}
 }
 
+// Constructor. Uses the given bare FMU.
+FMUCoSimulation::FMUCoSimulation( BareFMU2Ptr bareFMU,
+	const fmippBoolean loggingOn,
+	const fmippTime timeDiffResolution ) :
+		FMUCoSimulationBase( loggingOn ),
+		instance_( NULL ),
+		fmu_( bareFMU ),
+		time_( numeric_limits<fmippTime>::quiet_NaN() ),
+		timeDiffResolution_( timeDiffResolution ),
+		lastStatus_( fmi2OK )
+{
+	// Set default callback functions.
+	using namespace callback2;
+	callbacks_.logger = loggingOn ? verboseLogger : succinctLogger;
+	callbacks_.allocateMemory = allocateMemory;
+	callbacks_.freeMemory = freeMemory;
+	callbacks_.stepFinished = stepFinished;
+
+	if ( 0 != fmu_ ) {
+		readModelDescription();
+	} else {
+		lastStatus_ = fmi2Fatal;
+	}
+}
+
 FMUCoSimulation::FMUCoSimulation( const FMUCoSimulation& fmu ) :
 		FMUCoSimulationBase( fmu.loggingOn_ ),
 		instance_( NULL ),
 		fmu_( fmu.fmu_ ),
 		callbacks_( fmu.callbacks_ ),
-		varMap_( fmu.varMap_ ),
-		varTypeMap_( fmu.varTypeMap_ ),
+		varIndex_( fmu.varIndex_ ),
 		time_( numeric_limits<fmippReal>::quiet_NaN() ),
 		timeDiffResolution_( fmu.timeDiffResolution_ ),
 		lastStatus_( fmi2OK )
@@ -163,6 +188,9 @@ FMUCoSimulation::~FMUCoSimulation()
 		fmu_->functions->terminate( instance_ );
 		fmu_->functions->freeInstance( instance_ );
 	}
+
+	// Let the model manager unload the FMU if it is not used anymore.
+	ModelManager::releaseFMU( fmu_ );
 }
 
 void
@@ -171,6 +199,7 @@ FMUCoSimulation::terminate()
 	if ( instance_ ) {
 		fmu_->functions->terminate( instance_ );
 		fmu_->functions->freeInstance( instance_ );
+		instance_ = NULL; // Avoid freeing the instance again in the destructor.
 	}
 }
 
@@ -178,35 +207,29 @@ void FMUCoSimulation::readModelDescription()
 {
 	using namespace ModelDescriptionUtilities;
 
-	typedef ModelDescription::Properties Properties;
-	const ModelDescription* description = fmu_->description;
+	// The variable index only depends on the model description, i.e., it is
+	// built only once and then shared by all instances of the same model (the
+	// index is accessed atomically, since instances may be created concurrently).
+	std::shared_ptr<const VariableIndex> sharedIndex = atomic_load( &fmu_->variableIndex );
+	if ( sharedIndex ) {
+		varIndex_ = sharedIndex;
+		return;
+	}
 
-	const Properties& modelVariables = description->getModelVariables();
-	Properties::const_iterator itVar = modelVariables.begin();
-	Properties::const_iterator itEnd = modelVariables.end();
+	typedef ModelDescription::ScalarVariables ScalarVariables;
+	const ScalarVariables& variables = fmu_->description->getScalarVariables();
 
-	// List of all variable names -> check if names are unique.
-	set<fmippString> allVariableNames;
-	pair< set<fmippString>::iterator, fmippBoolean > varNamesInsert;
+	std::shared_ptr<VariableIndex> index( new VariableIndex( variables.size() ) );
 
 	// List of all variable value references -> check if value references are unique.
 	set<fmippValueReference> allVariableValRefs; 
 	pair< set<fmippValueReference>::iterator, fmippBoolean > varValRefsInsert;
 
-	for ( ; itVar != itEnd; ++itVar )
+	for ( ScalarVariables::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar )
 	{
-		const Properties& varAttributes = getAttributes( itVar );
-
-		fmippString varName = varAttributes.get<fmippString>( "name" );
-		fmippValueReference varValRef = varAttributes.get<fmippValueReference>( "valueReference" );
+		const fmippString& varName = itVar->name;
+		fmippValueReference varValRef = itVar->valueReference;
 
-		varNamesInsert = allVariableNames.insert( varName );
-
-		if ( false == varNamesInsert.second ) { // Check if variable name is unique.
-			fmippString message = fmippString( "multiple definitions of variable name '" ) +
-				varName + fmippString( "' found" );
-			logger( fmi2Warning, "WARNING", message );
-		}
 		varValRefsInsert = allVariableValRefs.insert( varValRef );
 		if ( false == varValRefsInsert.second ) { // Check if value reference is unique.
 			stringstream message;
@@ -215,23 +238,31 @@ void FMUCoSimulation::readModelDescription()
 			logger( fmi2Warning, "WARNING", message.str() );
 		}
 
-		// Map name to value reference.
-		varMap_.insert( make_pair( varName, varValRef ) );
-
-		// Map name to value type.
-		if ( hasChild( itVar, "Real" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeReal ) );
-		} else if ( hasChild( itVar, "Integer" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeInteger ) );
-		} else if ( hasChild( itVar, "Boolean" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeBoolean ) );
-		} else if ( hasChild( itVar, "String" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeString ) );
-		} else {
-			varTypeMap_.insert( make_pair( varName, fmippTypeUnknown ) );
+		// Map name to value reference and type.
+		if ( false == index->insert( varName, VariableHandle( varValRef, itVar->type ) ) ) { // Check if variable name is unique.
+			fmippString message = fmippString( "multiple definitions of variable name '" ) +
+				varName + fmippString( "' found" );
+			logger( fmi2Warning, "WARNING", message );
 		}
 	}
-	//nValueRefs_ = varMap_.size();
+
+	varIndex_ = index;
+	atomic_store( &fmu_->variableIndex, std::shared_ptr<const VariableIndex>( index ) );
+}
+
+const VariableHandle* FMUCoSimulation::findVariable( const fmippString& name ) const
+{
+	return varIndex_ ? varIndex_->find( name ) : 0;
+}
+
+fmippBoolean FMUCoSimulation::checkHandle( const VariableHandle& handle, FMIPPVariableType type )
+{
+	if ( type == handle.type ) return true;
+
+	logger( fmi2Discard, "WARNING", handle.isValid() ?
+		"variable handle does not match requested type" : "invalid variable handle" );
+	lastStatus_ = fmi2Discard;
+	return false;
 }
 
 fmippStatus FMUCoSimulation::instantiate( const fmippString& instanceName,
@@ -345,8 +376,12 @@ fmippStatus FMUCoSimulation::setValue( fmippValueReference* valref, const fmippI
 
 fmippStatus FMUCoSimulation::setValue( fmippValueReference* valref, const fmippBoolean* val, fmippSize ival )
 {
-	fmi2Boolean val2 = (fmi2Boolean) *val;
-	lastStatus_ = fmu_->functions->setBoolean( instance_, valref, ival, &val2 );
+	fmi2Boolean* val2 = new fmi2Boolean[ival];
+	for ( fmippSize i = 0; i < ival; ++i ) {
+		val2[i] = (fmi2Boolean) val[i];
+	}
+	lastStatus_ = fmu_->functions->setBoolean( instance_, valref, ival, val2 );
+	delete [] val2;
 	return (fmippStatus) lastStatus_;
 }
 
@@ -363,10 +398,10 @@ fmippStatus FMUCoSimulation::setValue( fmippValueReference* valref, const fmippS
 
 fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippReal& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->setReal( instance_, &it->second, 1, &val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->setReal( instance_, &it->valueReference, 1, &val );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -378,10 +413,10 @@ fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippReal&
 
 fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippInteger& val )
 {
-	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->setInteger( instance_, &it->second, 1, &val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->setInteger( instance_, &it->valueReference, 1, &val );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -393,11 +428,11 @@ fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippInteg
 
 fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippBoolean& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 
-	if ( it != varMap_.end() ) {
+	if ( 0 != it ) {
 		fmi2Boolean val2 = (fmi2Boolean) val;
-		lastStatus_ = fmu_->functions->setBoolean( instance_, &it->second, 1, &val2 );
+		lastStatus_ = fmu_->functions->setBoolean( instance_, &it->valueReference, 1, &val2 );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -409,12 +444,12 @@ fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippBoole
 
 fmippStatus FMUCoSimulation::setValue( const fmippString& name, const fmippString& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 
 	const char* cString = val.c_str();
 
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->setString( instance_, &it->second, 1, &cString );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->setString( instance_, &it->valueReference, 1, &cString );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -467,32 +502,31 @@ fmippStatus FMUCoSimulation::getValue( fmippValueReference* valref, fmippInteger
 fmippStatus FMUCoSimulation::getValue( fmippValueReference* valref, fmippBoolean* val, fmippSize ival )
 {
 	fmi2Boolean* val2 = new fmi2Boolean[ival];
+	lastStatus_ = fmu_->functions->getBoolean( instance_, valref, ival, val2 );
 	for ( fmippSize i = 0; i < ival; ++i ) {
-		val2[i] = (fmi2Boolean) val[i];
+		val[i] = (fmippBoolean) val2[i];
 	}
-	lastStatus_ = fmu_->functions->getBoolean( instance_, valref, ival, val2 );
-	delete val2;
+	delete [] val2;
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUCoSimulation::getValue( fmippValueReference* valref, fmippString* val, fmippSize ival )
 {
-	const char** cStrings = 0;
+	fmi2String* cStrings = new fmi2String[ival];
 	
 	lastStatus_ = fmu_->functions->getString( instance_, valref, ival, cStrings );
-	if ( 0 != cStrings ) {
-		for ( fmippSize i = 0; i < ival; i++ ) {
-			val[i] = fmippString( cStrings[i] );
-		}
+	for ( fmippSize i = 0; i < ival; i++ ) {
+		val[i] = ( 0 != cStrings[i] ) ? fmippString( cStrings[i] ) : fmippString();
 	}
+	delete [] cStrings;
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippReal& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getReal( instance_, &it->second, 1, &val );
+	const VariableHandle* it = findVariable( name );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getReal( instance_, &it->valueReference, 1, &val );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -504,9 +538,9 @@ fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippReal& val )
 
 fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippInteger& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getInteger( instance_, &it->second, 1, &val );
+	const VariableHandle* it = findVariable( name );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getInteger( instance_, &it->valueReference, 1, &val );
 		return (fmippStatus) lastStatus_;
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -518,10 +552,10 @@ fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippInteger& va
 
 fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippBoolean& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
-	if ( it != varMap_.end() ) {
+	const VariableHandle* it = findVariable( name );
+	if ( 0 != it ) {
 		fmi2Boolean val2 = (fmi2Boolean) val;
-		lastStatus_ = fmu_->functions->getBoolean( instance_, &it->second, 1, &val2 );
+		lastStatus_ = fmu_->functions->getBoolean( instance_, &it->valueReference, 1, &val2 );
 		val = (fmippBoolean) val2;
 		return (fmippStatus) lastStatus_;
 	} else {
@@ -534,10 +568,10 @@ fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippBoolean& va
 
 fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippString& val )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 	const char* cString;
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getString( instance_, &it->second, 1, &cString );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getString( instance_, &it->valueReference, 1, &cString );
 		val = fmippString( cString );
 		return (fmippStatus) lastStatus_;
 	} else {
@@ -549,10 +583,10 @@ fmippStatus FMUCoSimulation::getValue( const fmippString& name, fmippString& val
 }
 fmippReal FMUCoSimulation::getRealValue( const fmippString& name )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 	fmippReal val[1];
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getReal( instance_, &it->second, 1, val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getReal( instance_, &it->valueReference, 1, val );
 	} else {
 		val[0] = numeric_limits<fmippReal>::quiet_NaN();
 		fmippString ret = name + fmippString( " does not exist" );
@@ -564,10 +598,10 @@ fmippReal FMUCoSimulation::getRealValue( const fmippString& name )
 
 fmippInteger FMUCoSimulation::getIntegerValue( const fmippString& name )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 	fmippInteger val[1];
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getInteger( instance_, &it->second, 1, val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getInteger( instance_, &it->valueReference, 1, val );
 	} else {
 		val[0] = numeric_limits<fmippInteger>::quiet_NaN();
 		fmippString ret = name + fmippString( " does not exist" );
@@ -579,10 +613,10 @@ fmippInteger FMUCoSimulation::getIntegerValue( const fmippString& name )
 
 fmippBoolean FMUCoSimulation::getBooleanValue( const fmippString& name )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 	fmi2Boolean val[1];
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getBoolean( instance_, &it->second, 1, val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getBoolean( instance_, &it->valueReference, 1, val );
 	} else {
 		val[0] = fmi2False;
 		fmippString ret = name + fmippString( " does not exist" );
@@ -594,10 +628,10 @@ fmippBoolean FMUCoSimulation::getBooleanValue( const fmippString& name )
 
 fmippString FMUCoSimulation::getStringValue( const fmippString& name )
 {
-	map<fmippString,fmi2ValueReference>::const_iterator it = varMap_.find( name );
+	const VariableHandle* it = findVariable( name );
 	fmiString val[1];
-	if ( it != varMap_.end() ) {
-		lastStatus_ = fmu_->functions->getString( instance_, &it->second, 1, val );
+	if ( 0 != it ) {
+		lastStatus_ = fmu_->functions->getString( instance_, &it->valueReference, 1, val );
 	} else {
 		val[0] = 0;
 		fmippString ret = name + fmippString( " does not exist" );
@@ -607,6 +641,80 @@ fmippString FMUCoSimulation::getStringValue( const fmippString& name )
 	return fmippString( val[0] );
 }
 
+VariableHandle FMUCoSimulation::getVariableHandle( const fmippString& name ) const
+{
+	const VariableHandle* it = findVariable( name );
+	if ( 0 != it ) {
+		return *it;
+	} else {
+		fmippString ret = name + fmippString( " does not exist" );
+		logger( fmi2Discard, "WARNING", ret );
+		return VariableHandle();
+	}
+}
+
+fmippStatus FMUCoSimulation::setValue( const VariableHandle& handle, const fmippReal& val )
+{
+	if ( false == checkHandle( handle, fmippTypeReal ) ) return (fmippStatus) lastStatus_;
+	lastStatus_ = fmu_->functions->setReal( instance_, &handle.valueReference, 1, &val );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::setValue( const VariableHandle& handle, const fmippInteger& val )
+{
+	if ( false == checkHandle( handle, fmippTypeInteger ) ) return (fmippStatus) lastStatus_;
+	lastStatus_ = fmu_->functions->setInteger( instance_, &handle.valueReference, 1, &val );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::setValue( const VariableHandle& handle, const fmippBoolean& val )
+{
+	if ( false == checkHandle( handle, fmippTypeBoolean ) ) return (fmippStatus) lastStatus_;
+	fmi2Boolean val2 = (fmi2Boolean) val;
+	lastStatus_ = fmu_->functions->setBoolean( instance_, &handle.valueReference, 1, &val2 );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::setValue( const VariableHandle& handle, const fmippString& val )
+{
+	if ( false == checkHandle( handle, fmippTypeString ) ) return (fmippStatus) lastStatus_;
+	const char* cString = val.c_str();
+	lastStatus_ = fmu_->functions->setString( instance_, &handle.valueReference, 1, &cString );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::getValue( const VariableHandle& handle, fmippReal& val )
+{
+	if ( false == checkHandle( handle, fmippTypeReal ) ) return (fmippStatus) lastStatus_;
+	lastStatus_ = fmu_->functions->getReal( instance_, &handle.valueReference, 1, &val );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::getValue( const VariableHandle& handle, fmippInteger& val )
+{
+	if ( false == checkHandle( handle, fmippTypeInteger ) ) return (fmippStatus) lastStatus_;
+	lastStatus_ = fmu_->functions->getInteger( instance_, &handle.valueReference, 1, &val );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::getValue( const VariableHandle& handle, fmippBoolean& val )
+{
+	if ( false == checkHandle( handle, fmippTypeBoolean ) ) return (fmippStatus) lastStatus_;
+	fmi2Boolean val2;
+	lastStatus_ = fmu_->functions->getBoolean( instance_, &handle.valueReference, 1, &val2 );
+	val = (fmippBoolean) val2;
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::getValue( const VariableHandle& handle, fmippString& val )
+{
+	if ( false == checkHandle( handle, fmippTypeString ) ) return (fmippStatus) lastStatus_;
+	const char* cString;
+	lastStatus_ = fmu_->functions->getString( instance_, &handle.valueReference, 1, &cString );
+	val = fmippString( cString );
+	return (fmippStatus) lastStatus_;
+}
+
 fmippStatus FMUCoSimulation::getLastStatus() const
 {
 	return (fmippStatus) lastStatus_;
@@ -614,9 +722,9 @@ fmippStatus FMUCoSimulation::getLastStatus() const
 
 fmippValueReference FMUCoSimulation::getValueRef( const fmippString& name ) const
 {
-	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find(name);
-	if ( it != varMap_.end() ) {
-		return it->second;
+	const VariableHandle* it = findVariable( name );
+	if ( 0 != it ) {
+		return it->valueReference;
 	} else {
 		return fmippUndefinedValueReference;
 	}
@@ -677,7 +785,7 @@ fmippSize FMUCoSimulation::nEventInds() const
 
 fmippSize FMUCoSimulation::nValueRefs() const
 {
-	return varMap_.size();
+	return varIndex_ ? varIndex_->size() : 0;
 }
 
 const ModelDescription* FMUCoSimulation::getModelDescription() const
@@ -693,13 +801,105 @@ const ModelDescription* FMUCoSimulation::getModelDescription() const
 
 FMIPPVariableType FMUCoSimulation::getType( const fmippString& variableName ) const
 {
-	map<fmippString,FMIPPVariableType>::const_iterator it = varTypeMap_.find( variableName );
-	if ( it == varTypeMap_.end() ) {
+	const VariableHandle* it = findVariable( variableName );
+	if ( 0 == it ) {
 		fmippString ret = variableName + fmippString( " does not exist" );
 		logger( fmi2Discard, "WARNING", ret );
 		return fmippTypeUnknown;
 	}
-	return it->second;
+	return it->type;
+}
+
+fmippBoolean
+FMUCoSimulation::getOptionalCoSimToolCapability( const fmippString& attributeName ) const
+{
+	// Capability flags are optional, the default is false.
+	try {
+		return getCoSimToolCapabilities<fmippBoolean>( attributeName );
+	} catch ( const std::runtime_error& ) {
+		return false;
+	}
+}
+
+fmippBoolean
+FMUCoSimulation::canGetAndSetFMUstate() const
+{
+	return getOptionalCoSimToolCapability( "canGetAndSetFMUstate" );
+}
+
+fmippBoolean
+FMUCoSimulation::canSerializeFMUstate() const
+{
+	return getOptionalCoSimToolCapability( "canSerializeFMUstate" );
+}
+
+fmippStatus FMUCoSimulation::getFMUState( fmi2FMUstate* fmuState )
+{
+	lastStatus_ = fmu_->functions->getFMUstate( instance_, fmuState );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::setFMUState( fmi2FMUstate fmuState )
+{
+	lastStatus_ = fmu_->functions->setFMUstate( instance_, fmuState );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::freeFMUState( fmi2FMUstate* fmuState )
+{
+	lastStatus_ = fmu_->functions->freeFMUstate( instance_, fmuState );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::serializeState( std::vector<fmippByte>& buffer )
+{
+	if ( ( 0 == instance_ ) || ( 0 == fmu_->functions->serializeFMUstate ) ) {
+		logger( fmi2Error, "ERROR", "serialization of FMU state not available" );
+		lastStatus_ = fmi2Error;
+		return (fmippStatus) lastStatus_;
+	}
+
+	fmi2FMUstate fmuState = 0;
+	lastStatus_ = fmu_->functions->getFMUstate( instance_, &fmuState );
+	if ( fmi2Warning < lastStatus_ ) return (fmippStatus) lastStatus_;
+
+	size_t size = 0;
+	fmi2Status status = fmu_->functions->serializedFMUstateSize( instance_, fmuState, &size );
+	if ( fmi2Warning >= status ) {
+		buffer.resize( size );
+		status = fmu_->functions->serializeFMUstate( instance_, fmuState,
+			reinterpret_cast<fmi2Byte*>( buffer.data() ), size );
+	}
+	lastStatus_ = max( lastStatus_, status );
+
+	status = fmu_->functions->freeFMUstate( instance_, &fmuState );
+	lastStatus_ = max( lastStatus_, status );
+
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUCoSimulation::deSerializeState( const std::vector<fmippByte>& buffer, fmippTime time )
+{
+	if ( ( 0 == instance_ ) || ( 0 == fmu_->functions->deSerializeFMUstate ) ) {
+		logger( fmi2Error, "ERROR", "de-serialization of FMU state not available" );
+		lastStatus_ = fmi2Error;
+		return (fmippStatus) lastStatus_;
+	}
+
+	fmi2FMUstate fmuState = 0;
+	lastStatus_ = fmu_->functions->deSerializeFMUstate( instance_,
+		reinterpret_cast<const fmi2Byte*>( buffer.data() ), buffer.size(), &fmuState );
+	if ( fmi2Warning < lastStatus_ ) return (fmippStatus) lastStatus_;
+
+	fmi2Status status = fmu_->functions->setFMUstate( instance_, fmuState );
+	lastStatus_ = max( lastStatus_, status );
+
+	if ( fmi2Warning >= lastStatus_ ) time_ = time;
+
+	status = fmu_->functions->freeFMUstate( instance_, &fmuState );
+	lastStatus_ = max( lastStatus_, status );
+
+	return (fmippStatus) lastStatus_;
 }
 
 fmippBoolean
@@ -230,13 +230,15 @@ FMUModelExchange::~FMUModelExchange()
 		fmu_->functions->freeModelInstance( instance_ );
 #endif
 	}
+
+	// Let the model manager unload the FMU if it is not used anymore.
+	ModelManager::releaseFMU( fmu_ );
 }
 
 void FMUModelExchange::readModelDescription()
 {
 	using namespace ModelDescriptionUtilities;
 
-	typedef ModelDescription::Properties Properties;
 	const ModelDescription* description = fmu_->description;
 
 	nStateVars_ = description->getNumberOfContinuousStates();
@@ -244,9 +246,8 @@ void FMUModelExchange::readModelDescription()
 
 	providesJacobian_ = false;
 
-	const Properties& modelVariables = description->getModelVariables();
-	Properties::const_iterator itVar = modelVariables.begin();
-	Properties::const_iterator itEnd = modelVariables.end();
+	typedef ModelDescription::ScalarVariables ScalarVariables;
+	const ScalarVariables& variables = description->getScalarVariables();
 
 	// List of all variable names -> check if names are unique.
 	set<fmippString> allVariableNames;
@@ -256,12 +257,10 @@ void FMUModelExchange::readModelDescription()
 	set<fmippValueReference> allVariableValRefs;
 	pair< set<fmippValueReference>::iterator, fmippBoolean > varValRefsInsert;
 
-	for ( ; itVar != itEnd; ++itVar )
+	for ( ScalarVariables::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar )
 	{
-		const Properties& varAttributes = getAttributes( itVar );
-
-		fmippString varName = varAttributes.get<fmippString>( "name" );
-		fmippValueReference varValRef = varAttributes.get<fmippValueReference>( "valueReference" );
+		const fmippString& varName = itVar->name;
+		fmippValueReference varValRef = itVar->valueReference;
 
 		varNamesInsert = allVariableNames.insert( varName );
 
@@ -284,17 +283,7 @@ void FMUModelExchange::readModelDescription()
 		varMap_.insert( make_pair( varName, varValRef ) );
 
 		// Map name to value type.
-		if ( hasChild( itVar, "Real" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeReal ) );
-		} else if ( hasChild( itVar, "Integer" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeInteger ) );
-		} else if ( hasChild( itVar, "Boolean" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeBoolean ) );
-		} else if ( hasChild( itVar, "String" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeString ) );
-		} else {
-			varTypeMap_.insert( make_pair( varName, fmippTypeUnknown ) );
-		}
+		varTypeMap_.insert( make_pair( varName, itVar->type ) );
 	}
 	if ( fmu_->description->hasDefaultExperiment() ){
 		Integrator::Properties properties = integrator_->getProperties();
@@ -430,12 +419,14 @@ void FMUModelExchange::rewindTime( fmippReal deltaRewindTime )
 
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippReal& val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setReal( instance_, &valref, 1, &val );
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippInteger& val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setInteger( instance_, &valref, 1, &val );
 	return (fmippStatus) lastStatus_;
 }
@@ -443,6 +434,7 @@ fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippI
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippBoolean& val )
 {
 	fmiBoolean val2 = (fmiBoolean) val;
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setBoolean( instance_, &valref, 1, &val2 );
 	return (fmippStatus) lastStatus_;
 }
@@ -450,18 +442,21 @@ fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippB
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippString& val )
 {
 	const char* cString = val.c_str();
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setString( instance_, &valref, 1, &cString );
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippReal* val, fmippSize ival)
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setReal(instance_, valref, ival, val);
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippInteger* val, fmippSize ival)
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setInteger(instance_, valref, ival, val);
 	return (fmippStatus) lastStatus_;
 }
@@ -472,6 +467,7 @@ fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippB
 	for ( fmippSize i = 0; i < ival; ++i ) {
 		val2[i] = (fmiBoolean) val[i];
 	}
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setBoolean(instance_, valref, ival, val2);
 	return (fmippStatus) lastStatus_;
 }
@@ -483,6 +479,7 @@ fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippS
 		cStrings[i] = val[i].c_str();
 	}
 
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setString(instance_, valref, ival, cStrings);
 	delete [] cStrings;
 
@@ -493,6 +490,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippReal
 {
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setReal( instance_, &it->second, 1, &val );
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -507,6 +505,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippInte
 {
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setInteger( instance_, &it->second, 1, &val );
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -522,6 +521,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippBool
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 	fmiBoolean val2 = (fmiBoolean) val;
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setBoolean( instance_, &it->second, 1, &val2 );
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -537,6 +537,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippStri
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 	const char* cString = val.c_str();
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setString( instance_, &it->second, 1, &cString );
 	} else {
 		fmippString ret = name + fmippString( " does not exist" );
@@ -752,6 +753,7 @@ fmippStatus FMUModelExchange::getContinuousStates( fmippReal* val )
 
 fmippStatus FMUModelExchange::setContinuousStates( const fmippReal* val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setContinuousStates( instance_, val, nStateVars_ );
 	return (fmippStatus) lastStatus_;
 }
@@ -759,6 +761,7 @@ fmippStatus FMUModelExchange::setContinuousStates( const fmippReal* val )
 fmippStatus FMUModelExchange::getDerivatives( fmippReal* val )
 {
 	lastStatus_ = fmu_->functions->getDerivatives( instance_, val, nStateVars_ );
+	if ( statistics_ ) ++statistics_->derivativeEvaluations;
 	return (fmippStatus) lastStatus_;
 }
 
@@ -787,6 +790,9 @@ fmippReal FMUModelExchange::integrate( fmippTime tstop, unsigned int nsteps )
 
 fmippReal FMUModelExchange::integrate( fmippTime tend, fmippTime deltaT )
 {
+	Integrator::Statistics::Timer timer( statistics_ ? &statistics_->integrateTime : 0 );
+	if ( statistics_ ) ++statistics_->integrateCalls;
+
 	// If there are no continuous states, skip integration.
 	if ( nStateVars_ == 0 ){
 
@@ -847,6 +853,13 @@ fmippReal FMUModelExchange::integrate( fmippTime tend, fmippTime deltaT )
 	// Update the event flags.
 	stateEvent_= eventInfo.stateEvent;
 
+	// Count the event that stopped the integration.
+	if ( statistics_ ){
+		if ( eventInfo.stepEvent ) ++statistics_->stepEvents;
+		else if ( stateEvent_ ) ++statistics_->stateEvents;
+		else if ( timeEvent_ ) ++statistics_->timeEvents;
+	}
+
 	// \TODO: respond to terminateSimulation == true
 	if ( eventInfo.stepEvent )
 		// Make event iterations.
@@ -886,6 +899,8 @@ fmippBoolean FMUModelExchange::stepOverEvent()
 	if ( !stateEvent_ && !timeEvent_ )
 		return false;
 
+	Integrator::Statistics::Timer timer( statistics_ ? &statistics_->stepOverEventTime : 0 );
+
 	getContinuousStates( intStates_ );
 	getDerivatives( intDerivatives_ );
 
@@ -955,8 +970,13 @@ fmippStatus FMUModelExchange::resetEventIndicators()
 void FMUModelExchange::handleEvents()
 {
 	eventinfo_->iterationConverged = fmiFalse;
-	while ( fmiFalse == eventinfo_->iterationConverged )
+	while ( fmiFalse == eventinfo_->iterationConverged ) {
 		fmu_->functions->eventUpdate( instance_, fmiTrue, eventinfo_ );
+		if ( statistics_ ) ++statistics_->eventIterations;
+	}
+
+	// The discrete states may have changed, the stepper cannot continue its last step.
+	integrator_->reset();
 }
 
 fmippStatus FMUModelExchange::completedIntegratorStep()
@@ -66,7 +66,9 @@ FMUModelExchange::FMUModelExchange( const fmippString& fmuDirUri,
 		raisedEvent_( fmippFalse ),
 		eventFlag_( fmippFalse ),
 		intEventFlag_( fmippFalse ),
-		lastStatus_( fmi2OK )
+		lastStatus_( fmi2OK ),
+		constantJacobian_( fmippFalse ),
+		jacobianEvaluations_( 0 )
 {
 	// Get the model manager.
 	ModelManager& manager = ModelManager::getModelManager();
@@ -153,7 +155,9 @@ FMUModelExchange::FMUModelExchange( const fmippString& modelIdentifier,
 		raisedEvent_( fmippFalse ),
 		eventFlag_( fmippFalse ),
 		intEventFlag_( fmippFalse ),
-		lastStatus_( fmi2OK )
+		lastStatus_( fmi2OK ),
+		constantJacobian_( fmippFalse ),
+		jacobianEvaluations_( 0 )
 {
 	// Get the model manager.
 	ModelManager& manager = ModelManager::getModelManager();
@@ -211,7 +215,9 @@ FMUModelExchange::FMUModelExchange( const FMUModelExchange& fmu ) :
 		raisedEvent_( fmippFalse ),
 		eventFlag_( fmippFalse ),
 		intEventFlag_( fmippFalse ),
-		lastStatus_( fmi2OK )
+		lastStatus_( fmi2OK ),
+		constantJacobian_( fmippFalse ),
+		jacobianEvaluations_( 0 )
 {
 	if ( 0 != fmu_ ){
 		if ( 0 != nStateVars_ ) {
@@ -220,6 +226,17 @@ FMUModelExchange::FMUModelExchange( const FMUModelExchange& fmu ) :
 			// create the stepper
 			integrator_->setType( fmu.integrator_->getProperties().type );
 		}
+		numericalJacobian_->setMethod( fmu.numericalJacobian_->getMethod() );
+		numericalJacobian_->setSparsity( fmu.numericalJacobian_->getSparsity() );
+
+		jacobianColoring_ = fmu.jacobianColoring_;
+		constantJacobian_ = fmu.constantJacobian_;
+		jacobianKnowns_.reserve( nStateVars_ );
+		jacobianUnknowns_.reserve( nStateVars_ );
+		jacobianRows_.reserve( nStateVars_ );
+		jacobianRowPositions_ = fmu.jacobianRowPositions_;
+		jacobianSeeds_ = fmu.jacobianSeeds_;
+		jacobianValues_.resize( fmu.jacobianValues_.size() );
 	}
 }
 
@@ -245,6 +262,9 @@ FMUModelExchange::~FMUModelExchange()
 		fmu_->functions->freeInstance( instance_ );
 #endif
 	}
+
+	// Let the model manager unload the FMU if it is not used anymore.
+	ModelManager::releaseFMU( fmu_ );
 }
 
 void FMUModelExchange::readModelDescription()
@@ -253,7 +273,6 @@ void FMUModelExchange::readModelDescription()
 	assert(states_refs_ == NULL); // Will be initialized
 
 	using namespace ModelDescriptionUtilities;
-	typedef ModelDescription::Properties Properties;
 
 	const ModelDescription* description = fmu_->description;
 
@@ -261,10 +280,8 @@ void FMUModelExchange::readModelDescription()
 	nEventInds_       = description->getNumberOfEventIndicators();
 	providesJacobian_ = description->providesJacobian();
 
-	const Properties& modelVariables = description->getModelVariables();
-
-	Properties::const_iterator itVar = modelVariables.begin();
-	Properties::const_iterator itEnd = modelVariables.end();
+	typedef ModelDescription::ScalarVariables ScalarVariables;
+	const ScalarVariables& variables = description->getScalarVariables();
 
 	// List of all variable names -> check if names are unique.
 	set<fmippString> allVariableNames;
@@ -274,12 +291,10 @@ void FMUModelExchange::readModelDescription()
 	set<fmippValueReference> allVariableValRefs;
 	pair< set<fmippValueReference>::iterator, fmippBoolean > varValRefsInsert;
 
-	for ( ; itVar != itEnd; ++itVar )
+	for ( ScalarVariables::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar )
 	{
-		const Properties& varAttributes = getAttributes( itVar );
-
-		fmippString varName = varAttributes.get<fmippString>( "name" );
-		fmippValueReference varValRef = varAttributes.get<fmippValueReference>( "valueReference" );
+		const fmippString& varName = itVar->name;
+		fmippValueReference varValRef = itVar->valueReference;
 
 		varNamesInsert = allVariableNames.insert( varName );
 		if ( false == varNamesInsert.second ) { // Check if variable name is unique.
@@ -300,17 +315,7 @@ void FMUModelExchange::readModelDescription()
 		varMap_.insert( make_pair( varName, varValRef ) );
 
 		// Map name to value type.
-		if ( hasChild( itVar, "Real" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeReal ) );
-		} else if ( hasChild( itVar, "Integer" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeInteger ) );
-		} else if ( hasChild( itVar, "Boolean" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeBoolean ) );
-		} else if ( hasChild( itVar, "String" ) ) {
-			varTypeMap_.insert( make_pair( varName, fmippTypeString ) );
-		} else {
-			varTypeMap_.insert( make_pair( varName, fmippTypeUnknown ) );
-		}
+		varTypeMap_.insert( make_pair( varName, itVar->type ) );
 	}
 
 	if ( fmu_->description->hasDefaultExperiment() ){
@@ -340,6 +345,23 @@ void FMUModelExchange::readModelDescription()
 	states_refs_ = new fmippValueReference[nStateVars_];
 	if ( nStateVars_> 0 )
 		description->getStatesAndDerivativesReferences( states_refs_, derivatives_refs_ );
+
+	// use the dependencies listed in the model structure for coloring the numerical Jacobian
+	NumericalJacobian::Sparsity sparsity;
+	if ( ( nStateVars_ > 0 ) && description->getStateDependencies( sparsity ) )
+		numericalJacobian_->setSparsity( sparsity );
+
+	// ... and for assembling the Jacobian from directional derivatives
+	if ( providesJacobian_ && ( nStateVars_ > 0 ) ) {
+		jacobianColoring_.initialize( sparsity, nStateVars_ );
+		constantJacobian_ = description->hasConstantStateJacobian();
+		jacobianKnowns_.reserve( nStateVars_ );
+		jacobianUnknowns_.reserve( nStateVars_ );
+		jacobianRows_.reserve( nStateVars_ );
+		jacobianRowPositions_.assign( nStateVars_, nStateVars_ );
+		jacobianSeeds_.assign( nStateVars_, 1.0 );
+		jacobianValues_.resize( nStateVars_ );
+	}
 }
 
 FMIPPVariableType FMUModelExchange::getType( const fmippString& variableName ) const
@@ -466,6 +488,9 @@ fmippStatus FMUModelExchange::initialize( fmippBoolean toleranceDefined, double
 		static_cast<fmi2Boolean>( toleranceDefined ), static_cast<fmi2Real>( tolerance ),
 		time_, stopTimeDefined, stopTime );
 
+	// a constant Jacobian may still depend on parameters set before initialization
+	cachedJacobian_.clear();
+
 	lastStatus_ = fmu_->functions->enterInitializationMode( instance_ );
 
 	// exit initialization mode and enter discrete time mode
@@ -516,12 +541,14 @@ void FMUModelExchange::rewindTime( fmippTime deltaRewindTime )
 
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippReal& val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setReal( instance_, &valref, 1, &val );
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippInteger& val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setInteger( instance_, &valref, 1, &val );
 	return (fmippStatus) lastStatus_;
 }
@@ -529,6 +556,7 @@ fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippI
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippBoolean& val )
 {
 	fmi2Boolean val2 = (fmi2Boolean) val;
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setBoolean( instance_, &valref, 1, &val2 );
 	return (fmippStatus) lastStatus_;
 }
@@ -536,18 +564,21 @@ fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippB
 fmippStatus FMUModelExchange::setValue( fmippValueReference valref, const fmippString& val )
 {
 	fmi2String cString = val.c_str();
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setString( instance_, &valref, 1, &cString );
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippReal* val, fmippSize ival)
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setReal(instance_, valref, ival, val);
 	return (fmippStatus) lastStatus_;
 }
 
 fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippInteger* val, fmippSize ival)
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setInteger(instance_, valref, ival, val);
 	return (fmippStatus) lastStatus_;
 }
@@ -555,6 +586,7 @@ fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippI
 fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippBoolean* val, fmippSize ival)
 {
 	fmi2Boolean val2 = (fmi2Boolean) *val;
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setBoolean(instance_, valref, ival, &val2 );
 	// no need for backcasting since setter function is write-only
 	return (fmippStatus) lastStatus_;
@@ -567,6 +599,7 @@ fmippStatus FMUModelExchange::setValue(fmippValueReference* valref, const fmippS
 	for ( fmippSize i = 0; i < ival; i++ ) {
 		cStrings[i] = val[i].c_str();
 	}
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setString(instance_, valref, ival, cStrings);
 	delete [] cStrings;
 	return (fmippStatus) lastStatus_;
@@ -577,6 +610,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippReal
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setReal( instance_, &it->second, 1, &val );
 		return (fmippStatus) lastStatus_;
 
@@ -593,6 +627,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippInte
 	map<fmippString,fmippValueReference>::const_iterator it = varMap_.find( name );
 
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setInteger( instance_, &it->second, 1, &val );
 		return (fmippStatus) lastStatus_;
 	} else {
@@ -609,6 +644,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippBool
 
 	if ( it != varMap_.end() ) {
 		fmi2Boolean val2 = (fmi2Boolean) val;
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setBoolean( instance_, &it->second, 1, &val2 );
 		// no need for backcasting since setter function is write-only
 		return (fmippStatus) lastStatus_;
@@ -626,6 +662,7 @@ fmippStatus FMUModelExchange::setValue( const fmippString& name, const fmippStri
 	const char* cString = val.c_str();
 
 	if ( it != varMap_.end() ) {
+		integrator_->reset();
 		lastStatus_ = fmu_->functions->setString( instance_, &it->second, 1, &cString );
 		return (fmippStatus) lastStatus_;
 	} else {
@@ -843,6 +880,7 @@ fmippStatus FMUModelExchange::getContinuousStates( fmippReal* val )
 
 fmippStatus FMUModelExchange::setContinuousStates( const fmippReal* val )
 {
+	integrator_->reset();
 	lastStatus_ = fmu_->functions->setContinuousStates( instance_, val, nStateVars_ );
 	return (fmippStatus) lastStatus_;
 }
@@ -850,6 +888,7 @@ fmippStatus FMUModelExchange::setContinuousStates( const fmippReal* val )
 fmippStatus FMUModelExchange::getDerivatives( fmippReal* val )
 {
 	lastStatus_ = fmu_->functions->getDerivatives( instance_, val, nStateVars_ );
+	if ( statistics_ ) ++statistics_->derivativeEvaluations;
 	return (fmippStatus) lastStatus_;
 }
 
@@ -878,7 +917,6 @@ vector<fmippString> FMUModelExchange::getDerivativesNames() const
 }
 
 fmippStatus FMUModelExchange::getJac( fmippReal* J ){
-	fmippReal direction = 1.0;
 	/*
 	 * use the default behaviour defined in DynamicalSystem if getDirectionalDerivative is
 	 * not supported by the FMU
@@ -889,20 +927,51 @@ fmippStatus FMUModelExchange::getJac( fmippReal* J ){
 		return DynamicalSystem::getJac( J );
 	}
 
-	// else use getDirectionalDerivative to read the Jacobian
-	for ( unsigned int i = 0; i < nStateVars_; i++ ){
-		// get the i-th column of the jacobian
+	jacobianEvaluations_ = 0;
+
+	// reuse the Jacobian in case it is constant
+	if ( !cachedJacobian_.empty() ){
+		copy( cachedJacobian_.begin(), cachedJacobian_.end(), J );
+		return fmippOK;
+	}
+
+	// else use getDirectionalDerivative to read the Jacobian (column-wise, J[N*j+i] = df_i/dx_j)
+	fill( J, J + nStateVars_*nStateVars_, 0.0 );
+	lastStatus_ = fmi2OK;
+	for ( fmippSize c = 0; c < jacobianColoring_.nColors(); c++ ){
+		// seed all states of the same color at once, only request the derivatives depending on them
+		jacobianKnowns_.clear();
+		jacobianUnknowns_.clear();
+		jacobianRows_.clear();
+		for ( const fmippSize* j = jacobianColoring_.columnsBegin( c ); j != jacobianColoring_.columnsEnd( c ); ++j ){
+			jacobianKnowns_.push_back( states_refs_[*j] );
+			for ( const fmippSize* i = jacobianColoring_.rowsBegin( *j ); i != jacobianColoring_.rowsEnd( *j ); ++i ){
+				if ( jacobianRowPositions_[*i] != nStateVars_ ) continue;
+				jacobianRowPositions_[*i] = jacobianRows_.size();
+				jacobianRows_.push_back( *i );
+				jacobianUnknowns_.push_back( derivatives_refs_[*i] );
+			}
+		}
+
 		lastStatus_ = fmu_->functions->getDirectionalDerivative( instance_,
-									 derivatives_refs_, nStateVars_,
-									 &states_refs_[i], 1,
-									 &direction, J );
+									 &jacobianUnknowns_[0], jacobianUnknowns_.size(),
+									 &jacobianKnowns_[0], jacobianKnowns_.size(),
+									 &jacobianSeeds_[0], &jacobianValues_[0] );
+		++jacobianEvaluations_;
+
+		// every requested derivative depends on exactly one of the seeded states
+		if ( lastStatus_ == fmi2OK ){
+			for ( const fmippSize* j = jacobianColoring_.columnsBegin( c ); j != jacobianColoring_.columnsEnd( c ); ++j )
+				for ( const fmippSize* i = jacobianColoring_.rowsBegin( *j ); i != jacobianColoring_.rowsEnd( *j ); ++i )
+					J[nStateVars_*(*j) + *i] = jacobianValues_[jacobianRowPositions_[*i]];
+		}
+
+		for ( vector<fmippSize>::const_iterator i = jacobianRows_.begin(); i != jacobianRows_.end(); ++i )
+			jacobianRowPositions_[*i] = nStateVars_;
 
 		// stop calling the getDD function once it returns an exception
 		if ( lastStatus_ != fmi2OK )
 			break;
-
-		// fill bigger indices of J in the next iteration of the for loop
-		J += nStateVars_;
 	}
 
 #ifdef DYMOLA2015_WORKAROUND
@@ -912,17 +981,23 @@ fmippStatus FMUModelExchange::getJac( fmippReal* J ){
 	 * Switch the place of the inputs states_refs_ and derivatives_refs_. This bugfix is scripted in a
 	 * way, so non-Dymola FMUs also recieve a correct jacobian.
 	 */
-	if ( lastStatus_ > fmi2OK )
+	if ( lastStatus_ > fmi2OK ){
+		fmippReal direction = 1.0;
 		for ( unsigned int i = 0; i < nStateVars_; i++ ){
 			lastStatus_ = fmu_->functions->getDirectionalDerivative( instance_,
 									 &states_refs_[i], 1,
 									 derivatives_refs_, nStateVars_,
-									 &direction, J );
+									 &direction, J + nStateVars_*i );
+			++jacobianEvaluations_;
 			if ( lastStatus_ != fmi2OK )
 				break;
-			J += nStateVars_;
 		}
+	}
 #endif
+
+	if ( constantJacobian_ && ( lastStatus_ == fmi2OK ) )
+		cachedJacobian_.assign( J, J + nStateVars_*nStateVars_ );
+
 	return (fmippStatus) lastStatus_;
 }
 
@@ -951,6 +1026,9 @@ fmippTime FMUModelExchange::integrate( fmippTime tstop, unsigned int nsteps )
 
 fmippTime FMUModelExchange::integrate( fmippTime tend, fmippTime deltaT )
 {
+	Integrator::Statistics::Timer timer( statistics_ ? &statistics_->integrateTime : 0 );
+	if ( statistics_ ) ++statistics_->integrateCalls;
+
 	// if there are no continuous states, skip integration
 	if ( nStateVars_ == 0 ){
 		if ( stopBeforeEvent_ ){
@@ -1005,6 +1083,13 @@ fmippTime FMUModelExchange::integrate( fmippTime tend, fmippTime deltaT )
 	// update the event flags
 	stateEvent_ = eventInfo.stateEvent;
 
+	// count the event that stopped the integration
+	if ( statistics_ ){
+		if ( eventInfo.stepEvent ) ++statistics_->stepEvents;
+		else if ( stateEvent_ ) ++statistics_->stateEvents;
+		else if ( timeEvent_ ) ++statistics_->timeEvents;
+	}
+
 	/// \todo respond to terminateSimulation = true
 
 	if ( eventInfo.stepEvent )
@@ -1042,6 +1127,7 @@ fmippBoolean FMUModelExchange::stepOverEvent()
 {
 	if ( !stateEvent_ && !timeEvent_ )
 		return false;
+	Integrator::Statistics::Timer timer( statistics_ ? &statistics_->stepOverEventTime : 0 );
 	getContinuousStates( intStates_ );
 	getDerivatives( intDerivatives_ );
 	// make one step ftom t = time_ to t = tend_ with explicit euler
@@ -1111,12 +1197,17 @@ void FMUModelExchange::handleEvents()
 	eventinfo_->terminateSimulation = fmi2False;
 
 	// call newDiscreteStates several times if necessary
-	for ( fmippSize i = 0;
+	fmippSize i = 0;
+	for ( ;
 	      eventinfo_->newDiscreteStatesNeeded &&
 		      !eventinfo_->terminateSimulation &&
 		      i < maxEventIterations_ ;
 	      i++ )
 		fmu_->functions->newDiscreteStates( instance_, eventinfo_ );
+	if ( statistics_ ) statistics_->eventIterations += i;
+
+	// The discrete states may have changed, the stepper cannot continue its last step.
+	integrator_->reset();
 
 	/// \todo respond to eventInfo_->terminateSimulation = true
 
@@ -1260,4 +1351,64 @@ FMUModelExchange::sendDebugMessage( const fmippString& msg ) const
 	logger( fmi2OK, "DEBUG", msg );
 }
 
+fmippBoolean
+FMUModelExchange::canGetAndSetFMUstate() const
+{
+	using namespace ModelDescriptionUtilities;
+
+	// Capability flags are optional, the default is false.
+	const ModelDescription* description = getModelDescription();
+	if ( ( 0 == description ) || ( false == description->hasModelExchange() ) ) return false;
+
+	const Properties& attributes = getAttributes( description->getModelExchange() );
+	return attributes.get<fmippBoolean>( "canGetAndSetFMUstate", false );
+}
+
+fmippStatus FMUModelExchange::getFMUState( fmi2FMUstate* fmuState )
+{
+	if ( ( 0 == instance_ ) || ( 0 == fmu_->functions->getFMUstate ) ) {
+		logger( fmi2Error, "ERROR", "getting the FMU state is not available" );
+		lastStatus_ = fmi2Error;
+		return (fmippStatus) lastStatus_;
+	}
+
+	lastStatus_ = fmu_->functions->getFMUstate( instance_, fmuState );
+	return (fmippStatus) lastStatus_;
+}
+
+fmippStatus FMUModelExchange::setFMUState( fmi2FMUstate fmuState )
+{
+	if ( ( 0 == instance_ ) || ( 0 == fmu_->functions->setFMUstate ) ) {
+		logger( fmi2Error, "ERROR", "setting the FMU state is not available" );
+		lastStatus_ = fmi2Error;
+		return (fmippStatus) lastStatus_;
+	}
+
+	integrator_->reset();
+	lastStatus_ = fmu_->functions->setFMUstate( instance_, fmuState );
+
+	// The saved event indicators refer to the state before.
+	if ( fmi2Warning >= lastStatus_ ) saveEventIndicators();
+
+	return (fmippStatus) lastStatus_;
+}
+
+void FMUModelExchange::setEventInfo( const fmi2EventInfo& eventInfo )
+{
+	if ( 0 == eventinfo_ ) return;
+	*eventinfo_ = eventInfo;
+	checkTimeEvent();
+}
+
+fmippStatus FMUModelExchange::freeFMUState( fmi2FMUstate* fmuState )
+{
+	if ( ( 0 == instance_ ) || ( 0 == fmu_->functions->freeFMUstate ) ) {
+		lastStatus_ = fmi2Error;
+		return (fmippStatus) lastStatus_;
+	}
+
+	lastStatus_ = fmu_->functions->freeFMUstate( instance_, fmuState );
+	return (fmippStatus) lastStatus_;
+}
+
 } // namespace fmi_2_0
@@ -8,11 +8,17 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
 
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/foreach.hpp>
 
 #include "import/base/include/ModelDescription.h"
+#include "import/base/include/ModelDescriptionReader.h"
 #include "import/base/include/PathFromUrl.h"
 
 using namespace std;
@@ -22,54 +28,92 @@ using namespace ModelDescriptionUtilities;
 // Implementation of class ModelDescription.
 // 
 
-ModelDescription::ModelDescription( const fmippString& xmlDescriptionFilePath )
-{
-	try {
-		using namespace boost::property_tree::xml_parser;
-		read_xml( xmlDescriptionFilePath, data_, trim_whitespace | no_comments );
-	} catch( ... ) {
-		isValid_ = fmippFalse;
-		return;
-	}
+namespace {
 
-	try {
-		// Sanity check.
-		isValid_ = hasChild( data_, "fmiModelDescription" );
-	} catch ( ... ) {
-		isValid_ = fmippFalse;
-		return;
-	}
+	// Flag indicating if the binary cache is enabled (atomic, model descriptions may be parsed concurrently).
+	std::atomic<fmippBoolean> binaryCacheEnabled( fmippTrue );
 
-	detectFMUType();
 }
 
-ModelDescription::ModelDescription( const fmippString& modelDescriptionURL, fmippBoolean& isValid )
+
+ModelDescription::ModelDescription( const fmippString& xmlDescriptionFilePath ) :
+	isValid_( fmippFalse ),
+	fmuType_( invalid )
+{
+	read( xmlDescriptionFilePath );
+}
+
+ModelDescription::ModelDescription( const fmippString& modelDescriptionURL, fmippBoolean& isValid ) :
+	isValid_( fmippFalse ),
+	fmuType_( invalid )
 {
 	isValid = fmippFalse;
 	fmippString xmlDescriptionFilePath;
-	isValid_ = PathFromUrl::getPathFromUrl( modelDescriptionURL, xmlDescriptionFilePath );
-	if ( !isValid_ )
+	if ( !PathFromUrl::getPathFromUrl( modelDescriptionURL, xmlDescriptionFilePath ) )
 		return;
 
-	try {
-		using namespace boost::property_tree::xml_parser;
-		read_xml( xmlDescriptionFilePath, data_, trim_whitespace | no_comments );
-	} catch( ... ) {
-		isValid_ = fmippFalse;
-		return;
-	}
+	read( xmlDescriptionFilePath );
+	
+	isValid = isValid_;
+}
+
+
+// Read the model description from the binary cache or parse the XML file.
+void
+ModelDescription::read( const fmippString& xmlDescriptionFilePath )
+{
+	using namespace ModelDescriptionReader;
+
+	xmlDescriptionFilePath_ = xmlDescriptionFilePath;
+
+	ifstream xmlFile( xmlDescriptionFilePath.c_str(), ios::in | ios::binary );
+	if ( !xmlFile ) return;
+	const fmippString xml( ( istreambuf_iterator<char>( xmlFile ) ), istreambuf_iterator<char>() );
+	xmlFile.close();
+
+	const char* xmlBegin = xml.data();
+	const char* xmlEnd = xmlBegin + xml.size();
+	const fmippUInt64 xmlHash = computeHash( xmlBegin, xmlEnd );
+	const fmippString cacheFilePath = getCacheFilePath( xmlDescriptionFilePath );
+
+	Contents contents;
+	const fmippBoolean cached = binaryCacheEnabled && readCache( cacheFilePath, xml.size(), xmlHash, contents );
+
+	if ( false == cached ) {
+		if ( false == parseXml( xmlBegin, xmlEnd, contents ) ) return;
 
-	try {
 		// Sanity check.
-		isValid_ = hasChild( data_, "fmiModelDescription" );
-	} catch ( ... ) {
-		isValid_ = fmippFalse;
-		return;
+		if ( false == hasChild( contents.data, "fmiModelDescription" ) ) return;
+
+		// The cache is an optimization only, failing to write it (e.g., read-only directory) is not an error.
+		if ( binaryCacheEnabled ) writeCache( cacheFilePath, xml.size(), xmlHash, contents );
 	}
 
-	detectFMUType();
-	
-	isValid = isValid_;
+	swap( data_, contents.data );
+	swap( variables_, contents.variables );
+	swap( derivatives_, contents.derivatives );
+	swap( dependencies_, contents.dependencies );
+	swap( hasDependencies_, contents.hasDependencies );
+	swap( dependenciesKinds_, contents.dependenciesKinds );
+
+	isValid_ = hasChild( data_, "fmiModelDescription" );
+	if ( isValid_ ) detectFMUType();
+}
+
+
+// Enable or disable the binary cache.
+void
+ModelDescription::setBinaryCacheEnabled( fmippBoolean enabled )
+{
+	binaryCacheEnabled.store( enabled );
+}
+
+
+// Check if the binary cache is enabled.
+fmippBoolean
+ModelDescription::isBinaryCacheEnabled()
+{
+	return binaryCacheEnabled.load();
 }
 
 
@@ -159,7 +203,15 @@ ModelDescription::getVendorAnnotations() const
 const Properties&
 ModelDescription::getModelVariables() const
 {
-	return data_.get_child( "fmiModelDescription.ModelVariables" );
+	// The model variables are not kept by the streaming parser, hence the
+	// complete PropertyTree is built when they are requested for the first time.
+	std::lock_guard<std::mutex> lock( completeDataMutex_ );
+	if ( !completeData_ ) {
+		completeData_.reset( new Properties );
+		using namespace boost::property_tree::xml_parser;
+		read_xml( xmlDescriptionFilePath_, *completeData_, trim_whitespace | no_comments );
+	}
+	return completeData_->get_child( "fmiModelDescription.ModelVariables" );
 }
 
 
@@ -386,11 +438,7 @@ ModelDescription::getNumberOfContinuousStates() const
 
 	// in the 2.0 specification, the entry number OfContinuousStattes has been removed because of redundancy
 	// to get the number of continuous states, count the number of derivatives
-	if ( fmippFalse == hasChild( data_, "fmiModelDescription.ModelStructure.Derivatives" ) ) return 0;
-
-	const Properties& derivatives = data_.get_child("fmiModelDescription.ModelStructure.Derivatives");
-
-	return derivatives.size();
+	return derivatives_.size();
 }
 
 
@@ -408,30 +456,23 @@ void
 ModelDescription::getNumberOfVariables( fmippSize& nReal, fmippSize& nInt,
 	fmippSize& nBool, fmippSize& nString ) const
 {
-	// Define XML tags to search for.
-	const fmippString xmlRealTag( "Real" );
-	const fmippString xmlIntTag( "Integer" );
-	const fmippString xmlBoolTag( "Boolean" );
-	const fmippString xmlStringTag( "String" );
-
 	// Reset counters.
 	nReal = 0;
 	nInt = 0;
 	nBool = 0;
 	nString = 0;
 
-	const Properties& modelVariables = getModelVariables();
-
-	BOOST_FOREACH( const Properties::value_type &v, modelVariables )
+	for ( ScalarVariables::const_iterator it = variables_.begin(); it != variables_.end(); ++it )
 	{
-		if ( v.second.find( xmlRealTag ) != v.second.not_found() ) { ++nReal; continue; }
-		else if ( v.second.find( xmlIntTag ) != v.second.not_found() ) { ++nInt; continue; }
-		else if ( v.second.find( xmlBoolTag ) != v.second.not_found() ) { ++nBool; continue; }
-		else if ( v.second.find( xmlStringTag ) != v.second.not_found() ) { ++nString; continue; }
-		else {
-			fmippString error( "[ModelDescription::getNumberOfVariables] unknown type: " );
-			error += v.second.back().first;
-			throw runtime_error( error );
+		switch ( it->type ) {
+			case fmippTypeReal: ++nReal; break;
+			case fmippTypeInteger: ++nInt; break;
+			case fmippTypeBoolean: ++nBool; break;
+			case fmippTypeString: ++nString; break;
+			default:
+				fmippString error( "[ModelDescription::getNumberOfVariables] unknown type of variable: " );
+				error += it->name;
+				throw runtime_error( error );
 		}
 	}
 }
@@ -441,41 +482,78 @@ ModelDescription::getNumberOfVariables( fmippSize& nReal, fmippSize& nInt,
 void
 ModelDescription::getStatesAndDerivativesReferences( fmippValueReference* state_ref, fmippValueReference* der_ref ) const
 {
-	int i = 0;
-	const Properties& derivatives = data_.get_child( "fmiModelDescription.ModelStructure.Derivatives" );
+	// The indices refer to the list of scalar variables (starting at 1).
+	for ( fmippSize i = 0; i < derivatives_.size(); ++i )
+	{
+		const ScalarVariable& derivative = variables_.at( derivatives_[i] - 1 );
+		der_ref[i] = derivative.valueReference;
+		state_ref[i] = variables_.at( derivative.derivative - 1 ).valueReference;
+	}
+}
 
-	// get the index attribute from all derivatives
-	BOOST_FOREACH( const Properties::value_type &v, derivatives )
-		{
-			der_ref[i]= v.second.get<unsigned int>( "<xmlattr>.index" );
-			i++;
+
+// Get the dependencies of the derivatives on the states
+fmippBoolean
+ModelDescription::getStateDependencies( vector< vector<fmippSize> >& dependencies ) const
+{
+	const fmippSize nStates = derivatives_.size();
+	if ( ( 0 == nStates ) || ( hasDependencies_.end() == find( hasDependencies_.begin(), hasDependencies_.end(), 1 ) ) )
+		return false;
+
+	// Map the indices of the state variables to the indices of the states.
+	map<fmippSize, fmippSize> stateIndices;
+	for ( fmippSize i = 0; i < nStates; ++i )
+		stateIndices[variables_.at( derivatives_[i] - 1 ).derivative] = i;
+
+	dependencies.assign( nStates, vector<fmippSize>() );
+	for ( fmippSize i = 0; i < nStates; ++i )
+	{
+		vector<fmippSize>& states = dependencies[i];
+
+		if ( !hasDependencies_[i] ) {
+			// Without explicit dependencies, a derivative may depend on all states.
+			for ( fmippSize j = 0; j < nStates; ++j ) states.push_back( j );
 			continue;
 		}
-	const Properties& modelVariables = getModelVariables();
-	i = 0;
-	unsigned int j = 1;
 
-	// use the indices to get all value references. suppose the index vector is monotone
-	BOOST_FOREACH( const Properties::value_type & v, modelVariables )
-		{
-			if ( der_ref[i] == j ){
-				der_ref[i] = v.second.get<unsigned int>( "<xmlattr>.valueReference" );
-				state_ref[i] = v.second.get<unsigned int>( "Real.<xmlattr>.derivative" );
-				i++;
-				}
-			j++;
-			continue;
+		// Dependencies on other variables (e.g., inputs) do not matter here.
+		for ( vector<fmippSize>::const_iterator it = dependencies_[i].begin(); it != dependencies_[i].end(); ++it ) {
+			map<fmippSize, fmippSize>::const_iterator state = stateIndices.find( *it );
+			if ( stateIndices.end() != state ) states.push_back( state->second );
 		}
-	i = 0;
-	j = 1;
-	BOOST_FOREACH( const Properties::value_type & v, modelVariables )
-		{
-			if ( state_ref[i] == j ){
-				state_ref[i] = v.second.get<unsigned int>( "<xmlattr>.valueReference" );
-				i++;
-			}
-			j++;
+		sort( states.begin(), states.end() );
+		states.erase( unique( states.begin(), states.end() ), states.end() );
+	}
+
+	return true;
+}
+
+
+// Check if the Jacobian with respect to the states is constant
+fmippBoolean
+ModelDescription::hasConstantStateJacobian() const
+{
+	const fmippSize nStates = derivatives_.size();
+	if ( 0 == nStates ) return false;
+
+	set<fmippSize> stateVariables;
+	for ( fmippSize i = 0; i < nStates; ++i )
+		stateVariables.insert( variables_.at( derivatives_[i] - 1 ).derivative );
+
+	for ( fmippSize i = 0; i < nStates; ++i )
+	{
+		// Without explicit dependencies (and their kinds), every dependency is of kind "dependent".
+		if ( !hasDependencies_[i] ) return false;
+
+		for ( fmippSize j = 0; j < dependencies_[i].size(); ++j ) {
+			if ( 0 == stateVariables.count( dependencies_[i][j] ) ) continue;
+			if ( dependenciesKinds_[i].empty() ) return false;
+			const char kind = dependenciesKinds_[i][j];
+			if ( ( constant != kind ) && ( fixed != kind ) ) return false;
 		}
+	}
+
+	return true;
 }
 
 
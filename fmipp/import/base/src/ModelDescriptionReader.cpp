@@ -0,0 +1,699 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file ModelDescriptionReader.cpp
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined( WIN32 ) // Windows.
+#include <iterator>
+#else // Unix/Linux.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "import/base/include/ModelDescriptionReader.h"
+
+using namespace std;
+
+typedef ModelDescription::Properties Properties;
+typedef ModelDescription::ScalarVariable ScalarVariable;
+
+
+namespace {
+
+	//
+	// Streaming XML parser.
+	//
+
+	// Element of the XML document currently being parsed.
+	struct Frame
+	{
+		fmippString name;
+		Properties* node; ///< Corresponding node of the PropertyTree (0 if the element is not stored).
+		fmippBoolean storeChildren; ///< False for elements ModelVariables and ModelStructure.
+		fmippString text; ///< Text content (trimmed segments, character data is kept as is).
+	};
+
+	typedef vector< pair<fmippString, fmippString> > Attributes;
+
+	fmippBoolean isSpace( char c )
+	{
+		return ( ' ' == c ) || ( '\t' == c ) || ( '\n' == c ) || ( '\r' == c );
+	}
+
+	fmippBoolean isNameChar( char c )
+	{
+		return ( false == isSpace( c ) ) && ( '>' != c ) && ( '/' != c ) && ( '=' != c );
+	}
+
+	// Append a character given by its code point (UTF-8 encoded).
+	void appendCodePoint( fmippString& dest, unsigned long c )
+	{
+		if ( c < 0x80 ) {
+			dest += static_cast<char>( c );
+		} else if ( c < 0x800 ) {
+			dest += static_cast<char>( 0xC0 | ( c >> 6 ) );
+			dest += static_cast<char>( 0x80 | ( c & 0x3F ) );
+		} else if ( c < 0x10000 ) {
+			dest += static_cast<char>( 0xE0 | ( c >> 12 ) );
+			dest += static_cast<char>( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+			dest += static_cast<char>( 0x80 | ( c & 0x3F ) );
+		} else {
+			dest += static_cast<char>( 0xF0 | ( c >> 18 ) );
+			dest += static_cast<char>( 0x80 | ( ( c >> 12 ) & 0x3F ) );
+			dest += static_cast<char>( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+			dest += static_cast<char>( 0x80 | ( c & 0x3F ) );
+		}
+	}
+
+	// Append text, replacing entity and character references.
+	fmippBoolean appendDecoded( fmippString& dest, const char* begin, const char* end )
+	{
+		while ( begin != end )
+		{
+			const char* amp = static_cast<const char*>( memchr( begin, '&', end - begin ) );
+			if ( 0 == amp ) {
+				dest.append( begin, end );
+				return true;
+			}
+
+			dest.append( begin, amp );
+
+			const char* semicolon = static_cast<const char*>( memchr( amp, ';', end - amp ) );
+			if ( 0 == semicolon ) return false;
+
+			const fmippString entity( amp + 1, semicolon );
+			if ( "lt" == entity ) dest += '<';
+			else if ( "gt" == entity ) dest += '>';
+			else if ( "amp" == entity ) dest += '&';
+			else if ( "quot" == entity ) dest += '"';
+			else if ( "apos" == entity ) dest += '\'';
+			else if ( ( entity.size() > 1 ) && ( '#' == entity[0] ) ) {
+				const fmippBoolean hex = ( 'x' == entity[1] );
+				const char* digits = entity.c_str() + ( hex ? 2 : 1 );
+				char* digitsEnd = 0;
+				unsigned long c = strtoul( digits, &digitsEnd, hex ? 16 : 10 );
+				if ( ( digitsEnd == digits ) || ( 0 != *digitsEnd ) ) return false;
+				appendCodePoint( dest, c );
+			}
+			else return false;
+
+			begin = semicolon + 1;
+		}
+		return true;
+	}
+
+	// Remove leading and trailing whitespace and collapse sequences of whitespace (like Boost's XML parser).
+	fmippString trimWhitespace( const fmippString& text )
+	{
+		fmippString result;
+		fmippBoolean pendingSpace = false;
+		for ( fmippString::const_iterator it = text.begin(); it != text.end(); ++it ) {
+			if ( isSpace( *it ) ) {
+				pendingSpace = !result.empty();
+			} else {
+				if ( pendingSpace ) result += ' ';
+				pendingSpace = false;
+				result += *it;
+			}
+		}
+		return result;
+	}
+
+	const fmippString* findAttribute( const Attributes& attributes, const char* name )
+	{
+		for ( Attributes::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
+			if ( it->first == name ) return &it->second;
+		}
+		return 0;
+	}
+
+	fmippBoolean parseUnsigned( const fmippString* text, unsigned long& value )
+	{
+		if ( ( 0 == text ) || text->empty() ) return false;
+		char* end = 0;
+		value = strtoul( text->c_str(), &end, 10 );
+		return 0 == *end;
+	}
+
+	FMIPPVariableType getVariableType( const fmippString& elementName )
+	{
+		if ( "Real" == elementName ) return fmippTypeReal;
+		if ( "Integer" == elementName ) return fmippTypeInteger;
+		if ( "Boolean" == elementName ) return fmippTypeBoolean;
+		if ( "String" == elementName ) return fmippTypeString;
+		return fmippTypeUnknown;
+	}
+
+
+	// Get the kind of a dependency from its name (attribute dependenciesKind).
+	char getDependencyKind( const fmippString& kind )
+	{
+		if ( "constant" == kind ) return ModelDescription::constant;
+		if ( "fixed" == kind ) return ModelDescription::fixed;
+		if ( "tunable" == kind ) return ModelDescription::tunable;
+		if ( "discrete" == kind ) return ModelDescription::discrete;
+		return ModelDescription::dependent;
+	}
+
+
+	// Process the start of an element (element names of the enclosing elements are on the stack).
+	fmippBoolean startElement( const fmippString& name, const Attributes& attributes,
+		vector<Frame>& stack, ModelDescriptionReader::Contents& contents )
+	{
+		const fmippSize depth = stack.size(); // Depth of the new element (0 for the root element).
+
+		Frame frame;
+		frame.name = name;
+		frame.node = 0;
+		frame.storeChildren = false;
+
+		Properties* parent = ( 0 == depth ) ? &contents.data : ( stack.back().storeChildren ? stack.back().node : 0 );
+		if ( 0 != parent ) {
+			frame.node = &parent->push_back( make_pair( name, Properties() ) )->second;
+			if ( false == attributes.empty() ) {
+				Properties& xmlattr = frame.node->push_back( make_pair( fmippString( "<xmlattr>" ), Properties() ) )->second;
+				for ( Attributes::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
+					xmlattr.push_back( make_pair( it->first, Properties( it->second ) ) );
+				}
+			}
+			frame.storeChildren = ( 1 != depth ) || ( ( "ModelVariables" != name ) && ( "ModelStructure" != name ) );
+		}
+
+		if ( ( 2 == depth ) && ( "ModelVariables" == stack[1].name ) && ( "ScalarVariable" == name ) )
+		{
+			// New scalar variable (name and value reference are mandatory).
+			unsigned long valueReference = 0;
+			const fmippString* variableName = findAttribute( attributes, "name" );
+			if ( ( 0 == variableName ) || ( false == parseUnsigned( findAttribute( attributes, "valueReference" ), valueReference ) ) ) return false;
+
+			ScalarVariable variable;
+			variable.name = *variableName;
+			variable.valueReference = static_cast<fmippValueReference>( valueReference );
+			variable.type = fmippTypeUnknown;
+			variable.derivative = 0;
+			contents.variables.push_back( variable );
+		}
+		else if ( ( 3 == depth ) && ( "ModelVariables" == stack[1].name ) && ( "ScalarVariable" == stack[2].name ) )
+		{
+			// Type of the scalar variable.
+			ScalarVariable& variable = contents.variables.back();
+			FMIPPVariableType type = getVariableType( name );
+			if ( ( fmippTypeUnknown == variable.type ) && ( fmippTypeUnknown != type ) ) {
+				variable.type = type;
+				unsigned long derivative = 0;
+				if ( parseUnsigned( findAttribute( attributes, "derivative" ), derivative ) ) variable.derivative = derivative;
+			}
+		}
+		else if ( ( 3 == depth ) && ( "ModelStructure" == stack[1].name ) && ( "Derivatives" == stack[2].name ) )
+		{
+			unsigned long index = 0;
+			if ( false == parseUnsigned( findAttribute( attributes, "index" ), index ) ) return false;
+			contents.derivatives.push_back( index );
+
+			// Whitespace-separated list of indices (an empty list means no dependencies at all).
+			const fmippString* dependencies = findAttribute( attributes, "dependencies" );
+			contents.dependencies.push_back( vector<fmippSize>() );
+			contents.hasDependencies.push_back( 0 != dependencies );
+			if ( 0 != dependencies ) {
+				const char* pos = dependencies->c_str();
+				while ( true ) {
+					while ( isSpace( *pos ) ) ++pos;
+					if ( '\0' == *pos ) break;
+					char* next = 0;
+					const unsigned long dependency = strtoul( pos, &next, 10 );
+					if ( next == pos ) return false;
+					contents.dependencies.back().push_back( dependency );
+					pos = next;
+				}
+			}
+
+			// Whitespace-separated list of kinds (one per dependency).
+			const fmippString* kinds = findAttribute( attributes, "dependenciesKind" );
+			contents.dependenciesKinds.push_back( vector<char>() );
+			if ( 0 != kinds ) {
+				istringstream in( *kinds );
+				fmippString kind;
+				while ( in >> kind ) contents.dependenciesKinds.back().push_back( getDependencyKind( kind ) );
+				// Ignore inconsistent lists (i.e., treat all dependencies as "dependent").
+				if ( contents.dependenciesKinds.back().size() != contents.dependencies.back().size() ) contents.dependenciesKinds.back().clear();
+			}
+		}
+
+		stack.push_back( frame );
+		return true;
+	}
+
+
+	// Process the end of an element.
+	fmippBoolean endElement( const fmippString& name, vector<Frame>& stack )
+	{
+		if ( stack.empty() || ( stack.back().name != name ) ) return false;
+
+		Frame& frame = stack.back();
+		if ( ( 0 != frame.node ) && ( false == frame.text.empty() ) ) {
+			frame.node->data() = frame.text;
+		}
+
+		stack.pop_back();
+		return true;
+	}
+
+
+	// Parse a start tag (pos points behind '<'), sets pos behind the tag.
+	fmippBoolean parseStartTag( const char*& pos, const char* end,
+		vector<Frame>& stack, ModelDescriptionReader::Contents& contents )
+	{
+		const char* nameBegin = pos;
+		while ( ( pos != end ) && isNameChar( *pos ) ) ++pos;
+		if ( nameBegin == pos ) return false;
+		const fmippString name( nameBegin, pos );
+
+		Attributes attributes;
+		while ( true )
+		{
+			while ( ( pos != end ) && isSpace( *pos ) ) ++pos;
+			if ( pos == end ) return false;
+
+			if ( '>' == *pos ) {
+				++pos;
+				return startElement( name, attributes, stack, contents );
+			}
+
+			if ( '/' == *pos ) { // Empty-element tag.
+				if ( ( ++pos == end ) || ( '>' != *pos ) ) return false;
+				++pos;
+				return startElement( name, attributes, stack, contents ) && endElement( name, stack );
+			}
+
+			const char* attributeBegin = pos;
+			while ( ( pos != end ) && isNameChar( *pos ) ) ++pos;
+			if ( attributeBegin == pos ) return false;
+			const fmippString attributeName( attributeBegin, pos );
+
+			while ( ( pos != end ) && isSpace( *pos ) ) ++pos;
+			if ( ( pos == end ) || ( '=' != *pos ) ) return false;
+			++pos;
+			while ( ( pos != end ) && isSpace( *pos ) ) ++pos;
+			if ( ( pos == end ) || ( ( '"' != *pos ) && ( '\'' != *pos ) ) ) return false;
+
+			const char quote = *pos++;
+			const char* valueEnd = static_cast<const char*>( memchr( pos, quote, end - pos ) );
+			if ( 0 == valueEnd ) return false;
+
+			fmippString value;
+			if ( false == appendDecoded( value, pos, valueEnd ) ) return false;
+			attributes.push_back( make_pair( attributeName, value ) );
+			pos = valueEnd + 1;
+		}
+	}
+
+
+	// Find a string, returns the position behind it (or 0 if not found).
+	const char* skipPast( const char* pos, const char* end, const char* pattern )
+	{
+		const fmippSize length = strlen( pattern );
+		for ( ; static_cast<fmippSize>( end - pos ) >= length; ++pos ) {
+			if ( 0 == memcmp( pos, pattern, length ) ) return pos + length;
+		}
+		return 0;
+	}
+
+
+	//
+	// Binary cache.
+	//
+
+	const char cacheMagic[8] = { 'F', 'M', 'I', 'P', 'P', 'M', 'D', 'C' };
+
+	const fmippUInt32 cacheByteOrder = 0x01020304;
+
+	// Write primitive values and strings to a binary stream.
+	class CacheWriter
+	{
+	public:
+		explicit CacheWriter( ostream& out ) : out_( out ) {}
+
+		template<typename Type>
+		void put( Type value ) { out_.write( reinterpret_cast<const char*>( &value ), sizeof( Type ) ); }
+
+		void put( const fmippString& value ) {
+			put<fmippUInt32>( static_cast<fmippUInt32>( value.size() ) );
+			out_.write( value.data(), value.size() );
+		}
+
+		void put( const Properties& node ) {
+			put( node.data() );
+			put<fmippUInt32>( static_cast<fmippUInt32>( node.size() ) );
+			for ( Properties::const_iterator it = node.begin(); it != node.end(); ++it ) {
+				put( it->first );
+				put( it->second );
+			}
+		}
+
+	private:
+		ostream& out_;
+	};
+
+	// Read primitive values and strings from a memory buffer (with bounds checks).
+	class CacheReader
+	{
+	public:
+		CacheReader( const char* begin, const char* end ) : pos_( begin ), end_( end ) {}
+
+		template<typename Type>
+		fmippBoolean get( Type& value ) {
+			if ( static_cast<fmippSize>( end_ - pos_ ) < sizeof( Type ) ) return false;
+			memcpy( &value, pos_, sizeof( Type ) );
+			pos_ += sizeof( Type );
+			return true;
+		}
+
+		fmippBoolean get( fmippString& value ) {
+			fmippUInt32 size = 0;
+			if ( ( false == get( size ) ) || ( static_cast<fmippSize>( end_ - pos_ ) < size ) ) return false;
+			value.assign( pos_, size );
+			pos_ += size;
+			return true;
+		}
+
+		// Read the number of elements of a list, whose elements take at least elementSize bytes each.
+		// Fails if the remaining data cannot hold that many elements (corrupt or truncated file).
+		fmippBoolean getCount( fmippUInt32& count, fmippSize elementSize ) {
+			return get( count ) && ( count <= static_cast<fmippSize>( end_ - pos_ ) / elementSize );
+		}
+
+		fmippBoolean get( Properties& node ) {
+			fmippUInt32 nChildren = 0;
+			if ( ( false == get( node.data() ) ) || ( false == getCount( nChildren, 3 * sizeof( fmippUInt32 ) ) ) ) return false;
+			for ( fmippUInt32 i = 0; i < nChildren; ++i ) {
+				fmippString key;
+				if ( false == get( key ) ) return false;
+				Properties& child = node.push_back( make_pair( key, Properties() ) )->second;
+				if ( false == get( child ) ) return false;
+			}
+			return true;
+		}
+
+		fmippBoolean atEnd() const { return pos_ == end_; }
+
+	private:
+		const char* pos_;
+		const char* end_;
+	};
+
+	// Read-only memory mapping of a file.
+	class MappedFile
+	{
+	public:
+		explicit MappedFile( const fmippString& path ) : data_( 0 ), size_( 0 )
+		{
+#if defined( WIN32 )
+			ifstream in( path.c_str(), ios::in | ios::binary );
+			if ( !in ) return;
+			buffer_.assign( istreambuf_iterator<char>( in ), istreambuf_iterator<char>() );
+			data_ = buffer_.data();
+			size_ = buffer_.size();
+#else
+			int fd = open( path.c_str(), O_RDONLY );
+			if ( -1 == fd ) return;
+			struct stat info;
+			if ( ( 0 == fstat( fd, &info ) ) && ( info.st_size > 0 ) ) {
+				void* data = mmap( 0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+				if ( MAP_FAILED != data ) {
+					data_ = static_cast<const char*>( data );
+					size_ = info.st_size;
+				}
+			}
+			close( fd );
+#endif
+		}
+
+		~MappedFile()
+		{
+#if !defined( WIN32 )
+			if ( 0 != data_ ) munmap( const_cast<char*>( data_ ), size_ );
+#endif
+		}
+
+		const char* begin() const { return data_; }
+		const char* end() const { return data_ + size_; }
+		fmippBoolean isValid() const { return 0 != data_; }
+
+	private:
+		MappedFile( const MappedFile& ); ///< Prevent calling the copy constructor.
+		MappedFile& operator=( const MappedFile& ); ///< Prevent calling the assignment operator.
+
+		const char* data_;
+		fmippSize size_;
+#if defined( WIN32 )
+		fmippString buffer_;
+#endif
+	};
+
+}
+
+
+fmippUInt64
+ModelDescriptionReader::computeHash( const char* begin, const char* end )
+{
+	fmippUInt64 hash = 14695981039346656037ULL;
+	for ( ; begin != end; ++begin ) {
+		hash ^= static_cast<unsigned char>( *begin );
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+fmippBoolean
+ModelDescriptionReader::parseXml( const char* begin, const char* end, Contents& contents )
+{
+	vector<Frame> stack;
+	fmippBoolean hasRoot = false;
+
+	const char* pos = begin;
+	while ( pos != end )
+	{
+		const char* tag = static_cast<const char*>( memchr( pos, '<', end - pos ) );
+		if ( 0 == tag ) tag = end;
+
+		// Text content (Boost's XML parser trims each segment between tags, comments, etc. separately).
+		if ( ( tag != pos ) && ( false == stack.empty() ) && ( 0 != stack.back().node ) ) {
+			fmippString text;
+			if ( false == appendDecoded( text, pos, tag ) ) return false;
+			stack.back().text += trimWhitespace( text );
+		}
+
+		if ( tag == end ) break;
+		pos = tag + 1;
+		if ( pos == end ) return false;
+
+		if ( '/' == *pos ) { // End tag.
+			const char* nameBegin = ++pos;
+			while ( ( pos != end ) && isNameChar( *pos ) ) ++pos;
+			const fmippString name( nameBegin, pos );
+			while ( ( pos != end ) && isSpace( *pos ) ) ++pos;
+			if ( ( pos == end ) || ( '>' != *pos ) ) return false;
+			++pos;
+			if ( false == endElement( name, stack ) ) return false;
+		} else if ( '?' == *pos ) { // Processing instruction or XML declaration.
+			pos = skipPast( pos, end, "?>" );
+		} else if ( ( end - pos >= 3 ) && ( 0 == memcmp( pos, "!--", 3 ) ) ) { // Comment.
+			pos = skipPast( pos + 3, end, "-->" );
+		} else if ( ( end - pos >= 8 ) && ( 0 == memcmp( pos, "![CDATA[", 8 ) ) ) { // Character data.
+			const char* dataBegin = pos + 8;
+			pos = skipPast( dataBegin, end, "]]>" );
+			if ( ( 0 != pos ) && ( false == stack.empty() ) && ( 0 != stack.back().node ) ) {
+				stack.back().text.append( dataBegin, pos - 3 );
+			}
+		} else if ( '!' == *pos ) { // Document type declaration (possibly with internal subset).
+			int brackets = 0;
+			for ( ; pos != end; ++pos ) {
+				if ( '[' == *pos ) ++brackets;
+				else if ( ']' == *pos ) --brackets;
+				else if ( ( '>' == *pos ) && ( brackets <= 0 ) ) break;
+			}
+			if ( pos != end ) ++pos;
+		} else { // Start tag.
+			if ( stack.empty() && hasRoot ) return false; // Only a single root element is allowed.
+			hasRoot = true;
+			if ( false == parseStartTag( pos, end, stack, contents ) ) return false;
+		}
+
+		if ( 0 == pos ) return false;
+	}
+
+	return hasRoot && stack.empty();
+}
+
+
+fmippBoolean
+ModelDescriptionReader::readCache( const fmippString& cacheFilePath,
+	fmippUInt64 xmlSize, fmippUInt64 xmlHash, Contents& contents )
+{
+	MappedFile file( cacheFilePath );
+	if ( false == file.isValid() ) return false;
+
+	CacheReader reader( file.begin(), file.end() );
+
+	char magic[sizeof( cacheMagic )];
+	for ( fmippSize i = 0; i < sizeof( cacheMagic ); ++i ) {
+		if ( false == reader.get( magic[i] ) ) return false;
+	}
+	if ( 0 != memcmp( magic, cacheMagic, sizeof( cacheMagic ) ) ) return false;
+
+	fmippUInt32 version = 0;
+	fmippUInt32 byteOrder = 0;
+	fmippUInt64 size = 0;
+	fmippUInt64 hash = 0;
+	if ( ( false == reader.get( version ) ) || ( cacheVersion != version ) ||
+		( false == reader.get( byteOrder ) ) || ( cacheByteOrder != byteOrder ) ||
+		( false == reader.get( size ) ) || ( xmlSize != size ) ||
+		( false == reader.get( hash ) ) || ( xmlHash != hash ) ) return false;
+
+	Contents cached;
+	if ( false == reader.get( cached.data ) ) return false;
+
+	// All counts are checked against the remaining data before anything is allocated.
+	const fmippSize variableSize = sizeof( fmippUInt32 ) + sizeof( fmippValueReference ) + sizeof( fmippUInt32 ) + sizeof( fmippUInt64 );
+	fmippUInt32 nVariables = 0;
+	if ( false == reader.getCount( nVariables, variableSize ) ) return false;
+	cached.variables.resize( nVariables );
+	for ( fmippUInt32 i = 0; i < nVariables; ++i ) {
+		ScalarVariable& variable = cached.variables[i];
+		fmippUInt32 type = 0;
+		fmippUInt64 derivative = 0;
+		if ( ( false == reader.get( variable.name ) ) || ( false == reader.get( variable.valueReference ) ) ||
+			( false == reader.get( type ) ) || ( false == reader.get( derivative ) ) ) return false;
+		variable.type = static_cast<FMIPPVariableType>( type );
+		variable.derivative = derivative;
+	}
+
+	// Each derivative takes its index, the dependencies flag and the two counts of its dependencies.
+	const fmippSize derivativeSize = sizeof( fmippUInt64 ) + sizeof( char ) + 2 * sizeof( fmippUInt32 );
+	fmippUInt32 nDerivatives = 0;
+	if ( false == reader.getCount( nDerivatives, derivativeSize ) ) return false;
+	cached.derivatives.resize( nDerivatives );
+	for ( fmippUInt32 i = 0; i < nDerivatives; ++i ) {
+		fmippUInt64 index = 0;
+		if ( false == reader.get( index ) ) return false;
+		cached.derivatives[i] = index;
+	}
+
+	cached.dependencies.resize( nDerivatives );
+	cached.hasDependencies.resize( nDerivatives );
+	cached.dependenciesKinds.resize( nDerivatives );
+	for ( fmippUInt32 i = 0; i < nDerivatives; ++i ) {
+		fmippUInt32 nDependencies = 0;
+		if ( ( false == reader.get( cached.hasDependencies[i] ) ) || ( false == reader.getCount( nDependencies, sizeof( fmippUInt64 ) ) ) ) return false;
+		cached.dependencies[i].resize( nDependencies );
+		for ( fmippUInt32 j = 0; j < nDependencies; ++j ) {
+			fmippUInt64 index = 0;
+			if ( false == reader.get( index ) ) return false;
+			cached.dependencies[i][j] = index;
+		}
+		fmippUInt32 nKinds = 0;
+		if ( false == reader.getCount( nKinds, sizeof( char ) ) ) return false;
+		cached.dependenciesKinds[i].resize( nKinds );
+		for ( fmippUInt32 j = 0; j < nKinds; ++j ) {
+			if ( false == reader.get( cached.dependenciesKinds[i][j] ) ) return false;
+		}
+	}
+
+	if ( false == reader.atEnd() ) return false;
+
+	swap( contents.data, cached.data );
+	swap( contents.variables, cached.variables );
+	swap( contents.derivatives, cached.derivatives );
+	swap( contents.dependencies, cached.dependencies );
+	swap( contents.hasDependencies, cached.hasDependencies );
+	swap( contents.dependenciesKinds, cached.dependenciesKinds );
+	return true;
+}
+
+
+fmippBoolean
+ModelDescriptionReader::writeCache( const fmippString& cacheFilePath,
+	fmippUInt64 xmlSize, fmippUInt64 xmlHash, const Contents& contents )
+{
+	// Write to a temporary file first, so that concurrent readers never see an incomplete cache.
+	stringstream tmpFilePath;
+	tmpFilePath << cacheFilePath << ".tmp" << chrono::steady_clock::now().time_since_epoch().count()
+		<< "_" << static_cast<const void*>( &contents );
+
+	{
+		ofstream out( tmpFilePath.str().c_str(), ios::out | ios::binary | ios::trunc );
+		if ( !out ) return false;
+
+		CacheWriter writer( out );
+		out.write( cacheMagic, sizeof( cacheMagic ) );
+		writer.put( cacheVersion );
+		writer.put( cacheByteOrder );
+		writer.put( xmlSize );
+		writer.put( xmlHash );
+		writer.put( contents.data );
+
+		writer.put<fmippUInt32>( static_cast<fmippUInt32>( contents.variables.size() ) );
+		for ( ModelDescription::ScalarVariables::const_iterator it = contents.variables.begin();
+			it != contents.variables.end(); ++it ) {
+			writer.put( it->name );
+			writer.put( it->valueReference );
+			writer.put<fmippUInt32>( it->type );
+			writer.put<fmippUInt64>( it->derivative );
+		}
+
+		writer.put<fmippUInt32>( static_cast<fmippUInt32>( contents.derivatives.size() ) );
+		for ( vector<fmippSize>::const_iterator it = contents.derivatives.begin(); it != contents.derivatives.end(); ++it ) {
+			writer.put<fmippUInt64>( *it );
+		}
+
+		for ( fmippSize i = 0; i < contents.derivatives.size(); ++i ) {
+			writer.put<char>( contents.hasDependencies[i] );
+			writer.put<fmippUInt32>( static_cast<fmippUInt32>( contents.dependencies[i].size() ) );
+			for ( vector<fmippSize>::const_iterator it = contents.dependencies[i].begin(); it != contents.dependencies[i].end(); ++it ) {
+				writer.put<fmippUInt64>( *it );
+			}
+			writer.put<fmippUInt32>( static_cast<fmippUInt32>( contents.dependenciesKinds[i].size() ) );
+			for ( vector<char>::const_iterator it = contents.dependenciesKinds[i].begin(); it != contents.dependenciesKinds[i].end(); ++it ) {
+				writer.put<char>( *it );
+			}
+		}
+
+		if ( !out ) {
+			out.close();
+			remove( tmpFilePath.str().c_str() );
+			return false;
+		}
+	}
+
+#if defined( WIN32 )
+	remove( cacheFilePath.c_str() ); // Function rename does not replace existing files on Windows.
+#endif
+
+	if ( 0 != rename( tmpFilePath.str().c_str(), cacheFilePath.c_str() ) ) {
+		remove( tmpFilePath.str().c_str() );
+		return false;
+	}
+
+	return true;
+}
+
+
+fmippString
+ModelDescriptionReader::getCacheFilePath( const fmippString& xmlDescriptionFilePath )
+{
+	return xmlDescriptionFilePath + ".fmippcache";
+}
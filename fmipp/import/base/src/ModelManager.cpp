@@ -49,8 +49,20 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <set>
 #include <utility>
+#include <vector>
+
+#if !defined(MINGW) && !defined(_MSC_VER)
+#include <unistd.h>
+#endif
 
 #include "import/base/include/ModelManager.h"
 #include "import/base/include/ModelDescription.h"
@@ -60,26 +72,164 @@ using namespace std;
 
 ModelManager* ModelManager::modelManager_ = 0;
 
+namespace {
+
+	// Serializes all modifications of the collections of the model manager.
+	mutex collectionsMutex;
+
+	// Serializes loading isolated copies of shared libraries.
+	mutex isolatedLoadMutex;
+
+	// While a copy of the collections is modified, each bare FMU is referenced by the
+	// current collections and the copy, i.e., it is not in use if there are no other references.
+	const long unusedBareFMUUseCount = 2;
+
+	// Settings for automatically unloading bare FMUs (see ModelManager::setAutoUnload).
+	atomic<bool> autoUnloadEnabled( false );
+	atomic<fmippTime> autoUnloadGracePeriod( 0. );
+
+	// FMU directories currently being loaded (single-flight loading).
+	set<string> loadsInProgress;
+	mutex loadsInProgressMutex;
+	condition_variable loadFinished;
+
+	// Waits until no other thread is loading the FMU from the same directory and then
+	// marks it as being loaded for the lifetime of this object.
+	class SingleFlightLoad
+	{
+	public:
+		explicit SingleFlightLoad( const string& fmuDirUrl ) : fmuDirUrl_( fmuDirUrl )
+		{
+			unique_lock<mutex> lock( loadsInProgressMutex );
+			while ( loadsInProgress.end() != loadsInProgress.find( fmuDirUrl_ ) ) loadFinished.wait( lock );
+			loadsInProgress.insert( fmuDirUrl_ );
+		}
+
+		~SingleFlightLoad()
+		{
+			{
+				lock_guard<mutex> lock( loadsInProgressMutex );
+				loadsInProgress.erase( fmuDirUrl_ );
+			}
+			loadFinished.notify_all();
+		}
+
+	private:
+		SingleFlightLoad( const SingleFlightLoad& ); ///< Prevent calling the copy constructor.
+		SingleFlightLoad& operator=( const SingleFlightLoad& ); ///< Prevent calling the assignment operator.
+
+		const string fmuDirUrl_;
+	};
+
+	// Helper function for measuring wall-clock durations (in seconds).
+	fmippTime secondsSince( const chrono::steady_clock::time_point& start )
+	{
+		return chrono::duration<fmippTime>( chrono::steady_clock::now() - start ).count();
+	}
+
+	// Helper function for retrieving the size of a file (0 if it cannot be opened).
+	fmippSize getFileSize( const string& path )
+	{
+		ifstream file( path.c_str(), ios::binary | ios::ate );
+		return file ? static_cast<fmippSize>( file.tellg() ) : 0;
+	}
+
+	// Helper function for unloading the released bare FMUs of a collection that are still unused
+	// and whose grace period has expired, returns the keys and FMU directories of the unloaded bare FMUs.
+	template<typename FMUCollection, typename ResidentCollection>
+	vector< pair<typename FMUCollection::key_type, string> > unloadReleased( FMUCollection& fmus,
+		ResidentCollection& residents, fmippTime gracePeriod )
+	{
+		vector< pair<typename FMUCollection::key_type, string> > unloaded;
+		for ( typename FMUCollection::iterator it = fmus.begin(); it != fmus.end(); )
+		{
+			typename ResidentCollection::iterator itResident = residents.find( it->second.get() );
+			if ( ( residents.end() == itResident ) || ( false == itResident->second.released ) ||
+				( unusedBareFMUUseCount != it->second.use_count() ) || // Used again (or looked up concurrently).
+				( secondsSince( itResident->second.releaseTime ) < gracePeriod ) ) {
+				++it;
+			} else {
+				unloaded.push_back( make_pair( it->first, itResident->second.fmuDirUrl ) );
+				residents.erase( itResident );
+				it = fmus.erase( it );
+			}
+		}
+		return unloaded;
+	}
+
+#if !defined(MINGW) && !defined(_MSC_VER)
+	// Helper function for creating a private temporary copy of a shared library.
+	fmippBoolean copySharedLibrary( const string& dllPath, string& copyPath )
+	{
+		const char* tmpDir = getenv( "TMPDIR" );
+		string fileName = dllPath.substr( dllPath.find_last_of( '/' ) + 1 );
+		string pathTemplate = string( tmpDir ? tmpDir : "/tmp" ) + "/fmipp_" + fileName + "_XXXXXX";
+
+		vector<char> buffer( pathTemplate.begin(), pathTemplate.end() );
+		buffer.push_back( '\0' );
+		int fd = mkstemp( &buffer[0] );
+		if ( -1 == fd ) return fmippFalse;
+		close( fd );
+		copyPath = &buffer[0];
+
+		ifstream src( dllPath.c_str(), ios::binary );
+		ofstream dest( copyPath.c_str(), ios::binary | ios::trunc );
+		dest << src.rdbuf();
+		dest.close();
+
+		if ( !src || !dest ) {
+			unlink( copyPath.c_str() );
+			return fmippFalse;
+		}
+		return fmippTrue;
+	}
+#endif
+
+}
+
 ModelManager::~ModelManager()
 {
 	// No clean-up required:
 	//  - bare FMUs have their own destructors.
 	//  - destructors of bare FMUs will be called (from shared_ptr) when
 	//    the destructors of the maps they are contained in are called
+	// FMUs released by objects destroyed afterwards (static destructors at exit) must not
+	// access the collections anymore, hence automatic unloading is turned off.
+	autoUnloadEnabled = false;
 }
 
 
 // Retrieve a reference to the unique ModelManager instance.
 ModelManager& ModelManager::getModelManager()
 {
-	// Singleton instance
+	// Singleton instance (initialization of static local variables is thread-safe).
 	static ModelManager modelManagerInstance;
-	if ( 0 == modelManager_ ) {
-		modelManager_ = &modelManagerInstance;
-	}
+	static once_flag initialized;
+	call_once( initialized, [] () { modelManager_ = &modelManagerInstance; } );
 	return *modelManager_;
 }
 
+// Get a snapshot of the current collections.
+shared_ptr<const ModelManager::Collections>
+ModelManager::getCollections()
+{
+	return atomic_load( &getModelManager().collections_ );
+}
+
+// Modify a copy of the current collections and publish it.
+template<typename Result, typename Modification>
+Result
+ModelManager::updateCollections( Modification modify )
+{
+	lock_guard<mutex> lock( collectionsMutex );
+
+	shared_ptr<Collections> updated = make_shared<Collections>( *getCollections() );
+	Result result = modify( *updated );
+	atomic_store( &getModelManager().collections_, shared_ptr<const Collections>( updated ) );
+
+	return result;
+}
+
 // Load an unzipped FMU into the model manager. It is assumed that the FMU has been unzipped into
 // a single directory and that the unzipped content follows the standard naming conventions.
 ModelManager::LoadFMUStatus
@@ -88,10 +238,11 @@ ModelManager::loadFMU( const std::string& modelIdentifier,
 	const fmippBoolean loggingOn,
 	FMUType& type )
 {
-	if ( 0 == modelManager_ ) getModelManager();
-
 	type = invalid;
 
+	// Unload released FMUs whose grace period has expired.
+	if ( autoUnloadEnabled ) collectUnusedFMUs();
+
 	//	
 	// Check if FMU has already been loaded.
 	//
@@ -99,14 +250,22 @@ ModelManager::loadFMU( const std::string& modelIdentifier,
 	LoadFMUStatus status = getTypeOfLoadedFMU( modelIdentifier, &type );
 	if ( success == status ) return duplicate;
 
+	// Concurrent calls for the same FMU wait here until the first one has loaded it.
+	SingleFlightLoad singleFlight( fmuDirUrl );
+
+	status = getTypeOfLoadedFMU( modelIdentifier, &type );
+	if ( success == status ) return duplicate;
+
 	//
 	// Load new FMU.
 	// 
 
 	// Parse XML model description.
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
 	std::unique_ptr<ModelDescription> description;
 	status = loadModelDescription( fmuDirUrl, description );
 	if ( success != status ) return status;
+	fmippTime parseTime = secondsSince( start );
 
 	// Sanity check for model identifier.
 	if ( !description->hasModelIdentifier( modelIdentifier ) ) {
@@ -117,20 +276,25 @@ ModelManager::loadFMU( const std::string& modelIdentifier,
 	type = description->getFMUType();
 
 	// Load DLLs and BareFMU
-	status = loadBareFMU(std::move(description), fmuDirUrl, modelIdentifier);
-	return status;
+	return loadBareFMU(std::move(description), fmuDirUrl, modelIdentifier, parseTime);
 }	
 
 ModelManager::LoadFMUStatus
 ModelManager::loadFMU(const std::string& fmuDirUrl,
 	const fmippBoolean loggingOn, FMUType& type, std::string& modelIdentifier)
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	// Unload released FMUs whose grace period has expired.
+	if ( autoUnloadEnabled ) collectUnusedFMUs();
+
+	// Concurrent calls for the same FMU wait here until the first one has loaded it.
+	SingleFlightLoad singleFlight( fmuDirUrl );
 
 	// Parse XML model description.
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
 	std::unique_ptr<ModelDescription> description;
 	LoadFMUStatus status = loadModelDescription( fmuDirUrl, description );
 	if ( success != status ) return status;
+	fmippTime parseTime = secondsSince( start );
 
 	// Always take the first model identifier
 	assert(description->getModelIdentifier().size() > 0);
@@ -144,52 +308,80 @@ ModelManager::loadFMU(const std::string& fmuDirUrl,
 	if ( status == success ) return duplicate;
 
 	// Load DLLs and BareFMU
-	status = loadBareFMU(std::move(description), fmuDirUrl, modelIdentifier);
-	return status;
+	return loadBareFMU(std::move(description), fmuDirUrl, modelIdentifier, parseTime);
 }
 
 // Unload an FMU from the model manager. It must not be in use. 
 ModelManager::UnloadFMUStatus
 ModelManager::unloadFMU( const std::string& modelIdentifier )
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	return updateCollections<UnloadFMUStatus>( [&modelIdentifier] ( Collections& collections ) -> UnloadFMUStatus {
+		ModelManager::UnloadFMUStatus status;
+
+		// Remove the isolated copies of the FMU first (if not in use).
+		IsolatedInstanceCollection& isolated = collections.isolatedCollection;
+		for ( IsolatedInstanceCollection::iterator it = isolated.begin(); it != isolated.end(); ) {
+			if ( it->first.first != modelIdentifier ) { ++it; continue; }
+			if ( unusedBareFMUUseCount != it->second.use_count() ) {
+				pruneResidentInfos( collections );
+				return ModelManager::in_use;
+			}
+			it = isolated.erase( it );
+		}
 
-	ModelManager::UnloadFMUStatus status;
+		status = unloadFMU( modelIdentifier, collections.modelCollection );
+		if ( ModelManager::not_found == status ) {
+			status = unloadFMU( modelIdentifier, collections.slaveCollection );
+		}
+		if ( ModelManager::not_found == status ) {
+			status = unloadFMU( modelIdentifier, collections.instanceCollection );
+		}
 
-	status = unloadFMU( modelIdentifier, modelManager_->modelCollection_ );
-	if ( ModelManager::not_found != status ) return status;
+		if ( ModelManager::ok == status ) collections.loadTimingsCollection.erase( modelIdentifier );
 
-	status = unloadFMU( modelIdentifier, modelManager_->slaveCollection_ );
-	if ( ModelManager::not_found != status ) return status;
+		// Forget models that have been unloaded automatically.
+		if ( ( ModelManager::not_found == status ) && collections.unloadedCollection.erase( modelIdentifier ) ) {
+			status = ModelManager::ok;
+		}
 
-	status = unloadFMU( modelIdentifier, modelManager_->instanceCollection_ );
-	return status;
+		pruneResidentInfos( collections );
+		return status;
+	} );
 }
 
 // Removes all FMU instances
 ModelManager::UnloadFMUStatus
 ModelManager::unloadAllFMUs()
 {
-	if ( 0 == modelManager_ ) getModelManager();
-
-	UnloadFMUStatus status = unloadAllFMUs(modelManager_->modelCollection_);
-	if ( ok != status ) return status;
-
-	status = unloadAllFMUs(modelManager_->slaveCollection_);
-	if ( ok != status ) return status;
+	return updateCollections<UnloadFMUStatus>( [] ( Collections& collections ) -> UnloadFMUStatus {
+		IsolatedInstanceCollection& isolated = collections.isolatedCollection;
+		for ( IsolatedInstanceCollection::iterator it = isolated.begin(); it != isolated.end(); ) {
+			if ( unusedBareFMUUseCount != it->second.use_count() ) break;
+			it = isolated.erase( it );
+		}
 
-	status = unloadAllFMUs(modelManager_->instanceCollection_);
-	return status;
+		UnloadFMUStatus status = isolated.empty() ? unloadAllFMUs(collections.modelCollection) : in_use;
+		if ( ok == status ) status = unloadAllFMUs(collections.slaveCollection);
+		if ( ok == status ) status = unloadAllFMUs(collections.instanceCollection);
+		if ( ok == status ) collections.loadTimingsCollection.clear();
+		if ( ok == status ) collections.unloadedCollection.clear();
+		pruneResidentInfos( collections );
+		return status;
+	} );
 }
 
 // Get model (FMI ME 1.0).
 BareFMUModelExchangePtr
 ModelManager::getModel( const std::string& modelIdentifier )
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	shared_ptr<const Collections> collections = getCollections();
 
-	BareModelCollection::iterator itFind = modelManager_->modelCollection_.find( modelIdentifier );
-	if ( itFind != modelManager_->modelCollection_.end() ) { // Model identifier found in list.
+	// Load the model again in case it has been unloaded automatically.
+	if ( ( collections->modelCollection.end() == collections->modelCollection.find( modelIdentifier ) ) &&
+		reloadFMU( modelIdentifier ) ) collections = getCollections();
+
+	BareModelCollection::const_iterator itFind = collections->modelCollection.find( modelIdentifier );
+	if ( itFind != collections->modelCollection.end() ) { // Model identifier found in list.
 		return itFind->second;
 	}
 	
@@ -200,10 +392,14 @@ ModelManager::getModel( const std::string& modelIdentifier )
 BareFMUCoSimulationPtr
 ModelManager::getSlave( const std::string& modelIdentifier )
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	shared_ptr<const Collections> collections = getCollections();
+
+	// Load the model again in case it has been unloaded automatically.
+	if ( ( collections->slaveCollection.end() == collections->slaveCollection.find( modelIdentifier ) ) &&
+		reloadFMU( modelIdentifier ) ) collections = getCollections();
 
-	BareSlaveCollection::iterator itFind = modelManager_->slaveCollection_.find( modelIdentifier );
-	if ( itFind != modelManager_->slaveCollection_.end() ) { // Model identifier found in list.
+	BareSlaveCollection::const_iterator itFind = collections->slaveCollection.find( modelIdentifier );
+	if ( itFind != collections->slaveCollection.end() ) { // Model identifier found in list.
 		return itFind->second;
 	}
 	
@@ -214,40 +410,280 @@ ModelManager::getSlave( const std::string& modelIdentifier )
 BareFMU2Ptr
 ModelManager::getInstance( const std::string& modelIdentifier )
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	shared_ptr<const Collections> collections = getCollections();
+
+	// Load the model again in case it has been unloaded automatically.
+	if ( ( collections->instanceCollection.end() == collections->instanceCollection.find( modelIdentifier ) ) &&
+		reloadFMU( modelIdentifier ) ) collections = getCollections();
 
-	BareInstanceCollection::iterator itFind = modelManager_->instanceCollection_.find( modelIdentifier );
-	if ( itFind != modelManager_->instanceCollection_.end() ) { // Model identifier found in list.
+	BareInstanceCollection::const_iterator itFind = collections->instanceCollection.find( modelIdentifier );
+	if ( itFind != collections->instanceCollection.end() ) { // Model identifier found in list.
 		return itFind->second;
 	}
 
 	return BareFMU2Ptr();
 }
 
+// Get instance (FMI ME/CS 2.0) with an isolated copy of the shared library.
+BareFMU2Ptr
+ModelManager::getIsolatedInstance( const std::string& modelIdentifier, const std::string& isolationGroup )
+{
+	const IsolatedInstanceCollection::key_type key( modelIdentifier, isolationGroup );
+
+	{
+		shared_ptr<const Collections> collections = getCollections();
+		IsolatedInstanceCollection::const_iterator itFind = collections->isolatedCollection.find( key );
+		if ( itFind != collections->isolatedCollection.end() ) { // Isolation group found in list.
+			return itFind->second;
+		}
+	}
+
+	// Only one isolated copy is loaded at a time (check again, it may have been loaded meanwhile).
+	lock_guard<mutex> lock( isolatedLoadMutex );
+	{
+		shared_ptr<const Collections> collections = getCollections();
+		IsolatedInstanceCollection::const_iterator itFind = collections->isolatedCollection.find( key );
+		if ( itFind != collections->isolatedCollection.end() ) return itFind->second;
+	}
+
+	// The FMU has to be loaded before (in shared mode).
+	BareFMU2Ptr sharedFMU = getInstance( modelIdentifier );
+	if ( !sharedFMU ) return BareFMU2Ptr();
+
+	// The bare FMU owns its model description, hence it has to be parsed again.
+	std::unique_ptr<ModelDescription> description;
+	if ( success != loadModelDescription( sharedFMU->fmuLocation, description ) ) return BareFMU2Ptr();
+
+	string dllPath;
+	string dllUrl = sharedFMU->fmuLocation + "/binaries/" + FMU_BIN_DIR + "/" + modelIdentifier + FMU_BIN_EXT;
+	if ( false == PathFromUrl::getPathFromUrl( dllUrl, dllPath ) ) return BareFMU2Ptr();
+
+	BareFMU2Ptr bareFMU = make_shared<BareFMU2>();
+	bareFMU->description = description.release();
+	bareFMU->fmuLocation = sharedFMU->fmuLocation;
+	bareFMU->fmuResourceLocation = sharedFMU->fmuResourceLocation;
+	bareFMU->variableIndex = atomic_load( &sharedFMU->variableIndex );
+
+	if ( 0 == loadDll( dllPath, bareFMU, fmippTrue ) ) return BareFMU2Ptr();
+
+	const ResidentInfo resident = getResidentInfo( dllPath, sharedFMU->fmuLocation );
+	return updateCollections<BareFMU2Ptr>( [&key, &bareFMU, &resident] ( Collections& collections ) {
+		collections.isolatedCollection[key] = bareFMU;
+		collections.residentCollection[bareFMU.get()] = resident;
+		return bareFMU;
+	} );
+}
+
+fmippBoolean
+ModelManager::getLoadTimings( const std::string& modelIdentifier, LoadTimings& timings )
+{
+	shared_ptr<const Collections> collections = getCollections();
+
+	LoadTimingsCollection::const_iterator itFind = collections->loadTimingsCollection.find( modelIdentifier );
+	if ( itFind != collections->loadTimingsCollection.end() ) { // Model identifier found in list.
+		timings = itFind->second;
+		return fmippTrue;
+	}
+
+	return fmippFalse;
+}
+
+void
+ModelManager::setAutoUnload( fmippBoolean enabled, fmippTime gracePeriod )
+{
+	autoUnloadGracePeriod = gracePeriod;
+	autoUnloadEnabled = enabled;
+}
+
+void
+ModelManager::releaseFMU( BareFMUModelExchangePtr& bareFMU )
+{
+	releaseBareFMU( bareFMU );
+}
+
+void
+ModelManager::releaseFMU( BareFMUCoSimulationPtr& bareFMU )
+{
+	releaseBareFMU( bareFMU );
+}
+
+void
+ModelManager::releaseFMU( BareFMU2Ptr& bareFMU )
+{
+	releaseBareFMU( bareFMU );
+}
+
+// Release a bare FMU. It is marked as released and unloaded as soon as it is unused and its
+// grace period has expired. In case it is still (or again) in use, the mark is refreshed by its
+// next release.
+template<typename BareFMUPtrType>
+void
+ModelManager::releaseBareFMU( BareFMUPtrType& bareFMU )
+{
+	if ( !bareFMU ) return;
+
+	const void* released = bareFMU.get();
+	bareFMU.reset();
+
+	if ( false == autoUnloadEnabled ) return;
+
+	updateCollections<fmippSize>( [released] ( Collections& collections ) -> fmippSize {
+		ResidentCollection::iterator itFind = collections.residentCollection.find( released );
+		if ( itFind != collections.residentCollection.end() ) { // The grace period starts with the last release.
+			itFind->second.released = fmippTrue;
+			itFind->second.releaseTime = chrono::steady_clock::now();
+		}
+		return unloadReleasedFMUs( collections );
+	} );
+}
+
+fmippSize
+ModelManager::collectUnusedFMUs()
+{
+	// Check the snapshot first to avoid copying the collections if nothing has been released.
+	shared_ptr<const Collections> collections = getCollections();
+	ResidentCollection::const_iterator it = collections->residentCollection.begin();
+	while ( ( it != collections->residentCollection.end() ) && ( false == it->second.released ) ) ++it;
+	if ( it == collections->residentCollection.end() ) return 0;
+	collections.reset();
+
+	return updateCollections<fmippSize>( [] ( Collections& collections ) -> fmippSize {
+		return unloadReleasedFMUs( collections );
+	} );
+}
+
+fmippSize
+ModelManager::unloadReleasedFMUs( Collections& collections )
+{
+	const fmippTime gracePeriod = autoUnloadGracePeriod;
+	ResidentCollection& residents = collections.residentCollection;
+
+	typedef vector< pair<string, string> > UnloadedModels;
+	UnloadedModels unloaded = unloadReleased( collections.modelCollection, residents, gracePeriod );
+	UnloadedModels unloadedSlaves = unloadReleased( collections.slaveCollection, residents, gracePeriod );
+	UnloadedModels unloadedInstances = unloadReleased( collections.instanceCollection, residents, gracePeriod );
+	unloaded.insert( unloaded.end(), unloadedSlaves.begin(), unloadedSlaves.end() );
+	unloaded.insert( unloaded.end(), unloadedInstances.begin(), unloadedInstances.end() );
+
+	// Remember the FMU directories, so that the models can be loaded again on demand.
+	for ( UnloadedModels::const_iterator it = unloaded.begin(); it != unloaded.end(); ++it ) {
+		collections.loadTimingsCollection.erase( it->first );
+		collections.unloadedCollection[it->first] = it->second;
+	}
+
+	fmippSize count = unloaded.size() + unloadReleased( collections.isolatedCollection, residents, gracePeriod ).size();
+	collections.unloadedCount += count;
+	return count;
+}
+
+fmippBoolean
+ModelManager::reloadFMU( const std::string& modelIdentifier )
+{
+	string fmuDirUrl;
+	{
+		shared_ptr<const Collections> collections = getCollections();
+		UnloadedCollection::const_iterator itFind = collections->unloadedCollection.find( modelIdentifier );
+		if ( itFind == collections->unloadedCollection.end() ) return fmippFalse;
+		fmuDirUrl = itFind->second;
+	}
+
+	FMUType type;
+	LoadFMUStatus status = loadFMU( modelIdentifier, fmuDirUrl, fmippFalse, type );
+	return ( success == status ) || ( duplicate == status );
+}
+
+void
+ModelManager::pruneResidentInfos( Collections& collections )
+{
+	set<const void*> loaded;
+	for ( BareModelCollection::const_iterator it = collections.modelCollection.begin(); it != collections.modelCollection.end(); ++it ) loaded.insert( it->second.get() );
+	for ( BareSlaveCollection::const_iterator it = collections.slaveCollection.begin(); it != collections.slaveCollection.end(); ++it ) loaded.insert( it->second.get() );
+	for ( BareInstanceCollection::const_iterator it = collections.instanceCollection.begin(); it != collections.instanceCollection.end(); ++it ) loaded.insert( it->second.get() );
+	for ( IsolatedInstanceCollection::const_iterator it = collections.isolatedCollection.begin(); it != collections.isolatedCollection.end(); ++it ) loaded.insert( it->second.get() );
+
+	ResidentCollection& residents = collections.residentCollection;
+	for ( ResidentCollection::iterator it = residents.begin(); it != residents.end(); ) {
+		if ( loaded.end() == loaded.find( it->first ) ) it = residents.erase( it );
+		else ++it;
+	}
+}
+
+ModelManager::ResidentInfo
+ModelManager::getResidentInfo( const std::string& dllPath, const std::string& fmuDirUrl )
+{
+	ResidentInfo resident;
+	resident.fmuDirUrl = fmuDirUrl;
+	resident.sharedLibraryBytes = getFileSize( dllPath );
+	resident.descriptionBytes = 0;
+	resident.released = fmippFalse;
+
+	string xmlFilePath;
+	if ( PathFromUrl::getPathFromUrl( fmuDirUrl + "/modelDescription.xml", xmlFilePath ) ) {
+		resident.descriptionBytes = getFileSize( xmlFilePath );
+	}
+	return resident;
+}
+
+ModelManager::ResidentStatistics
+ModelManager::getResidentStatistics()
+{
+	shared_ptr<const Collections> collections = getCollections();
+
+	ResidentStatistics statistics;
+	statistics.residentModels = collections->modelCollection.size() +
+		collections->slaveCollection.size() + collections->instanceCollection.size();
+	statistics.isolatedCopies = collections->isolatedCollection.size();
+	statistics.unusedModels = 0;
+	statistics.sharedLibraryBytes = 0;
+	statistics.descriptionBytes = 0;
+	statistics.unloadedModels = collections->unloadedCount;
+
+	// Bare FMUs are unused if they are only referenced by the (published) collections.
+	for ( BareModelCollection::const_iterator it = collections->modelCollection.begin(); it != collections->modelCollection.end(); ++it ) {
+		if ( 1 == it->second.use_count() ) ++statistics.unusedModels;
+	}
+	for ( BareSlaveCollection::const_iterator it = collections->slaveCollection.begin(); it != collections->slaveCollection.end(); ++it ) {
+		if ( 1 == it->second.use_count() ) ++statistics.unusedModels;
+	}
+	for ( BareInstanceCollection::const_iterator it = collections->instanceCollection.begin(); it != collections->instanceCollection.end(); ++it ) {
+		if ( 1 == it->second.use_count() ) ++statistics.unusedModels;
+	}
+	for ( IsolatedInstanceCollection::const_iterator it = collections->isolatedCollection.begin(); it != collections->isolatedCollection.end(); ++it ) {
+		if ( 1 == it->second.use_count() ) ++statistics.unusedModels;
+	}
+
+	for ( ResidentCollection::const_iterator it = collections->residentCollection.begin(); it != collections->residentCollection.end(); ++it ) {
+		statistics.sharedLibraryBytes += it->second.sharedLibraryBytes;
+		statistics.descriptionBytes += it->second.descriptionBytes;
+	}
+
+	return statistics;
+}
+
 ModelManager::LoadFMUStatus
 ModelManager::getTypeOfLoadedFMU( const std::string& modelIdentifier, 
 	FMUType* dest )
 {
-	if ( 0 == modelManager_ ) getModelManager();
+	shared_ptr<const Collections> collections = getCollections();
 
 	// Write the result locally, in case it is not needed
 	FMUType dummyDest;
 	if (!dest) dest = &dummyDest;
 	
-	BareModelCollection::iterator itFindModel = modelManager_->modelCollection_.find( modelIdentifier );
-	if ( itFindModel != modelManager_->modelCollection_.end() ) { // Model identifier found in list of descriptions.
+	BareModelCollection::const_iterator itFindModel = collections->modelCollection.find( modelIdentifier );
+	if ( itFindModel != collections->modelCollection.end() ) { // Model identifier found in list of descriptions.
 		*dest = itFindModel->second->description->getFMUType();
 		return success;
 	}
 
-	BareSlaveCollection::iterator itFindSlave = modelManager_->slaveCollection_.find( modelIdentifier );
-	if ( itFindSlave != modelManager_->slaveCollection_.end() ) { // Model identifier found in list of descriptions.
+	BareSlaveCollection::const_iterator itFindSlave = collections->slaveCollection.find( modelIdentifier );
+	if ( itFindSlave != collections->slaveCollection.end() ) { // Model identifier found in list of descriptions.
 		*dest = itFindSlave->second->description->getFMUType();
 		return success;
 	}
 
-	BareInstanceCollection::iterator itFindInstance = modelManager_->instanceCollection_.find( modelIdentifier );
-	if ( itFindInstance != modelManager_->instanceCollection_.end() ) { // Model identifier found in list of descriptions.	
+	BareInstanceCollection::const_iterator itFindInstance = collections->instanceCollection.find( modelIdentifier );
+	if ( itFindInstance != collections->instanceCollection.end() ) { // Model identifier found in list of descriptions.	
 		*dest = itFindInstance->second->description->getFMUType();
 		return success;
 	}
@@ -257,18 +693,29 @@ ModelManager::getTypeOfLoadedFMU( const std::string& modelIdentifier,
 ModelManager::LoadFMUStatus 
 ModelManager::loadBareFMU(
 	std::unique_ptr<ModelDescription> description,
-	const std::string& fmuDirUrl, const std::string& modelIdentifier)
+	const std::string& fmuDirUrl, const std::string& modelIdentifier,
+	fmippTime parseTime)
 {
 	assert( (bool) description );
 	assert( description->hasModelIdentifier(modelIdentifier) );
-	assert(modelManager_);
-	assert( getTypeOfLoadedFMU( modelIdentifier, NULL ) != success );
 
 	// Path to shared library (OS specific).
 	string dllPath;
 	string dllUrl = fmuDirUrl + "/binaries/" + FMU_BIN_DIR + "/" + modelIdentifier + FMU_BIN_EXT;
 	if ( false == PathFromUrl::getPathFromUrl( dllUrl, dllPath ) ) return shared_lib_invalid_uri;
 
+	LoadTimings timings;
+	timings.parseModelDescription = parseTime;
+
+	const ResidentInfo resident = getResidentInfo( dllPath, fmuDirUrl );
+
+	// The model may have been loaded meanwhile (from another directory), in this case the bare FMU is discarded.
+	auto isLoaded = [&modelIdentifier] ( const Collections& collections ) {
+		return ( collections.modelCollection.end() != collections.modelCollection.find( modelIdentifier ) ) ||
+			( collections.slaveCollection.end() != collections.slaveCollection.find( modelIdentifier ) ) ||
+			( collections.instanceCollection.end() != collections.instanceCollection.find( modelIdentifier ) );
+	};
+
 	// The type of the FMU is determined by the model description.
 	FMUType type = description->getFMUType();
 	if ( fmi_1_0_me == type ) // FMI ME 1.0
@@ -277,12 +724,19 @@ ModelManager::loadBareFMU(
 		bareFMU->description = description.release();
 
 		// Loading the DLL may fail. In this case do not add it to list of models.
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 		if ( 0 == loadDll( dllPath, bareFMU ) ) return shared_lib_load_failed;
+		timings.loadSharedLibrary = secondsSince( start );
 		
 		// Add bare FMU to list.
-		modelManager_->modelCollection_[modelIdentifier] = bareFMU;
-
-		return success;
+		return updateCollections<LoadFMUStatus>( [&] ( Collections& collections ) -> LoadFMUStatus {
+			if ( isLoaded( collections ) ) return duplicate;
+			collections.modelCollection[modelIdentifier] = bareFMU;
+			collections.loadTimingsCollection[modelIdentifier] = timings;
+			collections.residentCollection[bareFMU.get()] = resident;
+			collections.unloadedCollection.erase( modelIdentifier );
+			return success;
+		} );
 	}
 	else if ( fmi_1_0_cs == type ) // FMI CS 1.0
 	{
@@ -292,28 +746,43 @@ ModelManager::loadBareFMU(
 		bareFMU->fmuLocation = fmuDirUrl;
 
 		//Loading the DLL may fail. In this case do not add it to list of slaves.
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 		if ( 0 == loadDll( dllPath, bareFMU ) ) return shared_lib_load_failed;
+		timings.loadSharedLibrary = secondsSince( start );
 
 		// Add bare FMU to list.
-		modelManager_->slaveCollection_[modelIdentifier] = bareFMU;
-
-		return success;
+		return updateCollections<LoadFMUStatus>( [&] ( Collections& collections ) -> LoadFMUStatus {
+			if ( isLoaded( collections ) ) return duplicate;
+			collections.slaveCollection[modelIdentifier] = bareFMU;
+			collections.loadTimingsCollection[modelIdentifier] = timings;
+			collections.residentCollection[bareFMU.get()] = resident;
+			collections.unloadedCollection.erase( modelIdentifier );
+			return success;
+		} );
 	}
 	else if ( ( fmi_2_0_me == type ) || ( fmi_2_0_cs == type ) || ( fmi_2_0_me_and_cs == type ) )
 	{
 		BareFMU2Ptr bareFMU = make_shared<BareFMU2>();
 		bareFMU->description = description.release();
 
+		bareFMU->fmuLocation = fmuDirUrl;
 		bareFMU->fmuResourceLocation = fmuDirUrl + "/resources";
 
 		// Loading the DLL may Fail. In this case do not add it to list of instances.
 		// Bare FMU desctructor should take care of freeing memory.
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 		if ( 0 == loadDll( dllPath, bareFMU ) ) return shared_lib_load_failed;
+		timings.loadSharedLibrary = secondsSince( start );
 
 		// Add bare FMU to list.
-		modelManager_->instanceCollection_[modelIdentifier] = bareFMU;
-
-		return success;
+		return updateCollections<LoadFMUStatus>( [&] ( Collections& collections ) -> LoadFMUStatus {
+			if ( isLoaded( collections ) ) return duplicate;
+			collections.instanceCollection[modelIdentifier] = bareFMU;
+			collections.loadTimingsCollection[modelIdentifier] = timings;
+			collections.residentCollection[bareFMU.get()] = resident;
+			collections.unloadedCollection.erase( modelIdentifier );
+			return success;
+		} );
 	}
 	return failed;
 }
@@ -412,7 +881,7 @@ int ModelManager::loadDll( string dllPath, BareFMUCoSimulationPtr bareFMU )
 }
 
 // Helper function for loading a bare FMU shared library (FMI ME/CS Version 2.0).
-int ModelManager::loadDll( string dllPath, BareFMU2Ptr bareFMU )
+int ModelManager::loadDll( string dllPath, BareFMU2Ptr bareFMU, fmippBoolean isolated )
 {
 	using namespace fmi2;
 
@@ -421,7 +890,7 @@ int ModelManager::loadDll( string dllPath, BareFMU2Ptr bareFMU )
 
 	int s = 1;
 
-	HANDLE h = openDLL( &s, dllPath );
+	HANDLE h = isolated ? openIsolatedDLL( &s, dllPath ) : openDLL( &s, dllPath );
 	if ( !s ) return 0;
 
 	FMU2_functions* fmuFun = new FMU2_functions;
@@ -612,6 +1081,50 @@ HANDLE ModelManager::openDLL(int* status, const string& dllPath)
 	return h;
 }
 
+HANDLE ModelManager::openIsolatedDLL(int* status, const string& dllPath)
+{
+	assert( status );
+
+#if defined(MINGW) || defined(_MSC_VER)
+
+	printf( "WARNING: isolated loading is not supported on Windows, \"%s\" is loaded in shared mode\n",
+		dllPath.c_str() );
+	fflush(stdout);
+	return openDLL( status, dllPath );
+
+#else
+
+	HANDLE h = 0;
+
+#if defined(__GLIBC__)
+	// Load the library (and its dependencies) into a new linker namespace.
+	h = dlmopen( LM_ID_NEWLM, dllPath.c_str(), RTLD_LAZY | RTLD_LOCAL );
+	if ( h ) return h;
+#endif
+
+	// Load a private copy of the library instead, which the dynamic loader regards as a
+	// different library. The copy can be removed right away, it stays mapped until closed.
+	string copyPath;
+	if ( false == copySharedLibrary( dllPath, copyPath ) ) {
+		printf( "DLOPEN ERROR: Could not create private copy of \"%s\"\n", dllPath.c_str() );
+		fflush(stdout);
+		*status = 0;
+		return 0; // failure
+	}
+
+	h = dlopen( copyPath.c_str(), RTLD_LAZY | RTLD_LOCAL );
+	unlink( copyPath.c_str() );
+
+	if ( !h ) {
+		printf( "DLOPEN ERROR: Could not load private copy of \"%s\":\n%s\n", dllPath.c_str(), dlerror() );
+		fflush(stdout);
+		*status = 0;
+		return 0; // failure
+	}
+	return h;
+#endif
+}
+
 // Helper function for loading FMU shared library.
 template<typename FunctionPtrType, typename BareFMUPtrType>
 FunctionPtrType ModelManager::getAdr10( int* s, BareFMUPtrType bareFMU, 
@@ -717,8 +1230,8 @@ ModelManager::unloadFMU( const std::string& modelIdentifier,
 {
 	auto itFindFMU = fmuCollection.find( modelIdentifier );
 	if ( itFindFMU != fmuCollection.end() ) { // Model identifier found in list of descriptions.
-		if ( 1 == itFindFMU->second.use_count() ) {
-			// The bare FMU instance found in the list is unique -> can be deleted without causing problems.
+		if ( unusedBareFMUUseCount == itFindFMU->second.use_count() ) {
+			// The bare FMU instance found in the list is not referenced elsewhere -> can be deleted without causing problems.
 			fmuCollection.erase( itFindFMU );
 			return ModelManager::ok;
 		} else {
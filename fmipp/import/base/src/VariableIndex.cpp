@@ -0,0 +1,102 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file VariableIndex.cpp
+ * Lookup table for model variables (name -> value reference and type).
+ */
+
+#include "import/base/include/VariableIndex.h"
+
+using namespace std;
+
+
+VariableIndex::VariableIndex( fmippSize expectedSize ) :
+	size_( 0 )
+{
+	// Keep the load factor below 0.5.
+	fmippSize capacity = 16;
+	while ( capacity < 2 * expectedSize ) capacity *= 2;
+	entries_.resize( capacity );
+}
+
+
+fmippBoolean
+VariableIndex::insert( const fmippString& name, const VariableHandle& handle )
+{
+	if ( 2 * ( size_ + 1 ) > entries_.size() ) rehash( 2 * entries_.size() );
+
+	const fmippSize h = hash( name );
+	const fmippSize mask = entries_.size() - 1;
+
+	for ( fmippSize i = h & mask; ; i = ( i + 1 ) & mask )
+	{
+		Entry& entry = entries_[i];
+
+		if ( false == entry.used ) {
+			entry.name = name;
+			entry.handle = handle;
+			entry.hash = h;
+			entry.used = true;
+			++size_;
+			return true;
+		}
+
+		if ( ( entry.hash == h ) && ( entry.name == name ) ) return false;
+	}
+}
+
+
+const VariableHandle*
+VariableIndex::find( const fmippString& name ) const
+{
+	const fmippSize h = hash( name );
+	const fmippSize mask = entries_.size() - 1;
+
+	// The table is never full, hence the search always ends at an unused entry.
+	for ( fmippSize i = h & mask; ; i = ( i + 1 ) & mask )
+	{
+		const Entry& entry = entries_[i];
+
+		if ( false == entry.used ) return 0;
+
+		if ( ( entry.hash == h ) && ( entry.name == name ) ) return &entry.handle;
+	}
+}
+
+
+fmippSize
+VariableIndex::hash( const fmippString& name )
+{
+	fmippSize h = static_cast<fmippSize>( 14695981039346656037ULL );
+	for ( fmippString::const_iterator it = name.begin(); it != name.end(); ++it ) {
+		h ^= static_cast<unsigned char>( *it );
+		h *= static_cast<fmippSize>( 1099511628211ULL );
+	}
+	return h;
+}
+
+
+void
+VariableIndex::rehash( fmippSize capacity )
+{
+	vector<Entry> old( capacity );
+	old.swap( entries_ );
+
+	const fmippSize mask = capacity - 1;
+
+	for ( vector<Entry>::iterator itOld = old.begin(); itOld != old.end(); ++itOld )
+	{
+		if ( false == itOld->used ) continue;
+
+		fmippSize i = itOld->hash & mask;
+		while ( true == entries_[i].used ) i = ( i + 1 ) & mask;
+
+		entries_[i].name.swap( itOld->name );
+		entries_[i].handle = itOld->handle;
+		entries_[i].hash = itOld->hash;
+		entries_[i].used = true;
+	}
+}
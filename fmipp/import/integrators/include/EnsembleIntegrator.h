@@ -0,0 +1,153 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_ENSEMBLEINTEGRATOR_H
+#define _FMIPP_ENSEMBLEINTEGRATOR_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+
+#include "import/integrators/include/Integrator.h"
+
+class DynamicalSystem;
+
+
+/**
+ * \file EnsembleIntegrator.h
+ * \class EnsembleIntegrator EnsembleIntegrator.h
+ * Integrate an ensemble of identical model exchange FMUs in lockstep.
+ *
+ * All instances must have the same number of continuous states. Their states are held in one
+ * structure-of-arrays buffer (state component j of instance i is stored at index j*N+i, where N
+ * is the size of the ensemble), so that the arithmetic of the stepper (an explicit Dormand-Prince
+ * 5(4) scheme with step size control) runs in plain loops over the whole ensemble. Only the
+ * evaluations of the derivatives are done instance by instance, they are spread over a pool of
+ * worker threads.
+ *
+ * The step size is either controlled per instance (each instance advances with its own step size,
+ * a step may be rejected for some instances and accepted for others) or shared (all instances
+ * advance with the same step size, a step is accepted only if the error of every instance is
+ * within the tolerances).
+ *
+ * The instances are not integrated by their own integrators, i.e., the ensemble integrator only
+ * sets time and continuous states. If a state event or step event is detected for an instance,
+ * this instance stops at the end of the last step without event (see EventInfo) and the caller
+ * is responsible for handling the event (e.g., by calling the integrate function of the FMU).
+ */
+
+class __FMI_DLL EnsembleIntegrator
+{
+
+public:
+
+	/// Step size control.
+	enum ErrorControl {
+		perInstance, ///< Every instance has its own step size.
+		shared ///< All instances share the same step size.
+	};
+
+	/**
+	 * Constructor.
+	 *
+	 * @param[in]  instances  FMU ME instances to be integrated (with the same number of continuous states)
+	 * @param[in]  errorControl  step size control
+	 * @param[in]  nThreads  number of threads for evaluating the derivatives (0: use all hardware threads)
+	 */
+	EnsembleIntegrator( const std::vector<DynamicalSystem*>& instances,
+		ErrorControl errorControl = perInstance, fmippSize nThreads = 0 );
+
+	/// Destructor, stops the worker threads.
+	~EnsembleIntegrator();
+
+	/// Set the absolute and relative tolerances (default: 1e-6).
+	void setTolerances( fmippReal abstol, fmippReal reltol );
+
+	/**
+	 * Integrate all instances from their current time by the given step size.
+	 *
+	 * @param[in]  step_size  time span to be integrated
+	 * @param[in]  dt  initial step size for integration
+	 * @return  number of instances that stopped before the end because of an event (see getEventInfo)
+	 */
+	fmippSize integrate( fmippTime step_size, fmippTime dt );
+
+	/// Event information of an instance for the last call to integrate.
+	const Integrator::EventInfo& getEventInfo( fmippSize i ) const { return eventInfo_[i]; }
+
+	/// Number of instances.
+	fmippSize size() const { return nInstances_; }
+
+	/// Number of continuous states per instance.
+	fmippSize nStates() const { return nStates_; }
+
+	/// Number of threads used for evaluating the derivatives (including the calling thread).
+	fmippSize nThreads() const { return workers_.size() + 1; }
+
+	/// Number of accepted steps of an instance (summed over all calls to integrate).
+	fmippSize getAcceptedSteps( fmippSize i ) const { return acceptedSteps_[i]; }
+
+	/// Number of rejected steps of an instance (summed over all calls to integrate).
+	fmippSize getRejectedSteps( fmippSize i ) const { return rejectedSteps_[i]; }
+
+private:
+
+	EnsembleIntegrator( const EnsembleIntegrator& ); ///< Prevent calling the copy constructor.
+	EnsembleIntegrator& operator=( const EnsembleIntegrator& ); ///< Prevent calling the assignment operator.
+
+	/// Evaluate the derivatives of a stage for all active instances (in parallel).
+	void evaluate( fmippSize stage, const fmippReal* y, fmippReal c );
+
+	/// Evaluate the derivatives of the current stage for the share of the instances of a thread.
+	void evaluateRange( fmippSize worker );
+
+	/// Main loop of a worker thread.
+	void run( fmippSize worker );
+
+	std::vector<DynamicalSystem*> instances_; ///< The FMU instances.
+	fmippSize nInstances_;
+	fmippSize nStates_;
+	ErrorControl errorControl_;
+
+	fmippReal abstol_;
+	fmippReal reltol_;
+
+	std::vector<fmippReal> y_; ///< States at the beginning of the step (structure of arrays).
+	std::vector<fmippReal> yNew_; ///< States at the end of the step (structure of arrays).
+	std::vector<fmippReal> yStage_; ///< States for evaluating a stage (structure of arrays).
+	std::vector<fmippReal> k_; ///< Derivatives of all 7 stages (structure of arrays, one block per stage).
+	std::vector<fmippReal> errorNorm_; ///< Norm of the local error estimate of each instance.
+
+	std::vector<fmippTime> time_; ///< Current time of each instance.
+	std::vector<fmippTime> tEnd_; ///< Time each instance has to reach.
+	std::vector<fmippTime> h_; ///< Step size of each instance for the current step (0 if inactive).
+	std::vector<fmippTime> hNext_; ///< Proposed step size of each instance.
+	std::vector<char> active_; ///< Flags for instances that have not reached the end yet.
+
+	std::vector<Integrator::EventInfo> eventInfo_;
+	std::vector<fmippSize> acceptedSteps_;
+	std::vector<fmippSize> rejectedSteps_;
+
+	std::vector< std::vector<fmippReal> > scratch_; ///< Per-thread buffers for gathering states and derivatives.
+
+	// Parameters of the current evaluation (read by the worker threads).
+	fmippSize stage_;
+	const fmippReal* stageStates_;
+	fmippReal stageC_;
+
+	std::vector<std::thread> workers_;
+	std::mutex mutex_; ///< Protects generation_, pending_ and stopRequested_.
+	std::condition_variable start_;
+	std::condition_variable done_;
+	fmippSize generation_; ///< Incremented for every evaluation that is handed to the workers.
+	fmippSize pending_; ///< Number of workers still busy with the current evaluation.
+	fmippBoolean stopRequested_;
+};
+
+
+#endif // _FMIPP_ENSEMBLEINTEGRATOR_H
@@ -6,6 +6,8 @@
 #ifndef _FMIPP_INTEGRATOR_H
 #define _FMIPP_INTEGRATOR_H
 
+#include <chrono>
+#include <iosfwd>
 #include <limits>
 #include <vector>
 
@@ -92,15 +94,80 @@ public:
 	EventInfo() : stepEvent( 0 ), stateEvent( 0 ), tLower( 0 ), tUpper( 0 ){}
 	};
 
+	/**
+	 * Performance counters of an FMU ME instance (see DynamicalSystem::enableIntegratorStatistics).
+	 *
+	 * The counters are summed over all calls to integrate. Rejected steps are derived from the
+	 * number of attempts per step, which is not available for the Bulirsch-Stoer stepper (no
+	 * rejected steps are counted for it). The timers measure wall-clock time, the time spent in
+	 * stepOverEvent is included in the time spent in integrate.
+	 */
+	struct __FMI_DLL Statistics{
+		fmippSize integrateCalls;        ///< Calls to FMUModelExchange::integrate.
+		fmippSize derivativeEvaluations; ///< Evaluations of the derivatives (including those for numerical Jacobians).
+		fmippSize jacobianEvaluations;   ///< Jacobians requested by the stepper (numerical or provided by the FMU).
+		fmippSize acceptedSteps;         ///< Accepted steps of the stepper.
+		fmippSize rejectedSteps;         ///< Rejected steps of the stepper.
+		fmippSize stateEvents;           ///< Integrations stopped by a state event.
+		fmippSize stepEvents;            ///< Integrations stopped by a step event.
+		fmippSize timeEvents;            ///< Integrations stopped by a time event.
+		fmippSize eventIterations;       ///< Event iterations (calls to newDiscreteStates or eventUpdate) in handleEvents.
+		double    integrateTime;         ///< Time spent in FMUModelExchange::integrate in seconds.
+		double    stepOverEventTime;     ///< Time spent in FMUModelExchange::stepOverEvent in seconds.
+
+		Statistics() : integrateCalls( 0 ), derivativeEvaluations( 0 ), jacobianEvaluations( 0 ),
+			acceptedSteps( 0 ), rejectedSteps( 0 ), stateEvents( 0 ), stepEvents( 0 ), timeEvents( 0 ),
+			eventIterations( 0 ), integrateTime( 0 ), stepOverEventTime( 0 ){}
+
+		/// Set all counters to zero.
+		void reset() { *this = Statistics(); }
+
+		/// Adds the wall-clock time spent in a scope to a timer (nothing is measured for a null pointer).
+		class Timer{
+		public:
+			Timer( double* seconds ) : seconds_( seconds ) {
+				if ( seconds_ ) start_ = std::chrono::steady_clock::now();
+			}
+			~Timer() {
+				if ( seconds_ ) *seconds_ += std::chrono::duration<double>( std::chrono::steady_clock::now() - start_ ).count();
+			}
+		private:
+			double* seconds_;
+			std::chrono::steady_clock::time_point start_;
+		};
+	};
+
 	/// Integrate FMU ME state.
 	EventInfo integrate( fmippTime step_size, fmippTime dt, fmippTime eventSearchPrecision );
 
+	/**
+	 * Reset the stepper, because the FMU has been changed externally (inputs, continuous or discrete
+	 * states). The next integration does not continue the last step of the stepper but starts anew.
+	 * Calls during integrate (in which the stepper changes the states of the FMU itself) are ignored.
+	 */
+	void reset();
+
 	/// Clone this instance of Integrator (not a copy).
 	Integrator* clone() const;
 
 	/// return upper and lower limits for state events
 	void getEventHorizon( fmippTime& tLower, fmippTime& tUpper );
 
+	/// Check whether the stepper provides dense output (see getInterpolatedStates).
+	bool hasDenseOutput() const;
+
+	/**
+	 * Get the states at a time within the last step of the stepper (dense output).
+	 *
+	 * The states are interpolated, i.e., neither derivatives are evaluated nor are the states of the
+	 * FMU changed. Valid times are within the last step up to the time the last integration stopped.
+	 *
+	 * @param[in]  t  time within the last step
+	 * @param[out]  states  interpolated states
+	 * @return  false if the stepper has no dense output or t is not within the last step
+	 */
+	bool getInterpolatedStates( fmippTime t, fmippReal* states );
+
 	/**
 	 * create a new stepper with the specified properties
 	 *
@@ -124,6 +191,20 @@ public:
 
 private:
 
+	/**
+	 * Locate a state event within the last step using the dense output of the stepper.
+	 *
+	 * The interval [tLower, tUpper] of eventInfo_ is narrowed down to eventSearchPrecision/2 with the
+	 * Anderson-Bjoerck variant of the Illinois method (a bracketing secant method) applied to the event
+	 * indicators. The event indicators are evaluated for interpolated states, i.e., no steps have to be
+	 * re-integrated and a smooth event typically costs a few evaluations of the event indicators.
+	 * Afterwards, the FMU is set to the interpolated states at tLower.
+	 */
+	void locateEvent( fmippTime eventSearchPrecision );
+
+	/// Set the FMU to the interpolated states at time t and get the event indicators.
+	void getEventIndicators( fmippTime t, StateType& indicators );
+
 	Properties properties_;         ///< Internal copy of the stepper properties
 	EventInfo  eventInfo_;          ///< last event info returned by the stepper
 	                                ///  gets updated inside the eventSearch loop
@@ -133,7 +214,18 @@ private:
 	StateType states_;		///< Internal states. Serve as backup if an intEvent occurs.
 	fmippTime time_;			///< Internal time. Serves as backup if an intEvent occurs.
 
+	fmippTime denseOutputEnd_;      ///< Time the last integration stopped (upper limit for interpolation).
+
+	StateType indicatorsLower_;     ///< Event indicators at the lower limit of the event horizon.
+	StateType indicatorsUpper_;     ///< Event indicators at the upper limit of the event horizon.
+	StateType indicators_;          ///< Event indicators at the current estimate of the event time.
+
 	bool is_copy_;                  ///< Is this just a copy of another instance of Integrator? -> See destructor.
+	bool integrating_;              ///< Is integrate being called? -> See reset.
 };
 
+
+/// Write the integrator statistics (one counter per line, "name: value").
+__FMI_DLL std::ostream& operator<<( std::ostream& out, const Integrator::Statistics& statistics );
+
 #endif // _FMIPP_INTEGRATOR_H
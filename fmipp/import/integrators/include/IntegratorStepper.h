@@ -31,6 +31,11 @@
  * | bdf     | BackwardsDifferentiationFormula  | SUNDIALS | 1-5   | Yes      | Stiff Models                   |
  * | abm2    | AdamsBashforthMoulton2           | SUNDIALS | 1-12  | Yes      | Nonstiff Models, expensive rhs |
  *
+ * The steppers dp, ck, bs and ro provide dense output, i.e., the states can be interpolated within
+ * the last step (see interpolate). The steppers dp and ck do not step exactly to the end of the
+ * integration interval but interpolate the states there, and continue with their last step (and
+ * step size) in case the next integration starts with the interpolated states.
+ *
  **/
 
 /// \copydoc Integrator::StateType
@@ -67,6 +72,29 @@ public:
 	virtual void do_step_const( EventInfo& eventInfo, StateType& states,
 		fmippTime& currentTime, fmippTime& dt ){};
 
+	/**
+	 * Check whether the stepper provides dense output, i.e., whether the states within the last step
+	 * can be interpolated (see interpolate).
+	 */
+	virtual bool hasDenseOutput() const { return false; }
+
+	/**
+	 * Interpolate the states within the last step (only for steppers with dense output).
+	 *
+	 * This does neither change the internal state of the stepper nor the states of the FMU, i.e., it
+	 * can be called repeatedly (e.g., for locating state events) without re-integrating the step.
+	 *
+	 * \param[in]  t       time within the last step
+	 * \param[out] states  interpolated states at time t
+	 */
+	virtual void interpolate( fmippTime t, StateType& states ){};
+
+	/**
+	 * Get the time interval of the last step (only for steppers with dense output), i.e., the interval
+	 * the states can be interpolated in.
+	 */
+	virtual void getLastStep( fmippTime& tBegin, fmippTime& tEnd ) const {};
+
 	/**
 	 * Invokes the integration method.
 	 *
@@ -91,8 +119,8 @@ public:
 	/**
 	 * Reset the stepper since the states changed externally
 	 *
-	 * Currently the steppers are reset before every call to invokeMethod. Yet, it would
-	 * be adviseable to make less reset calls for the sake of performance.
+	 * Called by Integrator::reset whenever inputs, continuous states or discrete states of the
+	 * FMU are changed. Steppers that continue their last step must start anew afterwards.
 	 */
 	virtual void reset(){};
 
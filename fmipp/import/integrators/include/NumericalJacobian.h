@@ -0,0 +1,170 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_NUMERICALJACOBIAN_H
+#define _FMIPP_NUMERICALJACOBIAN_H
+
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+
+class DynamicalSystem;
+
+
+/**
+ * \file NumericalJacobian.h
+ * Finite-difference approximation and column coloring of (sparse) Jacobians.
+ *
+ * \class JacobianColoring NumericalJacobian.h
+ * Column coloring of a (sparse) Jacobian.
+ *
+ * Columns with the same color have no non-zero row in common, i.e., the columns of one color
+ * can be computed at once (by perturbing or seeding all corresponding states together) and the
+ * result can be assigned to the columns unambiguously. The columns are colored greedily (columns
+ * with most non-zeros first). Without sparsity pattern, every column gets its own color. Columns
+ * without any non-zero row get no color at all.
+ */
+
+class __FMI_DLL JacobianColoring
+{
+
+public:
+
+	/// Sparsity pattern: for each row, the (sorted) indices of the non-zero columns.
+	typedef std::vector< std::vector<fmippSize> > Sparsity;
+
+	/// Constructor.
+	JacobianColoring() : N_( 0 ), dense_( true ) {}
+
+	/// Color the columns of an N*N Jacobian (dense if the sparsity pattern does not have N rows).
+	void initialize( const Sparsity& sparsity, fmippSize N );
+
+	/// Number of rows and columns.
+	fmippSize size() const { return N_; }
+
+	/// Number of colors.
+	fmippSize nColors() const { return groupStart_.empty() ? 0 : groupStart_.size() - 1; }
+
+	/// Columns of a color (begin).
+	const fmippSize* columnsBegin( fmippSize color ) const { return groupColumns_.data() + groupStart_[color]; }
+
+	/// Columns of a color (end).
+	const fmippSize* columnsEnd( fmippSize color ) const { return groupColumns_.data() + groupStart_[color + 1]; }
+
+	/// Non-zero rows of a column (begin).
+	const fmippSize* rowsBegin( fmippSize column ) const {
+		return dense_ ? columnRows_.data() : columnRows_.data() + columnStart_[column];
+	}
+
+	/// Non-zero rows of a column (end).
+	const fmippSize* rowsEnd( fmippSize column ) const {
+		return dense_ ? columnRows_.data() + N_ : columnRows_.data() + columnStart_[column + 1];
+	}
+
+private:
+
+	fmippSize N_;
+	fmippBoolean dense_;
+
+	std::vector<fmippSize> columnStart_; ///< Start of the rows of each column in columnRows_ (N+1 values, empty if dense).
+	std::vector<fmippSize> columnRows_; ///< Non-zero rows of all columns (all rows once if dense).
+
+	std::vector<fmippSize> groupStart_; ///< Start of the columns of each color in groupColumns_ (nColors+1 values).
+	std::vector<fmippSize> groupColumns_; ///< Columns sorted by color.
+};
+
+
+/**
+ * \class NumericalJacobian NumericalJacobian.h
+ * Finite-difference approximation of the Jacobian of a DynamicalSystem.
+ *
+ * If the sparsity pattern of the Jacobian is known (e.g., from the dependencies listed in the
+ * model structure of an FMI 2.0 model description), the columns of the Jacobian are colored
+ * (see JacobianColoring) and all states of the same color are perturbed at once, i.e., the
+ * number of right-hand side evaluations depends on the number of colors rather than the number
+ * of states.
+ *
+ * The work buffers are allocated once, i.e., computing the Jacobian does not allocate memory.
+ *
+ * | Method     | Order | RHS evaluations (states) | RHS evaluations (time) |
+ * | ---------- | ----- | ------------------------ | ---------------------- |
+ * | forward    | 1     | nColors + 1              | 1                      |
+ * | central    | 2     | 2 * nColors              | 2                      |
+ * | sixthOrder | 6     | 6 * nColors              | 6                      |
+ */
+
+class __FMI_DLL NumericalJacobian
+{
+
+public:
+
+	/// Finite-difference scheme.
+	enum Method {
+		forward, ///< Forward differences.
+		central, ///< Central differences.
+		sixthOrder ///< Central differences of 6th order (default).
+	};
+
+	/// \copydoc JacobianColoring::Sparsity
+	typedef JacobianColoring::Sparsity Sparsity;
+
+	/// Constructor.
+	NumericalJacobian( DynamicalSystem* ds );
+
+	/// Set the finite-difference scheme.
+	void setMethod( Method method ) { method_ = method; }
+
+	/// Get the finite-difference scheme.
+	Method getMethod() const { return method_; }
+
+	/// Set the sparsity pattern (an empty pattern means a dense Jacobian).
+	void setSparsity( const Sparsity& sparsity );
+
+	/// Get the sparsity pattern (empty for a dense Jacobian).
+	const Sparsity& getSparsity() const { return sparsity_; }
+
+	/// Number of colors, i.e., groups of states that are perturbed at once (0 before the first call to compute).
+	fmippSize nColors() const { return coloring_.nColors(); }
+
+	/**
+	 * Compute the Jacobian and the derivatives with respect to time.
+	 *
+	 * The Jacobian is stored row-wise, i.e., J[N*i+j] is the derivative of f_i with respect to x_j.
+	 * Afterwards, time and states of the dynamical system are set to t and x.
+	 *
+	 * @param[out]  J  Jacobian (N*N values)
+	 * @param[in]  x  states
+	 * @param[out]  dfdt  derivatives with respect to time (N values)
+	 * @param[in]  t  time
+	 */
+	void compute( fmippReal* J, const fmippReal* x, fmippReal* dfdt, fmippTime t );
+
+private:
+
+	/// Evaluate the right-hand side for the perturbed states.
+	void evaluate( fmippReal* dx );
+
+	/// Step size of the finite differences for a given value (relative for forward differences, absolute otherwise).
+	fmippReal stepSize( fmippReal value ) const;
+
+	DynamicalSystem* ds_;
+
+	Method method_;
+
+	Sparsity sparsity_; ///< Sparsity pattern as set by the user (may be empty).
+
+	fmippSize N_; ///< Number of states the work buffers are allocated and the columns are colored for.
+
+	JacobianColoring coloring_;
+
+	std::vector<fmippReal> x_; ///< Perturbed states.
+	std::vector<fmippReal> h_; ///< Step sizes of the states.
+	std::vector<fmippReal> f0_; ///< Unperturbed right-hand side (forward differences).
+	std::vector<fmippReal> fPlus_; ///< Right-hand side for positive perturbations.
+	std::vector<fmippReal> fMinus_; ///< Right-hand side for negative perturbations.
+};
+
+
+#endif // _FMIPP_NUMERICALJACOBIAN_H
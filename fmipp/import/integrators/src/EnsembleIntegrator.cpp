@@ -0,0 +1,343 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file EnsembleIntegrator.cpp
+ * Lockstep integration of an ensemble of identical FMU ME instances with an explicit
+ * Dormand-Prince 5(4) scheme.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "import/base/include/DynamicalSystem.h"
+
+#include "import/integrators/include/EnsembleIntegrator.h"
+
+using namespace std;
+
+
+namespace {
+
+	/// Number of stages of the Dormand-Prince scheme.
+	const fmippSize nStages = 7;
+
+	/// Nodes of the Dormand-Prince scheme.
+	const fmippReal c[nStages] = { 0., 1./5., 3./10., 4./5., 8./9., 1., 1. };
+
+	/// Coefficients of the Dormand-Prince scheme (the last row are the weights of the 5th order solution).
+	const fmippReal a[nStages][nStages - 1] = {
+		{ 0., 0., 0., 0., 0., 0. },
+		{ 1./5., 0., 0., 0., 0., 0. },
+		{ 3./40., 9./40., 0., 0., 0., 0. },
+		{ 44./45., -56./15., 32./9., 0., 0., 0. },
+		{ 19372./6561., -25360./2187., 64448./6561., -212./729., 0., 0. },
+		{ 9017./3168., -355./33., 46732./5247., 49./176., -5103./18656., 0. },
+		{ 35./384., 0., 500./1113., 125./192., -2187./6784., 11./84. }
+	};
+
+	/// Difference between the weights of the 5th and 4th order solutions (error estimate).
+	const fmippReal e[nStages] = {
+		71./57600., 0., -71./16695., 71./1920., -17253./339200., 22./525., -1./40.
+	};
+
+	/// Step size factor for a given error norm (bounded to [0.2, 5]).
+	fmippReal stepSizeFactor( fmippReal errorNorm )
+	{
+		if ( errorNorm <= 0. ) return 5.;
+		return min( 5., max( 0.2, 0.9 * pow( errorNorm, -0.2 ) ) );
+	}
+}
+
+
+EnsembleIntegrator::EnsembleIntegrator( const vector<DynamicalSystem*>& instances,
+	ErrorControl errorControl, fmippSize nThreads ) :
+	instances_( instances ),
+	nInstances_( instances.size() ),
+	nStates_( instances.empty() ? 0 : instances.front()->nStates() ),
+	errorControl_( errorControl ),
+	abstol_( 1e-6 ),
+	reltol_( 1e-6 ),
+	stage_( 0 ),
+	stageStates_( 0 ),
+	stageC_( 0. ),
+	generation_( 0 ),
+	pending_( 0 ),
+	stopRequested_( false )
+{
+	if ( 0 == nStates_ )
+		throw runtime_error( "ensemble integrator cannot be initialized with a number of continuous states equal to zero" );
+
+	for ( vector<DynamicalSystem*>::const_iterator it = instances_.begin(); it != instances_.end(); ++it )
+		if ( ( *it )->nStates() != nStates_ )
+			throw runtime_error( "ensemble integrator requires instances with the same number of continuous states" );
+
+	const fmippSize n = nInstances_ * nStates_;
+	y_.resize( n );
+	yNew_.resize( n );
+	yStage_.resize( n );
+	k_.resize( nStages * n );
+	errorNorm_.resize( nInstances_ );
+
+	time_.resize( nInstances_ );
+	tEnd_.resize( nInstances_ );
+	h_.resize( nInstances_ );
+	hNext_.resize( nInstances_ );
+	active_.resize( nInstances_ );
+
+	eventInfo_.resize( nInstances_ );
+	acceptedSteps_.resize( nInstances_, 0 );
+	rejectedSteps_.resize( nInstances_, 0 );
+
+	if ( 0 == nThreads ) nThreads = max( 1u, thread::hardware_concurrency() );
+	nThreads = max<fmippSize>( 1, min( nThreads, nInstances_ ) );
+
+	scratch_.resize( nThreads, vector<fmippReal>( 2 * nStates_ ) );
+	for ( fmippSize w = 1; w < nThreads; ++w )
+		workers_.push_back( thread( &EnsembleIntegrator::run, this, w ) );
+}
+
+
+EnsembleIntegrator::~EnsembleIntegrator()
+{
+	{
+		lock_guard<mutex> lock( mutex_ );
+		stopRequested_ = true;
+	}
+	start_.notify_all();
+
+	for ( vector<thread>::iterator it = workers_.begin(); it != workers_.end(); ++it )
+		it->join();
+}
+
+
+void EnsembleIntegrator::setTolerances( fmippReal abstol, fmippReal reltol )
+{
+	abstol_ = abstol;
+	reltol_ = reltol;
+}
+
+
+fmippSize EnsembleIntegrator::integrate( fmippTime step_size, fmippTime dt )
+{
+	const fmippSize N = nInstances_;
+	const fmippSize n = N * nStates_;
+	vector<fmippReal>& x = scratch_.front();
+
+	// Gather the current states and times of all instances.
+	for ( fmippSize i = 0; i < N; ++i ) {
+		time_[i] = instances_[i]->getTime();
+		tEnd_[i] = time_[i] + step_size;
+		hNext_[i] = dt;
+		active_[i] = step_size > 0.;
+		eventInfo_[i] = Integrator::EventInfo();
+
+		instances_[i]->getContinuousStates( &x.front() );
+		for ( fmippSize j = 0; j < nStates_; ++j ) y_[j*N + i] = x[j];
+	}
+
+	// First stage (afterwards always taken from the last stage of the previous step).
+	fill( h_.begin(), h_.end(), 0. );
+	evaluate( 0, &y_.front(), c[0] );
+
+	fmippSize nActive = count( active_.begin(), active_.end(), 1 );
+	fmippSize nEvents = 0;
+
+	while ( nActive > 0 )
+	{
+		// Step sizes for this step.
+		fmippTime hShared = numeric_limits<fmippTime>::infinity();
+		if ( shared == errorControl_ )
+			for ( fmippSize i = 0; i < N; ++i )
+				if ( active_[i] ) hShared = min( hShared, hNext_[i] );
+
+		for ( fmippSize i = 0; i < N; ++i ) {
+			if ( !active_[i] ) { h_[i] = 0.; continue; }
+			fmippTime h = ( shared == errorControl_ ) ? hShared : hNext_[i];
+			h_[i] = min( h, tEnd_[i] - time_[i] );
+			if ( h_[i] <= 1e-14 * max( 1., fabs( time_[i] ) ) )
+				throw runtime_error( "ensemble integrator step size underflow" );
+		}
+
+		// Stages 2 to 7, the states of the last stage are the solution of 5th order.
+		for ( fmippSize s = 1; s < nStages; ++s )
+		{
+			vector<fmippReal>& yS = ( nStages - 1 == s ) ? yNew_ : yStage_;
+			fill( yS.begin(), yS.end(), 0. );
+			for ( fmippSize r = 0; r < s; ++r ) {
+				const fmippReal ar = a[s][r];
+				if ( 0. == ar ) continue;
+				const fmippReal* kr = &k_[r*n];
+				for ( fmippSize idx = 0; idx < n; ++idx ) yS[idx] += ar * kr[idx];
+			}
+			for ( fmippSize j = 0; j < nStates_; ++j ) {
+				const fmippReal* yj = &y_[j*N];
+				fmippReal* ySj = &yS[j*N];
+				for ( fmippSize i = 0; i < N; ++i ) ySj[i] = yj[i] + h_[i] * ySj[i];
+			}
+			evaluate( s, &yS.front(), c[s] );
+		}
+
+		// Norm of the local error estimate (root mean square, scaled by the tolerances).
+		fill( errorNorm_.begin(), errorNorm_.end(), 0. );
+		for ( fmippSize j = 0; j < nStates_; ++j ) {
+			const fmippReal* yj = &y_[j*N];
+			const fmippReal* yNewj = &yNew_[j*N];
+			for ( fmippSize i = 0; i < N; ++i ) {
+				fmippReal err = 0.;
+				for ( fmippSize s = 0; s < nStages; ++s ) err += e[s] * k_[s*n + j*N + i];
+				err *= h_[i] / ( abstol_ + reltol_ * max( fabs( yj[i] ), fabs( yNewj[i] ) ) );
+				errorNorm_[i] += err * err;
+			}
+		}
+		for ( fmippSize i = 0; i < N; ++i ) errorNorm_[i] = sqrt( errorNorm_[i] / nStates_ );
+
+		if ( shared == errorControl_ ) {
+			fmippReal maxErrorNorm = 0.;
+			for ( fmippSize i = 0; i < N; ++i )
+				if ( active_[i] ) maxErrorNorm = max( maxErrorNorm, errorNorm_[i] );
+			for ( fmippSize i = 0; i < N; ++i ) errorNorm_[i] = maxErrorNorm;
+		}
+
+		// Accept or reject the step for each instance.
+		for ( fmippSize i = 0; i < N; ++i )
+		{
+			if ( !active_[i] ) continue;
+
+			const fmippReal factor = stepSizeFactor( errorNorm_[i] );
+
+			if ( !( errorNorm_[i] <= 1. ) ) {
+				++rejectedSteps_[i];
+				hNext_[i] = h_[i] * factor;
+				continue;
+			}
+
+			++acceptedSteps_[i];
+			// Do not let a step that was shortened to reach the end determine the next step size.
+			if ( h_[i] >= hNext_[i] ) hNext_[i] = h_[i] * factor;
+
+			// The last stage has been evaluated at the end of the step, i.e., the instance
+			// already holds the new time and states.
+			DynamicalSystem* fmu = instances_[i];
+			if ( fmu->checkStateEvent() ) {
+				for ( fmippSize j = 0; j < nStates_; ++j ) x[j] = y_[j*N + i];
+				fmu->setTime( time_[i] );
+				fmu->setContinuousStates( &x.front() );
+
+				eventInfo_[i].stateEvent = true;
+				eventInfo_[i].stepEvent = false;
+				eventInfo_[i].tLower = time_[i];
+				eventInfo_[i].tUpper = time_[i] + h_[i];
+				active_[i] = false;
+				--nActive;
+				++nEvents;
+				continue;
+			}
+
+			// A step that was shortened to reach the end ends exactly there (the sum of time and
+			// step size may be off by one ulp, which would leave a remainder below the minimum step size).
+			if ( h_[i] == tEnd_[i] - time_[i] ) {
+				time_[i] = tEnd_[i];
+				fmu->setTime( time_[i] );
+			} else {
+				time_[i] += h_[i];
+			}
+			for ( fmippSize j = 0; j < nStates_; ++j ) {
+				y_[j*N + i] = yNew_[j*N + i];
+				k_[j*N + i] = k_[( nStages - 1 )*n + j*N + i];
+			}
+
+			if ( fmu->checkStepEvent() ) {
+				eventInfo_[i].stepEvent = true;
+				eventInfo_[i].stateEvent = false;
+				active_[i] = false;
+				--nActive;
+				++nEvents;
+			} else if ( time_[i] >= tEnd_[i] ) {
+				active_[i] = false;
+				--nActive;
+			}
+		}
+	}
+
+	return nEvents;
+}
+
+
+void EnsembleIntegrator::evaluate( fmippSize stage, const fmippReal* y, fmippReal c )
+{
+	stage_ = stage;
+	stageStates_ = y;
+	stageC_ = c;
+
+	if ( workers_.empty() ) {
+		evaluateRange( 0 );
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock( mutex_ );
+		++generation_;
+		pending_ = workers_.size();
+	}
+	start_.notify_all();
+
+	evaluateRange( 0 );
+
+	unique_lock<mutex> lock( mutex_ );
+	done_.wait( lock, [this] { return 0 == pending_; } );
+}
+
+
+void EnsembleIntegrator::evaluateRange( fmippSize worker )
+{
+	const fmippSize N = nInstances_;
+	const fmippSize nThreads = scratch_.size();
+	const fmippSize begin = worker * N / nThreads;
+	const fmippSize end = ( worker + 1 ) * N / nThreads;
+
+	fmippReal* x = &scratch_[worker].front();
+	fmippReal* dx = x + nStates_;
+	fmippReal* k = &k_[stage_ * N * nStates_];
+
+	for ( fmippSize i = begin; i < end; ++i )
+	{
+		if ( !active_[i] ) continue;
+
+		for ( fmippSize j = 0; j < nStates_; ++j ) x[j] = stageStates_[j*N + i];
+
+		DynamicalSystem* fmu = instances_[i];
+		fmu->setTime( time_[i] + stageC_ * h_[i] );
+		fmu->setContinuousStates( x );
+		fmu->getDerivatives( dx );
+
+		for ( fmippSize j = 0; j < nStates_; ++j ) k[j*N + i] = dx[j];
+	}
+}
+
+
+void EnsembleIntegrator::run( fmippSize worker )
+{
+	fmippSize generation = 0;
+
+	while ( true )
+	{
+		{
+			unique_lock<mutex> lock( mutex_ );
+			start_.wait( lock, [this, &generation] { return stopRequested_ || generation_ != generation; } );
+			if ( stopRequested_ ) return;
+			generation = generation_;
+		}
+
+		evaluateRange( worker );
+
+		{
+			lock_guard<mutex> lock( mutex_ );
+			--pending_;
+		}
+		done_.notify_one();
+	}
+}
@@ -8,6 +8,7 @@
  * The Integrator serves as an interface between the IntegratorSteppers and FMUModelExchange
  */ 
 
+#include <algorithm>
 #include <cstdio>
 #include <cassert>
 #include <limits>
@@ -24,10 +25,29 @@
 using namespace std;
 
 
+namespace {
+
+	/**
+	 * Scale the event indicators at the retained limit of the event horizon (Anderson-Bjoerck
+	 * method), given the indicators at the other limit before and after it was replaced.
+	 */
+	void scaleIndicators( Integrator::StateType& retained,
+		const Integrator::StateType& replacedOld, const Integrator::StateType& replacedNew )
+	{
+		for ( size_t i = 0; i < retained.size(); i++ ){
+			fmippReal m = ( replacedOld[i] != 0 ) ? 1.0 - replacedNew[i]/replacedOld[i] : 0.0;
+			retained[i] *= ( m > 0 ) ? m : 0.5;
+		}
+	}
+}
+
+
 Integrator::Integrator( DynamicalSystem* fmu ) :
 	fmu_( fmu ),
 	stepper_( 0 ),
-	is_copy_( false )
+	denseOutputEnd_( std::numeric_limits<fmippTime>::quiet_NaN() ),
+	is_copy_( false ),
+	integrating_( false )
 {}
 
 
@@ -36,7 +56,9 @@ Integrator::Integrator( const Integrator& other ) :
 	stepper_( other.stepper_ ),
 	states_( other.states_ ),
 	time_( other.time_ ),
-	is_copy_( true )
+	denseOutputEnd_( other.denseOutputEnd_ ),
+	is_copy_( true ),
+	integrating_( false )
 {}
 
 
@@ -111,6 +133,13 @@ Integrator::Properties Integrator::getProperties() const
 
 Integrator::EventInfo Integrator::integrate( fmippTime step_size, fmippTime dt, fmippTime eventSearchPrecision )
 {
+	// The stepper changes the states of the FMU, which must not reset it (see reset).
+	struct IntegratingFlag {
+		bool& flag_;
+		IntegratingFlag( bool& flag ) : flag_( flag ) { flag_ = true; }
+		~IntegratingFlag() { flag_ = false; }
+	} integrating( integrating_ );
+
 	// Get current time.
 	time_ = fmu_->getTime();
 
@@ -122,6 +151,7 @@ Integrator::EventInfo Integrator::integrate( fmippTime step_size, fmippTime dt,
 
 	// if no event happened, return
 	if ( !eventInfo_.stateEvent ){
+		denseOutputEnd_ = fmu_->getTime();
 		return eventInfo_;
 	} // else, use a binary search to locate the event upt to the eventSearchPrecision_
 	else{
@@ -144,11 +174,16 @@ Integrator::EventInfo Integrator::integrate( fmippTime step_size, fmippTime dt,
 			fmu_->setTime( time_ + step_size );
 			if ( !fmu_->checkStateEvent() ){
 				eventInfo_.stateEvent = false;
+				denseOutputEnd_ = time_ + step_size;
 				return eventInfo_;
 			}
 			eventInfo_.tUpper = time_ + step_size;
 		}
-		while ( eventInfo_.tUpper - eventInfo_.tLower > eventSearchPrecision/2.0 ){
+		if ( stepper_->hasDenseOutput() ){
+			// use the interpolation formulas of the stepper instead of re-integrating
+			locateEvent( eventSearchPrecision );
+		}
+		else while ( eventInfo_.tUpper - eventInfo_.tLower > eventSearchPrecision/2.0 ){
 			// create backup states
 			StateType states_bak = states_;
 
@@ -180,6 +215,8 @@ Integrator::EventInfo Integrator::integrate( fmippTime step_size, fmippTime dt,
 				eventInfo_.tUpper = ( eventInfo_.tUpper + eventInfo_.tLower )/2.0;
 			}
 		}
+		denseOutputEnd_ = eventInfo_.tLower;
+
 		// make sure the event is *strictly* inside the interval [tLower_, tUpper_]
 		eventInfo_.tUpper += eventSearchPrecision/8.0;
 		time_              = eventInfo_.tLower;
@@ -188,8 +225,137 @@ Integrator::EventInfo Integrator::integrate( fmippTime step_size, fmippTime dt,
 }
 
 
+void Integrator::reset()
+{
+	if ( ( 0 != stepper_ ) && !integrating_ ) stepper_->reset();
+}
+
+
+void Integrator::locateEvent( fmippTime eventSearchPrecision )
+{
+	fmippTime tLower = eventInfo_.tLower;
+	fmippTime tUpper = eventInfo_.tUpper;
+	getEventIndicators( tLower, indicatorsLower_ );
+	getEventIndicators( tUpper, indicatorsUpper_ );
+
+	// minimal distance of a new estimate to the limits of the interval (guarantees termination)
+	const fmippTime minDistance = eventSearchPrecision/4.0;
+
+	int retained = 0;        // limit that was retained in the last iteration (-1: lower, 1: upper)
+	bool bisect = false;     // fall back to bisection if the interval did not shrink sufficiently
+	unsigned int iterations = 0;
+	fmippTime widthBefore = tUpper - tLower;
+	while ( tUpper - tLower > eventSearchPrecision/2.0 ){
+		const fmippTime width = tUpper - tLower;
+
+		// estimate the time of the first zero crossing (secant method for every indicator
+		// that changes its sign within the interval)
+		fmippTime t = tUpper;
+		if ( bisect ){
+			t = tLower + width/2.0;
+		} else {
+			for ( size_t i = 0; i < indicatorsLower_.size(); i++ ){
+				if ( indicatorsLower_[i] * indicatorsUpper_[i] < 0 ){
+					fmippTime tZero = tLower + width * indicatorsLower_[i] /
+						( indicatorsLower_[i] - indicatorsUpper_[i] );
+					if ( tZero < t ) t = tZero;
+				}
+			}
+		}
+		// shift the estimate towards the limit that was retained, such that the zero crossing is
+		// bracketed from both sides as soon as the estimate is accurate
+		if ( -1 == retained ) t -= minDistance;
+		else if ( 1 == retained ) t += minDistance;
+		t = std::min( std::max( t, tLower + minDistance ), tUpper - minDistance );
+
+		getEventIndicators( t, indicators_ );
+
+		bool event = false;
+		for ( size_t i = 0; i < indicators_.size(); i++ )
+			if ( indicators_[i] * indicatorsLower_[i] < 0 ){
+				event = true;
+				break;
+			}
+
+		// update the event horizon. In case the same limit is retained twice in a row, its
+		// indicators are scaled down (Anderson-Bjoerck modification, avoids one-sided convergence)
+		if ( event ){
+			if ( -1 == retained ) scaleIndicators( indicatorsLower_, indicatorsUpper_, indicators_ );
+			tUpper = t;
+			indicatorsUpper_.swap( indicators_ );
+			retained = -1;
+		} else {
+			if ( 1 == retained ) scaleIndicators( indicatorsUpper_, indicatorsLower_, indicators_ );
+			tLower = t;
+			indicatorsLower_.swap( indicators_ );
+			retained = 1;
+		}
+
+		// the interval shrinks superlinearly, use bisection if it did not shrink to at least
+		// half its size within three iterations
+		bisect = ( ++iterations % 3 == 0 ) && ( tUpper - tLower > widthBefore/2.0 );
+		if ( iterations % 3 == 0 ) widthBefore = tUpper - tLower;
+	}
+
+	// write the states before the event into the FMU
+	stepper_->interpolate( tLower, states_ );
+	fmu_->setTime( tLower );
+	fmu_->setContinuousStates( &states_[0] );
+
+	eventInfo_.tLower = tLower;
+	eventInfo_.tUpper = tUpper;
+}
+
+
+void Integrator::getEventIndicators( fmippTime t, StateType& indicators )
+{
+	indicators.resize( fmu_->nEventInds() );
+	stepper_->interpolate( t, states_ );
+	fmu_->setTime( t );
+	fmu_->setContinuousStates( &states_[0] );
+	fmu_->getEventIndicators( &indicators[0] );
+}
+
+
+bool Integrator::hasDenseOutput() const
+{
+	return ( 0 != stepper_ ) && stepper_->hasDenseOutput();
+}
+
+
+bool Integrator::getInterpolatedStates( fmippTime t, fmippReal* states )
+{
+	if ( !hasDenseOutput() ) return false;
+
+	fmippTime tBegin, tEnd;
+	stepper_->getLastStep( tBegin, tEnd );
+	if ( !( t >= tBegin && t <= std::min( tEnd, denseOutputEnd_ ) ) ) return false;
+
+	stepper_->interpolate( t, states_ );
+	std::copy( states_.begin(), states_.end(), states );
+	return true;
+}
+
+
 // get time horizon for the event
 void Integrator::getEventHorizon( fmippTime& tLower, fmippTime& tUpper ){
 	tLower = eventInfo_.tLower;
 	tUpper = eventInfo_.tUpper;
 }
+
+
+ostream& operator<<( ostream& out, const Integrator::Statistics& statistics )
+{
+	out << "integrate calls: " << statistics.integrateCalls << endl
+	    << "derivative evaluations: " << statistics.derivativeEvaluations << endl
+	    << "Jacobian evaluations: " << statistics.jacobianEvaluations << endl
+	    << "accepted steps: " << statistics.acceptedSteps << endl
+	    << "rejected steps: " << statistics.rejectedSteps << endl
+	    << "state events: " << statistics.stateEvents << endl
+	    << "step events: " << statistics.stepEvents << endl
+	    << "time events: " << statistics.timeEvents << endl
+	    << "event iterations: " << statistics.eventIterations << endl
+	    << "integrate time [s]: " << statistics.integrateTime << endl
+	    << "step over event time [s]: " << statistics.stepOverEventTime << endl;
+	return out;
+}
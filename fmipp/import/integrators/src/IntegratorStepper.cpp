@@ -9,6 +9,7 @@
  * are implemented here.
  */
 
+#include <cmath>
 #include <cstdio>
 
 // Boost Ublas type checks drastically slow down the rosenbrock4 integrator
@@ -91,6 +92,7 @@ public:
 			   fmippTime dt,
 			   fmippTime eventSearchPrecision )
 	{
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
 		fmippTime currentTime = time;
 		bool stop = false;
 		while ( ( currentTime < time + step_size ) && !stop ){
@@ -112,6 +114,7 @@ public:
 				//do_step
 				do_step( eventInfo, states, currentTime, dt );
 			}
+			if ( statistics ) ++statistics->acceptedSteps;
 			// update the state and time
 			fmu_->setTime( currentTime );
 			fmu_->setContinuousStates( &states[0] );
@@ -198,21 +201,115 @@ public:
 /**
  * 5th order Cash-Karp method with controlled step size.
  *
- * Very similar to the dormand-prince method (same order and same number of rhs evaluations per step), but
- * without dense output capability. Since the current implmentation hardly benefits from dense output, this
- * stepper should yoield almost the same results and same performance as dp.
+ * Very similar to the dormand-prince method (same order and same number of rhs evaluations per step).
+ * Since odeint does not provide dense output for this stepper, the states within a step are
+ * interpolated with a 4th order polynomial: a cubic Hermite polynomial (using the derivatives at both
+ * ends of the step, which are needed by the stepper anyway) plus a correction term that matches the
+ * derivative at one point within the step. This derivative is only evaluated for steps that are
+ * actually interpolated, i.e., the dense output costs at most one rhs evaluation per step.
  */
-class CashKarp : public OdeintStepper
+class CashKarp : public IntegratorStepper
 {
 	typedef runge_kutta_cash_karp54< StateType > error_stepper_type;
 	typedef controlled_runge_kutta< error_stepper_type > controlled_stepper_type;
 	/// Runge-Kutta-Cash-Karp controlled stepper.
 	controlled_stepper_type stepper;
 	controlled_step_result res_;
+	SystemWrapper sys_;
+
+	StateType x_;            ///< states at the end of the last step
+	StateType dxdt_;         ///< derivatives at the end of the last step
+	StateType xPrev_;        ///< states at the beginning of the last step
+	StateType dxdtPrev_;     ///< derivatives at the beginning of the last step
+	fmippTime t_;            ///< time at the end of the last step
+	fmippTime tPrev_;        ///< time at the beginning of the last step
+	fmippTime dt_;           ///< step size proposed for the next step
+	fmippTime endTime_;      ///< time the last integration ended at (NaN if it stopped because of an event)
+	StateType endStates_;    ///< interpolated states the last integration ended with
+
+	StateType correction_;   ///< coefficients of the correction term of the interpolation polynomial
+	bool hasCorrection_;     ///< flag indicating that the correction term is available for the last step
+	StateType fmuStates_;    ///< states of the FMU (to be restored after computing the correction)
+
+	/// Cubic Hermite polynomial (relative time theta within the last step).
+	fmippReal hermite( unsigned int i, fmippReal theta, fmippTime h ) const {
+		return ( 1.0 + 2.0*theta )*( 1.0 - theta )*( 1.0 - theta )*xPrev_[i]
+			+ theta*( 1.0 - theta )*( 1.0 - theta )*h*dxdtPrev_[i]
+			+ theta*theta*( 3.0 - 2.0*theta )*x_[i]
+			+ theta*theta*( theta - 1.0 )*h*dxdt_[i];
+	}
+
+	/// Derivative of the cubic Hermite polynomial with respect to theta.
+	fmippReal hermiteDerivative( unsigned int i, fmippReal theta, fmippTime h ) const {
+		return 6.0*theta*( theta - 1.0 )*( xPrev_[i] - x_[i] )
+			+ ( 1.0 - theta )*( 1.0 - 3.0*theta )*h*dxdtPrev_[i]
+			+ theta*( 3.0*theta - 2.0 )*h*dxdt_[i];
+	}
+
+	/**
+	 * Compute the correction term c*theta^2*(1-theta)^2 of the interpolation polynomial, such that its
+	 * derivative matches the rhs at theta = (3-sqrt(3))/6 (where the derivative of the correction term
+	 * is maximal). The rhs is evaluated for the states of the cubic Hermite polynomial, the error of
+	 * which only affects the interpolation with order 5.
+	 */
+	void computeCorrection(){
+		const fmippTime h = t_ - tPrev_;
+		const fmippReal theta = ( 3.0 - std::sqrt( 3.0 ) )/6.0;
+		const fmippReal dq = 2.0*theta*( 1.0 - theta )*( 1.0 - 2.0*theta );
+
+		// save the FMU, since the rhs evaluation changes time and states
+		const fmippTime fmuTime = fmu_->getTime();
+		fmuStates_.resize( x_.size() );
+		fmu_->getContinuousStates( &fmuStates_[0] );
+
+		StateType x( x_.size() );
+		correction_.resize( x_.size() );
+		for ( unsigned int i = 0; i < x_.size(); i++ ) x[i] = hermite( i, theta, h );
+		sys_( x, correction_, tPrev_ + theta*h );
+		for ( unsigned int i = 0; i < x_.size(); i++ )
+			correction_[i] = ( h*correction_[i] - hermiteDerivative( i, theta, h ) )/dq;
+
+		fmu_->setTime( fmuTime );
+		fmu_->setContinuousStates( &fmuStates_[0] );
+		hasCorrection_ = true;
+	}
+
+	/// Start the integration with the given states.
+	void initialize( const StateType& states, fmippTime time, fmippTime dt ){
+		x_ = states;
+		xPrev_ = states;
+		dxdt_.resize( states.size() );
+		sys_( x_, dxdt_, time );
+		dxdtPrev_ = dxdt_;
+		t_ = time;
+		tPrev_ = time;
+		dt_ = dt;
+		hasCorrection_ = false;
+	}
+
+	/// Make a step with controlled step size.
+	void do_step(){
+		xPrev_.swap( x_ );
+		dxdtPrev_.swap( dxdt_ );
+		tPrev_ = t_;
+		x_ = xPrev_;
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
+		while ( fail == ( res_ = stepper.try_step( sys_, x_, dxdtPrev_, t_, dt_ ) ) )
+			if ( statistics ) ++statistics->rejectedSteps;
+		sys_( x_, dxdt_, t_ );
+		hasCorrection_ = false;
+		if ( statistics ) ++statistics->acceptedSteps;
+	}
 
 public:
 	CashKarp( DynamicalSystem* fmu, Integrator::Properties& properties ) :
-		OdeintStepper( 5, fmu )
+		IntegratorStepper( fmu ),
+		sys_( fmu ),
+		t_( 0 ),
+		tPrev_( 0 ),
+		dt_( 0 ),
+		endTime_( std::numeric_limits<fmippTime>::quiet_NaN() ),
+		hasCorrection_( false )
 	{
 		// set the "read only" properties
 		properties.name  = "Cash Karp";
@@ -228,18 +325,101 @@ public:
 		stepper = make_controlled( properties.abstol, properties.reltol, error_stepper_type() );
 	};
 
-	void do_step_const( EventInfo& eventInfo, StateType& states,
-			    fmippTime& currentTime, fmippTime& dt ){
-		stepper.stepper().do_step( sys_, states, currentTime, dt );
-		currentTime += dt;
+	void invokeMethod( EventInfo& eventInfo,
+			   Integrator::StateType& states,
+			   fmippTime time,
+			   fmippTime step_size,
+			   fmippReal dt,
+			   fmippReal eventSearchPrecision ){
+		// continue with the last step (and its step size) in case the states were not changed since
+		// the last call, otherwise start from the given states
+		if ( ( time != endTime_ ) || ( states != endStates_ ) )
+			initialize( states, time, dt );
+		endTime_ = std::numeric_limits<fmippTime>::quiet_NaN();
+
+		while ( t_ < time + step_size ){
+			// perform a step
+			do_step();
+
+			// event detection like in OdeintStepper
+			fmu_->setTime( t_ );
+			fmu_->setContinuousStates( &x_[0] );
+			if ( fmu_->checkStateEvent() ){
+				// set back to the backup state/time
+				fmu_->setTime( tPrev_ );
+				fmu_->setContinuousStates( &xPrev_[0] );
+
+				// tell the integrator about the event
+				eventInfo.stepEvent  = false;
+				eventInfo.stateEvent = true;
+				eventInfo.tLower     = tPrev_;
+				eventInfo.tUpper     = t_;
+
+				return;
+			}
+
+			if ( ( t_ < time + step_size ) && fmu_->checkStepEvent() ){
+				// tell the integrator about the event
+				eventInfo.stepEvent  = true;
+				eventInfo.stateEvent = false;
+
+				return;
+			}
+		}
+		// use interoplation to get an approximation for time t.
+		interpolate( time + step_size, states );
+
+		// write the results in the FMU
+		fmu_->setTime( time + step_size );
+		fmu_->setContinuousStates( &states[0] );
+
+		// remember the end of the integration for the next call
+		endTime_   = time + step_size;
+		endStates_ = states;
+
+		// check for step events one more time
+		if ( fmu_->checkStepEvent() )
+			eventInfo.stepEvent = true;
+
+		eventInfo.stateEvent = false;
 	}
 
-	void do_step( EventInfo& eventInfo, StateType& states,
-		      fmippTime& currentTime, fmippTime& dt ){
-		do {
-			res_ = stepper.try_step( sys_, states, currentTime, dt );
+	void do_step_const( EventInfo& eventInfo,
+			    std::vector<fmippReal>& states,
+			    fmippTime& time,
+			    fmippReal& dt ){
+		// use interpolation for do_step_const
+		interpolate( time + dt, states );
+		time += dt;
+		fmu_->setTime( time );
+		fmu_->setContinuousStates( &states[0] );
+	}
+
+	bool hasDenseOutput() const { return true; }
+
+	void interpolate( fmippTime t, StateType& states ){
+		const fmippTime h = t_ - tPrev_;
+		states.resize( x_.size() );
+		if ( t == t_ || h <= 0 ){
+			states = x_;
+			return;
 		}
-		while ( res_ == fail );
+
+		if ( !hasCorrection_ ) computeCorrection();
+
+		const fmippReal theta = ( t - tPrev_ )/h;
+		const fmippReal q = theta*theta*( 1.0 - theta )*( 1.0 - theta );
+		for ( unsigned int i = 0; i < x_.size(); i++ )
+			states[i] = hermite( i, theta, h ) + q*correction_[i];
+	}
+
+	void getLastStep( fmippTime& tBegin, fmippTime& tEnd ) const {
+		tBegin = tPrev_;
+		tEnd   = t_;
+	}
+
+	void reset(){
+		endTime_ = std::numeric_limits<fmippTime>::quiet_NaN();
 	}
 };
 
@@ -256,11 +436,14 @@ class DormandPrince : public IntegratorStepper
 	/// Runge-Kutta-Dormand-Prince controlled stepper with dense output.
 	dense_stepper stepper;
 	SystemWrapper sys_;
+	fmippTime endTime_;      ///< time the last integration ended at (NaN if it stopped because of an event)
+	StateType endStates_;    ///< interpolated states the last integration ended with
 
 public:
 	DormandPrince( DynamicalSystem* fmu, Integrator::Properties& properties ) :
 		IntegratorStepper( fmu ),
-		sys_( fmu )
+		sys_( fmu ),
+		endTime_( std::numeric_limits<fmippTime>::quiet_NaN() )
 	{
 		properties.name  = "Dormand Prince";
 		properties.order = 5;
@@ -282,10 +465,24 @@ public:
 			   fmippTime step_size,
 			   fmippReal dt,
 			   fmippReal eventSearchPrecision ){
-		stepper.initialize( states, time, dt );
-		while ( true ){
+		// continue with the last step (and its step size) in case the states were not changed since
+		// the last call, otherwise start from the given states
+		if ( ( time != endTime_ ) || ( states != endStates_ ) )
+			stepper.initialize( states, time, dt );
+		endTime_ = std::numeric_limits<fmippTime>::quiet_NaN();
+
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
+		while ( stepper.current_time() < time + step_size ){
 			// perform a step
-			stepper.do_step( sys_ );
+			if ( statistics ){
+				// odeint does not report rejected steps, but every attempt costs 6 rhs evaluations
+				// (plus one at the very first step after initialization)
+				const fmippSize evaluations = statistics->derivativeEvaluations;
+				stepper.do_step( sys_ );
+				statistics->rejectedSteps += ( statistics->derivativeEvaluations - evaluations )/6 - 1;
+				++statistics->acceptedSteps;
+			} else
+				stepper.do_step( sys_ );
 
 			// event detection like in OdeintStepper
 			fmu_->setTime( stepper.current_time() );
@@ -304,9 +501,7 @@ public:
 				return;
 			}
 
-			if ( stepper.current_time() >= time + step_size )
-				break;
-			else if ( fmu_->checkStepEvent() ){
+			if ( ( stepper.current_time() < time + step_size ) && fmu_->checkStepEvent() ){
 				// tell the integrator about the event
 				eventInfo.stepEvent  = true;
 				eventInfo.stateEvent = false;
@@ -321,6 +516,10 @@ public:
 		fmu_->setTime( time + step_size );
 		fmu_->setContinuousStates( &states[0] );
 
+		// remember the end of the integration for the next call
+		endTime_   = time + step_size;
+		endStates_ = states;
+
 		// check for step events one more time
 		if ( fmu_->checkStepEvent() )
 			eventInfo.stepEvent = true;
@@ -339,8 +538,20 @@ public:
 		fmu_->setContinuousStates( &states[0] );
 	}
 
+	bool hasDenseOutput() const { return true; }
+
+	void interpolate( fmippTime t, StateType& states ){
+		stepper.calc_state( t, states );
+	}
+
+	void getLastStep( fmippTime& tBegin, fmippTime& tEnd ) const {
+		tBegin = stepper.previous_time();
+		tEnd   = stepper.current_time();
+	}
+
 	void reset(){
 		/// \todo Test if this is really OK. Semms like initialize makes reset unnecessary.
+		endTime_ = std::numeric_limits<fmippTime>::quiet_NaN();
 	}
 };
 
@@ -383,10 +594,9 @@ public:
 
 	void do_step( EventInfo& eventInfo, StateType& states,
 		      fmippTime& currentTime, fmippTime& dt ){
-		do {
-			res_ = stepper.try_step( sys_, states, currentTime, dt );
-		}
-		while ( res_ == fail );
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
+		while ( fail == ( res_ = stepper.try_step( sys_, states, currentTime, dt ) ) )
+			if ( statistics ) ++statistics->rejectedSteps;
 	}
 };
 
@@ -434,9 +644,11 @@ public:
 			   fmippReal eventSearchPrecision ){
 		reset();
 		stepper.initialize( states, time, dt );
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
 		while ( true ){
-			// perform a step
+			// perform a step (odeint does not report the attempts, i.e., only accepted steps are counted)
 			stepper.do_step( sys_ );
+			if ( statistics ) ++statistics->acceptedSteps;
 
 			// event detection like in OdeintStepper
 			fmu_->setTime( stepper.current_time() );
@@ -486,6 +698,17 @@ public:
 		time += dt;
 	}
 
+	bool hasDenseOutput() const { return true; }
+
+	void interpolate( fmippTime t, StateType& states ){
+		stepper.calc_state( t, states );
+	}
+
+	void getLastStep( fmippTime& tBegin, fmippTime& tEnd ) const {
+		tBegin = stepper.previous_time();
+		tEnd   = stepper.current_time();
+	}
+
 	void reset(){
 		stepper.reset();
 	}
@@ -566,6 +789,8 @@ class Rosenbrock : public IntegratorStepper
 		void operator()( const VectorType &x , MatrixType &jacobi , const fmippTime &t ,
 				 VectorType &dfdt ) const
 		{
+			if ( Integrator::Statistics* statistics = ds_->getIntegratorStatistics() )
+				++statistics->jacobianEvaluations;
 			if ( ds_->providesJacobian() ){
 				ds_->setTime( t );
 				ds_->setContinuousStates( &x[0] );
@@ -638,9 +863,17 @@ public:
 		reset();
 		change_type( states, statesV_ );
 		stepper.initialize( statesV_, time, dt );
+		Integrator::Statistics* statistics = fmu_->getIntegratorStatistics();
 		while ( true ){
 			// perform a step
-			stepper.do_step( std::make_pair( sys_, jac_ ) );
+			if ( statistics ){
+				// odeint does not report rejected steps, but every attempt evaluates the Jacobian once
+				const fmippSize evaluations = statistics->jacobianEvaluations;
+				stepper.do_step( std::make_pair( sys_, jac_ ) );
+				statistics->rejectedSteps += statistics->jacobianEvaluations - evaluations - 1;
+				++statistics->acceptedSteps;
+			} else
+				stepper.do_step( std::make_pair( sys_, jac_ ) );
 
 			// event detection like in OdeintStepper
 			fmu_->setTime( stepper.current_time() );
@@ -691,6 +924,18 @@ public:
 		time += dt;
 	}
 
+	bool hasDenseOutput() const { return true; }
+
+	void interpolate( fmippTime t, StateType& states ){
+		stepper.calc_state( t, statesV_ );
+		change_type( statesV_, states );
+	}
+
+	void getLastStep( fmippTime& tBegin, fmippTime& tEnd ) const {
+		tBegin = stepper.previous_time();
+		tEnd   = stepper.current_time();
+	}
+
 	void reset(){
 		//stepper.reset();
 	}
@@ -803,6 +1048,18 @@ private:
 	SUNMatrix A_;
 	SUNLinearSolver LS_;
 
+	/// Readings of the counters of CVode after the previous step (for collecting statistics).
+	long int lastSteps_;
+	long int lastErrorTestFails_;
+	long int lastConvergenceFails_;
+	long int lastJacobians_;
+
+	/// Reset the readings of the counters (the counters start from zero after CVodeReInit).
+	void resetCounterReadings()
+	{
+		lastSteps_ = lastErrorTestFails_ = lastConvergenceFails_ = lastJacobians_ = 0;
+	}
+
 public:
 	/**
 	 * Constructor
@@ -817,7 +1074,11 @@ public:
 		states_N_( N_VNew_Serial( NEQ_ ) ),
 		reltol_( properties.reltol != properties.reltol ? 1e-10 : properties.reltol ),
 		abstol_( properties.abstol != properties.abstol ? 1e-10 : properties.abstol ),
-		cvode_mem_( 0 )
+		cvode_mem_( 0 ),
+		lastSteps_( 0 ),
+		lastErrorTestFails_( 0 ),
+		lastConvergenceFails_( 0 ),
+		lastJacobians_( 0 )
 	{
 		// add missing tolerances if necessary
 		if ( properties.abstol != properties.abstol )
@@ -883,6 +1144,7 @@ public:
 
 		// reinitialize cvode. this deletes internal memeory
 		CVodeReInit( cvode_mem_, t_, states_N_ );     /// \todo reset only if states changed externally
+		resetCounterReadings();
 
 		// set initial step size
 		CVodeSetInitStep( cvode_mem_, dt );
@@ -890,6 +1152,23 @@ public:
 		// make iteration
 		int flag = CVode( cvode_mem_, t_ + step_size, states_N_, &t_, CV_NORMAL );
 
+		// the counters of CVode are cumulative (until the next call to CVodeReInit),
+		// hence only the increase since the previous reading is added
+		if ( Integrator::Statistics* statistics = fmu_->getIntegratorStatistics() ){
+			long int steps = 0, errorTestFails = 0, convergenceFails = 0, jacobians = 0;
+			CVodeGetNumSteps( cvode_mem_, &steps );
+			CVodeGetNumErrTestFails( cvode_mem_, &errorTestFails );
+			CVodeGetNumNonlinSolvConvFails( cvode_mem_, &convergenceFails );
+			CVDlsGetNumJacEvals( cvode_mem_, &jacobians );
+			statistics->acceptedSteps += steps - lastSteps_;
+			statistics->rejectedSteps += ( errorTestFails - lastErrorTestFails_ ) + ( convergenceFails - lastConvergenceFails_ );
+			statistics->jacobianEvaluations += jacobians - lastJacobians_;
+			lastSteps_ = steps;
+			lastErrorTestFails_ = errorTestFails;
+			lastConvergenceFails_ = convergenceFails;
+			lastJacobians_ = jacobians;
+		}
+
 		// convert output of cvode in StateType format
 		for ( int i = 0; i < NEQ_; i++ ) {
 			states[i] = Ith( states_N_, i );
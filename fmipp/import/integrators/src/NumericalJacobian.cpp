@@ -0,0 +1,210 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file NumericalJacobian.cpp
+ * Finite-difference approximation of (sparse) Jacobians with column coloring.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "import/base/include/DynamicalSystem.h"
+#include "import/base/include/NumericalJacobianCoefficients.icc"
+
+#include "import/integrators/include/NumericalJacobian.h"
+
+using namespace std;
+
+
+namespace {
+
+	/// Coefficients for central differences.
+	const NumericalJacobianCoefficients<1> centralCoefs;
+
+	/// Coefficients for central differences of 6th order.
+	const NumericalJacobianCoefficients<3> sixthOrderCoefs;
+}
+
+
+void JacobianColoring::initialize( const Sparsity& sparsity, fmippSize N )
+{
+	N_ = N;
+	dense_ = ( sparsity.size() != N );
+
+	// Rows of each column (transposed sparsity pattern).
+	if ( dense_ ) {
+		columnStart_.clear();
+		columnRows_.resize( N );
+		for ( fmippSize i = 0; i < N; ++i ) columnRows_[i] = i;
+	} else {
+		columnStart_.assign( N + 1, 0 );
+		for ( fmippSize i = 0; i < N; ++i )
+			for ( vector<fmippSize>::const_iterator it = sparsity[i].begin(); it != sparsity[i].end(); ++it )
+				++columnStart_[*it + 1];
+		for ( fmippSize j = 0; j < N; ++j ) columnStart_[j + 1] += columnStart_[j];
+		columnRows_.resize( columnStart_[N] );
+		vector<fmippSize> next( columnStart_.begin(), columnStart_.end() - 1 );
+		for ( fmippSize i = 0; i < N; ++i )
+			for ( vector<fmippSize>::const_iterator it = sparsity[i].begin(); it != sparsity[i].end(); ++it )
+				columnRows_[next[*it]++] = i;
+	}
+
+	// Greedy coloring: a column gets the smallest color that is not used by any column it shares a row with.
+	const fmippSize noColor = numeric_limits<fmippSize>::max();
+	vector<fmippSize> color( N, noColor );
+	fmippSize nColors = 0;
+	if ( dense_ ) {
+		for ( fmippSize j = 0; j < N; ++j ) color[j] = j;
+		nColors = N;
+	} else {
+		vector<fmippSize> order( N );
+		for ( fmippSize j = 0; j < N; ++j ) order[j] = j;
+		stable_sort( order.begin(), order.end(), [this]( fmippSize a, fmippSize b ) {
+			return columnStart_[a + 1] - columnStart_[a] > columnStart_[b + 1] - columnStart_[b];
+		} );
+
+		vector<fmippSize> forbidden( N, noColor ); // Column for which a color has been marked as forbidden last.
+		for ( vector<fmippSize>::const_iterator j = order.begin(); j != order.end(); ++j ) {
+			if ( columnStart_[*j] == columnStart_[*j + 1] ) continue; // Column without non-zeros.
+			for ( fmippSize r = columnStart_[*j]; r < columnStart_[*j + 1]; ++r ) {
+				const vector<fmippSize>& row = sparsity[columnRows_[r]];
+				for ( vector<fmippSize>::const_iterator k = row.begin(); k != row.end(); ++k )
+					if ( noColor != color[*k] ) forbidden[color[*k]] = *j;
+			}
+			fmippSize c = 0;
+			while ( forbidden[c] == *j ) ++c;
+			color[*j] = c;
+			nColors = max( nColors, c + 1 );
+		}
+	}
+
+	// Columns sorted by color.
+	groupStart_.assign( nColors + 1, 0 );
+	for ( fmippSize j = 0; j < N; ++j )
+		if ( noColor != color[j] ) ++groupStart_[color[j] + 1];
+	for ( fmippSize c = 0; c < nColors; ++c ) groupStart_[c + 1] += groupStart_[c];
+	groupColumns_.resize( groupStart_[nColors] );
+	vector<fmippSize> next( groupStart_.begin(), groupStart_.end() - 1 );
+	for ( fmippSize j = 0; j < N; ++j )
+		if ( noColor != color[j] ) groupColumns_[next[color[j]]++] = j;
+}
+
+
+NumericalJacobian::NumericalJacobian( DynamicalSystem* ds ) :
+	ds_( ds ),
+	method_( sixthOrder ),
+	N_( 0 )
+{}
+
+
+void NumericalJacobian::setSparsity( const Sparsity& sparsity )
+{
+	for ( Sparsity::const_iterator row = sparsity.begin(); row != sparsity.end(); ++row )
+		for ( vector<fmippSize>::const_iterator it = row->begin(); it != row->end(); ++it )
+			if ( *it >= sparsity.size() )
+				throw runtime_error( "sparsity pattern of the Jacobian is not square" );
+
+	sparsity_ = sparsity;
+
+	// Color the columns again with the next call to compute.
+	N_ = 0;
+}
+
+
+void NumericalJacobian::compute( fmippReal* J, const fmippReal* x, fmippReal* dfdt, fmippTime t )
+{
+	const fmippSize N = ds_->nStates();
+	if ( N != N_ ) {
+		N_ = N;
+		coloring_.initialize( sparsity_, N );
+		x_.resize( N );
+		h_.resize( N );
+		f0_.resize( N );
+		fPlus_.resize( N );
+		fMinus_.resize( N );
+	}
+
+	const fmippSize steps = ( central == method_ ) ? 1 : 3;
+	const fmippReal* coefs = ( central == method_ ) ? &centralCoefs[0] : &sixthOrderCoefs[0];
+
+	copy( x, x + N, x_.begin() );
+	for ( fmippSize j = 0; j < N; ++j ) h_[j] = stepSize( x[j] );
+	fill( J, J + N*N, 0. );
+
+	ds_->setTime( t );
+	if ( forward == method_ ) evaluate( &f0_[0] );
+
+	// Perturb all states of the same color at once.
+	for ( fmippSize c = 0; c < coloring_.nColors(); ++c )
+	{
+		const fmippSize* begin = coloring_.columnsBegin( c );
+		const fmippSize* end = coloring_.columnsEnd( c );
+
+		if ( forward == method_ ) {
+			for ( const fmippSize* j = begin; j != end; ++j ) x_[*j] = x[*j] + h_[*j];
+			evaluate( &fPlus_[0] );
+			for ( const fmippSize* j = begin; j != end; ++j ) {
+				x_[*j] = x[*j];
+				for ( const fmippSize* i = coloring_.rowsBegin( *j ); i != coloring_.rowsEnd( *j ); ++i )
+					J[N * *i + *j] = ( fPlus_[*i] - f0_[*i] ) / h_[*j];
+			}
+			continue;
+		}
+
+		for ( fmippSize k = 0; k < steps; ++k ) {
+			for ( const fmippSize* j = begin; j != end; ++j ) x_[*j] = x[*j] + ( k + 1. ) * h_[*j];
+			evaluate( &fPlus_[0] );
+			for ( const fmippSize* j = begin; j != end; ++j ) x_[*j] = x[*j] - ( k + 1. ) * h_[*j];
+			evaluate( &fMinus_[0] );
+			for ( const fmippSize* j = begin; j != end; ++j ) {
+				x_[*j] = x[*j];
+				for ( const fmippSize* i = coloring_.rowsBegin( *j ); i != coloring_.rowsEnd( *j ); ++i )
+					J[N * *i + *j] += coefs[k] * ( fPlus_[*i] - fMinus_[*i] ) / h_[*j];
+			}
+		}
+	}
+
+	// Derivatives with respect to time (same scheme).
+	ds_->setContinuousStates( &x_[0] );
+	const fmippTime ht = stepSize( t );
+	if ( forward == method_ ) {
+		ds_->setTime( t + ht );
+		ds_->getDerivatives( &fPlus_[0] );
+		for ( fmippSize i = 0; i < N; ++i ) dfdt[i] = ( fPlus_[i] - f0_[i] ) / ht;
+	} else {
+		fill( dfdt, dfdt + N, 0. );
+		for ( fmippSize k = 0; k < steps; ++k ) {
+			ds_->setTime( t + ( k + 1. ) * ht );
+			ds_->getDerivatives( &fPlus_[0] );
+			ds_->setTime( t - ( k + 1. ) * ht );
+			ds_->getDerivatives( &fMinus_[0] );
+			for ( fmippSize i = 0; i < N; ++i ) dfdt[i] += coefs[k] * ( fPlus_[i] - fMinus_[i] ) / ht;
+		}
+	}
+	ds_->setTime( t );
+}
+
+
+void NumericalJacobian::evaluate( fmippReal* dx )
+{
+	ds_->setContinuousStates( &x_[0] );
+	ds_->getDerivatives( dx );
+}
+
+
+fmippReal NumericalJacobian::stepSize( fmippReal value ) const
+{
+	// Forward differences: square root of the machine precision, relative to the value.
+	if ( forward == method_ ) {
+		static const fmippReal sqrtEpsilon = sqrt( numeric_limits<fmippReal>::epsilon() );
+		return sqrtEpsilon * max( 1., fabs( value ) );
+	}
+
+	// Central differences: the absolute step size used so far for all models (independent of the value).
+	return 1.0e-5;
+}
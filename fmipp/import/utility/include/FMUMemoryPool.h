@@ -0,0 +1,116 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_FMUMEMORYPOOL_H
+#define _FMIPP_FMUMEMORYPOOL_H
+
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+#include "common/fmi_v2.0/fmi_2.h"
+
+
+/**
+ * \file FMUMemoryPool.h
+ * \class FMUMemoryPool FMUMemoryPool.h
+ * Memory pool serving the allocations of a single FMU instance (FMI 2.0).
+ *
+ * Small blocks are taken from size classes (powers of 2, up to maxPooledBlockSize bytes),
+ * which are carved from large chunks and recycled via free lists. Hence, the memory of an
+ * FMU instance is kept close together, and the chunks are released at once when the pool
+ * is destroyed. Larger blocks are allocated directly from the heap. The pool keeps track
+ * of the number of allocations and the number of allocated bytes (live and peak).
+ *
+ * The FMI 2.0 memory callbacks do not receive the component environment. Therefore, each
+ * pool is bound to a dedicated pair of callback functions. The number of these pairs (and
+ * hence the number of pools with callbacks existing at the same time) is limited to
+ * maxPoolsWithCallbacks, see function hasCallbacks.
+ *
+ * The pool is not thread-safe, i.e., the functions of an FMU instance using it must not
+ * be called concurrently. The pool has to outlive the FMU instance.
+ */
+
+class __FMI_DLL FMUMemoryPool
+{
+
+public:
+
+	/// Maximum number of pools with callbacks existing at the same time.
+	static const fmippSize maxPoolsWithCallbacks = 256;
+
+	/// Largest block size (in bytes) served from the size classes.
+	static const fmippSize maxPooledBlockSize = 2048;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param[in]  chunkSize  size (in bytes) of the chunks from which small blocks are taken
+	 */
+	FMUMemoryPool( fmippSize chunkSize = 65536 );
+
+	/// Destructor, releases all memory of the pool.
+	~FMUMemoryPool();
+
+	/// Check if the pool has callback functions (false if too many pools exist).
+	fmippBoolean hasCallbacks() const { return slot_ < maxPoolsWithCallbacks; }
+
+	/// Callback function for allocating memory from this pool (0 if not available).
+	fmi2::fmi2CallbackAllocateMemory getAllocateMemoryCallback() const;
+
+	/// Callback function for freeing memory of this pool (0 if not available).
+	fmi2::fmi2CallbackFreeMemory getFreeMemoryCallback() const;
+
+	/// Allocate zero-initialized memory for an array of nobj objects of the given size.
+	void* allocate( fmippSize nobj, fmippSize size );
+
+	/// Free memory allocated from this pool.
+	void release( void* obj );
+
+	/// Number of bytes currently allocated (as requested by the FMU).
+	fmippSize getLiveBytes() const { return liveBytes_; }
+
+	/// Maximum number of bytes allocated at the same time.
+	fmippSize getPeakBytes() const { return peakBytes_; }
+
+	/// Total number of allocations.
+	fmippSize getAllocationCount() const { return allocationCount_; }
+
+	/// Number of blocks currently allocated.
+	fmippSize getLiveAllocations() const { return liveAllocations_; }
+
+	/// Number of bytes reserved from the heap (chunks and large blocks).
+	fmippSize getReservedBytes() const { return reservedBytes_; }
+
+private:
+
+	FMUMemoryPool( const FMUMemoryPool& ); ///< Prevent calling the copy constructor.
+	FMUMemoryPool& operator=( const FMUMemoryPool& ); ///< Prevent calling the assignment operator.
+
+	/// Header in front of every block.
+	struct BlockHeader;
+
+	/// Take a block of the given size class (from the free list or the current chunk).
+	char* takeBlock( fmippSize sizeClass );
+
+	const fmippSize chunkSize_;
+
+	fmippSize slot_; ///< Index of the pair of callback functions bound to this pool.
+
+	std::vector<char*> chunks_; ///< All chunks reserved so far.
+	char* chunkPos_; ///< Next free position in the current chunk.
+	char* chunkEnd_; ///< End of the current chunk.
+
+	std::vector<void*> freeLists_; ///< Heads of the free lists (one per size class).
+
+	fmippSize liveBytes_;
+	fmippSize peakBytes_;
+	fmippSize allocationCount_;
+	fmippSize liveAllocations_;
+	fmippSize reservedBytes_;
+
+};
+
+
+#endif // _FMIPP_FMUMEMORYPOOL_H
@@ -32,7 +32,8 @@ public:
 
 	~HistoryEntry() { delete [] state_; delete [] realValues_;  delete [] integerValues_;  delete [] booleanValues_;  delete [] stringValues_; }
 
-	HistoryEntry& operator=( HistoryEntry aHistoryEntry );
+	/// Copy the values of another entry, arrays are only reallocated if their sizes differ.
+	HistoryEntry& operator=( const HistoryEntry& aHistoryEntry );
 
 	fmippTime time_;
 	fmippSize nStates_;
@@ -47,6 +48,101 @@ public:
 	fmippString* stringValues_;
 };
 
+/**
+ * \class HistoryBuffer History.h
+ * Contiguous storage for a sequence of FMU states (e.g., the predictions of a look-ahead).
+ *
+ * All entries share a single memory arena in structure-of-arrays layout: one column holds
+ * the time stamps, and for each state and output variable one column holds its values over
+ * time. Entries are addressed by their logical index (0 refers to the oldest entry), which is
+ * mapped onto the arena like a ring buffer. Once the buffer has been reserved for the expected
+ * number of entries, pushing, clearing and reading entries does not allocate any memory.
+ * Time stamps are expected to be non-decreasing, which allows to search them with a binary search.
+ **/
+class HistoryBuffer
+{
+
+public:
+
+	HistoryBuffer();
+	~HistoryBuffer();
+
+	/**
+	 * Define the layout of the entries and reserve space for (at least) the given number of
+	 * entries. The buffer is cleared, the arena is only reallocated if the layout changes or
+	 * the capacity is too small.
+	 */
+	void reserve( fmippSize capacity, fmippSize nStates, fmippSize nRealValues, fmippSize nIntegerValues, fmippSize nBooleanValues, fmippSize nStringValues );
+
+	/// Remove all entries (does not release any memory).
+	void clear() { head_ = 0; size_ = 0; }
+
+	/// Append a copy of an entry. In case the buffer is full, its capacity is doubled.
+	void push_back( const HistoryEntry& entry );
+
+	/// Remove the oldest entry.
+	void pop_front();
+
+	/// Overwrite the entry with the given logical index.
+	void set( fmippSize i, const HistoryEntry& entry );
+
+	/// Copy the entry with the given logical index (arrays of the target are reused if possible).
+	void get( fmippSize i, HistoryEntry& entry ) const;
+
+	/// Return the index of the newest entry with a time stamp not greater than t, or size() if there is none.
+	fmippSize findLast( fmippTime t ) const;
+
+	fmippSize size() const { return size_; }
+	fmippSize capacity() const { return capacity_; }
+	bool empty() const { return 0 == size_; }
+
+	fmippSize nStates() const { return nStates_; }
+	fmippSize nRealValues() const { return nRealValues_; }
+
+	fmippTime time( fmippSize i ) const { return time_[slot( i )]; }
+	fmippTime frontTime() const { return time( 0 ); }
+	fmippTime backTime() const { return time( size_ - 1 ); }
+
+	/// Return the value of state variable j of the entry with logical index i.
+	fmippReal state( fmippSize i, fmippSize j ) const { return state_[j*capacity_ + slot( i )]; }
+
+	/// Return the value of real output j of the entry with logical index i.
+	fmippReal realValue( fmippSize i, fmippSize j ) const { return realValues_[j*capacity_ + slot( i )]; }
+
+private:
+
+	/// Map a logical index onto a slot of the arena.
+	fmippSize slot( fmippSize i ) const { return ( head_ + i < capacity_ ) ? head_ + i : head_ + i - capacity_; }
+
+	/// (Re-)allocate the arena, the contents of the buffer are preserved.
+	void allocate( fmippSize capacity );
+
+	/// Copy an entry into the given slot.
+	void write( fmippSize s, const HistoryEntry& entry );
+
+	fmippSize capacity_;
+	fmippSize head_;
+	fmippSize size_;
+
+	fmippSize nStates_;
+	fmippSize nRealValues_;
+	fmippSize nIntegerValues_;
+	fmippSize nBooleanValues_;
+	fmippSize nStringValues_;
+
+	fmippReal* arena_; ///< Memory of the time stamps and all non-string columns.
+	fmippString* strings_; ///< Columns of the string values.
+
+	fmippTime* time_;
+	fmippReal* state_;
+	fmippReal* realValues_;
+	fmippInteger* integerValues_;
+	fmippBoolean* booleanValues_;
+
+	HistoryBuffer( const HistoryBuffer& ); ///< Prevent calling the copy constructor.
+	HistoryBuffer& operator=( const HistoryBuffer& ); ///< Prevent calling the assignment operator.
+};
+
 /// This namespace contains typedefs that ease the use of class HistorEntry.
 namespace History
 {
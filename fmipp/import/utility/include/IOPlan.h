@@ -0,0 +1,153 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_IOPLAN_H
+#define _FMIPP_IOPLAN_H
+
+#include <memory>
+#include <vector>
+
+#include "common/FMIPPConfig.h"
+#include "common/FMIPPVariableType.h"
+
+namespace fmi_2_0 {
+	class FMUCoSimulation;
+}
+
+/**
+ * \file IOPlan.h
+ * \class IOPlan IOPlan.h
+ * Precompiled plan for setting inputs and getting outputs of an FMU CS (FMI 2.0).
+ *
+ * The variable names are resolved once when the plan is created. Variables are grouped
+ * by type, with value references and value buffers held in contiguous arrays. Setting
+ * all inputs or getting all outputs then requires only one batched FMI call per type.
+ * A plan does not depend on a specific FMU instance, i.e., it can be applied to all
+ * instances of the same model. Instances that are used independently of each other
+ * should use their own copies of a plan, which share nothing but the resolved variables.
+ */
+
+class __FMI_DLL IOPlan
+{
+
+public:
+
+	/**
+	 * Constructor.
+	 *
+	 * @param[in]  fmu  FMU used for resolving the variable names
+	 * @param[in]  inputNames  names of input variables
+	 * @param[in]  outputNames  names of output variables
+	 */
+	IOPlan( const fmi_2_0::FMUCoSimulation& fmu,
+		const std::vector<fmippString>& inputNames,
+		const std::vector<fmippString>& outputNames );
+
+	/**
+	 * Copy constructor, the copy gets its own value buffers (the buffered values are not copied).
+	 * No variable names are resolved, i.e., a plan has to be compiled only once per model.
+	 */
+	IOPlan( const IOPlan& plan );
+
+	/// Check if all variable names have been resolved.
+	fmippBoolean isValid() const { return valid_; }
+
+	/// Number of inputs.
+	fmippSize nInputs() const { return inputs_.size(); }
+
+	/// Number of outputs.
+	fmippSize nOutputs() const { return outputs_.size(); }
+
+	/// Type of the i-th input (fmippTypeUnknown if the name could not be resolved).
+	FMIPPVariableType getInputType( fmippSize i ) const { return inputs_[i].type; }
+
+	/// Type of the i-th output (fmippTypeUnknown if the name could not be resolved).
+	FMIPPVariableType getOutputType( fmippSize i ) const { return outputs_[i].type; }
+
+	/// Set the value of the i-th input in the buffer (returns false in case of a type mismatch).
+	fmippBoolean setInput( fmippSize i, const fmippReal& val );
+
+	/// Set the value of the i-th input in the buffer (returns false in case of a type mismatch).
+	fmippBoolean setInput( fmippSize i, const fmippInteger& val );
+
+	/// Set the value of the i-th input in the buffer (returns false in case of a type mismatch).
+	fmippBoolean setInput( fmippSize i, const fmippBoolean& val );
+
+	/// Set the value of the i-th input in the buffer (returns false in case of a type mismatch).
+	fmippBoolean setInput( fmippSize i, const fmippString& val );
+
+	/// Get the value of the i-th output from the buffer (returns false in case of a type mismatch).
+	fmippBoolean getOutput( fmippSize i, fmippReal& val ) const;
+
+	/// Get the value of the i-th output from the buffer (returns false in case of a type mismatch).
+	fmippBoolean getOutput( fmippSize i, fmippInteger& val ) const;
+
+	/// Get the value of the i-th output from the buffer (returns false in case of a type mismatch).
+	fmippBoolean getOutput( fmippSize i, fmippBoolean& val ) const;
+
+	/// Get the value of the i-th output from the buffer (returns false in case of a type mismatch).
+	fmippBoolean getOutput( fmippSize i, fmippString& val ) const;
+
+	/// Write all buffered input values to the FMU (one call per type), returns the most severe status.
+	fmippStatus applyInputs( fmi_2_0::FMUCoSimulation& fmu );
+
+	/// Read all output values from the FMU into the buffer (one call per type), returns the most severe status.
+	fmippStatus fetchOutputs( fmi_2_0::FMUCoSimulation& fmu );
+
+private:
+
+	/// Position of a variable within the batch of its type.
+	struct Slot
+	{
+		FMIPPVariableType type;
+		fmippSize index;
+	};
+
+	/// Value references and value buffer for all variables of the same type.
+	template<typename Type>
+	struct Batch
+	{
+		Batch() : size( 0 ) {}
+
+		/// Copy the value references, the copy gets its own value buffer.
+		Batch( const Batch& batch ) : valueRefs( batch.valueRefs ), size( 0 ) { allocate(); }
+
+		/// Allocate the value buffer, initialized with zeros (call once all value references have been added).
+		void allocate() { size = valueRefs.size(); values.reset( size ? new Type[size]() : 0 ); }
+
+		std::vector<fmippValueReference> valueRefs;
+		std::unique_ptr<Type[]> values;
+		fmippSize size;
+	};
+
+	/// All batches (one per type) of either inputs or outputs.
+	struct Batches
+	{
+		Batch<fmippReal> real;
+		Batch<fmippInteger> integer;
+		Batch<fmippBoolean> boolean;
+		Batch<fmippString> string;
+	};
+
+	/// Resolve names and add them to the batches.
+	fmippBoolean compile( const fmi_2_0::FMUCoSimulation& fmu,
+		const std::vector<fmippString>& names,
+		std::vector<Slot>& slots,
+		Batches& batches );
+
+	IOPlan& operator=( const IOPlan& ); ///< Prevent calling the assignment operator.
+
+	std::vector<Slot> inputs_; ///< Slots of all inputs (in the order of the input names).
+	std::vector<Slot> outputs_; ///< Slots of all outputs (in the order of the output names).
+
+	Batches inputBatches_; ///< Batched inputs.
+	Batches outputBatches_; ///< Batched outputs.
+
+	fmippBoolean valid_; ///< Flag indicating that all variable names have been resolved.
+
+};
+
+
+#endif // _FMIPP_IOPLAN_H
@@ -132,6 +132,12 @@ public:
 	 */
 	Integrator::Properties getIntegratorProperties() const;
 
+	/// \copydoc DynamicalSystem::enableIntegratorStatistics
+	void enableIntegratorStatistics( fmippBoolean enable = true );
+
+	/// Get the integrator statistics of the FMU (null if disabled).
+	const Integrator::Statistics* getIntegratorStatistics() const;
+
 	FMIPPVariableType getType( const fmippString& varName ) const;
 
 	void defineRealInputs( const fmippString inputs[],
@@ -230,7 +236,7 @@ public:
 
 protected:
 
-	History::History predictions_; ///< Vector of state predictions.
+	HistoryBuffer predictions_; ///< Contiguous buffer of state predictions (oldest first).
 
 	/// Check the latest prediction if an event has occured. If so, update the latest prediction accordingly.
 	virtual bool checkForEvent( const HistoryEntry& newestPrediction );
@@ -288,10 +294,10 @@ protected:
 	void getOutputs( fmippString* outputs ) const;
 
 	/** In case no look-ahead prediction is given for time t, this function is responsible to provide
-	 *  an estimate for the corresponding state. For convenience, a REVERSE iterator pointing to the
-	 *  next prediction available AFTER time t is handed over to the function.
+	 *  an estimate for the corresponding state. For convenience, the index of the last prediction
+	 *  available BEFORE time t is handed over to the function (the next prediction follows it).
 	 **/
-	void interpolateState(fmippTime t, History::const_reverse_iterator& historyEntry, HistoryEntry& state);
+	void interpolateState(fmippTime t, fmippSize left, HistoryEntry& state);
 
 	/** Helper function: linear value interpolation. **/
 	double interpolateValue( fmippReal x, fmippReal x0, fmippReal y0, fmippReal x1, fmippReal y1 ) const;
@@ -304,6 +310,9 @@ private:
 	/** The current state. **/
 	HistoryEntry currentState_;
 
+	/** The latest prediction (reused for every look-ahead). **/
+	HistoryEntry prediction_;
+
 	/** Value references of the real inputs. **/
 	fmippValueReference* realInputRefs_;
 
@@ -0,0 +1,170 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_REMOTEFMUCHANNEL_H
+#define _FMIPP_REMOTEFMUCHANNEL_H
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "common/FMIPPConfig.h"
+
+/**
+ * \file RemoteFMUChannel.h
+ * Shared-memory communication between an FMU proxy (see RemoteFMUCoSimulation) and
+ * the worker process hosting the actual FMU instance.
+ */
+
+
+/// Commands sent from the proxy to the worker process.
+enum RemoteFMUCommand
+{
+	remoteFMUPing = 1,
+	remoteFMUInstantiate,
+	remoteFMUInitialize,
+	remoteFMUDoStep,
+	remoteFMUTerminate,
+	remoteFMUSetReal,
+	remoteFMUSetInteger,
+	remoteFMUSetBoolean,
+	remoteFMUSetString,
+	remoteFMUGetReal,
+	remoteFMUGetInteger,
+	remoteFMUGetBoolean,
+	remoteFMUGetString,
+	remoteFMUShutdown
+};
+
+
+/**
+ * \class RemoteFMUMessage RemoteFMUChannel.h
+ * Binary message (batch of commands or response) exchanged via a RemoteFMUChannel.
+ */
+class __FMI_DLL RemoteFMUMessage
+{
+
+public:
+
+	RemoteFMUMessage() : pos_( 0 ) {}
+
+	explicit RemoteFMUMessage( const std::string& data ) : data_( data ), pos_( 0 ) {}
+
+	/// Append a plain value.
+	template<typename Type>
+	void put( const Type& val ) { data_.append( reinterpret_cast<const char*>( &val ), sizeof( Type ) ); }
+
+	/// Append a string.
+	void put( const fmippString& val ) { put<fmippSize>( val.size() ); data_.append( val ); }
+
+	/// Append the contents of another message.
+	void append( const RemoteFMUMessage& msg ) { data_.append( msg.data_ ); }
+
+	/// Read the next plain value (returns false if the message is too short).
+	template<typename Type>
+	fmippBoolean get( Type& val )
+	{
+		if ( pos_ + sizeof( Type ) > data_.size() ) return false;
+		std::memcpy( &val, data_.data() + pos_, sizeof( Type ) );
+		pos_ += sizeof( Type );
+		return true;
+	}
+
+	/// Read the next string (returns false if the message is too short).
+	fmippBoolean get( fmippString& val );
+
+	/// Read the number of elements of a list, whose elements take at least elementSize bytes each
+	/// (returns false if the rest of the message cannot hold that many elements).
+	fmippBoolean getCount( fmippSize& n, fmippSize elementSize )
+	{
+		return get( n ) && ( n <= ( data_.size() - pos_ ) / elementSize );
+	}
+
+	/// Check if all contents of the message have been read.
+	fmippBoolean atEnd() const { return pos_ >= data_.size(); }
+
+	const std::string& data() const { return data_; }
+
+	void clear() { data_.clear(); pos_ = 0; }
+
+private:
+
+	std::string data_;
+	fmippSize pos_;
+
+};
+
+
+/**
+ * \class RemoteFMUChannel RemoteFMUChannel.h
+ * Channel between proxy and worker process based on a POSIX shared memory segment.
+ *
+ * The segment contains two single-producer single-consumer ring buffers, one for
+ * requests (proxy to worker) and one for responses (worker to proxy), each guarded
+ * by a process-shared semaphore signalling the availability of a new message.
+ * Waiting for a message is done in short time slices, such that the waiting side
+ * can check if its counterpart is still alive.
+ */
+class __FMI_DLL RemoteFMUChannel
+{
+
+public:
+
+	/// Function checking if the counterpart is still alive (called while waiting).
+	typedef std::function<fmippBoolean ()> AliveCheck;
+
+	/// Default capacity (in bytes) of each ring buffer.
+	static const fmippSize defaultCapacity = 1 << 20;
+
+	/// Create a new shared memory segment (returns 0 in case of failure).
+	static RemoteFMUChannel* create( const fmippString& name, fmippSize capacity = defaultCapacity );
+
+	/// Attach to an existing shared memory segment (returns 0 in case of failure).
+	static RemoteFMUChannel* open( const fmippString& name );
+
+	/// Destructor, the creator of the segment also removes it.
+	~RemoteFMUChannel();
+
+	const fmippString& getName() const { return name_; }
+
+	/// Send a request to the worker (returns false if the message is too large).
+	fmippBoolean sendRequest( const RemoteFMUMessage& msg );
+
+	/// Wait for the next request (returns false if the proxy is no longer alive or the message is invalid).
+	fmippBoolean receiveRequest( RemoteFMUMessage& msg, const AliveCheck& alive );
+
+	/// Send a response to the proxy (returns false if the message is too large).
+	fmippBoolean sendResponse( const RemoteFMUMessage& msg );
+
+	/// Wait for the next response (returns false if the worker is no longer alive or the message is invalid).
+	fmippBoolean receiveResponse( RemoteFMUMessage& msg, const AliveCheck& alive );
+
+private:
+
+	struct Ring;
+	struct Header;
+
+	RemoteFMUChannel( const fmippString& name, void* segment, fmippSize segmentSize, fmippBoolean owner );
+
+	RemoteFMUChannel( const RemoteFMUChannel& ); ///< Prevent calling the copy constructor.
+	RemoteFMUChannel& operator=( const RemoteFMUChannel& ); ///< Prevent calling the assignment operator.
+
+	fmippBoolean send( Ring& ring, char* data, const RemoteFMUMessage& msg );
+	fmippBoolean receive( Ring& ring, const char* data, RemoteFMUMessage& msg, const AliveCheck& alive );
+
+	fmippString name_;
+	void* segment_;
+	fmippSize segmentSize_;
+	fmippBoolean owner_;
+
+	Header* header_;
+	fmippSize capacity_; ///< Capacity of each ring buffer (checked when the segment is opened).
+	char* requestData_;
+	char* responseData_;
+
+};
+
+
+#endif // _FMIPP_REMOTEFMUCHANNEL_H
@@ -0,0 +1,269 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#ifndef _FMIPP_REMOTEFMUCOSIMULATION_H
+#define _FMIPP_REMOTEFMUCOSIMULATION_H
+
+#include <memory>
+#include <sys/types.h>
+
+#include "import/base/include/FMUCoSimulationBase.h"
+#include "import/base/include/VariableIndex.h"
+#include "import/utility/include/RemoteFMUChannel.h"
+
+
+/**
+ * \file RemoteFMUCoSimulation.h
+ * \class RemoteFMUCoSimulation RemoteFMUCoSimulation.h
+ * Proxy for an FMU CS (FMI 2.0) hosted by a separate worker process.
+ *
+ * The worker process (executable fmippworker) loads the FMU's shared library and
+ * creates the FMU instance, hence every proxy has its own copy of the library's global
+ * state. This allows to use several instances of FMUs that can only be instantiated
+ * once per process, and a crashing FMU does not take down the importing process.
+ *
+ * Commands are sent to the worker via a shared-memory channel (see RemoteFMUChannel).
+ * Setting values does not require a round trip: set commands are collected and sent
+ * together with the next command that returns a result (getting values, stepping,
+ * etc.), whose status then also covers all previously collected set commands.
+ * In case the worker process terminates unexpectedly, all calls return fmippFatal.
+ *
+ * The model description is parsed by the proxy itself, i.e., variable names are
+ * resolved without contacting the worker.
+ *
+ * The proxy is a stand-alone FMUCoSimulationBase. It is not used by ModelManager or
+ * by the wrappers built on fmi_2_0::FMUCoSimulation (e.g., the ns-3 devices), which
+ * load FMUs into the importing process.
+ */
+
+class __FMI_DLL RemoteFMUCoSimulation : public FMUCoSimulationBase
+{
+
+public:
+
+	/**
+	 * Constructor. Starts the worker process and loads the FMU in it.
+	 *
+	 * @param[in]  fmuDirUrl  URL of the directory containing the extracted FMU
+	 * @param[in]  modelIdentifier  FMU model identifier
+	 * @param[in]  loggingOn  turn on logging of the FMU
+	 * @param[in]  workerPath  path of the worker executable (searched in PATH if no directory is given)
+	 */
+	RemoteFMUCoSimulation( const fmippString& fmuDirUrl,
+		const fmippString& modelIdentifier,
+		const fmippBoolean loggingOn = false,
+		const fmippString& workerPath = "fmippworker" );
+
+	/// Destructor. Shuts down the worker process.
+	~RemoteFMUCoSimulation();
+
+	/// Check if the worker process is (still) running.
+	fmippBoolean isWorkerAlive() const;
+
+	/// Send all collected set commands to the worker, returns the most severe status of these commands.
+	fmippStatus flush();
+
+	/// \copydoc FMUCoSimulationBase::terminate
+	virtual void terminate();
+
+	/// \copydoc FMUCoSimulationBase::instantiate
+	virtual fmippStatus instantiate( const fmippString& instanceName,
+		const fmippTime timeout,
+		const fmippBoolean visible,
+		const fmippBoolean interactive );
+
+	/// \copydoc FMUCoSimulationBase::initialize
+	virtual fmippStatus initialize( const fmippReal startTime,
+		const fmippBoolean stopTimeDefined,
+		const fmippReal stopTime );
+
+	/// \copydoc FMUCoSimulationBase::doStep
+	virtual fmippStatus doStep( fmippTime currentCommunicationPoint,
+		fmippTime communicationStepSize,
+		fmippBoolean newStep );
+
+	/// \copydoc FMUBase::getTime()
+	virtual fmippTime getTime() const { return time_; }
+
+	/// \copydoc FMUBase::getLastStatus()
+	virtual fmippStatus getLastStatus() const { return lastStatus_; }
+
+	/// \copydoc FMUBase::getModelDescription()
+	virtual const ModelDescription* getModelDescription() const { return description_.get(); }
+
+	/// \copydoc FMUBase::nStates()
+	virtual fmippSize nStates() const { return 0; }
+
+	/// \copydoc FMUBase::nEventInds()
+	virtual fmippSize nEventInds() const { return 0; }
+
+	/// \copydoc FMUBase::nValueRefs()
+	virtual fmippSize nValueRefs() const { return varIndex_.size(); }
+
+	/// \copydoc FMUBase::getValueRef()
+	virtual fmippValueReference getValueRef( const fmippString& name ) const;
+
+	/// \copydoc FMUBase::getType()
+	virtual FMIPPVariableType getType( const fmippString& variableName ) const;
+
+	/// Get a handle (value reference and type) for a variable.
+	VariableHandle getVariableHandle( const fmippString& name ) const;
+
+	/// \copydoc FMUBase::getValue( fmippValueReference valref, fmippReal& val )
+	virtual fmippStatus getValue( fmippValueReference valref, fmippReal& val );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference valref, fmippInteger& val )
+	virtual fmippStatus getValue( fmippValueReference valref, fmippInteger& val );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference valref, fmippBoolean& val )
+	virtual fmippStatus getValue( fmippValueReference valref, fmippBoolean& val );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference valref, fmippString& val )
+	virtual fmippStatus getValue( fmippValueReference valref, fmippString& val );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference* valref, fmippReal* val, fmippSize ival )
+	virtual fmippStatus getValue( fmippValueReference* valref, fmippReal* val, fmippSize ival );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference* valref, fmippInteger* val, fmippSize ival )
+	virtual fmippStatus getValue( fmippValueReference* valref, fmippInteger* val, fmippSize ival );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference* valref, fmippBoolean* val, fmippSize ival )
+	virtual fmippStatus getValue( fmippValueReference* valref, fmippBoolean* val, fmippSize ival );
+
+	/// \copydoc FMUBase::getValue( fmippValueReference* valref, fmippString* val, fmippSize ival )
+	virtual fmippStatus getValue( fmippValueReference* valref, fmippString* val, fmippSize ival );
+
+	/// \copydoc FMUBase::getValue( const fmippString& name, fmippReal& val )
+	virtual fmippStatus getValue( const fmippString& name, fmippReal& val );
+
+	/// \copydoc FMUBase::getValue( const fmippString& name, fmippInteger& val )
+	virtual fmippStatus getValue( const fmippString& name, fmippInteger& val );
+
+	/// \copydoc FMUBase::getValue( const fmippString& name, fmippBoolean& val )
+	virtual fmippStatus getValue( const fmippString& name, fmippBoolean& val );
+
+	/// \copydoc FMUBase::getValue( const fmippString& name, fmippString& val )
+	virtual fmippStatus getValue( const fmippString& name, fmippString& val );
+
+	/// \copydoc FMUBase::getRealValue()
+	virtual fmippReal getRealValue( const fmippString& name );
+
+	/// \copydoc FMUBase::getIntegerValue()
+	virtual fmippInteger getIntegerValue( const fmippString& name );
+
+	/// \copydoc FMUBase::getBooleanValue()
+	virtual fmippBoolean getBooleanValue( const fmippString& name );
+
+	/// \copydoc FMUBase::getStringValue()
+	virtual fmippString getStringValue( const fmippString& name );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference valref, const fmippReal& val )
+	virtual fmippStatus setValue( fmippValueReference valref, const fmippReal& val );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference valref, const fmippInteger& val )
+	virtual fmippStatus setValue( fmippValueReference valref, const fmippInteger& val );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference valref, const fmippBoolean& val )
+	virtual fmippStatus setValue( fmippValueReference valref, const fmippBoolean& val );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference valref, const fmippString& val )
+	virtual fmippStatus setValue( fmippValueReference valref, const fmippString& val );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference* valref, const fmippReal* val, fmippSize ival )
+	virtual fmippStatus setValue( fmippValueReference* valref, const fmippReal* val, fmippSize ival );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference* valref, const fmippInteger* val, fmippSize ival )
+	virtual fmippStatus setValue( fmippValueReference* valref, const fmippInteger* val, fmippSize ival );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference* valref, const fmippBoolean* val, fmippSize ival )
+	virtual fmippStatus setValue( fmippValueReference* valref, const fmippBoolean* val, fmippSize ival );
+
+	/// \copydoc FMUBase::setValue( fmippValueReference* valref, const fmippString* val, fmippSize ival )
+	virtual fmippStatus setValue( fmippValueReference* valref, const fmippString* val, fmippSize ival );
+
+	/// \copydoc FMUBase::setValue( const fmippString& name, const fmippReal& val )
+	virtual fmippStatus setValue( const fmippString& name, const fmippReal& val );
+
+	/// \copydoc FMUBase::setValue( const fmippString& name, const fmippInteger& val )
+	virtual fmippStatus setValue( const fmippString& name, const fmippInteger& val );
+
+	/// \copydoc FMUBase::setValue( const fmippString& name, const fmippBoolean& val )
+	virtual fmippStatus setValue( const fmippString& name, const fmippBoolean& val );
+
+	/// \copydoc FMUBase::setValue( const fmippString& name, const fmippString& val )
+	virtual fmippStatus setValue( const fmippString& name, const fmippString& val );
+
+	/// \copydoc FMUCoSimulationBase::canHandleVariableCommunicationStepSize
+	virtual fmippBoolean canHandleVariableCommunicationStepSize() const;
+
+	/// \copydoc FMUCoSimulationBase::canHandleEvents
+	virtual fmippBoolean canHandleEvents() const;
+
+	/// \copydoc FMUCoSimulationBase::canRejectSteps
+	virtual fmippBoolean canRejectSteps() const;
+
+	/// \copydoc FMUCoSimulationBase::canInterpolateInputs
+	virtual fmippBoolean canInterpolateInputs() const;
+
+	/// \copydoc FMUCoSimulationBase::maxOutputDerivativeOrder
+	virtual fmippSize maxOutputDerivativeOrder() const;
+
+	/// \copydoc FMUCoSimulationBase::canRunAsynchronuously
+	virtual fmippBoolean canRunAsynchronuously() const;
+
+	/// \copydoc FMUCoSimulationBase::canSignalEvents
+	virtual fmippBoolean canSignalEvents() const;
+
+	/// \copydoc FMUCoSimulationBase::canBeInstantiatedOnlyOncePerProcess
+	virtual fmippBoolean canBeInstantiatedOnlyOncePerProcess() const;
+
+	/// \copydoc FMUCoSimulationBase::canNotUseMemoryManagementFunctions
+	virtual fmippBoolean canNotUseMemoryManagementFunctions() const;
+
+	/// \copydoc FMUBase::sendDebugMessage
+	virtual void sendDebugMessage( const fmippString& msg ) const;
+
+private:
+
+	RemoteFMUCoSimulation( const RemoteFMUCoSimulation& ); ///< Prevent calling the copy constructor.
+	RemoteFMUCoSimulation& operator=( const RemoteFMUCoSimulation& ); ///< Prevent calling the assignment operator.
+
+	/// Parse the model description and build the variable index.
+	fmippBoolean readModelDescription( const fmippString& fmuDirUrl );
+
+	/// Start the worker process and wait until it has loaded the FMU.
+	fmippBoolean startWorker( const fmippString& fmuDirUrl, const fmippString& modelIdentifier,
+		const fmippString& workerPath );
+
+	/// Send the collected commands plus the given command to the worker and wait for the response.
+	fmippStatus call( RemoteFMUMessage& response );
+
+	/// Read a capability flag from the model description (false if not available).
+	fmippBoolean getCapability( const fmippString& attributeName ) const;
+
+	/// Find a variable of the given type.
+	const VariableHandle* findVariable( const fmippString& name, FMIPPVariableType type );
+
+	template<typename Type>
+	fmippStatus getValues( RemoteFMUCommand command, const fmippValueReference* valref, Type* val, fmippSize ival );
+
+	template<typename Type>
+	fmippStatus setValues( RemoteFMUCommand command, const fmippValueReference* valref, const Type* val, fmippSize ival );
+
+	std::unique_ptr<ModelDescription> description_; ///< Model description (parsed by the proxy).
+	VariableIndex varIndex_; ///< Maps variable names to value references and types.
+
+	std::unique_ptr<RemoteFMUChannel> channel_; ///< Shared-memory channel to the worker.
+	mutable pid_t workerPid_; ///< Process ID of the worker (0 if not running).
+
+	RemoteFMUMessage pending_; ///< Collected commands (sent with the next call).
+
+	fmippTime time_; ///< Current time of the FMU.
+	fmippStatus lastStatus_; ///< Status of the last operation.
+
+};
+
+
+#endif // _FMIPP_REMOTEFMUCOSIMULATION_H
@@ -16,6 +16,12 @@
  * \class RollbackFMU RollbackFMU.h 
  *  This class allows to perform rollbacks to times not longer
  *  ago than the previous update (or a saved internal state).
+ *
+ *  If an FMI 2.0 model supports getting and setting its internal state
+ *  (capability flag canGetAndSetFMUstate), rollback states are stored as
+ *  native FMU states, which also include the discrete states of the model.
+ *  The handle of the native FMU state is reused for all rollback states.
+ *  Otherwise only the continuous states are stored.
  **/
 
 class __FMI_DLL RollbackFMU
@@ -102,6 +108,18 @@ private:
 	/** pointer to fmu instance **/
 	FMUModelExchangeBase* fmu_;
 
+	/** pointer to fmu instance, in case it supports getting and setting its state (otherwise null) **/
+	fmi_2_0::FMUModelExchange* fmuWithState_;
+
+	/** native FMU state used as rollback state (reused, null until the first state is saved) **/
+	fmi2FMUstate rollbackFMUState_;
+
+	/** event info of the FMU at the time the native FMU state was saved (e.g., the time of the next time event) **/
+	fmi2EventInfo rollbackEventInfo_;
+
+	/** Store the current state of the FMU as rollback state. **/
+	void storeRollbackState();
+
 	/**  prevent calling the default constructor **/
 	RollbackFMU();
 
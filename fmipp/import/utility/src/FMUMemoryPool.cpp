@@ -0,0 +1,215 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file FMUMemoryPool.cpp
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <stdint.h>
+
+#include "import/utility/include/FMUMemoryPool.h"
+
+using namespace std;
+
+
+/// Header in front of every block (16 bytes, preserves the alignment of the blocks).
+struct FMUMemoryPool::BlockHeader
+{
+	uint64_t sizeClass; ///< Size class of the block (largeBlock for blocks allocated directly from the heap).
+	uint64_t size; ///< Number of bytes requested by the FMU.
+};
+
+
+namespace {
+
+	// Size of the smallest size class.
+	const fmippSize minBlockSize = 16;
+
+	// Number of size classes (16, 32, ..., FMUMemoryPool::maxPooledBlockSize bytes).
+	const fmippSize nSizeClasses = 8;
+
+	// Size class of blocks allocated directly from the heap.
+	const uint64_t largeBlock = numeric_limits<uint64_t>::max();
+
+	// Pools bound to the callback functions.
+	FMUMemoryPool* poolSlots[FMUMemoryPool::maxPoolsWithCallbacks] = { 0 };
+
+	// Protects the pool slots.
+	mutex poolSlotsMutex;
+
+	// Callback functions bound to a pool slot.
+	template<fmippSize Slot>
+	struct SlotCallbacks
+	{
+		static void* allocateMemory( size_t nobj, size_t size ) { return poolSlots[Slot]->allocate( nobj, size ); }
+		static void freeMemory( void* obj ) { poolSlots[Slot]->release( obj ); }
+	};
+
+	// Table of the callback functions of all pool slots.
+	struct SlotCallbackTable
+	{
+		fmi2::fmi2CallbackAllocateMemory allocateMemory[FMUMemoryPool::maxPoolsWithCallbacks];
+		fmi2::fmi2CallbackFreeMemory freeMemory[FMUMemoryPool::maxPoolsWithCallbacks];
+
+		SlotCallbackTable() { fill<FMUMemoryPool::maxPoolsWithCallbacks>(); }
+
+		template<fmippSize N>
+		typename std::enable_if<( N > 0 )>::type fill()
+		{
+			allocateMemory[N - 1] = &SlotCallbacks<N - 1>::allocateMemory;
+			freeMemory[N - 1] = &SlotCallbacks<N - 1>::freeMemory;
+			fill<N - 1>();
+		}
+
+		template<fmippSize N>
+		typename std::enable_if<( N == 0 )>::type fill() {}
+	};
+
+	const SlotCallbackTable slotCallbacks;
+
+	// Get the size class for blocks of the given size.
+	fmippSize getSizeClass( fmippSize bytes )
+	{
+		fmippSize sizeClass = 0;
+		while ( ( minBlockSize << sizeClass ) < bytes ) ++sizeClass;
+		return sizeClass;
+	}
+
+}
+
+
+FMUMemoryPool::FMUMemoryPool( fmippSize chunkSize ) :
+	chunkSize_( max( chunkSize, sizeof( BlockHeader ) + maxPooledBlockSize ) ),
+	slot_( maxPoolsWithCallbacks ),
+	chunkPos_( 0 ),
+	chunkEnd_( 0 ),
+	freeLists_( nSizeClasses, static_cast<void*>( 0 ) ),
+	liveBytes_( 0 ),
+	peakBytes_( 0 ),
+	allocationCount_( 0 ),
+	liveAllocations_( 0 ),
+	reservedBytes_( 0 )
+{
+	lock_guard<mutex> lock( poolSlotsMutex );
+	for ( fmippSize i = 0; i < maxPoolsWithCallbacks; ++i ) {
+		if ( 0 == poolSlots[i] ) {
+			poolSlots[i] = this;
+			slot_ = i;
+			break;
+		}
+	}
+}
+
+
+FMUMemoryPool::~FMUMemoryPool()
+{
+	if ( hasCallbacks() ) {
+		lock_guard<mutex> lock( poolSlotsMutex );
+		poolSlots[slot_] = 0;
+	}
+
+	// Large blocks still in use (i.e., leaked by the FMU) are not released.
+	for ( vector<char*>::iterator it = chunks_.begin(); it != chunks_.end(); ++it ) free( *it );
+}
+
+
+fmi2::fmi2CallbackAllocateMemory
+FMUMemoryPool::getAllocateMemoryCallback() const
+{
+	return hasCallbacks() ? slotCallbacks.allocateMemory[slot_] : 0;
+}
+
+
+fmi2::fmi2CallbackFreeMemory
+FMUMemoryPool::getFreeMemoryCallback() const
+{
+	return hasCallbacks() ? slotCallbacks.freeMemory[slot_] : 0;
+}
+
+
+void*
+FMUMemoryPool::allocate( fmippSize nobj, fmippSize size )
+{
+	if ( ( 0 != size ) && ( nobj > numeric_limits<fmippSize>::max() / size ) ) return 0;
+	const fmippSize bytes = max<fmippSize>( nobj * size, 1 );
+
+	BlockHeader* header = 0;
+
+	if ( bytes <= maxPooledBlockSize ) {
+		fmippSize sizeClass = getSizeClass( bytes );
+		header = reinterpret_cast<BlockHeader*>( takeBlock( sizeClass ) );
+		if ( 0 == header ) return 0;
+		header->sizeClass = sizeClass;
+		memset( header + 1, 0, bytes );
+	} else {
+		if ( bytes > numeric_limits<fmippSize>::max() - sizeof( BlockHeader ) ) return 0;
+		header = static_cast<BlockHeader*>( calloc( 1, sizeof( BlockHeader ) + bytes ) );
+		if ( 0 == header ) return 0;
+		header->sizeClass = largeBlock;
+		reservedBytes_ += sizeof( BlockHeader ) + bytes;
+	}
+
+	header->size = bytes;
+
+	liveBytes_ += bytes;
+	peakBytes_ = max( peakBytes_, liveBytes_ );
+	++allocationCount_;
+	++liveAllocations_;
+
+	return header + 1;
+}
+
+
+void
+FMUMemoryPool::release( void* obj )
+{
+	if ( 0 == obj ) return;
+
+	BlockHeader* header = static_cast<BlockHeader*>( obj ) - 1;
+
+	liveBytes_ -= header->size;
+	--liveAllocations_;
+
+	if ( largeBlock == header->sizeClass ) {
+		reservedBytes_ -= sizeof( BlockHeader ) + header->size;
+		free( header );
+	} else {
+		// Put block on the free list of its size class (the link is stored in the block itself).
+		*static_cast<void**>( obj ) = freeLists_[header->sizeClass];
+		freeLists_[header->sizeClass] = header;
+	}
+}
+
+
+char*
+FMUMemoryPool::takeBlock( fmippSize sizeClass )
+{
+	if ( 0 != freeLists_[sizeClass] ) {
+		char* block = static_cast<char*>( freeLists_[sizeClass] );
+		freeLists_[sizeClass] = *reinterpret_cast<void**>( block + sizeof( BlockHeader ) );
+		return block;
+	}
+
+	const fmippSize blockSize = sizeof( BlockHeader ) + ( minBlockSize << sizeClass );
+
+	if ( static_cast<fmippSize>( chunkEnd_ - chunkPos_ ) < blockSize ) {
+		char* chunk = static_cast<char*>( malloc( chunkSize_ ) );
+		if ( 0 == chunk ) return 0;
+		chunks_.push_back( chunk );
+		reservedBytes_ += chunkSize_;
+		chunkPos_ = chunk;
+		chunkEnd_ = chunk + chunkSize_;
+	}
+
+	char* block = chunkPos_;
+	chunkPos_ += blockSize;
+	return block;
+}
@@ -8,6 +8,7 @@
  */ 
 
 #include <stdlib.h>
+#include <cassert>
 
 #include "import/utility/include/History.h"
 
@@ -116,8 +117,10 @@ HistoryEntry::HistoryEntry( const HistoryEntry& aHistoryEntry )
 	}
 }
 
-HistoryEntry& HistoryEntry::operator=( HistoryEntry aHistoryEntry )
+HistoryEntry& HistoryEntry::operator=( const HistoryEntry& aHistoryEntry )
 {
+	if ( this == &aHistoryEntry ) return *this;
+
 	time_ = aHistoryEntry.time_;
 	if ( nStates_ != aHistoryEntry.nStates_ ) {
 		nStates_ = aHistoryEntry.nStates_;
@@ -166,3 +169,160 @@ HistoryEntry& HistoryEntry::operator=( HistoryEntry aHistoryEntry )
 
 	return *this;
 }
+
+
+namespace {
+
+	// Number of fmippReal elements needed to store n elements of type T.
+	template<typename T>
+	fmippSize arenaSize( fmippSize n )
+	{
+		return ( n*sizeof( T ) + sizeof( fmippReal ) - 1 ) / sizeof( fmippReal );
+	}
+
+}
+
+HistoryBuffer::HistoryBuffer() :
+	capacity_( 0 ), head_( 0 ), size_( 0 ),
+	nStates_( 0 ), nRealValues_( 0 ), nIntegerValues_( 0 ), nBooleanValues_( 0 ), nStringValues_( 0 ),
+	arena_( NULL ), strings_( NULL ),
+	time_( NULL ), state_( NULL ), realValues_( NULL ), integerValues_( NULL ), booleanValues_( NULL )
+{}
+
+HistoryBuffer::~HistoryBuffer()
+{
+	delete [] arena_;
+	delete [] strings_;
+}
+
+void HistoryBuffer::reserve( fmippSize capacity, fmippSize nStates, fmippSize nRealValues, fmippSize nIntegerValues, fmippSize nBooleanValues, fmippSize nStringValues )
+{
+	clear();
+
+	if ( ( nStates_ != nStates ) || ( nRealValues_ != nRealValues ) || ( nIntegerValues_ != nIntegerValues ) ||
+	     ( nBooleanValues_ != nBooleanValues ) || ( nStringValues_ != nStringValues ) )
+	{
+		delete [] arena_;
+		delete [] strings_;
+		arena_ = NULL;
+		strings_ = NULL;
+		capacity_ = 0;
+
+		nStates_ = nStates;
+		nRealValues_ = nRealValues;
+		nIntegerValues_ = nIntegerValues;
+		nBooleanValues_ = nBooleanValues;
+		nStringValues_ = nStringValues;
+	}
+
+	if ( capacity > capacity_ ) allocate( capacity );
+}
+
+void HistoryBuffer::push_back( const HistoryEntry& entry )
+{
+	if ( size_ == capacity_ ) allocate( capacity_ ? 2*capacity_ : 1 );
+	write( slot( size_ ), entry );
+	++size_;
+}
+
+void HistoryBuffer::pop_front()
+{
+	assert( size_ > 0 );
+	head_ = slot( 1 );
+	--size_;
+	if ( 0 == size_ ) head_ = 0;
+}
+
+void HistoryBuffer::set( fmippSize i, const HistoryEntry& entry )
+{
+	assert( i < size_ );
+	write( slot( i ), entry );
+}
+
+void HistoryBuffer::get( fmippSize i, HistoryEntry& entry ) const
+{
+	assert( i < size_ );
+	const fmippSize s = slot( i );
+
+	if ( ( entry.nStates_ != nStates_ ) || ( entry.nRealValues_ != nRealValues_ ) || ( entry.nIntegerValues_ != nIntegerValues_ ) ||
+	     ( entry.nBooleanValues_ != nBooleanValues_ ) || ( entry.nStringValues_ != nStringValues_ ) )
+	{
+		entry = HistoryEntry( nStates_, nRealValues_, nIntegerValues_, nBooleanValues_, nStringValues_ );
+	}
+
+	entry.time_ = time_[s];
+	for ( fmippSize j = 0; j < nStates_; ++j ) entry.state_[j] = state_[j*capacity_ + s];
+	for ( fmippSize j = 0; j < nRealValues_; ++j ) entry.realValues_[j] = realValues_[j*capacity_ + s];
+	for ( fmippSize j = 0; j < nIntegerValues_; ++j ) entry.integerValues_[j] = integerValues_[j*capacity_ + s];
+	for ( fmippSize j = 0; j < nBooleanValues_; ++j ) entry.booleanValues_[j] = booleanValues_[j*capacity_ + s];
+	for ( fmippSize j = 0; j < nStringValues_; ++j ) entry.stringValues_[j] = strings_[j*capacity_ + s];
+}
+
+fmippSize HistoryBuffer::findLast( fmippTime t ) const
+{
+	// Binary search for the first entry with a time stamp greater than t.
+	fmippSize low = 0;
+	fmippSize high = size_;
+	while ( low < high ) {
+		fmippSize mid = low + ( high - low )/2;
+		if ( time( mid ) <= t ) low = mid + 1; else high = mid;
+	}
+	return ( 0 == low ) ? size_ : low - 1;
+}
+
+void HistoryBuffer::allocate( fmippSize capacity )
+{
+	assert( capacity >= size_ );
+
+	const fmippSize nReals = ( 1 + nStates_ + nRealValues_ )*capacity;
+	const fmippSize nIntegers = arenaSize<fmippInteger>( nIntegerValues_*capacity );
+	const fmippSize nBooleans = arenaSize<fmippBoolean>( nBooleanValues_*capacity );
+
+	fmippReal* arena = new fmippReal[nReals + nIntegers + nBooleans];
+	fmippString* strings = nStringValues_ ? new fmippString[nStringValues_*capacity] : NULL;
+
+	fmippTime* time = arena;
+	fmippReal* state = time + capacity;
+	fmippReal* realValues = state + nStates_*capacity;
+	fmippInteger* integerValues = reinterpret_cast<fmippInteger*>( arena + nReals );
+	fmippBoolean* booleanValues = reinterpret_cast<fmippBoolean*>( arena + nReals + nIntegers );
+
+	// Move the current entries to the beginning of the new columns.
+	for ( fmippSize i = 0; i < size_; ++i ) {
+		const fmippSize s = slot( i );
+		time[i] = time_[s];
+		for ( fmippSize j = 0; j < nStates_; ++j ) state[j*capacity + i] = state_[j*capacity_ + s];
+		for ( fmippSize j = 0; j < nRealValues_; ++j ) realValues[j*capacity + i] = realValues_[j*capacity_ + s];
+		for ( fmippSize j = 0; j < nIntegerValues_; ++j ) integerValues[j*capacity + i] = integerValues_[j*capacity_ + s];
+		for ( fmippSize j = 0; j < nBooleanValues_; ++j ) booleanValues[j*capacity + i] = booleanValues_[j*capacity_ + s];
+		for ( fmippSize j = 0; j < nStringValues_; ++j ) strings[j*capacity + i].swap( strings_[j*capacity_ + s] );
+	}
+
+	delete [] arena_;
+	delete [] strings_;
+
+	arena_ = arena;
+	strings_ = strings;
+	time_ = time;
+	state_ = state;
+	realValues_ = realValues;
+	integerValues_ = integerValues;
+	booleanValues_ = booleanValues;
+
+	capacity_ = capacity;
+	head_ = 0;
+}
+
+void HistoryBuffer::write( fmippSize s, const HistoryEntry& entry )
+{
+	assert( ( entry.nStates_ == nStates_ ) && ( entry.nRealValues_ == nRealValues_ ) &&
+		( entry.nIntegerValues_ == nIntegerValues_ ) && ( entry.nBooleanValues_ == nBooleanValues_ ) &&
+		( entry.nStringValues_ == nStringValues_ ) );
+
+	time_[s] = entry.time_;
+	for ( fmippSize j = 0; j < nStates_; ++j ) state_[j*capacity_ + s] = entry.state_[j];
+	for ( fmippSize j = 0; j < nRealValues_; ++j ) realValues_[j*capacity_ + s] = entry.realValues_[j];
+	for ( fmippSize j = 0; j < nIntegerValues_; ++j ) integerValues_[j*capacity_ + s] = entry.integerValues_[j];
+	for ( fmippSize j = 0; j < nBooleanValues_; ++j ) booleanValues_[j*capacity_ + s] = entry.booleanValues_[j];
+	for ( fmippSize j = 0; j < nStringValues_; ++j ) strings_[j*capacity_ + s] = entry.stringValues_[j];
+}
@@ -0,0 +1,208 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file IOPlan.cpp
+ */
+
+#include <algorithm>
+
+#include "import/base/include/FMUCoSimulation_v2.h"
+
+#include "import/utility/include/IOPlan.h"
+
+using namespace std;
+
+
+namespace {
+
+	// Set all values of a batch (if not empty), return the most severe status.
+	template<typename Type, typename BatchType>
+	fmippStatus setBatch( fmi_2_0::FMUCoSimulation& fmu, BatchType& batch, fmippStatus status )
+	{
+		if ( 0 == batch.size ) return status;
+		fmippStatus s = fmu.setValue( &batch.valueRefs[0], static_cast<const Type*>( batch.values.get() ), batch.size );
+		return max( status, s );
+	}
+
+	// Get all values of a batch (if not empty), return the most severe status.
+	template<typename BatchType>
+	fmippStatus getBatch( fmi_2_0::FMUCoSimulation& fmu, BatchType& batch, fmippStatus status )
+	{
+		if ( 0 == batch.size ) return status;
+		fmippStatus s = fmu.getValue( &batch.valueRefs[0], batch.values.get(), batch.size );
+		return max( status, s );
+	}
+
+}
+
+
+IOPlan::IOPlan( const fmi_2_0::FMUCoSimulation& fmu,
+	const vector<fmippString>& inputNames,
+	const vector<fmippString>& outputNames ) :
+	valid_( false )
+{
+	fmippBoolean inputsValid = compile( fmu, inputNames, inputs_, inputBatches_ );
+	fmippBoolean outputsValid = compile( fmu, outputNames, outputs_, outputBatches_ );
+	valid_ = inputsValid && outputsValid;
+}
+
+
+IOPlan::IOPlan( const IOPlan& plan ) :
+	inputs_( plan.inputs_ ),
+	outputs_( plan.outputs_ ),
+	inputBatches_( plan.inputBatches_ ),
+	outputBatches_( plan.outputBatches_ ),
+	valid_( plan.valid_ )
+{}
+
+
+fmippBoolean
+IOPlan::compile( const fmi_2_0::FMUCoSimulation& fmu,
+	const vector<fmippString>& names,
+	vector<Slot>& slots,
+	Batches& batches )
+{
+	fmippBoolean valid = true;
+
+	slots.reserve( names.size() );
+
+	for ( vector<fmippString>::const_iterator it = names.begin(); it != names.end(); ++it )
+	{
+		VariableHandle handle = fmu.getVariableHandle( *it );
+
+		Slot slot;
+		slot.type = handle.type;
+		slot.index = 0;
+
+		switch ( handle.type )
+		{
+		case fmippTypeReal:
+			slot.index = batches.real.valueRefs.size();
+			batches.real.valueRefs.push_back( handle.valueReference );
+			break;
+		case fmippTypeInteger:
+			slot.index = batches.integer.valueRefs.size();
+			batches.integer.valueRefs.push_back( handle.valueReference );
+			break;
+		case fmippTypeBoolean:
+			slot.index = batches.boolean.valueRefs.size();
+			batches.boolean.valueRefs.push_back( handle.valueReference );
+			break;
+		case fmippTypeString:
+			slot.index = batches.string.valueRefs.size();
+			batches.string.valueRefs.push_back( handle.valueReference );
+			break;
+		case fmippTypeUnknown:
+			valid = false;
+			break;
+		}
+
+		slots.push_back( slot );
+	}
+
+	batches.real.allocate();
+	batches.integer.allocate();
+	batches.boolean.allocate();
+	batches.string.allocate();
+
+	return valid;
+}
+
+
+fmippBoolean
+IOPlan::setInput( fmippSize i, const fmippReal& val )
+{
+	if ( fmippTypeReal != inputs_[i].type ) return false;
+	inputBatches_.real.values[inputs_[i].index] = val;
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::setInput( fmippSize i, const fmippInteger& val )
+{
+	if ( fmippTypeInteger != inputs_[i].type ) return false;
+	inputBatches_.integer.values[inputs_[i].index] = val;
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::setInput( fmippSize i, const fmippBoolean& val )
+{
+	if ( fmippTypeBoolean != inputs_[i].type ) return false;
+	inputBatches_.boolean.values[inputs_[i].index] = val;
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::setInput( fmippSize i, const fmippString& val )
+{
+	if ( fmippTypeString != inputs_[i].type ) return false;
+	inputBatches_.string.values[inputs_[i].index] = val;
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::getOutput( fmippSize i, fmippReal& val ) const
+{
+	if ( fmippTypeReal != outputs_[i].type ) return false;
+	val = outputBatches_.real.values[outputs_[i].index];
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::getOutput( fmippSize i, fmippInteger& val ) const
+{
+	if ( fmippTypeInteger != outputs_[i].type ) return false;
+	val = outputBatches_.integer.values[outputs_[i].index];
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::getOutput( fmippSize i, fmippBoolean& val ) const
+{
+	if ( fmippTypeBoolean != outputs_[i].type ) return false;
+	val = outputBatches_.boolean.values[outputs_[i].index];
+	return true;
+}
+
+
+fmippBoolean
+IOPlan::getOutput( fmippSize i, fmippString& val ) const
+{
+	if ( fmippTypeString != outputs_[i].type ) return false;
+	val = outputBatches_.string.values[outputs_[i].index];
+	return true;
+}
+
+
+fmippStatus
+IOPlan::applyInputs( fmi_2_0::FMUCoSimulation& fmu )
+{
+	fmippStatus status = fmippOK;
+	status = setBatch<fmippReal>( fmu, inputBatches_.real, status );
+	status = setBatch<fmippInteger>( fmu, inputBatches_.integer, status );
+	status = setBatch<fmippBoolean>( fmu, inputBatches_.boolean, status );
+	status = setBatch<fmippString>( fmu, inputBatches_.string, status );
+	return status;
+}
+
+
+fmippStatus
+IOPlan::fetchOutputs( fmi_2_0::FMUCoSimulation& fmu )
+{
+	fmippStatus status = fmippOK;
+	status = getBatch( fmu, outputBatches_.real, status );
+	status = getBatch( fmu, outputBatches_.integer, status );
+	status = getBatch( fmu, outputBatches_.boolean, status );
+	status = getBatch( fmu, outputBatches_.string, status );
+	return status;
+}
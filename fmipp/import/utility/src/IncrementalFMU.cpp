@@ -106,6 +106,22 @@ Integrator::Properties IncrementalFMU::getIntegratorProperties() const
 	return fmu_->getIntegratorProperties();
 }
 
+void IncrementalFMU::enableIntegratorStatistics( fmippBoolean enable )
+{
+	assert( fmu_ );
+	if ( !fmu_ ) return;
+
+	fmu_->enableIntegratorStatistics( enable );
+}
+
+const Integrator::Statistics* IncrementalFMU::getIntegratorStatistics() const
+{
+	assert( fmu_ );
+	if ( !fmu_ ) return 0;
+
+	return static_cast<const FMUModelExchangeBase*>( fmu_ )->getIntegratorStatistics();
+}
+
 FMIPPVariableType IncrementalFMU::getType( const fmippString& varName ) const
 {
 	return fmu_->getType( varName );
@@ -402,11 +418,14 @@ int IncrementalFMU::init( const fmippString& instanceName,
 	fmu_->raiseEvent(); // ... then raise an event ...
 	fmu_->handleEvents(); // ... and finally take proper actions.
 	retrieveFMUState( init.state_, init.realValues_, init.integerValues_, init.booleanValues_, init.stringValues_ ); // Then retrieve the result and ...
-	predictions_.push_back( init ); // ... store as prediction -> will be used by first call to updateState().
 
-	predictions_[0] = predictions_[0];
+	// Reserve space for all predictions of a look-ahead (the initial prediction plus one per look-ahead step).
+	fmippSize nPredictions = static_cast<fmippSize>( ceil( lookAheadHorizon / lookAheadStepSize ) ) + 2;
+	predictions_.reserve( nPredictions, fmu_->nStates(), nRealOutputs_, nIntegerOutputs_, nBooleanOutputs_, nStringOutputs_ );
+	predictions_.push_back( init ); // ... store as prediction -> will be used by first call to updateState().
 
 	currentState_ = init;
+	prediction_ = init;
 
 	lookAheadHorizon_ = lookAheadHorizon;
 	lookaheadStepSize_ = lookAheadStepSize;
@@ -416,22 +435,24 @@ int IncrementalFMU::init( const fmippString& instanceName,
 }
 
 /* In case no look-ahead prediction is given for time t, this function is responsible to provide
- * an estimate for the corresponding state. For convenience, a REVERSE iterator pointing to the
- * next prediction available AFTER time t is handed over to the function.
+ * an estimate for the corresponding state. For convenience, the index of the last prediction
+ * available BEFORE time t is handed over to the function (the next prediction follows it).
  */
 void IncrementalFMU::interpolateState( fmippTime t,
-	History::const_reverse_iterator& historyEntry,
+	fmippSize left,
 	HistoryEntry& result )
 {
-	const HistoryEntry& right = *(historyEntry-1);
-	const HistoryEntry& left = *(historyEntry);
+	const fmippSize right = left + 1;
+	const fmippTime leftTime = predictions_.time( left );
+	const fmippTime rightTime = predictions_.time( right );
 
-	for ( fmippSize i = 0; i < fmu_->nStates(); ++i ) {
-		result.state_[i] = interpolateValue( t, left.time_, left.state_[i], right.time_, right.state_[i] );
+	// Read the values directly from the columns of the prediction buffer.
+	for ( fmippSize i = 0; i < predictions_.nStates(); ++i ) {
+		result.state_[i] = interpolateValue( t, leftTime, predictions_.state( left, i ), rightTime, predictions_.state( right, i ) );
 	}
 
 	for ( fmippSize i = 0; i < nRealOutputs_; ++i ) {
-		result.realValues_[i] = interpolateValue( t, left.time_, left.realValues_[i], right.time_, right.realValues_[i] );
+		result.realValues_[i] = interpolateValue( t, leftTime, predictions_.realValue( left, i ), rightTime, predictions_.realValue( right, i ) );
 	}
 
 	// no sense in interpolating other values.
@@ -493,8 +514,8 @@ fmippTime IncrementalFMU::sync( fmippTime t0, fmippTime t1, fmippReal* realInput
 
 void IncrementalFMU::getState( fmippTime t, HistoryEntry& state )
 {
-	fmippTime oldestPredictionTime = predictions_.front().time_;
-	fmippTime newestPredictionTime = predictions_.back().time_;
+	fmippTime oldestPredictionTime = predictions_.frontTime();
+	fmippTime newestPredictionTime = predictions_.backTime();
 
 	// Check if time stamp t is within the range of the predictions.
 	if ( ( t <= oldestPredictionTime - timeDiffResolution_ ) ||
@@ -509,30 +530,22 @@ void IncrementalFMU::getState( fmippTime t, HistoryEntry& state )
 		fmu_->setTime( t );
 	}
 
-	// Search the previous predictions for the state at time t. The search is
-	// performed from back to front, because the last entry is hopefully the
-	// correct one ...
-	History::const_reverse_iterator itFind = predictions_.rbegin();
-	History::const_reverse_iterator itEnd = predictions_.rend();
-	for ( ; itFind != itEnd; ++itFind ) {
-
-		if ( fabs( t - itFind->time_ ) <= timeDiffResolution_ ) {
-			state = *itFind;
-			/* should not be necessary, remove again, but have a look ;) !!!
-			   if ( t < newestPredictionTime ) {
-			   fmu_->setContinuousStates(state.state);
-			   fmu_->rewindTime( newestPredictionTime - t );
-			   }
-			*/
-			return;
-		}
-		if ( t > itFind->time_ ) {
-			interpolateState(t, itFind, state);
-			return;
-		}
+	// Search the previous predictions for the state at time t, i.e., for the newest
+	// prediction that is not later than t (within the time resolution). Since the
+	// predictions are ordered in time, a binary search can be used.
+	fmippSize iFind = predictions_.findLast( t + timeDiffResolution_ );
+
+	if ( iFind == predictions_.size() ) {
+		state.time_ = INVALID_FMI_TIME;
+		return;
+	}
+
+	if ( fabs( t - predictions_.time( iFind ) ) <= timeDiffResolution_ ) {
+		predictions_.get( iFind, state );
+		return;
 	}
 
-	state.time_ = INVALID_FMI_TIME;
+	interpolateState( t, iFind, state );
 }
 
 /* Apply the most recent prediction and make a state update. */
@@ -568,7 +581,7 @@ fmippTime IncrementalFMU::updateStateFromTheRight( fmippTime t1 )
 	// Decide whether to use the right hand side limit
 	// Just a hint, prediction horizon may be reached without an event.
 	bool eventFlag = !predictions_.empty()
-		&& fabs(predictions_.back().time_ - t1) < timeDiffResolution_;
+		&& fabs(predictions_.backTime() - t1) < timeDiffResolution_;
 
 	fmippTime ret = updateState(t1);
 
@@ -590,7 +603,7 @@ fmippTime IncrementalFMU::updateStateFromTheRight( fmippTime t1 )
 
 		initializeIntegration( currentState_ );
 
-		predictions_.back() = currentState_;
+		predictions_.set( predictions_.size() - 1, currentState_ );
 	}
 
 	return ret;
@@ -614,7 +627,7 @@ fmippTime IncrementalFMU::predictState( fmippTime t1 )
 	predictions_.clear();
 
 	// Initialize the first state and the FMU.
-	HistoryEntry prediction;
+	HistoryEntry& prediction = prediction_;
 
 	prediction = currentState_;
 	prediction.time_ = t1;
@@ -0,0 +1,251 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file RemoteFMUChannel.cpp
+ */
+
+#include <cerrno>
+#include <ctime>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "import/utility/include/RemoteFMUChannel.h"
+
+using namespace std;
+
+
+/// Ring buffer for messages (each message is preceded by its length).
+struct RemoteFMUChannel::Ring
+{
+	sem_t ready; ///< Counts the messages available for reading.
+	uint64_t head; ///< Total number of bytes written.
+	uint64_t tail; ///< Total number of bytes read.
+};
+
+
+/// Layout of the beginning of the shared memory segment (followed by the data of both rings).
+struct RemoteFMUChannel::Header
+{
+	uint64_t magic;
+	uint64_t capacity;
+	Ring request;
+	Ring response;
+};
+
+
+namespace {
+
+	const uint64_t channelMagic = 0x464d554348414e31ULL; // "FMUCHAN1"
+
+	// Time slice for waiting on messages before checking if the counterpart is alive.
+	const long waitSliceInNs = 100000000;
+
+	// Copy data into the ring buffer, wrapping around at its end.
+	void copyToRing( char* ring, uint64_t capacity, uint64_t pos, const char* src, uint64_t n )
+	{
+		uint64_t offset = pos % capacity;
+		uint64_t first = min( n, capacity - offset );
+		memcpy( ring + offset, src, first );
+		memcpy( ring, src + first, n - first );
+	}
+
+	// Copy data from the ring buffer, wrapping around at its end.
+	void copyFromRing( const char* ring, uint64_t capacity, uint64_t pos, char* dest, uint64_t n )
+	{
+		uint64_t offset = pos % capacity;
+		uint64_t first = min( n, capacity - offset );
+		memcpy( dest, ring + offset, first );
+		memcpy( dest + first, ring, n - first );
+	}
+
+}
+
+
+fmippBoolean
+RemoteFMUMessage::get( fmippString& val )
+{
+	fmippSize n;
+	if ( false == get( n ) ) return false;
+	if ( n > data_.size() - pos_ ) return false;
+	val.assign( data_, pos_, n );
+	pos_ += n;
+	return true;
+}
+
+
+RemoteFMUChannel*
+RemoteFMUChannel::create( const fmippString& name, fmippSize capacity )
+{
+	int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR );
+	if ( -1 == fd ) return 0;
+
+	fmippSize segmentSize = sizeof( Header ) + 2 * capacity;
+	if ( -1 == ftruncate( fd, segmentSize ) ) {
+		close( fd );
+		shm_unlink( name.c_str() );
+		return 0;
+	}
+
+	void* segment = mmap( 0, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	if ( MAP_FAILED == segment ) {
+		shm_unlink( name.c_str() );
+		return 0;
+	}
+
+	Header* header = static_cast<Header*>( segment );
+	header->capacity = capacity;
+	header->request.head = header->request.tail = 0;
+	header->response.head = header->response.tail = 0;
+	sem_init( &header->request.ready, 1, 0 );
+	sem_init( &header->response.ready, 1, 0 );
+	header->magic = channelMagic;
+
+	return new RemoteFMUChannel( name, segment, segmentSize, true );
+}
+
+
+RemoteFMUChannel*
+RemoteFMUChannel::open( const fmippString& name )
+{
+	int fd = shm_open( name.c_str(), O_RDWR, 0 );
+	if ( -1 == fd ) return 0;
+
+	struct stat info;
+	if ( -1 == fstat( fd, &info ) || static_cast<fmippSize>( info.st_size ) < sizeof( Header ) ) {
+		close( fd );
+		return 0;
+	}
+
+	void* segment = mmap( 0, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	if ( MAP_FAILED == segment ) return 0;
+
+	const Header* header = static_cast<const Header*>( segment );
+	if ( ( channelMagic != header->magic ) ||
+		( sizeof( Header ) + 2 * header->capacity != static_cast<uint64_t>( info.st_size ) ) ) {
+		munmap( segment, info.st_size );
+		return 0;
+	}
+
+	return new RemoteFMUChannel( name, segment, info.st_size, false );
+}
+
+
+RemoteFMUChannel::RemoteFMUChannel( const fmippString& name, void* segment,
+	fmippSize segmentSize, fmippBoolean owner ) :
+	name_( name ),
+	segment_( segment ),
+	segmentSize_( segmentSize ),
+	owner_( owner )
+{
+	header_ = static_cast<Header*>( segment_ );
+	capacity_ = header_->capacity;
+	requestData_ = static_cast<char*>( segment_ ) + sizeof( Header );
+	responseData_ = requestData_ + capacity_;
+}
+
+
+RemoteFMUChannel::~RemoteFMUChannel()
+{
+	if ( owner_ ) {
+		sem_destroy( &header_->request.ready );
+		sem_destroy( &header_->response.ready );
+	}
+
+	munmap( segment_, segmentSize_ );
+
+	if ( owner_ ) shm_unlink( name_.c_str() );
+}
+
+
+fmippBoolean
+RemoteFMUChannel::sendRequest( const RemoteFMUMessage& msg )
+{
+	return send( header_->request, requestData_, msg );
+}
+
+
+fmippBoolean
+RemoteFMUChannel::receiveRequest( RemoteFMUMessage& msg, const AliveCheck& alive )
+{
+	return receive( header_->request, requestData_, msg, alive );
+}
+
+
+fmippBoolean
+RemoteFMUChannel::sendResponse( const RemoteFMUMessage& msg )
+{
+	return send( header_->response, responseData_, msg );
+}
+
+
+fmippBoolean
+RemoteFMUChannel::receiveResponse( RemoteFMUMessage& msg, const AliveCheck& alive )
+{
+	return receive( header_->response, responseData_, msg, alive );
+}
+
+
+fmippBoolean
+RemoteFMUChannel::send( Ring& ring, char* data, const RemoteFMUMessage& msg )
+{
+	const uint64_t capacity = capacity_;
+	const uint64_t size = msg.data().size();
+	const uint64_t used = ring.head - ring.tail;
+
+	if ( used + sizeof( size ) + size > capacity ) return false;
+
+	copyToRing( data, capacity, ring.head, reinterpret_cast<const char*>( &size ), sizeof( size ) );
+	copyToRing( data, capacity, ring.head + sizeof( size ), msg.data().data(), size );
+	ring.head += sizeof( size ) + size;
+
+	// Posting the semaphore also makes the written data visible to the other process.
+	sem_post( &ring.ready );
+	return true;
+}
+
+
+fmippBoolean
+RemoteFMUChannel::receive( Ring& ring, const char* data, RemoteFMUMessage& msg, const AliveCheck& alive )
+{
+	while ( true )
+	{
+		struct timespec deadline;
+		clock_gettime( CLOCK_REALTIME, &deadline );
+		deadline.tv_nsec += waitSliceInNs;
+		if ( deadline.tv_nsec >= 1000000000 ) {
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+
+		if ( 0 == sem_timedwait( &ring.ready, &deadline ) ) break;
+
+		if ( ( ETIMEDOUT == errno ) && alive && ( false == alive() ) ) return false;
+	}
+
+	// The segment is shared with another process, i.e., neither the positions in the ring nor
+	// the length of the message are trusted.
+	const uint64_t capacity = capacity_;
+	const uint64_t available = ring.head - ring.tail;
+
+	uint64_t size = 0;
+	if ( ( available > capacity ) || ( available < sizeof( size ) ) ) return false;
+	copyFromRing( data, capacity, ring.tail, reinterpret_cast<char*>( &size ), sizeof( size ) );
+	if ( size > available - sizeof( size ) ) return false;
+
+	std::string buffer( size, '\0' );
+	copyFromRing( data, capacity, ring.tail + sizeof( size ), &buffer[0], size );
+	ring.tail += sizeof( size ) + size;
+
+	msg = RemoteFMUMessage( buffer );
+	return true;
+}
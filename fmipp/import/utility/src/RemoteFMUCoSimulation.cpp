@@ -0,0 +1,627 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file RemoteFMUCoSimulation.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "import/base/include/ModelDescription.h"
+#include "import/base/include/PathFromUrl.h"
+
+#include "import/utility/include/RemoteFMUCoSimulation.h"
+
+extern char **environ;
+
+using namespace std;
+
+
+namespace {
+
+	// Unique name of the shared memory segment used by a proxy.
+	string createChannelName()
+	{
+		static atomic<unsigned int> counter( 0 );
+		stringstream name;
+		name << "/fmipp_" << getpid() << "_" << counter++;
+		return name.str();
+	}
+
+	// Time (in seconds) granted to the worker for shutting down before it is killed.
+	const unsigned int shutdownGracePeriod = 5;
+
+}
+
+
+RemoteFMUCoSimulation::RemoteFMUCoSimulation( const fmippString& fmuDirUrl,
+	const fmippString& modelIdentifier,
+	const fmippBoolean loggingOn,
+	const fmippString& workerPath ) :
+	FMUCoSimulationBase( loggingOn ),
+	workerPid_( 0 ),
+	time_( numeric_limits<fmippTime>::quiet_NaN() ),
+	lastStatus_( fmippOK )
+{
+	if ( false == readModelDescription( fmuDirUrl ) ) {
+		cerr << "[RemoteFMUCoSimulation] unable to read model description of FMU "
+		     << modelIdentifier << " from " << fmuDirUrl << endl;
+		lastStatus_ = fmippFatal;
+		return;
+	}
+
+	if ( false == startWorker( fmuDirUrl, modelIdentifier, workerPath ) ) {
+		cerr << "[RemoteFMUCoSimulation] unable to start worker process for FMU " << modelIdentifier << endl;
+		lastStatus_ = fmippFatal;
+	}
+}
+
+
+RemoteFMUCoSimulation::~RemoteFMUCoSimulation()
+{
+	if ( isWorkerAlive() ) {
+		pending_.put<fmippUInt32>( remoteFMUShutdown );
+		channel_->sendRequest( pending_ );
+
+		// Give the worker some time to terminate the FMU and exit, kill it otherwise.
+		for ( unsigned int i = 0; i < 10 * shutdownGracePeriod && isWorkerAlive(); ++i ) usleep( 100000 );
+		if ( isWorkerAlive() ) {
+			kill( workerPid_, SIGKILL );
+			waitpid( workerPid_, 0, 0 );
+			workerPid_ = 0;
+		}
+	}
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::readModelDescription( const fmippString& fmuDirUrl )
+{
+	fmippString xmlFilePath;
+	if ( false == PathFromUrl::getPathFromUrl( fmuDirUrl + "/modelDescription.xml", xmlFilePath ) ) return false;
+
+	description_.reset( new ModelDescription( xmlFilePath ) );
+	if ( false == description_->isValid() ) return false;
+
+	typedef ModelDescription::ScalarVariables ScalarVariables;
+	const ScalarVariables& variables = description_->getScalarVariables();
+	varIndex_ = VariableIndex( variables.size() );
+
+	for ( ScalarVariables::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar ) {
+		varIndex_.insert( itVar->name, VariableHandle( itVar->valueReference, itVar->type ) );
+	}
+
+	return true;
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::startWorker( const fmippString& fmuDirUrl, const fmippString& modelIdentifier,
+	const fmippString& workerPath )
+{
+	channel_.reset( RemoteFMUChannel::create( createChannelName() ) );
+	if ( !channel_ ) return false;
+
+	fmippString logging = loggingOn_ ? "1" : "0";
+	char* argv[] = {
+		const_cast<char*>( workerPath.c_str() ),
+		const_cast<char*>( channel_->getName().c_str() ),
+		const_cast<char*>( fmuDirUrl.c_str() ),
+		const_cast<char*>( modelIdentifier.c_str() ),
+		const_cast<char*>( logging.c_str() ),
+		0
+	};
+
+	// Search the worker executable in PATH only if no directory is given.
+	pid_t pid = 0;
+	int err = ( fmippString::npos == workerPath.find( '/' ) ) ?
+		posix_spawnp( &pid, workerPath.c_str(), 0, 0, argv, environ ) :
+		posix_spawn( &pid, workerPath.c_str(), 0, 0, argv, environ );
+	if ( 0 != err ) return false;
+
+	workerPid_ = pid;
+
+	// Wait until the worker has loaded the FMU.
+	pending_.put<fmippUInt32>( remoteFMUPing );
+	RemoteFMUMessage response;
+	return fmippOK == call( response );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::isWorkerAlive() const
+{
+	if ( 0 == workerPid_ ) return false;
+
+	int status;
+	if ( 0 == waitpid( workerPid_, &status, WNOHANG ) ) return true;
+
+	workerPid_ = 0;
+	return false;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::call( RemoteFMUMessage& response )
+{
+	if ( false == isWorkerAlive() ) {
+		pending_.clear();
+		lastStatus_ = fmippFatal;
+		return lastStatus_;
+	}
+
+	fmippBoolean sent = channel_->sendRequest( pending_ );
+	pending_.clear();
+
+	if ( false == sent ) {
+		cerr << "[RemoteFMUCoSimulation] batch of commands exceeds capacity of channel" << endl;
+		lastStatus_ = fmippError;
+		return lastStatus_;
+	}
+
+	fmippUInt32 status = fmippFatal;
+	if ( ( false == channel_->receiveResponse( response, [this]() { return this->isWorkerAlive(); } ) ) ||
+		( false == response.get( status ) ) ) {
+		cerr << "[RemoteFMUCoSimulation] worker process terminated unexpectedly" << endl;
+		lastStatus_ = fmippFatal;
+		return lastStatus_;
+	}
+
+	lastStatus_ = static_cast<fmippStatus>( status );
+	return lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::flush()
+{
+	pending_.put<fmippUInt32>( remoteFMUPing );
+	RemoteFMUMessage response;
+	return call( response );
+}
+
+
+void
+RemoteFMUCoSimulation::terminate()
+{
+	pending_.put<fmippUInt32>( remoteFMUTerminate );
+	RemoteFMUMessage response;
+	call( response );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::instantiate( const fmippString& instanceName,
+	const fmippTime timeout,
+	const fmippBoolean visible,
+	const fmippBoolean interactive )
+{
+	pending_.put<fmippUInt32>( remoteFMUInstantiate );
+	pending_.put( instanceName );
+	pending_.put( timeout );
+	pending_.put( visible );
+	pending_.put( interactive );
+	RemoteFMUMessage response;
+	return call( response );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::initialize( const fmippReal startTime,
+	const fmippBoolean stopTimeDefined,
+	const fmippReal stopTime )
+{
+	pending_.put<fmippUInt32>( remoteFMUInitialize );
+	pending_.put( startTime );
+	pending_.put( stopTimeDefined );
+	pending_.put( stopTime );
+	RemoteFMUMessage response;
+	if ( fmippOK == call( response ) ) time_ = startTime;
+	return lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::doStep( fmippTime currentCommunicationPoint,
+	fmippTime communicationStepSize,
+	fmippBoolean newStep )
+{
+	pending_.put<fmippUInt32>( remoteFMUDoStep );
+	pending_.put( currentCommunicationPoint );
+	pending_.put( communicationStepSize );
+	pending_.put( newStep );
+	RemoteFMUMessage response;
+	if ( fmippFatal != call( response ) ) response.get( time_ );
+	return lastStatus_;
+}
+
+
+fmippValueReference
+RemoteFMUCoSimulation::getValueRef( const fmippString& name ) const
+{
+	const VariableHandle* handle = varIndex_.find( name );
+	return handle ? handle->valueReference : fmippUndefinedValueReference;
+}
+
+
+FMIPPVariableType
+RemoteFMUCoSimulation::getType( const fmippString& variableName ) const
+{
+	const VariableHandle* handle = varIndex_.find( variableName );
+	return handle ? handle->type : fmippTypeUnknown;
+}
+
+
+VariableHandle
+RemoteFMUCoSimulation::getVariableHandle( const fmippString& name ) const
+{
+	const VariableHandle* handle = varIndex_.find( name );
+	return handle ? *handle : VariableHandle();
+}
+
+
+const VariableHandle*
+RemoteFMUCoSimulation::findVariable( const fmippString& name, FMIPPVariableType type )
+{
+	const VariableHandle* handle = varIndex_.find( name );
+	if ( ( 0 == handle ) || ( type != handle->type ) ) {
+		lastStatus_ = fmippDiscard;
+		return 0;
+	}
+	return handle;
+}
+
+
+template<typename Type>
+fmippStatus
+RemoteFMUCoSimulation::getValues( RemoteFMUCommand command, const fmippValueReference* valref,
+	Type* val, fmippSize ival )
+{
+	pending_.put<fmippUInt32>( command );
+	pending_.put( ival );
+	for ( fmippSize i = 0; i < ival; ++i ) pending_.put( valref[i] );
+
+	RemoteFMUMessage response;
+	if ( fmippFatal == call( response ) ) return lastStatus_;
+
+	for ( fmippSize i = 0; i < ival; ++i ) {
+		if ( false == response.get( val[i] ) ) {
+			lastStatus_ = fmippFatal;
+			break;
+		}
+	}
+	return lastStatus_;
+}
+
+
+template<typename Type>
+fmippStatus
+RemoteFMUCoSimulation::setValues( RemoteFMUCommand command, const fmippValueReference* valref,
+	const Type* val, fmippSize ival )
+{
+	// Set commands are only collected, they are sent together with the next call.
+	if ( false == isWorkerAlive() ) {
+		lastStatus_ = fmippFatal;
+		return lastStatus_;
+	}
+
+	pending_.put<fmippUInt32>( command );
+	pending_.put( ival );
+	for ( fmippSize i = 0; i < ival; ++i ) pending_.put( valref[i] );
+	for ( fmippSize i = 0; i < ival; ++i ) pending_.put( val[i] );
+
+	lastStatus_ = fmippOK;
+	return lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference valref, fmippReal& val )
+{
+	return getValues( remoteFMUGetReal, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference valref, fmippInteger& val )
+{
+	return getValues( remoteFMUGetInteger, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference valref, fmippBoolean& val )
+{
+	return getValues( remoteFMUGetBoolean, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference valref, fmippString& val )
+{
+	return getValues( remoteFMUGetString, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference* valref, fmippReal* val, fmippSize ival )
+{
+	return getValues( remoteFMUGetReal, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference* valref, fmippInteger* val, fmippSize ival )
+{
+	return getValues( remoteFMUGetInteger, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference* valref, fmippBoolean* val, fmippSize ival )
+{
+	return getValues( remoteFMUGetBoolean, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( fmippValueReference* valref, fmippString* val, fmippSize ival )
+{
+	return getValues( remoteFMUGetString, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( const fmippString& name, fmippReal& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeReal );
+	return handle ? getValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( const fmippString& name, fmippInteger& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeInteger );
+	return handle ? getValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( const fmippString& name, fmippBoolean& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeBoolean );
+	return handle ? getValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::getValue( const fmippString& name, fmippString& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeString );
+	return handle ? getValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippReal
+RemoteFMUCoSimulation::getRealValue( const fmippString& name )
+{
+	fmippReal val = numeric_limits<fmippReal>::quiet_NaN();
+	getValue( name, val );
+	return val;
+}
+
+
+fmippInteger
+RemoteFMUCoSimulation::getIntegerValue( const fmippString& name )
+{
+	fmippInteger val = numeric_limits<fmippInteger>::quiet_NaN();
+	getValue( name, val );
+	return val;
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::getBooleanValue( const fmippString& name )
+{
+	fmippBoolean val = false;
+	getValue( name, val );
+	return val;
+}
+
+
+fmippString
+RemoteFMUCoSimulation::getStringValue( const fmippString& name )
+{
+	fmippString val;
+	getValue( name, val );
+	return val;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference valref, const fmippReal& val )
+{
+	return setValues( remoteFMUSetReal, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference valref, const fmippInteger& val )
+{
+	return setValues( remoteFMUSetInteger, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference valref, const fmippBoolean& val )
+{
+	return setValues( remoteFMUSetBoolean, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference valref, const fmippString& val )
+{
+	return setValues( remoteFMUSetString, &valref, &val, 1 );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference* valref, const fmippReal* val, fmippSize ival )
+{
+	return setValues( remoteFMUSetReal, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference* valref, const fmippInteger* val, fmippSize ival )
+{
+	return setValues( remoteFMUSetInteger, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference* valref, const fmippBoolean* val, fmippSize ival )
+{
+	return setValues( remoteFMUSetBoolean, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( fmippValueReference* valref, const fmippString* val, fmippSize ival )
+{
+	return setValues( remoteFMUSetString, valref, val, ival );
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( const fmippString& name, const fmippReal& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeReal );
+	return handle ? setValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( const fmippString& name, const fmippInteger& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeInteger );
+	return handle ? setValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( const fmippString& name, const fmippBoolean& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeBoolean );
+	return handle ? setValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippStatus
+RemoteFMUCoSimulation::setValue( const fmippString& name, const fmippString& val )
+{
+	const VariableHandle* handle = findVariable( name, fmippTypeString );
+	return handle ? setValue( handle->valueReference, val ) : lastStatus_;
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::getCapability( const fmippString& attributeName ) const
+{
+	using namespace ModelDescriptionUtilities;
+
+	if ( !description_ || ( false == description_->hasCoSimulation() ) ) return false;
+
+	const Properties& capabilities = getAttributes( description_->getCoSimulation() );
+	return hasChild( capabilities, attributeName ) ? capabilities.get<fmippBoolean>( attributeName ) : false;
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canHandleVariableCommunicationStepSize() const
+{
+	return getCapability( "canHandleVariableCommunicationStepSize" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canHandleEvents() const
+{
+	return getCapability( "canHandleEvents" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canRejectSteps() const
+{
+	return getCapability( "canRejectSteps" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canInterpolateInputs() const
+{
+	return getCapability( "canInterpolateInputs" );
+}
+
+
+fmippSize
+RemoteFMUCoSimulation::maxOutputDerivativeOrder() const
+{
+	using namespace ModelDescriptionUtilities;
+
+	if ( !description_ || ( false == description_->hasCoSimulation() ) ) return 0;
+
+	const Properties& capabilities = getAttributes( description_->getCoSimulation() );
+	return hasChild( capabilities, "maxOutputDerivativeOrder" ) ?
+		capabilities.get<fmippSize>( "maxOutputDerivativeOrder" ) : 0;
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canRunAsynchronuously() const
+{
+	return getCapability( "canRunAsynchronuously" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canSignalEvents() const
+{
+	return getCapability( "canSignalEvents" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canBeInstantiatedOnlyOncePerProcess() const
+{
+	return getCapability( "canBeInstantiatedOnlyOncePerProcess" );
+}
+
+
+fmippBoolean
+RemoteFMUCoSimulation::canNotUseMemoryManagementFunctions() const
+{
+	return getCapability( "canNotUseMemoryManagementFunctions" );
+}
+
+
+void
+RemoteFMUCoSimulation::sendDebugMessage( const fmippString& msg ) const
+{
+	if ( loggingOn_ ) cout << "[RemoteFMUCoSimulation] DEBUG: " << msg << endl;
+}
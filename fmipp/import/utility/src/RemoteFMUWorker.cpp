@@ -0,0 +1,205 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file RemoteFMUWorker.cpp
+ * Worker process (executable fmippworker) hosting an FMU CS (FMI 2.0) on behalf of
+ * a RemoteFMUCoSimulation proxy.
+ *
+ * Usage: fmippworker <channel name> <FMU dir URL> <model identifier> <logging on (0/1)>
+ *
+ * The worker exits when receiving the shutdown command or when its parent process
+ * (the proxy) terminates.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <unistd.h>
+
+#include "import/base/include/FMUCoSimulation_v2.h"
+#include "import/utility/include/RemoteFMUChannel.h"
+
+using namespace std;
+
+
+namespace {
+
+	// Read value references and values from the request and set them.
+	template<typename Type>
+	fmippStatus setValues( FMUCoSimulationBase& fmu, RemoteFMUMessage& request )
+	{
+		// Each element consists of (at least) a value reference, the request is bounded by the capacity of the channel.
+		fmippSize n = 0;
+		if ( false == request.getCount( n, sizeof( fmippValueReference ) ) ) return fmippFatal;
+
+		vector<fmippValueReference> valref( n );
+		unique_ptr<Type[]> val( new Type[n] ); // Not a vector, which has no references to elements of type bool.
+		for ( fmippSize i = 0; i < n; ++i ) if ( false == request.get( valref[i] ) ) return fmippFatal;
+		for ( fmippSize i = 0; i < n; ++i ) if ( false == request.get( val[i] ) ) return fmippFatal;
+
+		fmippStatus status = fmippOK;
+		for ( fmippSize i = 0; i < n; ++i ) status = max( status, fmu.setValue( valref[i], val[i] ) );
+		return status;
+	}
+
+
+	// Read value references from the request, get the values and append them to the response.
+	template<typename Type>
+	fmippStatus getValues( FMUCoSimulationBase& fmu, RemoteFMUMessage& request, RemoteFMUMessage& response )
+	{
+		fmippSize n = 0;
+		if ( false == request.getCount( n, sizeof( fmippValueReference ) ) ) return fmippFatal;
+
+		vector<fmippValueReference> valref( n );
+		for ( fmippSize i = 0; i < n; ++i ) if ( false == request.get( valref[i] ) ) return fmippFatal;
+
+		fmippStatus status = fmippOK;
+		for ( fmippSize i = 0; i < n; ++i ) {
+			Type val = Type();
+			status = max( status, fmu.getValue( valref[i], val ) );
+			response.put( val );
+		}
+		return status;
+	}
+
+}
+
+
+int main( int argc, char** argv )
+{
+	if ( 5 != argc ) {
+		cerr << "usage: " << argv[0] << " <channel name> <FMU dir URL> <model identifier> <logging on (0/1)>" << endl;
+		return 1;
+	}
+
+	const fmippString channelName = argv[1];
+	const fmippString fmuDirUrl = argv[2];
+	const fmippString modelIdentifier = argv[3];
+	const fmippBoolean loggingOn = ( fmippString( "1" ) == argv[4] );
+
+	const pid_t parent = getppid();
+
+	unique_ptr<RemoteFMUChannel> channel( RemoteFMUChannel::open( channelName ) );
+	if ( !channel ) {
+		cerr << "[fmippworker] unable to open channel " << channelName << endl;
+		return 1;
+	}
+
+	fmi_2_0::FMUCoSimulation fmu( fmuDirUrl, modelIdentifier, loggingOn );
+	if ( fmippFatal == fmu.getLastStatus() ) return 1;
+
+	RemoteFMUChannel::AliveCheck parentAlive = [parent]() { return getppid() == parent; };
+
+	fmippBoolean shutdown = false;
+	while ( false == shutdown )
+	{
+		RemoteFMUMessage request;
+		if ( false == channel->receiveRequest( request, parentAlive ) ) break;
+
+		// Process all commands of the batch, the response contains their most severe status.
+		fmippStatus status = fmippOK;
+		RemoteFMUMessage results;
+
+		while ( ( false == request.atEnd() ) && ( fmippFatal != status ) )
+		{
+			fmippUInt32 command = 0;
+			request.get( command );
+
+			switch ( command )
+			{
+			case remoteFMUPing:
+				break;
+			case remoteFMUInstantiate:
+			{
+				fmippString instanceName;
+				fmippTime timeout = 0.;
+				fmippBoolean visible = false;
+				fmippBoolean interactive = false;
+				if ( request.get( instanceName ) && request.get( timeout ) &&
+					request.get( visible ) && request.get( interactive ) ) {
+					status = max( status, fmu.instantiate( instanceName, timeout, visible, interactive ) );
+				} else {
+					status = fmippFatal;
+				}
+				break;
+			}
+			case remoteFMUInitialize:
+			{
+				fmippReal startTime = 0.;
+				fmippBoolean stopTimeDefined = false;
+				fmippReal stopTime = 0.;
+				if ( request.get( startTime ) && request.get( stopTimeDefined ) && request.get( stopTime ) ) {
+					status = max( status, fmu.initialize( startTime, stopTimeDefined, stopTime ) );
+				} else {
+					status = fmippFatal;
+				}
+				break;
+			}
+			case remoteFMUDoStep:
+			{
+				fmippTime currentCommunicationPoint = 0.;
+				fmippTime communicationStepSize = 0.;
+				fmippBoolean newStep = false;
+				if ( request.get( currentCommunicationPoint ) && request.get( communicationStepSize ) &&
+					request.get( newStep ) ) {
+					status = max( status, fmu.doStep( currentCommunicationPoint, communicationStepSize, newStep ) );
+				} else {
+					status = fmippFatal;
+				}
+				results.put( fmu.getTime() );
+				break;
+			}
+			case remoteFMUTerminate:
+				fmu.terminate();
+				break;
+			case remoteFMUSetReal:
+				status = max( status, setValues<fmippReal>( fmu, request ) );
+				break;
+			case remoteFMUSetInteger:
+				status = max( status, setValues<fmippInteger>( fmu, request ) );
+				break;
+			case remoteFMUSetBoolean:
+				status = max( status, setValues<fmippBoolean>( fmu, request ) );
+				break;
+			case remoteFMUSetString:
+				status = max( status, setValues<fmippString>( fmu, request ) );
+				break;
+			case remoteFMUGetReal:
+				status = max( status, getValues<fmippReal>( fmu, request, results ) );
+				break;
+			case remoteFMUGetInteger:
+				status = max( status, getValues<fmippInteger>( fmu, request, results ) );
+				break;
+			case remoteFMUGetBoolean:
+				status = max( status, getValues<fmippBoolean>( fmu, request, results ) );
+				break;
+			case remoteFMUGetString:
+				status = max( status, getValues<fmippString>( fmu, request, results ) );
+				break;
+			case remoteFMUShutdown:
+				shutdown = true;
+				break;
+			default:
+				cerr << "[fmippworker] unknown command: " << command << endl;
+				status = fmippFatal;
+			}
+		}
+
+		if ( shutdown ) break;
+
+		RemoteFMUMessage response;
+		response.put<fmippUInt32>( status );
+		response.append( results );
+		if ( false == channel->sendResponse( response ) ) {
+			cerr << "[fmippworker] response exceeds capacity of channel" << endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
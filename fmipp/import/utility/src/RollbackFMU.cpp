@@ -29,6 +29,9 @@ RollbackFMU::RollbackFMU( const fmippString& fmuDirUri,
 		const fmippReal timeDiffResolution,
 		const IntegratorType integratorType ) :
 	fmu_( 0 ),
+	fmuWithState_( 0 ),
+	rollbackFMUState_( 0 ),
+	rollbackEventInfo_(),
 	rollbackState_(),
 	rollbackStateSaved_( false )
 {
@@ -47,7 +50,9 @@ RollbackFMU::RollbackFMU( const fmippString& fmuDirUri,
 	}
 	else if ( ( fmi_2_0_me == fmuType ) || ( fmi_2_0_me_and_cs == fmuType ) ) // FMI ME 2.0
 	{
-		fmu_ = new fmi_2_0::FMUModelExchange( modelIdentifier, loggingOn, fmippTrue, timeDiffResolution, integratorType );
+		fmi_2_0::FMUModelExchange* fmu2 = new fmi_2_0::FMUModelExchange( modelIdentifier, loggingOn, fmippTrue, timeDiffResolution, integratorType );
+		if ( fmu2->canGetAndSetFMUstate() ) fmuWithState_ = fmu2;
+		fmu_ = fmu2;
 	}
 
 	// create history entry
@@ -55,6 +60,7 @@ RollbackFMU::RollbackFMU( const fmippString& fmuDirUri,
 }
 
 RollbackFMU::~RollbackFMU() {
+	if ( 0 != rollbackFMUState_ ) fmuWithState_->freeFMUState( &rollbackFMUState_ );
 	if ( 0 != fmu_ ) delete fmu_;
 }
 
@@ -65,8 +71,7 @@ fmippReal RollbackFMU::integrate( fmippReal tstop, unsigned int nsteps )
 	if ( tstop < now ) { // Make a rollback.
 		if ( fmippOK != rollback( tstop ) ) return now;
 	} else if ( false == rollbackStateSaved_ ) { // Retrieve current state and store it as rollback state.
-		rollbackState_.time_ = now;
-		if ( 0 != fmu_->nStates() ) fmu_->getContinuousStates( rollbackState_.state_ );
+		storeRollbackState();
 	}
 
 	// Integrate.
@@ -82,8 +87,7 @@ fmippReal RollbackFMU::integrate( fmippReal tstop, fmippTime deltaT )
 	if ( tstop < now ) { // Make a rollback.
 		if ( fmippOK != rollback( tstop ) ) return now;
 	} else if ( false == rollbackStateSaved_ ) { // Retrieve current state and store it as rollback state.
-		rollbackState_.time_ = now;
-		if ( 0 != fmu_->nStates() ) fmu_->getContinuousStates( rollbackState_.state_ );
+		storeRollbackState();
 	}
 
 	// Integrate.
@@ -96,14 +100,31 @@ fmippReal RollbackFMU::integrate( fmippReal tstop, fmippTime deltaT )
 void RollbackFMU::saveCurrentStateForRollback()
 {
 	if ( false == rollbackStateSaved_ ) {
-		rollbackState_.time_ = fmu_->getTime();
-		if ( 0 != fmu_->nStates() )
-			fmu_->getContinuousStates( rollbackState_.state_ );
-
+		storeRollbackState();
 		rollbackStateSaved_ = true;
 	}
 }
 
+void RollbackFMU::storeRollbackState()
+{
+	rollbackState_.time_ = fmu_->getTime();
+
+	if ( 0 != fmuWithState_ ) {
+		// The FMU overwrites the previous state (if any) instead of allocating a new one.
+		if ( fmippWarning >= fmuWithState_->getFMUState( &rollbackFMUState_ ) ) {
+			rollbackEventInfo_ = fmuWithState_->getEventInfo();
+			return;
+		}
+
+		// Fall back to storing the continuous states.
+		if ( 0 != rollbackFMUState_ ) fmuWithState_->freeFMUState( &rollbackFMUState_ );
+		rollbackFMUState_ = 0;
+		fmuWithState_ = 0;
+	}
+
+	if ( 0 != fmu_->nStates() ) fmu_->getContinuousStates( rollbackState_.state_ );
+}
+
 /** Realease an internal rollback state, that was previously
     saved via "saveCurrentStateForRollback()". **/
 void RollbackFMU::releaseRollbackState()
@@ -117,6 +138,20 @@ fmippStatus RollbackFMU::rollback( fmippTime time )
 		return fmippFatal;
 	}
 
+	if ( 0 != fmuWithState_ ) {
+		if ( 0 == rollbackFMUState_ ) return fmippFatal;
+
+		// Restore the complete state (including discrete states) of the FMU and the event
+		// info that belongs to it. The FMU saves its event indicators for the restored state.
+		fmippStatus status = fmuWithState_->setFMUState( rollbackFMUState_ );
+		if ( fmippWarning < status ) return status;
+
+		fmuWithState_->setEventInfo( rollbackEventInfo_ );
+		fmu_->setTime( rollbackState_.time_ );
+		fmu_->resetEventFlags();
+		return fmippOK;
+	}
+
 	fmu_->setTime( rollbackState_.time_ );
 	fmu_->raiseEvent();
 	fmu_->handleEvents();
@@ -0,0 +1,91 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+/**
+ * \file benchmarkModelManager.cpp
+ * Measures the throughput of the model manager when getInstance, getSlave and loadFMU (for FMUs
+ * that have already been loaded) are called concurrently from an increasing number of threads.
+ *
+ * Usage: benchmarkModelManager [iterations per thread] [maximum number of threads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "import/base/include/ModelManager.h"
+
+using namespace std;
+
+namespace {
+
+/// Run the same number of lookups in each thread and return the number of lookups per second.
+double run( unsigned int nThreads, unsigned int iterations )
+{
+	const string thermostatUri = FMU_URI_PRE "thermostat";
+	const string tickerUri = FMU_URI_PRE "ticker";
+
+	atomic<unsigned int> ready( 0 );
+	atomic<unsigned int> failures( 0 );
+	vector<thread> threads;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for ( unsigned int i = 0; i < nThreads; ++i ) {
+		threads.push_back( thread( [&, i] () {
+			++ready;
+			while ( ready < nThreads ) this_thread::yield();
+
+			FMUType type = invalid;
+			for ( unsigned int n = 0; n < iterations; ++n ) {
+				// Every thread mixes the three kinds of lookups in a different order.
+				switch ( ( n + i ) % 3 ) {
+				case 0:
+					if ( !ModelManager::getInstance( "thermostat" ) ) ++failures;
+					break;
+				case 1:
+					if ( !ModelManager::getSlave( "ticker" ) ) ++failures;
+					break;
+				default:
+					if ( ModelManager::duplicate != ModelManager::loadFMU( "thermostat", thermostatUri, fmippFalse, type ) ) ++failures;
+					if ( ModelManager::duplicate != ModelManager::loadFMU( "ticker", tickerUri, fmippFalse, type ) ) ++failures;
+				}
+			}
+		} ) );
+	}
+
+	for ( thread& t : threads ) t.join();
+
+	double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+	if ( 0 != failures ) cerr << "lookups failed: " << failures << endl;
+
+	return nThreads * iterations / seconds;
+}
+
+}
+
+int main( int argc, char** argv )
+{
+	const unsigned int iterations = ( argc > 1 ) ? atoi( argv[1] ) : 100000;
+	const unsigned int maxThreads = ( argc > 2 ) ? atoi( argv[2] ) : 8;
+
+	FMUType type = invalid;
+	if ( ( ModelManager::success != ModelManager::loadFMU( "thermostat", FMU_URI_PRE "thermostat", fmippFalse, type ) ) ||
+		( ModelManager::success != ModelManager::loadFMU( "ticker", FMU_URI_PRE "ticker", fmippFalse, type ) ) ) {
+		cerr << "loading the test FMUs failed" << endl;
+		return 1;
+	}
+
+	cout << "threads\tlookups/s" << endl;
+	for ( unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2 ) {
+		cout << nThreads << "\t" << run( nThreads, iterations ) << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,256 @@
+/* -------------------------------------------------------------------
+ * Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+ * All rights reserved. See file FMIPP_LICENSE for details.
+ * -------------------------------------------------------------------
+ *
+ * Test FMU (FMI 2.0, model exchange): a chain of first-order lags.
+ *
+ * The states follow der(x1) = -k * x1 and der(xi) = x(i-1) - k * xi for i > 1, i.e., the
+ * Jacobian is lower bidiagonal. Its entries only depend on the (fixed) parameter k, which is
+ * reported in the model structure. Directional derivatives are provided.
+ *
+ * Value references:
+ *   Real: 0-3 x1-x4, 4-7 der(x1)-der(x4), 8 k (parameter)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmi2ModelTypes.h"
+
+#if defined(_WIN32)
+#define FMI2_EXPORT __declspec(dllexport)
+#else
+#define FMI2_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define N_STATES 4
+
+typedef struct {
+	fmi2Real time;
+	fmi2Real x[N_STATES];
+	fmi2Real k;
+} Chain;
+
+static void reset( Chain* m )
+{
+	int i;
+	m->time = 0.;
+	for ( i = 0; i < N_STATES; ++i ) m->x[i] = 1.;
+	m->k = 1.;
+}
+
+static fmi2Real derivative( const Chain* m, int i )
+{
+	return ( ( i > 0 ) ? m->x[i-1] : 0. ) - m->k * m->x[i];
+}
+
+/* Partial derivative of der(xi) with respect to xj. */
+static fmi2Real jacobian( const Chain* m, int i, int j )
+{
+	if ( i == j ) return -m->k;
+	if ( i == j + 1 ) return 1.;
+	return 0.;
+}
+
+
+/* Common functions */
+
+FMI2_EXPORT const char* fmi2GetTypesPlatform( void ) { return "default"; }
+
+FMI2_EXPORT const char* fmi2GetVersion( void ) { return "2.0"; }
+
+FMI2_EXPORT fmi2Status fmi2SetDebugLogging( fmi2Component c, fmi2Boolean loggingOn,
+	size_t nCategories, const fmi2String categories[] )
+{
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Component fmi2Instantiate( fmi2String instanceName, fmi2Type fmuType,
+	fmi2String fmuGUID, fmi2String fmuResourceLocation, const void* functions,
+	fmi2Boolean visible, fmi2Boolean loggingOn )
+{
+	Chain* m = (Chain*) calloc( 1, sizeof( Chain ) );
+	if ( m ) reset( m );
+	return m;
+}
+
+FMI2_EXPORT void fmi2FreeInstance( fmi2Component c ) { free( c ); }
+
+FMI2_EXPORT fmi2Status fmi2SetupExperiment( fmi2Component c, fmi2Boolean toleranceDefined,
+	fmi2Real tolerance, fmi2Real startTime, fmi2Boolean stopTimeDefined, fmi2Real stopTime )
+{
+	( (Chain*) c )->time = startTime;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2EnterInitializationMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2ExitInitializationMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2Terminate( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2Reset( fmi2Component c )
+{
+	reset( (Chain*) c );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetReal( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Real value[] )
+{
+	const Chain* m = (const Chain*) c;
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( vr[i] < N_STATES ) value[i] = m->x[vr[i]];
+		else if ( vr[i] < 2 * N_STATES ) value[i] = derivative( m, vr[i] - N_STATES );
+		else if ( vr[i] == 2 * N_STATES ) value[i] = m->k;
+		else return fmi2Error;
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetInteger( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Integer value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetBoolean( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Boolean value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetString( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2String value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetReal( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Real value[] )
+{
+	Chain* m = (Chain*) c;
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( vr[i] < N_STATES ) m->x[vr[i]] = value[i];
+		else if ( vr[i] == 2 * N_STATES ) m->k = value[i];
+		else return fmi2Error;
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetInteger( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Integer value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetBoolean( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Boolean value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetString( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2String value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetFMUstate( fmi2Component c, fmi2FMUstate* state ) { return fmi2Error; }
+
+FMI2_EXPORT fmi2Status fmi2SetFMUstate( fmi2Component c, fmi2FMUstate state ) { return fmi2Error; }
+
+FMI2_EXPORT fmi2Status fmi2FreeFMUstate( fmi2Component c, fmi2FMUstate* state ) { return fmi2Error; }
+
+FMI2_EXPORT fmi2Status fmi2SerializedFMUstateSize( fmi2Component c, fmi2FMUstate state, size_t* size ) { return fmi2Error; }
+
+FMI2_EXPORT fmi2Status fmi2SerializeFMUstate( fmi2Component c, fmi2FMUstate state, fmi2Byte serializedState[], size_t size )
+{
+	return fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2DeSerializeFMUstate( fmi2Component c, const fmi2Byte serializedState[], size_t size, fmi2FMUstate* state )
+{
+	return fmi2Error;
+}
+
+/* Any combination of states (knowns) and derivatives (unknowns) is supported. */
+FMI2_EXPORT fmi2Status fmi2GetDirectionalDerivative( fmi2Component c,
+	const fmi2ValueReference vUnknown_ref[], size_t nUnknown,
+	const fmi2ValueReference vKnown_ref[], size_t nKnown,
+	const fmi2Real dvKnown[], fmi2Real dvUnknown[] )
+{
+	const Chain* m = (const Chain*) c;
+	size_t i, j;
+	for ( i = 0; i < nUnknown; ++i ) {
+		if ( ( vUnknown_ref[i] < N_STATES ) || ( vUnknown_ref[i] >= 2 * N_STATES ) ) return fmi2Error;
+		dvUnknown[i] = 0.;
+		for ( j = 0; j < nKnown; ++j ) {
+			if ( vKnown_ref[j] >= N_STATES ) return fmi2Error;
+			dvUnknown[i] += jacobian( m, vUnknown_ref[i] - N_STATES, vKnown_ref[j] ) * dvKnown[j];
+		}
+	}
+	return fmi2OK;
+}
+
+
+/* Model exchange */
+
+FMI2_EXPORT fmi2Status fmi2EnterEventMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2NewDiscreteStates( fmi2Component c, fmi2EventInfo* eventInfo )
+{
+	eventInfo->newDiscreteStatesNeeded = fmi2False;
+	eventInfo->terminateSimulation = fmi2False;
+	eventInfo->nominalsOfContinuousStatesChanged = fmi2False;
+	eventInfo->valuesOfContinuousStatesChanged = fmi2False;
+	eventInfo->nextEventTimeDefined = fmi2False;
+	eventInfo->nextEventTime = 0.;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2EnterContinuousTimeMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2CompletedIntegratorStep( fmi2Component c, fmi2Boolean noSetFMUStatePriorToCurrentPoint,
+	fmi2Boolean* enterEventMode, fmi2Boolean* terminateSimulation )
+{
+	*enterEventMode = fmi2False;
+	*terminateSimulation = fmi2False;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetTime( fmi2Component c, fmi2Real time )
+{
+	( (Chain*) c )->time = time;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetContinuousStates( fmi2Component c, const fmi2Real x[], size_t nx )
+{
+	if ( N_STATES != nx ) return fmi2Error;
+	memcpy( ( (Chain*) c )->x, x, N_STATES * sizeof( fmi2Real ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetDerivatives( fmi2Component c, fmi2Real derivatives[], size_t nx )
+{
+	int i;
+	if ( N_STATES != nx ) return fmi2Error;
+	for ( i = 0; i < N_STATES; ++i ) derivatives[i] = derivative( (const Chain*) c, i );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetEventIndicators( fmi2Component c, fmi2Real eventIndicators[], size_t ni )
+{
+	return ( 0 == ni ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetContinuousStates( fmi2Component c, fmi2Real x[], size_t nx )
+{
+	if ( N_STATES != nx ) return fmi2Error;
+	memcpy( x, ( (const Chain*) c )->x, N_STATES * sizeof( fmi2Real ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetNominalsOfContinuousStates( fmi2Component c, fmi2Real x_nominal[], size_t nx )
+{
+	int i;
+	if ( N_STATES != nx ) return fmi2Error;
+	for ( i = 0; i < N_STATES; ++i ) x_nominal[i] = 1.;
+	return fmi2OK;
+}
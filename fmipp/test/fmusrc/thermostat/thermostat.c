@@ -0,0 +1,369 @@
+/* -------------------------------------------------------------------
+ * Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+ * All rights reserved. See file FMIPP_LICENSE for details.
+ * -------------------------------------------------------------------
+ *
+ * Test FMU (FMI 2.0, model exchange and co-simulation): a thermostat.
+ *
+ * The temperature x follows der(x) = ( on ? 2 : -1 ) - x + u. The heater is switched off when x
+ * reaches 1 and switched on when x drops to 0 (state events). If the parameter period is positive,
+ * the FMU has time events at multiples of the period, which are counted by the output ticks.
+ *
+ * Value references:
+ *   Real:    0 x, 1 der(x), 2 u (input), 3 y (output, equal to x), 4 period (parameter)
+ *   Integer: 0 ticks (output)
+ *   Boolean: 0 on
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmi2ModelTypes.h"
+
+#if defined(_WIN32)
+#define FMI2_EXPORT __declspec(dllexport)
+#else
+#define FMI2_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Tolerance for detecting time events. */
+#define TIME_EVENT_TOLERANCE 1e-10
+
+/* Step size of the internal solver used for co-simulation. */
+#define CS_STEP_SIZE 1e-3
+
+typedef struct {
+	fmi2Real time;
+	fmi2Real x;
+	fmi2Real u;
+	fmi2Real period;
+	fmi2Real nextTick;
+	fmi2Integer ticks;
+	fmi2Boolean on;
+} Thermostat;
+
+static void reset( Thermostat* m )
+{
+	m->time = 0.;
+	m->x = 0.;
+	m->u = 0.;
+	m->period = 0.;
+	m->nextTick = 0.;
+	m->ticks = 0;
+	m->on = fmi2True;
+}
+
+static fmi2Real derivative( const Thermostat* m )
+{
+	return ( m->on ? 2. : -1. ) - m->x + m->u;
+}
+
+static fmi2Real indicator( const Thermostat* m )
+{
+	return m->on ? 1. - m->x : m->x;
+}
+
+/* Update the discrete states (switch the heater, count time events). */
+static void update( Thermostat* m )
+{
+	if ( m->on && ( m->x >= 1. ) ) m->on = fmi2False;
+	else if ( !m->on && ( m->x <= 0. ) ) m->on = fmi2True;
+
+	while ( ( m->period > 0. ) && ( m->time >= m->nextTick - TIME_EVENT_TOLERANCE ) ) {
+		++m->ticks;
+		m->nextTick += m->period;
+	}
+}
+
+
+/* Common functions */
+
+FMI2_EXPORT const char* fmi2GetTypesPlatform( void ) { return "default"; }
+
+FMI2_EXPORT const char* fmi2GetVersion( void ) { return "2.0"; }
+
+FMI2_EXPORT fmi2Status fmi2SetDebugLogging( fmi2Component c, fmi2Boolean loggingOn,
+	size_t nCategories, const fmi2String categories[] )
+{
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Component fmi2Instantiate( fmi2String instanceName, fmi2Type fmuType,
+	fmi2String fmuGUID, fmi2String fmuResourceLocation, const void* functions,
+	fmi2Boolean visible, fmi2Boolean loggingOn )
+{
+	Thermostat* m = (Thermostat*) calloc( 1, sizeof( Thermostat ) );
+	if ( m ) reset( m );
+	return m;
+}
+
+FMI2_EXPORT void fmi2FreeInstance( fmi2Component c ) { free( c ); }
+
+FMI2_EXPORT fmi2Status fmi2SetupExperiment( fmi2Component c, fmi2Boolean toleranceDefined,
+	fmi2Real tolerance, fmi2Real startTime, fmi2Boolean stopTimeDefined, fmi2Real stopTime )
+{
+	( (Thermostat*) c )->time = startTime;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2EnterInitializationMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2ExitInitializationMode( fmi2Component c )
+{
+	Thermostat* m = (Thermostat*) c;
+	m->nextTick = m->time + m->period;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2Terminate( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2Reset( fmi2Component c )
+{
+	reset( (Thermostat*) c );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetReal( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Real value[] )
+{
+	const Thermostat* m = (const Thermostat*) c;
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		switch ( vr[i] ) {
+		case 0: case 3: value[i] = m->x; break;
+		case 1: value[i] = derivative( m ); break;
+		case 2: value[i] = m->u; break;
+		case 4: value[i] = m->period; break;
+		default: return fmi2Error;
+		}
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetInteger( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Integer value[] )
+{
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( 0 != vr[i] ) return fmi2Error;
+		value[i] = ( (const Thermostat*) c )->ticks;
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetBoolean( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Boolean value[] )
+{
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( 0 != vr[i] ) return fmi2Error;
+		value[i] = ( (const Thermostat*) c )->on;
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetString( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2String value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetReal( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Real value[] )
+{
+	Thermostat* m = (Thermostat*) c;
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		switch ( vr[i] ) {
+		case 0: m->x = value[i]; break;
+		case 2: m->u = value[i]; break;
+		case 4: m->period = value[i]; break;
+		default: return fmi2Error;
+		}
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetInteger( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Integer value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetBoolean( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Boolean value[] )
+{
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( 0 != vr[i] ) return fmi2Error;
+		( (Thermostat*) c )->on = value[i];
+	}
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetString( fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2String value[] )
+{
+	return ( 0 == nvr ) ? fmi2OK : fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetFMUstate( fmi2Component c, fmi2FMUstate* state )
+{
+	if ( 0 == *state ) *state = malloc( sizeof( Thermostat ) );
+	if ( 0 == *state ) return fmi2Error;
+	memcpy( *state, c, sizeof( Thermostat ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetFMUstate( fmi2Component c, fmi2FMUstate state )
+{
+	if ( 0 == state ) return fmi2Error;
+	memcpy( c, state, sizeof( Thermostat ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2FreeFMUstate( fmi2Component c, fmi2FMUstate* state )
+{
+	free( *state );
+	*state = 0;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SerializedFMUstateSize( fmi2Component c, fmi2FMUstate state, size_t* size )
+{
+	*size = sizeof( Thermostat );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SerializeFMUstate( fmi2Component c, fmi2FMUstate state, fmi2Byte serializedState[], size_t size )
+{
+	if ( size < sizeof( Thermostat ) ) return fmi2Error;
+	memcpy( serializedState, state, sizeof( Thermostat ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2DeSerializeFMUstate( fmi2Component c, const fmi2Byte serializedState[], size_t size, fmi2FMUstate* state )
+{
+	if ( size < sizeof( Thermostat ) ) return fmi2Error;
+	if ( 0 == *state ) *state = malloc( sizeof( Thermostat ) );
+	if ( 0 == *state ) return fmi2Error;
+	memcpy( *state, serializedState, sizeof( Thermostat ) );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetDirectionalDerivative( fmi2Component c,
+	const fmi2ValueReference vUnknown_ref[], size_t nUnknown,
+	const fmi2ValueReference vKnown_ref[], size_t nKnown,
+	const fmi2Real dvKnown[], fmi2Real dvUnknown[] )
+{
+	return fmi2Error;
+}
+
+
+/* Model exchange */
+
+FMI2_EXPORT fmi2Status fmi2EnterEventMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2NewDiscreteStates( fmi2Component c, fmi2EventInfo* eventInfo )
+{
+	Thermostat* m = (Thermostat*) c;
+	update( m );
+	eventInfo->newDiscreteStatesNeeded = fmi2False;
+	eventInfo->terminateSimulation = fmi2False;
+	eventInfo->nominalsOfContinuousStatesChanged = fmi2False;
+	eventInfo->valuesOfContinuousStatesChanged = fmi2False;
+	eventInfo->nextEventTimeDefined = ( m->period > 0. ) ? fmi2True : fmi2False;
+	eventInfo->nextEventTime = m->nextTick;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2EnterContinuousTimeMode( fmi2Component c ) { return fmi2OK; }
+
+FMI2_EXPORT fmi2Status fmi2CompletedIntegratorStep( fmi2Component c, fmi2Boolean noSetFMUStatePriorToCurrentPoint,
+	fmi2Boolean* enterEventMode, fmi2Boolean* terminateSimulation )
+{
+	*enterEventMode = fmi2False;
+	*terminateSimulation = fmi2False;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetTime( fmi2Component c, fmi2Real time )
+{
+	( (Thermostat*) c )->time = time;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2SetContinuousStates( fmi2Component c, const fmi2Real x[], size_t nx )
+{
+	if ( 1 != nx ) return fmi2Error;
+	( (Thermostat*) c )->x = x[0];
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetDerivatives( fmi2Component c, fmi2Real derivatives[], size_t nx )
+{
+	if ( 1 != nx ) return fmi2Error;
+	derivatives[0] = derivative( (const Thermostat*) c );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetEventIndicators( fmi2Component c, fmi2Real eventIndicators[], size_t ni )
+{
+	if ( 1 != ni ) return fmi2Error;
+	eventIndicators[0] = indicator( (const Thermostat*) c );
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetContinuousStates( fmi2Component c, fmi2Real x[], size_t nx )
+{
+	if ( 1 != nx ) return fmi2Error;
+	x[0] = ( (const Thermostat*) c )->x;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetNominalsOfContinuousStates( fmi2Component c, fmi2Real x_nominal[], size_t nx )
+{
+	if ( 1 != nx ) return fmi2Error;
+	x_nominal[0] = 1.;
+	return fmi2OK;
+}
+
+
+/* Co-simulation (explicit Euler with a fixed internal step size) */
+
+FMI2_EXPORT fmi2Status fmi2SetRealInputDerivatives( fmi2Component c, const fmi2ValueReference vr[], size_t nvr,
+	const fmi2Integer order[], const fmi2Real value[] )
+{
+	return fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetRealOutputDerivatives( fmi2Component c, const fmi2ValueReference vr[], size_t nvr,
+	const fmi2Integer order[], fmi2Real value[] )
+{
+	return fmi2Error;
+}
+
+FMI2_EXPORT fmi2Status fmi2DoStep( fmi2Component c, fmi2Real currentCommunicationPoint,
+	fmi2Real communicationStepSize, fmi2Boolean noSetFMUStatePriorToCurrentPoint )
+{
+	Thermostat* m = (Thermostat*) c;
+	const fmi2Real tEnd = currentCommunicationPoint + communicationStepSize;
+
+	while ( m->time < tEnd ) {
+		fmi2Real h = tEnd - m->time;
+		if ( h > CS_STEP_SIZE ) h = CS_STEP_SIZE;
+		m->x += h * derivative( m );
+		m->time = ( tEnd - m->time - h < TIME_EVENT_TOLERANCE ) ? tEnd : m->time + h;
+		update( m );
+	}
+
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2CancelStep( fmi2Component c ) { return fmi2Error; }
+
+FMI2_EXPORT fmi2Status fmi2GetStatus( fmi2Component c, const fmi2StatusKind s, fmi2Status* value ) { return fmi2Discard; }
+
+FMI2_EXPORT fmi2Status fmi2GetRealStatus( fmi2Component c, const fmi2StatusKind s, fmi2Real* value )
+{
+	*value = ( (const Thermostat*) c )->time;
+	return fmi2OK;
+}
+
+FMI2_EXPORT fmi2Status fmi2GetIntegerStatus( fmi2Component c, const fmi2StatusKind s, fmi2Integer* value ) { return fmi2Discard; }
+
+FMI2_EXPORT fmi2Status fmi2GetBooleanStatus( fmi2Component c, const fmi2StatusKind s, fmi2Boolean* value ) { return fmi2Discard; }
+
+FMI2_EXPORT fmi2Status fmi2GetStringStatus( fmi2Component c, const fmi2StatusKind s, fmi2String* value ) { return fmi2Discard; }
@@ -0,0 +1,171 @@
+/* -------------------------------------------------------------------
+ * Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+ * All rights reserved. See file FMIPP_LICENSE for details.
+ * -------------------------------------------------------------------
+ *
+ * Test FMU (FMI 1.0, co-simulation): a ticker.
+ *
+ * The output count is incremented by each call of doStep, the output time is the current
+ * communication point. The input gain scales the increment.
+ *
+ * Value references:
+ *   Real:    0 time (output), 1 gain (input)
+ *   Integer: 0 count (output)
+ */
+
+#include <stdlib.h>
+
+#include "fmiModelTypes.h"
+
+#if defined(_WIN32)
+#define FMI_EXPORT __declspec(dllexport)
+#else
+#define FMI_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define FMI_FUNCTION( name ) ticker_ ## name
+
+/* Same layout as the callback functions of FMI 1.0 for co-simulation. */
+typedef struct {
+	void* logger;
+	void* allocateMemory;
+	void* freeMemory;
+	void* stepFinished;
+} CallbackFunctions;
+
+typedef struct {
+	fmiReal time;
+	fmiReal gain;
+	fmiInteger count;
+} Ticker;
+
+FMI_EXPORT const char* FMI_FUNCTION( fmiGetTypesPlatform )() { return "standard32"; }
+
+FMI_EXPORT const char* FMI_FUNCTION( fmiGetVersion )() { return "1.0"; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetDebugLogging )( fmiComponent c, fmiBoolean loggingOn ) { return fmiOK; }
+
+FMI_EXPORT fmiComponent FMI_FUNCTION( fmiInstantiateSlave )( fmiString instanceName, fmiString fmuGUID,
+	fmiString fmuLocation, fmiString mimeType, fmiReal timeout, fmiBoolean visible, fmiBoolean interactive,
+	CallbackFunctions functions, fmiBoolean loggingOn )
+{
+	Ticker* m = (Ticker*) calloc( 1, sizeof( Ticker ) );
+	if ( m ) m->gain = 1.;
+	return m;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiInitializeSlave )( fmiComponent c, fmiReal tStart,
+	fmiBoolean stopTimeDefined, fmiReal tStop )
+{
+	( (Ticker*) c )->time = tStart;
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiTerminateSlave )( fmiComponent c ) { return fmiOK; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiResetSlave )( fmiComponent c )
+{
+	Ticker* m = (Ticker*) c;
+	m->time = 0.;
+	m->gain = 1.;
+	m->count = 0;
+	return fmiOK;
+}
+
+FMI_EXPORT void FMI_FUNCTION( fmiFreeSlaveInstance )( fmiComponent c ) { free( c ); }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetReal )( fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiReal value[] )
+{
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( 1 != vr[i] ) return fmiError;
+		( (Ticker*) c )->gain = value[i];
+	}
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetInteger )( fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiInteger value[] )
+{
+	return ( 0 == nvr ) ? fmiOK : fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetBoolean )( fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiBoolean value[] )
+{
+	return ( 0 == nvr ) ? fmiOK : fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetString )( fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiString value[] )
+{
+	return ( 0 == nvr ) ? fmiOK : fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetReal )( fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiReal value[] )
+{
+	const Ticker* m = (const Ticker*) c;
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		switch ( vr[i] ) {
+		case 0: value[i] = m->time; break;
+		case 1: value[i] = m->gain; break;
+		default: return fmiError;
+		}
+	}
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetInteger )( fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiInteger value[] )
+{
+	size_t i;
+	for ( i = 0; i < nvr; ++i ) {
+		if ( 0 != vr[i] ) return fmiError;
+		value[i] = ( (const Ticker*) c )->count;
+	}
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetBoolean )( fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiBoolean value[] )
+{
+	return ( 0 == nvr ) ? fmiOK : fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetString )( fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiString value[] )
+{
+	return ( 0 == nvr ) ? fmiOK : fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiSetRealInputDerivatives )( fmiComponent c, const fmiValueReference vr[], size_t nvr,
+	const fmiInteger order[], const fmiReal value[] )
+{
+	return fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetRealOutputDerivatives )( fmiComponent c, const fmiValueReference vr[], size_t nvr,
+	const fmiInteger order[], fmiReal value[] )
+{
+	return fmiError;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiDoStep )( fmiComponent c, fmiReal currentCommunicationPoint,
+	fmiReal communicationStepSize, fmiBoolean newStep )
+{
+	Ticker* m = (Ticker*) c;
+	m->time = currentCommunicationPoint + communicationStepSize;
+	m->count += (fmiInteger) m->gain;
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiCancelStep )( fmiComponent c ) { return fmiError; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetStatus )( fmiComponent c, const fmiStatusKind s, fmiStatus* value ) { return fmiDiscard; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetRealStatus )( fmiComponent c, const fmiStatusKind s, fmiReal* value )
+{
+	*value = ( (const Ticker*) c )->time;
+	return fmiOK;
+}
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetIntegerStatus )( fmiComponent c, const fmiStatusKind s, fmiInteger* value ) { return fmiDiscard; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetBooleanStatus )( fmiComponent c, const fmiStatusKind s, fmiBoolean* value ) { return fmiDiscard; }
+
+FMI_EXPORT fmiStatus FMI_FUNCTION( fmiGetStringStatus )( fmiComponent c, const fmiStatusKind s, fmiString* value ) { return fmiDiscard; }
@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testAsyncLogger
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "import/base/include/AsyncLogger.h"
+
+namespace {
+
+std::string logFileName( const std::string& test )
+{
+	return "fmipp_test_" + test + "_" + std::to_string( getpid() ) + ".log";
+}
+
+void logMessage( const char* instanceName, const char* format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	AsyncLogger::getAsyncLogger().log( instanceName, fmippOK, "test", format, args );
+	va_end( args );
+}
+
+std::vector<std::string> readLines( const std::string& fileName )
+{
+	std::vector<std::string> lines;
+	std::ifstream file( fileName.c_str() );
+	std::string line;
+	while ( std::getline( file, line ) ) lines.push_back( line );
+	return lines;
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( test_all_messages_are_written )
+{
+	const std::string fileName = logFileName( "written" );
+	std::remove( fileName.c_str() );
+	AsyncLogger& logger = AsyncLogger::getAsyncLogger();
+
+	// Messages are ignored while the logger is not active.
+	logMessage( "producer", "message %d", -1 );
+
+	BOOST_REQUIRE( logger.start( fileName, 1024 ) );
+	BOOST_CHECK( false == logger.start( fileName ) );
+	for ( int i = 0; i < 100; ++i ) logMessage( "producer", "message %d", i );
+	logger.stop();
+
+	logMessage( "producer", "message %d", 100 );
+
+	std::vector<std::string> lines = readLines( fileName );
+	BOOST_REQUIRE_EQUAL( lines.size(), 100u );
+	BOOST_CHECK_EQUAL( lines.front(), "[OK] producer [test]: message 0" );
+	BOOST_CHECK_EQUAL( lines.back(), "[OK] producer [test]: message 99" );
+	std::remove( fileName.c_str() );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_stop_and_start_while_logging )
+{
+	const std::string fileName = logFileName( "restart" );
+	std::remove( fileName.c_str() );
+	AsyncLogger& logger = AsyncLogger::getAsyncLogger();
+
+	std::atomic<bool> done( false );
+	std::vector<std::thread> producers;
+	for ( int p = 0; p < 4; ++p ) {
+		producers.push_back( std::thread( [&done, p]() {
+			const std::string instanceName = "producer" + std::to_string( p );
+			for ( int i = 0; false == done.load(); ++i ) logMessage( instanceName.c_str(), "message %d", i );
+		} ) );
+	}
+
+	// Small ring buffers, such that the slots are reallocated while producers are enqueueing.
+	for ( int cycle = 0; cycle < 200; ++cycle ) {
+		BOOST_REQUIRE( logger.start( fileName, 16 ) );
+		std::this_thread::yield();
+		logger.stop();
+	}
+
+	done = true;
+	for ( std::thread& producer : producers ) producer.join();
+
+	// Every line is either a complete message or the warning about dropped messages.
+	for ( const std::string& line : readLines( fileName ) ) {
+		bool message = ( 0 == line.find( "[OK] producer" ) ) && ( std::string::npos != line.find( " [test]: message " ) );
+		bool dropped = ( 0 == line.find( "[WARNING] AsyncLogger: " ) );
+		BOOST_CHECK_MESSAGE( message || dropped, "unexpected line: " << line );
+	}
+	std::remove( fileName.c_str() );
+}
@@ -0,0 +1,115 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testEnsembleIntegrator
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "import/base/include/FMUModelExchange_v2.h"
+#include "import/integrators/include/EnsembleIntegrator.h"
+
+using namespace fmi_2_0;
+
+namespace {
+
+const std::string fmuUri = FMU_URI_PRE "thermostat";
+const std::string modelIdentifier = "thermostat";
+
+/// Ensemble of thermostats with different inputs (the heater stays on until t = 0.2).
+class Ensemble
+{
+public:
+	Ensemble( fmippSize n, fmippTime startTime )
+	{
+		for ( fmippSize i = 0; i < n; ++i ) {
+			fmus_.push_back( std::unique_ptr<FMUModelExchange>( new FMUModelExchange( fmuUri, modelIdentifier ) ) );
+			FMUModelExchange& fmu = *fmus_.back();
+			BOOST_REQUIRE_EQUAL( fmu.instantiate( "thermostat" + std::to_string( i ) ), fmippOK );
+			BOOST_REQUIRE_EQUAL( fmu.setValue( "u", 0.5 * i ), fmippOK );
+			BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+			fmu.setTime( startTime );
+			instances_.push_back( &fmu );
+		}
+	}
+
+	const std::vector<DynamicalSystem*>& instances() const { return instances_; }
+
+	FMUModelExchange& operator[]( fmippSize i ) { return *fmus_[i]; }
+
+private:
+	std::vector< std::unique_ptr<FMUModelExchange> > fmus_;
+	std::vector<DynamicalSystem*> instances_;
+};
+
+}
+
+/// Every instance ends exactly at its current time plus the step size, no matter how it was reached.
+BOOST_AUTO_TEST_CASE( test_end_time_is_reached_exactly )
+{
+	const EnsembleIntegrator::ErrorControl modes[] = { EnsembleIntegrator::perInstance, EnsembleIntegrator::shared };
+
+	for ( EnsembleIntegrator::ErrorControl mode : modes ) {
+		const fmippTime startTime = 0.1;
+		const fmippTime stepSize = 0.2 / 30.;
+
+		Ensemble ensemble( 4, startTime );
+		EnsembleIntegrator integrator( ensemble.instances(), mode, 1 );
+
+		std::vector<fmippTime> tEnd( 4, startTime );
+		for ( int n = 0; n < 30; ++n ) {
+			BOOST_REQUIRE_EQUAL( integrator.integrate( stepSize, 1e-3 ), 0u );
+			for ( fmippSize i = 0; i < 4; ++i ) {
+				tEnd[i] += stepSize;
+				BOOST_REQUIRE_EQUAL( ensemble[i].getTime(), tEnd[i] );
+			}
+		}
+
+		for ( fmippSize i = 0; i < 4; ++i ) {
+			const fmippReal u = 0.5 * i;
+			const fmippReal x = ( 2. + u ) * ( 1. - std::exp( -( tEnd[i] - startTime ) ) );
+			BOOST_CHECK_SMALL( ensemble[i].getRealValue( "x" ) - x, 1e-5 );
+		}
+	}
+}
+
+/// The sum of the time and a step that was shortened to reach the end may be one ulp below the end.
+BOOST_AUTO_TEST_CASE( test_step_shortened_to_end )
+{
+	// Equilibrium (der(x) = 0), i.e., the first step is accepted and the second one is shortened.
+	Ensemble ensemble( 1, 0. );
+	ensemble[0].setValue( "u", -2. );
+
+	// 0.17720226965132496 + ( 0.8993933116527743 - 0.17720226965132496 ) < 0.8993933116527743
+	const fmippTime firstStep = 0.17720226965132496;
+	const fmippTime stepSize = 0.8993933116527743;
+
+	EnsembleIntegrator integrator( ensemble.instances(), EnsembleIntegrator::perInstance, 1 );
+	BOOST_CHECK_EQUAL( integrator.integrate( stepSize, firstStep ), 0u );
+	BOOST_CHECK_EQUAL( ensemble[0].getTime(), stepSize );
+	BOOST_CHECK_EQUAL( integrator.getAcceptedSteps( 0 ), 2u );
+}
+
+/// An instance that reaches a state event stops before it, the others reach the end.
+BOOST_AUTO_TEST_CASE( test_state_event_stops_instance )
+{
+	Ensemble ensemble( 2, 0. );
+	ensemble[1].setValue( "u", 10. ); // The heater is switched off at t = ln(12/11).
+
+	EnsembleIntegrator integrator( ensemble.instances(), EnsembleIntegrator::perInstance, 2 );
+	BOOST_CHECK_EQUAL( integrator.integrate( 0.2, 1e-3 ), 1u );
+
+	BOOST_CHECK( !integrator.getEventInfo( 0 ).stateEvent );
+	BOOST_CHECK_EQUAL( ensemble[0].getTime(), 0.2 );
+
+	const Integrator::EventInfo& eventInfo = integrator.getEventInfo( 1 );
+	BOOST_CHECK( eventInfo.stateEvent );
+	BOOST_CHECK_LE( eventInfo.tLower, std::log( 12. / 11. ) );
+	BOOST_CHECK_GE( eventInfo.tUpper, std::log( 12. / 11. ) );
+	BOOST_CHECK_EQUAL( ensemble[1].getTime(), eventInfo.tLower );
+}
@@ -0,0 +1,108 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testFMUMemoryPool
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "import/utility/include/FMUMemoryPool.h"
+
+
+/// Released blocks are reused for allocations of the same size class (and handed out zeroed).
+BOOST_AUTO_TEST_CASE( test_block_reuse )
+{
+	FMUMemoryPool pool;
+
+	char* block = static_cast<char*>( pool.allocate( 1, 100 ) );
+	BOOST_REQUIRE( 0 != block );
+	const fmippSize reserved = pool.getReservedBytes();
+	BOOST_CHECK( reserved > 0 );
+
+	std::memset( block, 0xff, 100 );
+	pool.release( block );
+
+	// Same size class (65 to 128 bytes).
+	char* reused = static_cast<char*>( pool.allocate( 10, 12 ) );
+	BOOST_CHECK( reused == block );
+	BOOST_CHECK_EQUAL( pool.getReservedBytes(), reserved );
+	for ( fmippSize i = 0; i < 120; ++i ) BOOST_REQUIRE_EQUAL( reused[i], 0 );
+
+	// A different size class takes a new block from the same chunk.
+	void* other = pool.allocate( 1, 16 );
+	BOOST_CHECK( other != reused );
+	BOOST_CHECK_EQUAL( pool.getReservedBytes(), reserved );
+
+	pool.release( reused );
+	pool.release( other );
+	BOOST_CHECK_EQUAL( pool.getLiveAllocations(), 0u );
+}
+
+
+/// The counters follow allocations and releases of small and large blocks.
+BOOST_AUTO_TEST_CASE( test_counters )
+{
+	FMUMemoryPool pool;
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 0u );
+	BOOST_CHECK_EQUAL( pool.getReservedBytes(), 0u );
+
+	void* small = pool.allocate( 3, 10 );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 30u );
+	BOOST_CHECK_EQUAL( pool.getLiveAllocations(), 1u );
+
+	const fmippSize largeSize = 4 * FMUMemoryPool::maxPooledBlockSize;
+	const fmippSize reservedBefore = pool.getReservedBytes();
+	void* large = pool.allocate( 1, largeSize );
+	BOOST_REQUIRE( 0 != large );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 30u + largeSize );
+	BOOST_CHECK( pool.getReservedBytes() >= reservedBefore + largeSize );
+	BOOST_CHECK_EQUAL( pool.getPeakBytes(), 30u + largeSize );
+
+	// Large blocks are returned to the heap right away.
+	pool.release( large );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 30u );
+	BOOST_CHECK_EQUAL( pool.getReservedBytes(), reservedBefore );
+	BOOST_CHECK_EQUAL( pool.getPeakBytes(), 30u + largeSize );
+
+	pool.release( small );
+	pool.release( 0 );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 0u );
+	BOOST_CHECK_EQUAL( pool.getLiveAllocations(), 0u );
+	BOOST_CHECK_EQUAL( pool.getAllocationCount(), 2u );
+
+	// Overflowing requests fail without changing the counters.
+	BOOST_CHECK( 0 == pool.allocate( ~fmippSize( 0 ), 2 ) );
+	BOOST_CHECK_EQUAL( pool.getAllocationCount(), 2u );
+}
+
+
+/// The callback functions of a pool serve allocations from that pool, the number of pools
+/// with callbacks is limited and their slots are reused.
+BOOST_AUTO_TEST_CASE( test_callbacks )
+{
+	std::vector< std::unique_ptr<FMUMemoryPool> > pools;
+	for ( fmippSize i = 0; i < FMUMemoryPool::maxPoolsWithCallbacks; ++i ) {
+		pools.push_back( std::unique_ptr<FMUMemoryPool>( new FMUMemoryPool ) );
+		BOOST_REQUIRE( pools.back()->hasCallbacks() );
+	}
+
+	FMUMemoryPool overflow;
+	BOOST_CHECK( false == overflow.hasCallbacks() );
+	BOOST_CHECK( 0 == overflow.getAllocateMemoryCallback() );
+
+	FMUMemoryPool& pool = *pools[7];
+	void* obj = pool.getAllocateMemoryCallback()( 4, 8 );
+	BOOST_REQUIRE( 0 != obj );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 32u );
+	BOOST_CHECK_EQUAL( pools[8]->getLiveBytes(), 0u );
+	pool.getFreeMemoryCallback()( obj );
+	BOOST_CHECK_EQUAL( pool.getLiveBytes(), 0u );
+
+	pools[3].reset();
+	FMUMemoryPool reused;
+	BOOST_CHECK( reused.hasCallbacks() );
+}
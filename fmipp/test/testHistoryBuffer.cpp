@@ -0,0 +1,92 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testHistoryBuffer
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include "import/utility/include/History.h"
+
+namespace {
+
+/// Entry with 2 states, 1 real, 1 integer, 1 boolean and 1 string value, all derived from t.
+HistoryEntry makeEntry( fmippTime t )
+{
+	HistoryEntry entry( t, 2, 1, 1, 1, 1 );
+	entry.state_[0] = t;
+	entry.state_[1] = -t;
+	entry.realValues_[0] = 2. * t;
+	entry.integerValues_[0] = static_cast<fmippInteger>( t );
+	entry.booleanValues_[0] = ( static_cast<fmippInteger>( t ) % 2 ) ? fmippTrue : fmippFalse;
+	entry.stringValues_[0] = std::to_string( static_cast<fmippInteger>( t ) );
+	return entry;
+}
+
+void checkEntry( const HistoryBuffer& buffer, fmippSize i, fmippTime t )
+{
+	BOOST_CHECK_EQUAL( buffer.time( i ), t );
+	BOOST_CHECK_EQUAL( buffer.state( i, 0 ), t );
+	BOOST_CHECK_EQUAL( buffer.state( i, 1 ), -t );
+	BOOST_CHECK_EQUAL( buffer.realValue( i, 0 ), 2. * t );
+
+	HistoryEntry entry;
+	buffer.get( i, entry );
+	BOOST_CHECK_EQUAL( entry.time_, t );
+	BOOST_CHECK_EQUAL( entry.state_[1], -t );
+	BOOST_CHECK_EQUAL( entry.integerValues_[0], static_cast<fmippInteger>( t ) );
+	BOOST_CHECK_EQUAL( entry.booleanValues_[0], ( static_cast<fmippInteger>( t ) % 2 ) ? fmippTrue : fmippFalse );
+	BOOST_CHECK_EQUAL( entry.stringValues_[0], std::to_string( static_cast<fmippInteger>( t ) ) );
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( test_ring_buffer )
+{
+	HistoryBuffer buffer;
+	buffer.reserve( 4, 2, 1, 1, 1, 1 );
+	const fmippSize capacity = buffer.capacity();
+
+	// Wrap around the end of the arena without growing.
+	for ( fmippSize t = 0; t < capacity; ++t ) buffer.push_back( makeEntry( t ) );
+	buffer.pop_front();
+	buffer.pop_front();
+	buffer.push_back( makeEntry( capacity ) );
+	buffer.push_back( makeEntry( capacity + 1 ) );
+	BOOST_CHECK_EQUAL( buffer.capacity(), capacity );
+	BOOST_REQUIRE_EQUAL( buffer.size(), capacity );
+	for ( fmippSize i = 0; i < buffer.size(); ++i ) checkEntry( buffer, i, i + 2 );
+
+	// Growing a wrapped buffer preserves the order of the entries.
+	buffer.push_back( makeEntry( capacity + 2 ) );
+	BOOST_CHECK( buffer.capacity() > capacity );
+	BOOST_REQUIRE_EQUAL( buffer.size(), capacity + 1 );
+	for ( fmippSize i = 0; i < buffer.size(); ++i ) checkEntry( buffer, i, i + 2 );
+
+	buffer.set( 0, makeEntry( 1 ) );
+	checkEntry( buffer, 0, 1 );
+
+	buffer.clear();
+	BOOST_CHECK( buffer.empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_find_last )
+{
+	HistoryBuffer buffer;
+	buffer.reserve( 8, 2, 1, 1, 1, 1 );
+	BOOST_CHECK_EQUAL( buffer.findLast( 1. ), 0u );
+
+	buffer.push_back( makeEntry( 0. ) );
+	buffer.pop_front();
+	for ( fmippSize t = 1; t <= 5; ++t ) buffer.push_back( makeEntry( t ) );
+
+	BOOST_CHECK_EQUAL( buffer.findLast( 0.5 ), buffer.size() );
+	BOOST_CHECK_EQUAL( buffer.findLast( 1. ), 0u );
+	BOOST_CHECK_EQUAL( buffer.findLast( 3.5 ), 2u );
+	BOOST_CHECK_EQUAL( buffer.findLast( 5. ), 4u );
+	BOOST_CHECK_EQUAL( buffer.findLast( 10. ), 4u );
+}
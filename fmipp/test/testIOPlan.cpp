@@ -0,0 +1,112 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testIOPlan
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "import/base/include/FMUCoSimulation_v2.h"
+#include "import/utility/include/IOPlan.h"
+
+using namespace fmi_2_0;
+
+namespace {
+
+const std::string fmuUri = FMU_URI_PRE "thermostat";
+const std::string modelIdentifier = "thermostat";
+
+void initialize( FMUCoSimulation& fmu, const std::string& instanceName )
+{
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( instanceName, 0., fmippFalse, fmippFalse ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize( 0., fmippFalse, 0. ), fmippOK );
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( test_resolve_variables )
+{
+	FMUCoSimulation fmu( fmuUri, modelIdentifier );
+	initialize( fmu, "thermostat1" );
+
+	IOPlan plan( fmu, std::vector<std::string>{ "u" }, std::vector<std::string>{ "y", "ticks", "on" } );
+	BOOST_CHECK( plan.isValid() );
+	BOOST_CHECK_EQUAL( plan.nInputs(), 1u );
+	BOOST_CHECK_EQUAL( plan.nOutputs(), 3u );
+	BOOST_CHECK_EQUAL( plan.getOutputType( 0 ), fmippTypeReal );
+	BOOST_CHECK_EQUAL( plan.getOutputType( 1 ), fmippTypeInteger );
+	BOOST_CHECK_EQUAL( plan.getOutputType( 2 ), fmippTypeBoolean );
+
+	// Type mismatch.
+	BOOST_CHECK( false == plan.setInput( 0, fmippInteger( 1 ) ) );
+
+	IOPlan invalid( fmu, std::vector<std::string>(), std::vector<std::string>{ "y", "unknown" } );
+	BOOST_CHECK( false == invalid.isValid() );
+	BOOST_CHECK_EQUAL( invalid.getOutputType( 1 ), fmippTypeUnknown );
+}
+
+
+/// Copies of a plan share the resolved variables but not the value buffers.
+BOOST_AUTO_TEST_CASE( test_copies_have_own_buffers )
+{
+	FMUCoSimulation fmu1( fmuUri, modelIdentifier );
+	initialize( fmu1, "thermostat1" );
+	FMUCoSimulation fmu2( modelIdentifier );
+	initialize( fmu2, "thermostat2" );
+
+	const IOPlan compiled( fmu1, std::vector<std::string>{ "u" }, std::vector<std::string>{ "y" } );
+	IOPlan plan1( compiled );
+	IOPlan plan2( compiled );
+	BOOST_CHECK( plan2.isValid() );
+
+	BOOST_CHECK( plan1.setInput( 0, fmippReal( 5. ) ) );
+	BOOST_CHECK( plan2.setInput( 0, fmippReal( -5. ) ) );
+	BOOST_CHECK_EQUAL( plan1.applyInputs( fmu1 ), fmippOK );
+	BOOST_CHECK_EQUAL( plan2.applyInputs( fmu2 ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu1.getRealValue( "u" ), 5. );
+	BOOST_CHECK_EQUAL( fmu2.getRealValue( "u" ), -5. );
+
+	BOOST_REQUIRE_EQUAL( fmu1.doStep( 0., 0.1, fmippTrue ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu2.doStep( 0., 0.1, fmippTrue ), fmippOK );
+
+	BOOST_CHECK_EQUAL( plan1.fetchOutputs( fmu1 ), fmippOK );
+	BOOST_CHECK_EQUAL( plan2.fetchOutputs( fmu2 ), fmippOK );
+
+	fmippReal y1 = 0., y2 = 0.;
+	BOOST_CHECK( plan1.getOutput( 0, y1 ) );
+	BOOST_CHECK( plan2.getOutput( 0, y2 ) );
+	BOOST_CHECK_EQUAL( y1, fmu1.getRealValue( "y" ) );
+	BOOST_CHECK_EQUAL( y2, fmu2.getRealValue( "y" ) );
+	BOOST_CHECK( y1 > 0. );
+	BOOST_CHECK( y2 < 0. );
+}
+
+
+/// Inputs that have not been set are applied as zero (the value buffers are initialized).
+BOOST_AUTO_TEST_CASE( test_unset_inputs_are_zero )
+{
+	FMUCoSimulation fmu( fmuUri, modelIdentifier );
+	initialize( fmu, "thermostat1" );
+	BOOST_REQUIRE_EQUAL( fmu.setValue( "u", fmippReal( 3. ) ), fmippOK );
+
+	IOPlan plan( fmu, std::vector<std::string>{ "u" }, std::vector<std::string>{ "y", "ticks", "on" } );
+	BOOST_REQUIRE( plan.isValid() );
+
+	// Outputs that have not been fetched yet are zero as well.
+	fmippReal y = -1.;
+	fmippInteger ticks = -1;
+	fmippBoolean on = fmippTrue;
+	BOOST_CHECK( plan.getOutput( 0, y ) );
+	BOOST_CHECK( plan.getOutput( 1, ticks ) );
+	BOOST_CHECK( plan.getOutput( 2, on ) );
+	BOOST_CHECK_EQUAL( y, 0. );
+	BOOST_CHECK_EQUAL( ticks, 0 );
+	BOOST_CHECK( false == on );
+
+	BOOST_CHECK_EQUAL( plan.applyInputs( fmu ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu.getRealValue( "u" ), 0. );
+}
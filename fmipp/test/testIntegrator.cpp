@@ -0,0 +1,144 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testIntegrator
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "import/base/include/FMUModelExchange_v2.h"
+
+using namespace fmi_2_0;
+
+namespace {
+
+const std::string fmuUri = FMU_URI_PRE "thermostat";
+const std::string chainUri = FMU_URI_PRE "chain";
+
+/// Temperature of the thermostat (heater on) after time dt, starting at x0 with input u.
+double heating( double x0, double u, double dt )
+{
+	return 2. + u - ( 2. + u - x0 ) * std::exp( -dt );
+}
+
+void initialize( FMUModelExchange& fmu )
+{
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( "thermostat1" ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+}
+
+}
+
+/// The steppers with dense output continue their last step only if the FMU has not been changed.
+BOOST_AUTO_TEST_CASE( test_continue_after_input_change )
+{
+	const IntegratorType types[] = { IntegratorType::dp, IntegratorType::ck };
+
+	for ( IntegratorType type : types ) {
+		FMUModelExchange fmu( fmuUri, "thermostat", fmippFalse, fmippFalse, 1e-6, type );
+		initialize( fmu );
+
+		fmu.integrate( 0.5, 0.1 );
+		const double x0 = fmu.getRealValue( "x" );
+		BOOST_CHECK_SMALL( x0 - heating( 0., 0., 0.5 ), 1e-5 );
+
+		// The last step of the stepper (with u = 0) ends after t = 0.52.
+		fmu.setValue( "u", 5. );
+		fmu.integrate( 0.52, 0.1 );
+		BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - heating( x0, 5., 0.02 ), 1e-5 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_continue_after_state_change )
+{
+	const IntegratorType types[] = { IntegratorType::dp, IntegratorType::ck };
+
+	for ( IntegratorType type : types ) {
+		FMUModelExchange fmu( fmuUri, "thermostat", fmippFalse, fmippFalse, 1e-6, type );
+		initialize( fmu );
+
+		fmu.integrate( 0.5, 0.1 );
+
+		const fmippReal x0 = 0.2;
+		fmu.setContinuousStates( &x0 );
+		fmu.integrate( 0.55, 0.1 );
+		BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - heating( x0, 0., 0.05 ), 1e-5 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_continue_without_change )
+{
+	const IntegratorType types[] = { IntegratorType::dp, IntegratorType::ck };
+
+	for ( IntegratorType type : types ) {
+		FMUModelExchange fmu( fmuUri, "thermostat", fmippFalse, fmippFalse, 1e-6, type );
+		initialize( fmu );
+
+		for ( int i = 1; i <= 6; ++i ) {
+			fmu.integrate( 0.1 * i, 0.1 );
+			BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - heating( 0., 0., 0.1 * i ), 1e-5 );
+		}
+	}
+}
+
+/// Continuing the last step gives the same states (and steps) as a fresh integration to the same
+/// time, since the steps of the controlled steppers do not depend on the end of the integration.
+BOOST_AUTO_TEST_CASE( test_continue_equals_fresh_integration )
+{
+	const IntegratorType types[] = { IntegratorType::dp, IntegratorType::ck };
+	const fmippSize nStates = 4;
+
+	for ( IntegratorType type : types ) {
+		FMUModelExchange continued( chainUri, "chain", fmippFalse, fmippFalse, 1e-6, type );
+		BOOST_REQUIRE_EQUAL( continued.instantiate( "chain1" ), fmippOK );
+		BOOST_REQUIRE_EQUAL( continued.initialize(), fmippOK );
+		continued.enableIntegratorStatistics();
+
+		for ( int i = 1; i <= 10; ++i ) {
+			const fmippTime time = 0.15 * i;
+			continued.integrate( time, 0.1 );
+
+			FMUModelExchange fresh( chainUri, "chain", fmippFalse, fmippFalse, 1e-6, type );
+			BOOST_REQUIRE_EQUAL( fresh.instantiate( "chain2" ), fmippOK );
+			BOOST_REQUIRE_EQUAL( fresh.initialize(), fmippOK );
+			fresh.enableIntegratorStatistics();
+			fresh.integrate( time, 0.1 );
+
+			std::vector<fmippReal> states( nStates );
+			std::vector<fmippReal> expected( nStates );
+			continued.getContinuousStates( &states[0] );
+			fresh.getContinuousStates( &expected[0] );
+			BOOST_CHECK_EQUAL_COLLECTIONS( states.begin(), states.end(), expected.begin(), expected.end() );
+
+			// The continued integration has not taken any additional steps.
+			BOOST_CHECK_EQUAL( continued.getIntegratorStatistics()->acceptedSteps,
+				fresh.getIntegratorStatistics()->acceptedSteps );
+			BOOST_CHECK_EQUAL( continued.getIntegratorStatistics()->rejectedSteps,
+				fresh.getIntegratorStatistics()->rejectedSteps );
+		}
+
+		// der(x1) = -x1 with x1(0) = 1.
+		BOOST_CHECK_SMALL( continued.getRealValue( "x1" ) - std::exp( -1.5 ), 1e-5 );
+	}
+}
+
+/// The heater is switched off at x = 1, i.e., at t = ln(2) when starting at x = 0.
+BOOST_AUTO_TEST_CASE( test_locate_state_event )
+{
+	const IntegratorType types[] = { IntegratorType::dp, IntegratorType::ck, IntegratorType::rk };
+	const double precision = 1e-6;
+
+	for ( IntegratorType type : types ) {
+		FMUModelExchange fmu( fmuUri, "thermostat", fmippFalse, fmippFalse, precision, type );
+		initialize( fmu );
+
+		const fmippTime time = fmu.integrate( 2., 0.1 );
+		BOOST_CHECK_SMALL( time - std::log( 2. ), precision );
+		BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - 1., 1e-5 );
+		BOOST_CHECK_EQUAL( fmu.getBooleanValue( "on" ), fmippFalse );
+	}
+}
@@ -0,0 +1,230 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testModelDescription
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "import/base/include/ModelDescription.h"
+#include "import/base/include/ModelDescriptionReader.h"
+#include "import/base/include/PathFromUrl.h"
+
+namespace {
+
+typedef ModelDescription::Properties Properties;
+
+std::string getXmlFilePath( const std::string& fmuName )
+{
+	std::string path;
+	BOOST_REQUIRE( PathFromUrl::getPathFromUrl( std::string( FMU_URI_PRE ) + fmuName + "/modelDescription.xml", path ) );
+	return path;
+}
+
+std::string readFile( const std::string& path )
+{
+	std::ifstream in( path.c_str(), std::ios::in | std::ios::binary );
+	BOOST_REQUIRE( in );
+	return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+}
+
+void writeFile( const std::string& path, const std::string& contents )
+{
+	std::ofstream out( path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+	out << contents;
+	BOOST_REQUIRE( out );
+}
+
+/// Parse with Boost's XML parser (as done before the streaming parser was introduced).
+Properties parseWithPropertyTree( const std::string& xml )
+{
+	using namespace boost::property_tree::xml_parser;
+	Properties tree;
+	std::istringstream in( xml );
+	read_xml( in, tree, trim_whitespace | no_comments );
+	return tree;
+}
+
+/// Remove the contents of ModelVariables and ModelStructure (except their attributes),
+/// which the streaming parser does not store in the PropertyTree.
+void removeVariablesAndStructure( Properties& tree )
+{
+	Properties& root = tree.get_child( "fmiModelDescription" );
+	for ( Properties::iterator it = root.begin(); it != root.end(); ++it ) {
+		if ( ( "ModelVariables" != it->first ) && ( "ModelStructure" != it->first ) ) continue;
+		Properties& node = it->second;
+		for ( Properties::iterator child = node.begin(); child != node.end(); ) {
+			if ( "<xmlattr>" == child->first ) ++child;
+			else child = node.erase( child );
+		}
+	}
+}
+
+/// Compare the streaming parser with Boost's XML parser.
+void checkParser( const std::string& xml )
+{
+	ModelDescriptionReader::Contents contents;
+	BOOST_REQUIRE( ModelDescriptionReader::parseXml( xml.data(), xml.data() + xml.size(), contents ) );
+
+	Properties expected = parseWithPropertyTree( xml );
+
+	// Compare the compact table of scalar variables with the complete tree.
+	const Properties& modelVariables = expected.get_child( "fmiModelDescription.ModelVariables" );
+	ModelDescription::ScalarVariables::const_iterator variable = contents.variables.begin();
+	for ( Properties::const_iterator it = modelVariables.begin(); it != modelVariables.end(); ++it ) {
+		if ( "ScalarVariable" != it->first ) continue;
+		BOOST_REQUIRE( variable != contents.variables.end() );
+		BOOST_CHECK_EQUAL( variable->name, it->second.get<std::string>( "<xmlattr>.name" ) );
+		BOOST_CHECK_EQUAL( variable->valueReference, it->second.get<fmippValueReference>( "<xmlattr>.valueReference" ) );
+		const fmippBoolean isReal = ( 0 != it->second.count( "Real" ) );
+		BOOST_CHECK_EQUAL( isReal, fmippTypeReal == variable->type );
+		++variable;
+	}
+	BOOST_CHECK( variable == contents.variables.end() );
+
+	removeVariablesAndStructure( expected );
+	BOOST_CHECK( expected == contents.data );
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( test_parser_matches_property_tree )
+{
+	checkParser( readFile( getXmlFilePath( "thermostat" ) ) );
+	checkParser( readFile( getXmlFilePath( "ticker" ) ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_parser_entities_cdata_comments )
+{
+	const std::string xml =
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<!-- leading comment -->\n"
+		"<fmiModelDescription fmiVersion=\"2.0\" modelName=\"a &amp; b\" description=\"&lt;x&gt; &quot;y&quot; &apos;z&apos; &#65;&#x42;\">\n"
+		"  <!-- comment inside the root element -->\n"
+		"  <?custom processing instruction?>\n"
+		"  <VendorAnnotations>\n"
+		"    <Tool name=\"t\"><![CDATA[<raw> & text]]></Tool>\n"
+		"    <Tool name=\"u\">plain <!-- ignored --> text &amp; more</Tool>\n"
+		"  </VendorAnnotations>\n"
+		"  <ModelVariables>\n"
+		"    <!-- comment between variables -->\n"
+		"    <ScalarVariable name=\"&lt;a&gt;\" valueReference=\"7\"><Real start=\"1\"/></ScalarVariable>\n"
+		"    <ScalarVariable name='b' valueReference='8'><Integer/></ScalarVariable>\n"
+		"  </ModelVariables>\n"
+		"</fmiModelDescription>\n";
+
+	checkParser( xml );
+
+	ModelDescriptionReader::Contents contents;
+	BOOST_REQUIRE( ModelDescriptionReader::parseXml( xml.data(), xml.data() + xml.size(), contents ) );
+	BOOST_CHECK_EQUAL( contents.data.get<std::string>( "fmiModelDescription.<xmlattr>.modelName" ), "a & b" );
+	BOOST_CHECK_EQUAL( contents.data.get<std::string>( "fmiModelDescription.<xmlattr>.description" ), "<x> \"y\" 'z' AB" );
+	BOOST_CHECK_EQUAL( contents.data.get<std::string>( "fmiModelDescription.VendorAnnotations.Tool" ), "<raw> & text" );
+	BOOST_REQUIRE_EQUAL( contents.variables.size(), 2u );
+	BOOST_CHECK_EQUAL( contents.variables[0].name, "<a>" );
+	BOOST_CHECK_EQUAL( contents.variables[1].type, fmippTypeInteger );
+
+	// Malformed XML is rejected.
+	const std::string malformed = "<fmiModelDescription><ModelVariables></fmiModelDescription>";
+	BOOST_CHECK( false == ModelDescriptionReader::parseXml( malformed.data(), malformed.data() + malformed.size(), contents ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_cache_invalidated_by_changed_xml )
+{
+	const std::string xmlFilePath = "testModelDescription.xml";
+	const std::string cacheFilePath = ModelDescriptionReader::getCacheFilePath( xmlFilePath );
+	const std::string xml = readFile( getXmlFilePath( "thermostat" ) );
+	std::remove( cacheFilePath.c_str() );
+
+	writeFile( xmlFilePath, xml );
+	{
+		ModelDescription description( xmlFilePath );
+		BOOST_REQUIRE( description.isValid() );
+		BOOST_CHECK_EQUAL( description.getModelAttributes().get<std::string>( "modelName" ), "thermostat" );
+		BOOST_CHECK_EQUAL( description.getScalarVariables().at( 2 ).name, "u" );
+	}
+	BOOST_REQUIRE( std::ifstream( cacheFilePath.c_str() ) );
+
+	// Same size, different contents: only the hash differs.
+	std::string changed = xml;
+	changed.replace( changed.find( "modelName=\"thermostat\"" ), 22, "modelName=\"thermostaT\"" );
+	changed.replace( changed.find( "name=\"u\"" ), 8, "name=\"v\"" );
+	writeFile( xmlFilePath, changed );
+	{
+		ModelDescription description( xmlFilePath );
+		BOOST_REQUIRE( description.isValid() );
+		BOOST_CHECK_EQUAL( description.getModelAttributes().get<std::string>( "modelName" ), "thermostaT" );
+		BOOST_CHECK_EQUAL( description.getScalarVariables().at( 2 ).name, "v" );
+	}
+
+	// Reading the (rewritten) cache gives the same result as parsing.
+	ModelDescriptionReader::Contents parsed;
+	ModelDescriptionReader::Contents cached;
+	BOOST_REQUIRE( ModelDescriptionReader::parseXml( changed.data(), changed.data() + changed.size(), parsed ) );
+	const fmippUInt64 hash = ModelDescriptionReader::computeHash( changed.data(), changed.data() + changed.size() );
+	BOOST_REQUIRE( ModelDescriptionReader::readCache( cacheFilePath, changed.size(), hash, cached ) );
+	BOOST_CHECK( parsed.data == cached.data );
+	BOOST_CHECK_EQUAL( parsed.variables.size(), cached.variables.size() );
+	BOOST_CHECK( parsed.dependencies == cached.dependencies );
+	BOOST_CHECK( parsed.dependenciesKinds == cached.dependenciesKinds );
+
+	std::remove( xmlFilePath.c_str() );
+	std::remove( cacheFilePath.c_str() );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_corrupt_cache_is_discarded )
+{
+	const std::string xmlFilePath = "testModelDescriptionCorrupt.xml";
+	const std::string cacheFilePath = ModelDescriptionReader::getCacheFilePath( xmlFilePath );
+	const std::string xml = readFile( getXmlFilePath( "thermostat" ) );
+	const fmippUInt64 hash = ModelDescriptionReader::computeHash( xml.data(), xml.data() + xml.size() );
+
+	ModelDescriptionReader::Contents contents;
+	BOOST_REQUIRE( ModelDescriptionReader::parseXml( xml.data(), xml.data() + xml.size(), contents ) );
+	BOOST_REQUIRE( ModelDescriptionReader::writeCache( cacheFilePath, xml.size(), hash, contents ) );
+	const std::string cache = readFile( cacheFilePath );
+
+	// The header (magic, version, byte order, size, hash) is followed by the PropertyTree, whose data
+	// is an empty string and whose child count comes next. Overwrite it with a huge count.
+	const std::size_t headerSize = 8 + 4 + 4 + 8 + 8;
+	std::string corrupt = cache;
+	corrupt.replace( headerSize + 4, 4, std::string( 4, '\xff' ) );
+	writeFile( cacheFilePath, corrupt );
+	ModelDescriptionReader::Contents result;
+	BOOST_CHECK( false == ModelDescriptionReader::readCache( cacheFilePath, xml.size(), hash, result ) );
+
+	// Huge counts at the end of the file (the count of the kinds of the last derivative).
+	corrupt = cache;
+	corrupt.replace( corrupt.size() - 6, 4, std::string( 4, '\xff' ) );
+	writeFile( cacheFilePath, corrupt );
+	BOOST_CHECK( false == ModelDescriptionReader::readCache( cacheFilePath, xml.size(), hash, result ) );
+
+	// Truncated file.
+	writeFile( cacheFilePath, cache.substr( 0, cache.size() / 2 ) );
+	BOOST_CHECK( false == ModelDescriptionReader::readCache( cacheFilePath, xml.size(), hash, result ) );
+
+	// The model description falls back to parsing the XML file (and replaces the corrupt cache).
+	writeFile( xmlFilePath, xml );
+	writeFile( cacheFilePath, corrupt );
+	{
+		ModelDescription description( xmlFilePath );
+		BOOST_REQUIRE( description.isValid() );
+		BOOST_CHECK_EQUAL( description.getScalarVariables().size(), contents.variables.size() );
+	}
+	BOOST_CHECK( ModelDescriptionReader::readCache( cacheFilePath, xml.size(), hash, result ) );
+
+	std::remove( xmlFilePath.c_str() );
+	std::remove( cacheFilePath.c_str() );
+}
@@ -0,0 +1,96 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testModelManager
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "import/base/include/ModelManager.h"
+
+namespace {
+
+const unsigned int nThreads = 8;
+
+/// Call loadFMU from several threads at the same time and collect the results.
+template<typename LoadFunction>
+std::vector<ModelManager::LoadFMUStatus> loadConcurrently( LoadFunction load )
+{
+	std::vector<ModelManager::LoadFMUStatus> status( nThreads, ModelManager::failed );
+	std::atomic<unsigned int> ready( 0 );
+	std::vector<std::thread> threads;
+
+	for ( unsigned int i = 0; i < nThreads; ++i ) {
+		threads.push_back( std::thread( [&status, &ready, &load, i] () {
+			// Start all threads at (almost) the same time.
+			++ready;
+			while ( ready < nThreads ) std::this_thread::yield();
+			status[i] = load();
+		} ) );
+	}
+
+	for ( std::thread& thread : threads ) thread.join();
+	return status;
+}
+
+unsigned int count( const std::vector<ModelManager::LoadFMUStatus>& status, ModelManager::LoadFMUStatus value )
+{
+	unsigned int n = 0;
+	for ( ModelManager::LoadFMUStatus s : status ) if ( value == s ) ++n;
+	return n;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_load_by_model_identifier )
+{
+	const std::string fmuUri = FMU_URI_PRE "thermostat";
+	const fmippSize residentModels = ModelManager::getResidentStatistics().residentModels;
+
+	std::vector<ModelManager::LoadFMUStatus> status = loadConcurrently( [&fmuUri] () {
+		FMUType type = invalid;
+		ModelManager::LoadFMUStatus s = ModelManager::loadFMU( "thermostat", fmuUri, fmippFalse, type );
+		return ( fmi_2_0_me_and_cs == type ) ? s : ModelManager::failed;
+	} );
+
+	// The FMU is loaded by exactly one thread, all other threads reuse it.
+	BOOST_CHECK_EQUAL( count( status, ModelManager::success ), 1u );
+	BOOST_CHECK_EQUAL( count( status, ModelManager::duplicate ), nThreads - 1 );
+	BOOST_CHECK_EQUAL( ModelManager::getResidentStatistics().residentModels, residentModels + 1 );
+
+	BOOST_CHECK( ModelManager::getInstance( "thermostat" ) );
+	BOOST_CHECK_EQUAL( ModelManager::unloadFMU( "thermostat" ), ModelManager::ok );
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_load_by_directory )
+{
+	const std::string fmuUri = FMU_URI_PRE "ticker";
+	const fmippSize residentModels = ModelManager::getResidentStatistics().residentModels;
+
+	std::vector<ModelManager::LoadFMUStatus> status = loadConcurrently( [&fmuUri] () {
+		FMUType type = invalid;
+		std::string modelIdentifier;
+		ModelManager::LoadFMUStatus s = ModelManager::loadFMU( fmuUri, fmippFalse, type, modelIdentifier );
+		return ( ( fmi_1_0_cs == type ) && ( "ticker" == modelIdentifier ) ) ? s : ModelManager::failed;
+	} );
+
+	BOOST_CHECK_EQUAL( count( status, ModelManager::success ), 1u );
+	BOOST_CHECK_EQUAL( count( status, ModelManager::duplicate ), nThreads - 1 );
+	BOOST_CHECK_EQUAL( ModelManager::getResidentStatistics().residentModels, residentModels + 1 );
+
+	BOOST_CHECK( ModelManager::getSlave( "ticker" ) );
+	BOOST_CHECK_EQUAL( ModelManager::unloadFMU( "ticker" ), ModelManager::ok );
+}
+
+BOOST_AUTO_TEST_CASE( test_load_unknown_fmu )
+{
+	FMUType type = invalid;
+	BOOST_CHECK_EQUAL( ModelManager::loadFMU( "thermostat", FMU_URI_PRE "does_not_exist", fmippFalse, type ),
+		ModelManager::description_invalid );
+	BOOST_CHECK( !ModelManager::getInstance( "does_not_exist" ) );
+}
@@ -0,0 +1,202 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testNumericalJacobian
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "import/base/include/BareFMU.h"
+#include "import/base/include/FMUModelExchange_v2.h"
+#include "import/base/include/ModelDescription.h"
+#include "import/base/include/ModelManager.h"
+#include "import/integrators/include/NumericalJacobian.h"
+
+using namespace fmi_2_0;
+
+namespace {
+
+const std::string fmuUri = FMU_URI_PRE "thermostat";
+const std::string chainUri = FMU_URI_PRE "chain";
+
+/// Number of states of the chain FMU.
+const fmippSize nChain = 4;
+
+/// Check that no two columns of the same color share a non-zero row and that all columns are colored.
+void checkColoring( const JacobianColoring& coloring )
+{
+	std::set<fmippSize> colored;
+	for ( fmippSize c = 0; c < coloring.nColors(); ++c ) {
+		std::set<fmippSize> rows;
+		for ( const fmippSize* j = coloring.columnsBegin( c ); j != coloring.columnsEnd( c ); ++j ) {
+			BOOST_CHECK( colored.insert( *j ).second );
+			for ( const fmippSize* i = coloring.rowsBegin( *j ); i != coloring.rowsEnd( *j ); ++i )
+				BOOST_CHECK( rows.insert( *i ).second );
+		}
+	}
+	BOOST_CHECK_EQUAL( colored.size(), coloring.size() );
+}
+
+
+/// Assemble the Jacobian of the chain FMU column by column (one directional derivative of all
+/// state derivatives per state), using a separate instance of the loaded FMU.
+std::vector<fmippReal> getDenseChainJacobian( fmippReal k )
+{
+	using namespace fmi2;
+
+	BareFMU2Ptr bareFMU = ModelManager::getInstance( "chain" );
+	BOOST_REQUIRE( bareFMU );
+	FMU2_functions* functions = bareFMU->functions;
+
+	fmi2CallbackFunctions callbacks = { 0, 0, 0, 0, 0 };
+	fmi2Component instance = functions->instantiate( "dense", fmi2ModelExchange,
+		bareFMU->description->getGUID().c_str(), bareFMU->fmuResourceLocation.c_str(), &callbacks, fmi2False, fmi2False );
+	BOOST_REQUIRE( 0 != instance );
+
+	const fmi2ValueReference kRef = 8;
+	BOOST_REQUIRE_EQUAL( functions->setReal( instance, &kRef, 1, &k ), fmi2OK );
+
+	fmi2ValueReference derivativesRefs[nChain];
+	for ( fmippSize i = 0; i < nChain; ++i ) derivativesRefs[i] = nChain + i;
+
+	std::vector<fmippReal> J( nChain*nChain );
+	const fmi2Real seed = 1.;
+	for ( fmippSize j = 0; j < nChain; ++j ) {
+		const fmi2ValueReference stateRef = j;
+		BOOST_REQUIRE_EQUAL( functions->getDirectionalDerivative( instance,
+			derivativesRefs, nChain, &stateRef, 1, &seed, &J[nChain*j] ), fmi2OK );
+	}
+
+	functions->freeInstance( instance );
+	return J;
+}
+
+}
+
+
+BOOST_AUTO_TEST_CASE( test_dense_coloring )
+{
+	JacobianColoring coloring;
+	coloring.initialize( JacobianColoring::Sparsity(), 4 );
+	BOOST_CHECK_EQUAL( coloring.nColors(), 4u );
+	checkColoring( coloring );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_tridiagonal_coloring )
+{
+	const fmippSize N = 10;
+	JacobianColoring::Sparsity sparsity( N );
+	for ( fmippSize i = 0; i < N; ++i ) {
+		if ( i > 0 ) sparsity[i].push_back( i - 1 );
+		sparsity[i].push_back( i );
+		if ( i + 1 < N ) sparsity[i].push_back( i + 1 );
+	}
+
+	JacobianColoring coloring;
+	coloring.initialize( sparsity, N );
+	BOOST_CHECK_EQUAL( coloring.nColors(), 3u );
+	checkColoring( coloring );
+}
+
+
+BOOST_AUTO_TEST_CASE( test_diagonal_coloring )
+{
+	const fmippSize N = 10;
+	JacobianColoring::Sparsity sparsity( N );
+	for ( fmippSize i = 0; i < N; ++i ) sparsity[i].push_back( i );
+
+	JacobianColoring coloring;
+	coloring.initialize( sparsity, N );
+	BOOST_CHECK_EQUAL( coloring.nColors(), 1u );
+	checkColoring( coloring );
+}
+
+
+/// der(x) = 2 - x + u for the thermostat with heater on, i.e., J = -1 and df/dt = 0.
+BOOST_AUTO_TEST_CASE( test_thermostat_jacobian )
+{
+	const NumericalJacobian::Method methods[] = {
+		NumericalJacobian::forward, NumericalJacobian::central, NumericalJacobian::sixthOrder };
+
+	for ( NumericalJacobian::Method method : methods ) {
+		FMUModelExchange fmu( fmuUri, "thermostat", fmippFalse, fmippFalse, 1e-6 );
+		BOOST_REQUIRE_EQUAL( fmu.instantiate( "thermostat1" ), fmippOK );
+		BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+		fmu.setNumericalJacobianMethod( method );
+
+		// Also for large values of the state (the heater is not switched off without event handling).
+		const fmippReal states[] = { 0.5, 1e3 };
+		for ( fmippReal x : states ) {
+			fmippReal J = 0.;
+			fmippReal dfdt = 1.;
+			fmu.getNumericalJacobian( &J, &x, &dfdt, 0.25 );
+			BOOST_CHECK_SMALL( J + 1., 1e-6 );
+			BOOST_CHECK_SMALL( dfdt, 1e-6 );
+
+			// Time and states are reset afterwards.
+			fmippReal state = 0.;
+			fmu.getContinuousStates( &state );
+			BOOST_CHECK_EQUAL( state, x );
+			BOOST_CHECK_EQUAL( fmu.getTime(), 0.25 );
+		}
+	}
+}
+
+
+/// The Jacobian assembled from colored directional derivatives equals the dense assembly. The
+/// lower bidiagonal Jacobian of the chain FMU needs 2 instead of 4 directional derivatives.
+BOOST_AUTO_TEST_CASE( test_colored_jacobian_matches_dense )
+{
+	const fmippReal k = 2.5;
+	FMUModelExchange fmu( chainUri, "chain", fmippFalse, fmippFalse, 1e-6 );
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( "chain1" ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.setValue( "k", k ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+
+	std::vector<fmippReal> J( nChain*nChain, -42. );
+	BOOST_REQUIRE_EQUAL( fmu.getJac( &J[0] ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu.getJacobianEvaluations(), 2u );
+
+	const std::vector<fmippReal> dense = getDenseChainJacobian( k );
+	BOOST_CHECK_EQUAL_COLLECTIONS( J.begin(), J.end(), dense.begin(), dense.end() );
+
+	// Column-wise storage, J[N*j+i] = df_i/dx_j.
+	BOOST_CHECK_EQUAL( J[0], -k );
+	BOOST_CHECK_EQUAL( J[1], 1. );
+	BOOST_CHECK_EQUAL( J[nChain], 0. );
+}
+
+
+/// A constant Jacobian is reused until the FMU is initialized again (which may change parameters).
+BOOST_AUTO_TEST_CASE( test_constant_jacobian_cache )
+{
+	FMUModelExchange fmu( chainUri, "chain", fmippFalse, fmippFalse, 1e-6 );
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( "chain1" ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+
+	std::vector<fmippReal> J( nChain*nChain );
+	BOOST_REQUIRE_EQUAL( fmu.getJac( &J[0] ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu.getJacobianEvaluations(), 2u );
+	BOOST_CHECK_EQUAL( J[0], -1. );
+
+	// The cached Jacobian does not follow changes of the states.
+	fmippReal states[nChain] = { 3., -2., 0.5, 7. };
+	BOOST_REQUIRE_EQUAL( fmu.setContinuousStates( states ), fmippOK );
+	std::vector<fmippReal> reused( nChain*nChain );
+	BOOST_REQUIRE_EQUAL( fmu.getJac( &reused[0] ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu.getJacobianEvaluations(), 0u );
+	BOOST_CHECK_EQUAL_COLLECTIONS( J.begin(), J.end(), reused.begin(), reused.end() );
+
+	// After initialization with a new value of the (fixed) parameter, the Jacobian is evaluated again.
+	BOOST_REQUIRE_EQUAL( fmu.setValue( "k", 3. ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.getJac( &J[0] ), fmippOK );
+	BOOST_CHECK_EQUAL( fmu.getJacobianEvaluations(), 2u );
+	const std::vector<fmippReal> dense = getDenseChainJacobian( 3. );
+	BOOST_CHECK_EQUAL_COLLECTIONS( J.begin(), J.end(), dense.begin(), dense.end() );
+}
@@ -0,0 +1,148 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testRemoteFMUChannel
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "import/utility/include/RemoteFMUChannel.h"
+
+namespace {
+
+std::string channelName( const std::string& test )
+{
+	return "/fmipp_test_" + test + "_" + std::to_string( getpid() );
+}
+
+/// Overwrite the length of the message with the given payload in the shared memory segment.
+void corruptMessageSize( const std::string& name, const std::string& payload, uint64_t size )
+{
+	int fd = shm_open( name.c_str(), O_RDWR, 0 );
+	BOOST_REQUIRE( -1 != fd );
+	struct stat info;
+	BOOST_REQUIRE( 0 == fstat( fd, &info ) );
+	void* segment = mmap( 0, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	BOOST_REQUIRE( MAP_FAILED != segment );
+
+	// Each message is preceded by its length.
+	char* begin = static_cast<char*>( segment );
+	char* end = begin + info.st_size - payload.size();
+	char* pos = begin + sizeof( uint64_t );
+	while ( ( pos < end ) && ( 0 != std::memcmp( pos, payload.data(), payload.size() ) ) ) ++pos;
+	BOOST_REQUIRE( pos < end );
+	std::memcpy( pos - sizeof( size ), &size, sizeof( size ) );
+
+	munmap( segment, info.st_size );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_request_and_response )
+{
+	const std::string name = channelName( "roundtrip" );
+	std::unique_ptr<RemoteFMUChannel> proxy( RemoteFMUChannel::create( name, 1024 ) );
+	BOOST_REQUIRE( proxy );
+
+	// The worker echoes the requests until it receives a shutdown command.
+	std::thread worker( [&name] () {
+		std::unique_ptr<RemoteFMUChannel> channel( RemoteFMUChannel::open( name ) );
+		if ( !channel ) return;
+		RemoteFMUMessage request;
+		while ( channel->receiveRequest( request, RemoteFMUChannel::AliveCheck() ) ) {
+			int command = 0;
+			request.get( command );
+			channel->sendResponse( request );
+			if ( remoteFMUShutdown == command ) break;
+		}
+	} );
+
+	for ( int i = 0; i < 100; ++i ) {
+		RemoteFMUMessage request;
+		request.put<int>( remoteFMUSetReal );
+		request.put<fmippReal>( 0.5 * i );
+		request.put( fmippString( "x" ) );
+		BOOST_REQUIRE( proxy->sendRequest( request ) );
+
+		RemoteFMUMessage response;
+		BOOST_REQUIRE( proxy->receiveResponse( response, RemoteFMUChannel::AliveCheck() ) );
+		int command = 0;
+		fmippReal value = 0.;
+		fmippString variable;
+		BOOST_CHECK( response.get( command ) && response.get( value ) && response.get( variable ) );
+		BOOST_CHECK_EQUAL( command, remoteFMUSetReal );
+		BOOST_CHECK_EQUAL( value, 0.5 * i );
+		BOOST_CHECK_EQUAL( variable, "x" );
+		BOOST_CHECK( response.atEnd() );
+	}
+
+	RemoteFMUMessage shutdown;
+	shutdown.put<int>( remoteFMUShutdown );
+	BOOST_REQUIRE( proxy->sendRequest( shutdown ) );
+	RemoteFMUMessage response;
+	BOOST_CHECK( proxy->receiveResponse( response, RemoteFMUChannel::AliveCheck() ) );
+	worker.join();
+}
+
+BOOST_AUTO_TEST_CASE( test_message_too_large )
+{
+	std::unique_ptr<RemoteFMUChannel> channel( RemoteFMUChannel::create( channelName( "large" ), 64 ) );
+	BOOST_REQUIRE( channel );
+
+	RemoteFMUMessage msg;
+	msg.put( fmippString( 64, 'x' ) );
+	BOOST_CHECK( !channel->sendRequest( msg ) );
+}
+
+/// The length of a message in the shared memory segment must not exceed the data written.
+BOOST_AUTO_TEST_CASE( test_invalid_message_size )
+{
+	const std::string name = channelName( "invalid" );
+	const std::string payload = "0123456789abcdef";
+	const uint64_t sizes[] = { payload.size() + 1, 1024, uint64_t( 1 ) << 62 };
+
+	for ( uint64_t size : sizes ) {
+		std::unique_ptr<RemoteFMUChannel> channel( RemoteFMUChannel::create( name, 1024 ) );
+		BOOST_REQUIRE( channel );
+
+		RemoteFMUMessage msg( payload );
+		BOOST_REQUIRE( channel->sendRequest( msg ) );
+		corruptMessageSize( name, payload, size );
+
+		RemoteFMUMessage received;
+		BOOST_CHECK( !channel->receiveRequest( received, RemoteFMUChannel::AliveCheck() ) );
+	}
+}
+
+/// Element counts read from a message must fit into the rest of the message.
+BOOST_AUTO_TEST_CASE( test_element_count )
+{
+	RemoteFMUMessage msg;
+	msg.put<fmippSize>( 2 );
+	msg.put<fmippValueReference>( 1 );
+	msg.put<fmippValueReference>( 2 );
+	msg.put<fmippSize>( 4 ); // Only 12 bytes follow.
+	msg.put<fmippValueReference>( 1 );
+	msg.put<fmippSize>( ~fmippSize( 0 ) );
+
+	fmippSize n = 0;
+	BOOST_CHECK( msg.getCount( n, sizeof( fmippValueReference ) ) );
+	BOOST_CHECK_EQUAL( n, 2u );
+	fmippValueReference valref = 0;
+	BOOST_CHECK( msg.get( valref ) && msg.get( valref ) );
+	BOOST_CHECK( !msg.getCount( n, sizeof( fmippValueReference ) ) );
+	BOOST_CHECK( msg.get( valref ) );
+	BOOST_CHECK( !msg.getCount( n, 1 ) );
+}
@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------
+// Copyright (c) 2013-2022, AIT Austrian Institute of Technology GmbH.
+// All rights reserved. See file FMIPP_LICENSE for details.
+// -------------------------------------------------------------------
+
+#define BOOST_TEST_MODULE testRollbackFMU
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+
+#include "import/utility/include/RollbackFMU.h"
+
+namespace {
+
+const std::string fmuUri = FMU_URI_PRE "thermostat";
+
+/// Integrate until time t (integrate stops at events). A rollback is made if t is in the past.
+void integrateTo( RollbackFMU& fmu, fmippTime t )
+{
+	do fmu.integrate( t ); while ( fmu.getTime() < t );
+}
+
+}
+
+/// A rollback restores the time of the next time event together with the native FMU state.
+BOOST_AUTO_TEST_CASE( test_rollback_over_time_event )
+{
+	RollbackFMU fmu( fmuUri, "thermostat" );
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( "thermostat1" ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.setValue( "period", 0.3 ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+
+	// Save the rollback state before the time event at t = 0.3.
+	integrateTo( fmu, 0.2 );
+	fmu.saveCurrentStateForRollback();
+
+	integrateTo( fmu, 0.5 );
+	BOOST_CHECK_EQUAL( fmu.getIntegerValue( "ticks" ), 1 );
+
+	// The time event at t = 0.3 has to be handled again after the rollback.
+	integrateTo( fmu, 0.25 );
+	BOOST_CHECK_EQUAL( fmu.getIntegerValue( "ticks" ), 0 );
+	integrateTo( fmu, 0.4 );
+	BOOST_CHECK_EQUAL( fmu.getIntegerValue( "ticks" ), 1 );
+	BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - 2. * ( 1. - std::exp( -0.4 ) ), 1e-5 );
+}
+
+/// A rollback restores the discrete states, state events are detected again afterwards.
+BOOST_AUTO_TEST_CASE( test_rollback_over_state_event )
+{
+	RollbackFMU fmu( fmuUri, "thermostat" );
+	BOOST_REQUIRE_EQUAL( fmu.instantiate( "thermostat1" ), fmippOK );
+	BOOST_REQUIRE_EQUAL( fmu.initialize(), fmippOK );
+
+	// The heater is switched off at t = ln(2).
+	const double tOff = std::log( 2. );
+
+	integrateTo( fmu, 0.6 );
+	fmu.saveCurrentStateForRollback();
+
+	integrateTo( fmu, 0.8 );
+	BOOST_CHECK_EQUAL( fmu.getBooleanValue( "on" ), fmippFalse );
+
+	integrateTo( fmu, 0.65 );
+	BOOST_CHECK_EQUAL( fmu.getBooleanValue( "on" ), fmippTrue );
+	BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - 2. * ( 1. - std::exp( -0.65 ) ), 1e-5 );
+
+	integrateTo( fmu, 0.8 );
+	BOOST_CHECK_EQUAL( fmu.getBooleanValue( "on" ), fmippFalse );
+	BOOST_CHECK_SMALL( fmu.getRealValue( "x" ) - ( 2. * std::exp( tOff - 0.8 ) - 1. ), 1e-3 );
+}
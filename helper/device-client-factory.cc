@@ -1,6 +1,7 @@
 #include "ns3/device-client-factory.h"
 #include "ns3/device-client-helper.h"
 #include "ns3/callback.h"
+#include "ns3/fmu-checkpoint-manager.h"
 
 #include "factory-util.h"
 
@@ -34,6 +35,8 @@ DeviceClientFactory::DeviceClientFactory(
     } else {
         std::cout << "  > Device client factory enabled" << std::endl;
 
+        setup_fmu_checkpoints(m_basicSimulation);
+
         NodeContainer nodes = topology->GetNodes();
         uint32_t system_id = m_basicSimulation->GetSystemId();
         bool enable_distributed = m_basicSimulation->IsDistributedEnabled();
@@ -101,7 +104,7 @@ DeviceClientFactory::DeviceClientFactory(
     
                 // Install it on the node and start it right now
                 ApplicationContainer app = source.Install(nodes.Get(p.first));
-                app.Start(Time(0.));
+                app.Start(FmuCheckpointManager::GetStartTime());
                 m_apps.push_back(app);
             }
         } else {
@@ -123,7 +126,7 @@ DeviceClientFactory::DeviceClientFactory(
     
                 // Install it on the node and start it right now
                 ApplicationContainer app = source.Install(nodes.Get(node_id));
-                app.Start(Time(0.));
+                app.Start(FmuCheckpointManager::GetStartTime());
                 m_apps.push_back(app);
             }            
         }
@@ -1,5 +1,15 @@
 #include "factory-util.h"
 #include "ns3/exp-util.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-hibernation-manager.h"
+#include "ns3/fmu-startup-profiler.h"
+#include "ns3/simulator.h"
+
+#include <common/FMIPPConfig.h>
+#include <import/base/include/AsyncLogger.h>
+#include <import/base/include/ModelManager.h>
+
+#include <iostream>
 
 using namespace std;
 
@@ -51,4 +61,191 @@ parse_time_unit(const std::string& time_unit_str) {
     }
 }
 
+void
+setup_fmu_startup_profiler(Ptr<BasicSimulation> basicSimulation) {
+    bool enabled = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_fmu_startup_profile", "false"));
+    FmuStartupProfiler::Enable(enabled);
+    if (enabled) {
+        printf("  > FMU startup profiling is enabled\n");
+    }
+}
+
+void
+add_fmu_load_timings_to_startup_profile(const std::string& modelIdentifier) {
+    if (!FmuStartupProfiler::IsEnabled()) { return; }
+
+    ModelManager::LoadTimings timings;
+    if (ModelManager::getLoadTimings(modelIdentifier, timings)) {
+        FmuStartupProfiler::AddRecord(modelIdentifier, "parse_model_description", timings.parseModelDescription);
+        FmuStartupProfiler::AddRecord(modelIdentifier, "load_shared_library", timings.loadSharedLibrary);
+    }
+}
+
+void
+setup_fmu_checkpoints(Ptr<BasicSimulation> basicSimulation) {
+    static bool done = false;
+    if (done) { return; }
+    done = true;
+
+    string filename = basicSimulation->GetConfigParamOrDefault("fmu_checkpoint_filename", "fmu_checkpoint.bin");
+    if (basicSimulation->IsDistributedEnabled()) {
+        filename = "system_" + std::to_string(basicSimulation->GetSystemId()) + "_" + filename;
+    }
+    filename = basicSimulation->GetRunDir() + "/" + filename;
+
+    if (parse_boolean(basicSimulation->GetConfigParamOrDefault("fmu_checkpoint_restore", "false"))) {
+        FmuCheckpointManager::Restore(filename);
+        printf("  > Resuming from checkpoint %s at t = %f s\n", filename.c_str(), FmuCheckpointManager::GetStartTime().GetSeconds());
+    }
+
+    if (parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_fmu_checkpoints", "false"))) {
+        int64_t interval_ns = parse_positive_int64(basicSimulation->GetConfigParamOrFail("fmu_checkpoint_interval_ns"));
+        FmuCheckpointManager::EnableCheckpoints(filename, NanoSeconds(interval_ns));
+        printf("  > Writing checkpoints every %" PRId64 " ns to %s\n", interval_ns, filename.c_str());
+    }
+}
+
+bool
+setup_fmu_hibernation(Ptr<BasicSimulation> basicSimulation) {
+    static bool done = false;
+    static bool enabled = false;
+    if (done) { return enabled; }
+    done = true;
+
+    enabled = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_fmu_hibernation", "false"));
+    if (!enabled) { return false; }
+
+    int64_t maxLiveInstances = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_hibernation_max_live_instances", "0"));
+    int64_t maxLiveBytes = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_hibernation_max_live_bytes", "0"));
+    FmuHibernationManager::SetBudget(maxLiveInstances, maxLiveBytes);
+    printf("  > Hibernating FMUs beyond %" PRId64 " live instances / %" PRId64 " bytes (0 = no limit)\n", maxLiveInstances, maxLiveBytes);
+
+    int64_t idleTimeout_ns = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_hibernation_idle_timeout_ns", "0"));
+    if (idleTimeout_ns > 0) {
+        FmuHibernationManager::SetIdleTimeout(NanoSeconds(idleTimeout_ns));
+        printf("  > Hibernating FMUs idle for %" PRId64 " ns\n", idleTimeout_ns);
+    }
+
+    string dir = basicSimulation->GetConfigParamOrDefault("fmu_hibernation_dir", "");
+    if (!dir.empty()) {
+        dir = basicSimulation->GetRunDir() + "/" + dir;
+        mkdir_if_not_exists(dir);
+        FmuHibernationManager::SetStorageDir(dir);
+        printf("  > Storing hibernated FMU states in %s\n", dir.c_str());
+    }
+
+    return true;
+}
+
+bool
+setup_fmu_async_logging(Ptr<BasicSimulation> basicSimulation) {
+    static bool done = false;
+    static bool enabled = false;
+    if (done) { return enabled; }
+    done = true;
+
+    enabled = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_fmu_async_logging", "false"));
+    if (!enabled) { return false; }
+
+    AsyncLogger& logger = AsyncLogger::getAsyncLogger();
+
+    string severity = basicSimulation->GetConfigParamOrDefault("fmu_log_min_severity", "ok");
+    if (severity == "ok") {
+        logger.setMinimumSeverity(fmippOK);
+    } else if (severity == "warning") {
+        logger.setMinimumSeverity(fmippWarning);
+    } else if (severity == "discard") {
+        logger.setMinimumSeverity(fmippDiscard);
+    } else if (severity == "error") {
+        logger.setMinimumSeverity(fmippError);
+    } else if (severity == "fatal") {
+        logger.setMinimumSeverity(fmippFatal);
+    } else {
+        NS_ABORT_MSG("Unsupported FMU log severity: " + severity);
+    }
+    printf("  > Logging FMU messages with severity %s or higher\n", severity.c_str());
+
+    set<string> categories = parse_set_string(basicSimulation->GetConfigParamOrDefault("fmu_log_categories", "set()"));
+    logger.setCategories(vector<string>(categories.begin(), categories.end()));
+    if (!categories.empty()) {
+        printf("  > Logging FMU messages of %zu categories\n", categories.size());
+    }
+
+    int64_t capacity = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_log_capacity", "4096"));
+
+    string filename;
+    if (basicSimulation->IsDistributedEnabled()) {
+        filename = basicSimulation->GetLogsDir() + "/system_" + std::to_string(basicSimulation->GetSystemId()) + "_fmu_messages.log";
+    } else {
+        filename = basicSimulation->GetLogsDir() + "/fmu_messages.log";
+    }
+
+    bool started = logger.start(filename, capacity);
+    NS_ABORT_MSG_UNLESS(started, "Unable to start asynchronous FMU logging to " + filename);
+    printf("  > Logging FMU messages asynchronously to %s (capacity: %" PRId64 " messages)\n", filename.c_str(), capacity);
+
+    return true;
+}
+
+bool
+setup_fmu_auto_unload(Ptr<BasicSimulation> basicSimulation) {
+    static bool done = false;
+    static bool enabled = false;
+    if (done) { return enabled; }
+    done = true;
+
+    enabled = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_fmu_auto_unload", "false"));
+    if (!enabled) { return false; }
+
+    int64_t gracePeriod_ms = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_auto_unload_grace_period_ms", "0"));
+    ModelManager::setAutoUnload(true, gracePeriod_ms / 1000.0);
+
+    // Turn it off again when the simulation is destroyed, i.e., before static destructors run at exit
+    // (FMUs released by them must not trigger unloading, see ModelManager::setAutoUnload).
+    Simulator::ScheduleDestroy(&ModelManager::setAutoUnload, false, 0.);
+    printf("  > Unloading unused FMUs after a grace period of %" PRId64 " ms (wall-clock time)\n", gracePeriod_ms);
+
+    return true;
+}
+
+void
+write_fmu_startup_profile(Ptr<BasicSimulation> basicSimulation) {
+    if (!FmuStartupProfiler::IsEnabled()) { return; }
+
+    // The profile covers all FMU device factories, the first factory writes it
+    static bool done = false;
+    if (done) {
+        printf("  > FMU startup profile has already been written\n");
+        return;
+    }
+    done = true;
+
+    size_t topN = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("fmu_startup_profile_top_n", "10"));
+
+    string filename;
+    if (basicSimulation->IsDistributedEnabled()) {
+        filename = basicSimulation->GetLogsDir() + "/system_" + std::to_string(basicSimulation->GetSystemId()) + "_fmu_startup_profile.json";
+    } else {
+        filename = basicSimulation->GetLogsDir() + "/fmu_startup_profile.json";
+    }
+
+    FmuStartupProfiler::WriteJson(filename, topN);
+    printf("  > FMU startup profile written to: %s\n", filename.c_str());
+}
+
+void
+write_fmu_factory_results(Ptr<BasicSimulation> basicSimulation, bool factoryEnabled) {
+    std::cout << "STORE FMU STARTUP PROFILE" << std::endl;
+
+    if (!factoryEnabled) {
+        std::cout << "  > Not enabled, so no startup profile is written" << std::endl;
+    } else if (!FmuStartupProfiler::IsEnabled()) {
+        std::cout << "  > Startup profiling not enabled explicitly" << std::endl;
+    } else {
+        write_fmu_startup_profile(basicSimulation);
+    }
+
+    std::cout << std::endl;
+}
+
 }
@@ -2,6 +2,7 @@
 #define FACTORY_UTIL_H
 
 #include "ns3/object.h"
+#include "ns3/basic-simulation.h"
 #include "ns3/topology.h"
 
 namespace ns3 {
@@ -17,6 +18,38 @@ namespace ns3 {
     Time::Unit
     parse_time_unit(const std::string& time_unit_str);
 
+    /// @brief Enable the FMU startup profiler according to the simulation config
+    void
+    setup_fmu_startup_profiler(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Add the load times (parsing, shared library) of an FMU to the startup profile
+    void
+    add_fmu_load_timings_to_startup_profile(const std::string& modelIdentifier);
+
+    /// @brief Set up checkpointing and restoring of FMU device states according to the simulation config (only once)
+    void
+    setup_fmu_checkpoints(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Set up the hibernation of idle FMU instances according to the simulation config (only once), returns true if enabled
+    bool
+    setup_fmu_hibernation(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Set up the asynchronous logging of FMU messages according to the simulation config (only once), returns true if enabled
+    bool
+    setup_fmu_async_logging(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Set up the automatic unloading of unused FMUs according to the simulation config (only once), returns true if enabled
+    bool
+    setup_fmu_auto_unload(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Write the FMU startup profile (if enabled) to the logs directory (only once)
+    void
+    write_fmu_startup_profile(Ptr<BasicSimulation> basicSimulation);
+
+    /// @brief Write the results of an FMU device factory (the startup profile), called by WriteResults() of all factories
+    void
+    write_fmu_factory_results(Ptr<BasicSimulation> basicSimulation, bool factoryEnabled);
+
 }
 
 #endif // FACTORY_UTIL_H
\ No newline at end of file
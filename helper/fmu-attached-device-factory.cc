@@ -3,6 +3,8 @@
 #include "factory-util.h"
 
 #include "ns3/exp-util.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-startup-profiler.h"
 
 #include <common/FMIPPConfig.h>
 #include <import/base/include/ModelManager.h>
@@ -78,6 +80,27 @@ FmuAttachedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulat
 
         m_nodes = m_topology->GetNodes();
 
+        setup_fmu_startup_profiler(m_basicSimulation);
+        setup_fmu_checkpoints(m_basicSimulation);
+
+        bool asyncLogging = setup_fmu_async_logging(m_basicSimulation);
+        std::cout << "  > Asynchronous logging of FMU messages: " << (asyncLogging ? "enabled" : "disabled") << std::endl;
+
+        bool autoUnload = setup_fmu_auto_unload(m_basicSimulation);
+        std::cout << "  > Automatic unloading of unused FMUs: " << (autoUnload ? "enabled" : "disabled") << std::endl;
+
+        bool enableWarmStart = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_fmu_warm_start", "false"));
+        std::cout << "  > Warm start of FMU instances: " << (enableWarmStart ? "enabled" : "disabled") << std::endl;
+
+        bool hibernation = setup_fmu_hibernation(m_basicSimulation);
+        std::cout << "  > Hibernation of idle FMUs: " << (hibernation ? "enabled" : "disabled") << std::endl;
+
+        bool lazyInstantiation = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_fmu_lazy_instantiation", "false"));
+        std::cout << "  > Lazy instantiation of FMUs: " << (lazyInstantiation ? "enabled" : "disabled") << std::endl;
+
+        bool memoryPools = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_fmu_memory_pools", "false"));
+        std::cout << "  > Memory pools for FMU instances: " << (memoryPools ? "enabled" : "disabled") << std::endl;
+
         string fmuConfigRaw = basicSimulation->GetConfigParamOrFail("fmu_config_files");
         vector<pair<string, string>> fmuConfigList = parse_map_string(fmuConfigRaw);
         for (auto const& config : fmuConfigList)
@@ -113,7 +136,14 @@ FmuAttachedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulat
             string fmuDirUri = getFileUriFromPath(fmuDirAbs);
             ModelManager::LoadFMUStatus status = ModelManager::failed;
             FMUType type = invalid;
-            status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+            {
+                // The load times of the FMU are nested in phase load_fmu of the startup profile.
+                FmuStartupProfiler::Scope profile(modelIdentifier, "load_fmu");
+                status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+                if (status == ModelManager::success) {
+                    add_fmu_load_timings_to_startup_profile(modelIdentifier);
+                }
+            }
             
             NS_ABORT_MSG_UNLESS(status == ModelManager::success, "Loading of FMU failed");
             NS_ABORT_MSG_UNLESS(type == fmi_2_0_cs, "Wrong FMU type");
@@ -149,6 +179,32 @@ FmuAttachedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulat
                 printf("    >> not writing any results\n");
             }
 
+            fmuDevice.SetAttribute("LazyInstantiation", BooleanValue(lazyInstantiation));
+            fmuDevice.SetAttribute("Hibernation", BooleanValue(hibernation));
+            fmuDevice.SetAttribute("MemoryPool", BooleanValue(memoryPools));
+
+            // Devices with the same warm start key are cloned from the first initialized instance. By default,
+            // only devices sharing the same FMU config file (i.e., the same FMU and settings) are cloned.
+            string warmStartDefaultKey = enableWarmStart ?
+                modelIdentifier + "@" + get_param_or_default("start_time_in_s", "0.0", fmuConfig) + "@" + config.second : "";
+            string warmStartKey = get_param_or_default("warm_start_key", warmStartDefaultKey, fmuConfig);
+            if (!warmStartKey.empty()) {
+                fmuDevice.SetAttribute("WarmStartKey", StringValue(warmStartKey));
+                printf("    >> warm start of FMU instance with key: %s\n", warmStartKey.c_str());
+            }
+
+            string libraryIsolation = get_param_or_default("library_isolation", "", fmuConfig);
+            if (!libraryIsolation.empty()) {
+                fmuDevice.SetAttribute("LibraryIsolation", StringValue(libraryIsolation));
+                printf("    >> isolated loading of FMU shared library (group: %s)\n", libraryIsolation.c_str());
+            }
+
+            string outputSubscriptions = get_param_or_default("output_subscriptions", "", fmuConfig);
+            if (!outputSubscriptions.empty()) {
+                fmuDevice.SetAttribute("OutputSubscriptions", StringValue(outputSubscriptions));
+                printf("    >> reporting changes of the following outputs: %s\n", outputSubscriptions.c_str());
+            }
+
             bool sendData = parse_boolean(get_param_or_default("send_data", "false", fmuConfig));
             if (sendData) {
                 double sendDataInterval = parse_positive_double(get_param_or_default("send_data_interval_s", "1.0", fmuConfig));
@@ -161,11 +217,17 @@ FmuAttachedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulat
                 fmuDevice.SetAttribute("RemotePort", UintegerValue (sendDataPort));
                 
                 printf("    >> sending data every %f seconds to endpoint %ld (port %d)\n", sendDataInterval, sendDataEndpoint, sendDataPort);
+
+                bool sendOnOutputChange = parse_boolean(get_param_or_default("send_on_output_change", "false", fmuConfig));
+                if (sendOnOutputChange) {
+                    fmuDevice.SetAttribute("SendOnOutputChange", BooleanValue(sendOnOutputChange));
+                    printf("    >> sending data only if a subscribed output has changed\n");
+                }
             }
 
             // Install it on the node and start it right now
             ApplicationContainer app = fmuDevice.Install(m_nodes.Get(endpoint));
-            app.Start(Seconds(0.0));
+            app.Start(FmuCheckpointManager::GetStartTime());
             m_apps.push_back(app);
         }
         m_basicSimulation->RegisterTimestamp("Setup FMU-attached devices");
@@ -175,4 +237,9 @@ FmuAttachedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulat
     std::cout << std::endl;
 }
 
+void
+FmuAttachedDeviceFactory::WriteResults() {
+    write_fmu_factory_results(m_basicSimulation, m_enabled);
+}
+
 }
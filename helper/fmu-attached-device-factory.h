@@ -32,6 +32,8 @@ public:
     FmuAttachedDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
         FmuAttachedDevice::InitCallbackType initCallback, FmuAttachedDevice::DoStepCallbackType doStepCallback);
 
+    void WriteResults();
+
 protected:
     Ptr<BasicSimulation> m_basicSimulation;
     Ptr<Topology> m_topology = nullptr;
@@ -0,0 +1,221 @@
+#include "fmu-incremental-device-factory.h"
+#include "fmu-device-helper.h"
+#include "factory-util.h"
+
+#include "ns3/exp-util.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-startup-profiler.h"
+
+#include <common/FMIPPConfig.h>
+#include <import/base/include/ModelManager.h>
+
+#include <boost/filesystem.hpp>
+#include <sstream>
+
+using namespace std;
+using namespace boost::filesystem;
+
+namespace {
+
+string getFileUriFromPath(const path& path)
+{
+    stringstream str;
+    str << "file://" << path.string();
+	return str.str();
+}
+
+bool toBoolean(const std::string & v)
+{
+    return !v.empty () &&
+        (strcasecmp (v.c_str (), "true") == 0 ||
+         atoi (v.c_str ()) != 0);
+}
+
+}
+
+namespace ns3 {
+
+FmuIncrementalDeviceFactory::FmuIncrementalDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology
+) {
+    initFmuDeviceFactory(basicSimulation, topology,
+        MakeCallback(&FmuIncrementalDevice::defaultInitCallbackImpl),
+        MakeCallback(&FmuIncrementalDevice::defaultDoStepCallbackImpl));
+}
+
+FmuIncrementalDeviceFactory::FmuIncrementalDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology,
+    FmuIncrementalDevice::DoStepCallbackType doStepCallback
+) {
+    initFmuDeviceFactory(basicSimulation, topology,
+        MakeCallback(&FmuIncrementalDevice::defaultInitCallbackImpl), doStepCallback);
+}
+
+FmuIncrementalDeviceFactory::FmuIncrementalDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology,
+    FmuIncrementalDevice::InitCallbackType initCallback,
+    FmuIncrementalDevice::DoStepCallbackType doStepCallback
+) {
+    initFmuDeviceFactory(basicSimulation, topology, initCallback, doStepCallback);
+}
+
+void
+FmuIncrementalDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology,
+        FmuIncrementalDevice::InitCallbackType initCallback, FmuIncrementalDevice::DoStepCallbackType doStepCallback)
+{
+    printf("FMU INCREMENTAL DEVICE FACTORY\n");
+
+    m_basicSimulation = basicSimulation;
+    m_topology = topology;
+
+    // Check if it is enabled explicitly
+    m_enabled = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_fmu_incremental_devices", "false"));
+    if (!m_enabled) {
+        std::cout << "  > Not enabled explicitly, so disabled" << std::endl;
+
+    } else {
+        std::cout << "  > FMU incremental device factory is enabled" << std::endl;
+
+        m_nodes = m_topology->GetNodes();
+
+        setup_fmu_startup_profiler(m_basicSimulation);
+
+        bool asyncLogging = setup_fmu_async_logging(m_basicSimulation);
+        std::cout << "  > Asynchronous logging of FMU messages: " << (asyncLogging ? "enabled" : "disabled") << std::endl;
+
+        bool autoUnload = setup_fmu_auto_unload(m_basicSimulation);
+        std::cout << "  > Automatic unloading of unused FMUs: " << (autoUnload ? "enabled" : "disabled") << std::endl;
+
+        string fmuConfigRaw = basicSimulation->GetConfigParamOrFail("fmu_config_files");
+        vector<pair<string, string>> fmuConfigList = parse_map_string(fmuConfigRaw);
+        for (auto const& config : fmuConfigList)
+        {
+            int64_t endpoint = parse_positive_int64(config.first);
+            string fmuConfigFileName = basicSimulation->GetRunDir() + "/" + config.second;
+
+            printf("  > Read FMU configuration for enpoint %ld from %s\n", endpoint, fmuConfigFileName.c_str());
+            map<string, string> fmuConfig = read_config(fmuConfigFileName);
+
+            path fmuDir = get_param_or_fail("fmu_dir", fmuConfig);
+            path fmuDirAbs = fmuDir.is_absolute() ? fmuDir :
+                canonical(absolute(fmuDir, basicSimulation->GetRunDir()));
+
+            printf("    >> Load extracted FMU from %s\n", fmuDirAbs.string().c_str());
+
+            NS_ABORT_MSG_UNLESS(dir_exists(fmuDirAbs.string().c_str()),
+                format_string("Not a directory: %s", fmuDirAbs.string().c_str()));
+            NS_ABORT_MSG_UNLESS(file_exists((fmuDirAbs / "/modelDescription.xml").string().c_str()),
+                "Not a valid FMU: no model descritpion found");
+            NS_ABORT_MSG_UNLESS(dir_exists((fmuDirAbs / "/binaries").string().c_str()),
+                "Not a valid FMU: no binaries folder found");
+
+            double fmuStartTimeInS = parse_positive_double(get_param_or_default("start_time_in_s", "0.0", fmuConfig));
+            double fmuCommStepSizeInS = parse_positive_double(get_param_or_fail("comm_step_size_in_s", fmuConfig));
+            double fmuLookAheadHorizonInS = parse_positive_double(get_param_or_fail("lookahead_horizon_in_s", fmuConfig));
+            double fmuIntegratorStepSizeInS = parse_positive_double(
+                get_param_or_default("integrator_step_size_in_s", to_string(fmuCommStepSizeInS / 10.), fmuConfig));
+            bool loggingOn = toBoolean(get_param_or_fail("logging_on", fmuConfig));
+            string modelIdentifier = get_param_or_fail("model_identifier", fmuConfig);
+            double proc_time_const_ns = parse_positive_double(get_param_or_fail("processing_time_const_ns", fmuConfig));
+            double proc_time_mean_ns = parse_positive_double(get_param_or_fail("processing_time_mean_ns", fmuConfig));
+            double proc_time_std_dev_ns = parse_positive_double(get_param_or_fail("processing_time_std_dev_ns", fmuConfig));
+            Time::Unit proc_time_base = parse_time_unit(get_param_or_default("processing_time_base", "MS", fmuConfig));
+
+            string fmuDirUri = getFileUriFromPath(fmuDirAbs);
+            ModelManager::LoadFMUStatus status = ModelManager::failed;
+            FMUType type = invalid;
+            {
+                // The load times of the FMU are nested in phase load_fmu of the startup profile.
+                FmuStartupProfiler::Scope profile(modelIdentifier, "load_fmu");
+                status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+                if (status == ModelManager::success) {
+                    add_fmu_load_timings_to_startup_profile(modelIdentifier);
+                }
+            }
+
+            NS_ABORT_MSG_UNLESS(status == ModelManager::success || status == ModelManager::duplicate, "Loading of FMU failed");
+            NS_ABORT_MSG_UNLESS(type == fmi_1_0_me || type == fmi_2_0_me, "Wrong FMU type (model exchange FMU expected)");
+
+            printf("    >> FMU loaded successfully\n");
+
+            // Helper to install the application.
+            FmuDeviceHelper<FmuIncrementalDevice> fmuDevice(1025, endpoint, modelIdentifier, fmuStartTimeInS,
+                fmuCommStepSizeInS, loggingOn, initCallback, doStepCallback,
+                NanoSeconds(proc_time_const_ns), NanoSeconds(proc_time_mean_ns),
+                NanoSeconds(proc_time_std_dev_ns), proc_time_base);
+
+            fmuDevice.SetAttribute("LookAheadHorizon", DoubleValue(fmuLookAheadHorizonInS));
+            fmuDevice.SetAttribute("IntegratorStepSize", DoubleValue(fmuIntegratorStepSizeInS));
+            printf("    >> lookahead predictions for %f seconds (step size %f seconds)\n", fmuLookAheadHorizonInS, fmuCommStepSizeInS);
+
+            string realInputs = get_param_or_default("real_inputs", "", fmuConfig);
+            if (!realInputs.empty()) {
+                fmuDevice.SetAttribute("RealInputs", StringValue(realInputs));
+                printf("    >> real inputs: %s\n", realInputs.c_str());
+            }
+
+            string realOutputs = get_param_or_default("real_outputs", "", fmuConfig);
+            if (!realOutputs.empty()) {
+                fmuDevice.SetAttribute("RealOutputs", StringValue(realOutputs));
+                printf("    >> real outputs: %s\n", realOutputs.c_str());
+            }
+
+            printf("    >> FMU instance successfully attached to device\n");
+
+            printf("  > Read FMU configuration for writing results\n");
+            bool fmuResultsWrite = toBoolean(get_param_or_fail("fmu_res_write", fmuConfig));
+            if (fmuResultsWrite) {
+                fmuDevice.SetAttribute("ResultsWrite", BooleanValue(fmuResultsWrite));
+
+                double fmuResWritePeriodInS = parse_positive_double(get_param_or_fail("fmu_res_write_period_in_s", fmuConfig));
+                fmuDevice.SetAttribute("ResultsWritePeriodInS", DoubleValue(fmuResWritePeriodInS));
+                printf("    >> writing results every %f seconds\n", fmuResWritePeriodInS);
+
+                string fmuResultsFilename = get_param_or_fail("fmu_res_filename", fmuConfig);
+                fmuResultsFilename = basicSimulation->GetLogsDir() + "/" + fmuResultsFilename;
+                fmuDevice.SetAttribute("ResultsFilename", StringValue(fmuResultsFilename));
+                printf("    >> writing results to: %s\n", fmuResultsFilename.c_str());
+            } else {
+                printf("    >> not writing any results\n");
+            }
+
+            string integratorStatisticsFilename = get_param_or_default("integrator_statistics_filename", "", fmuConfig);
+            if (!integratorStatisticsFilename.empty()) {
+                integratorStatisticsFilename = basicSimulation->GetLogsDir() + "/" + integratorStatisticsFilename;
+                fmuDevice.SetAttribute("IntegratorStatistics", BooleanValue(true));
+                fmuDevice.SetAttribute("IntegratorStatisticsFilename", StringValue(integratorStatisticsFilename));
+                printf("    >> writing integrator statistics to: %s\n", integratorStatisticsFilename.c_str());
+            }
+
+            bool sendData = parse_boolean(get_param_or_default("send_data", "false", fmuConfig));
+            if (sendData) {
+                double sendDataInterval = parse_positive_double(get_param_or_default("send_data_interval_s", "1.0", fmuConfig));
+                int64_t sendDataEndpoint = parse_positive_int64(get_param_or_fail("send_data_endpoint", fmuConfig));
+                uint32_t sendDataPort = 1025;
+
+                fmuDevice.SetAttribute("SendData", BooleanValue (sendData));
+                fmuDevice.SetAttribute("SendInterval", TimeValue(Seconds(sendDataInterval)));
+                fmuDevice.SetAttribute("RemoteAddress", AddressValue (m_nodes.Get(sendDataEndpoint)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()));
+                fmuDevice.SetAttribute("RemotePort", UintegerValue (sendDataPort));
+
+                printf("    >> sending data every %f seconds to endpoint %ld (port %d)\n", sendDataInterval, sendDataEndpoint, sendDataPort);
+            }
+
+            // Install it on the node and start it right now
+            ApplicationContainer app = fmuDevice.Install(m_nodes.Get(endpoint));
+            app.Start(FmuCheckpointManager::GetStartTime());
+            m_apps.push_back(app);
+        }
+        m_basicSimulation->RegisterTimestamp("Setup FMU incremental devices");
+
+    }
+
+    std::cout << std::endl;
+}
+
+void
+FmuIncrementalDeviceFactory::WriteResults() {
+    write_fmu_factory_results(m_basicSimulation, m_enabled);
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef FMU_INCREMENTAL_DEVICE_FACTORY_H
+#define FMU_INCREMENTAL_DEVICE_FACTORY_H
+
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <ctime>
+#include <iostream>
+#include <fstream>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <chrono>
+#include <stdexcept>
+
+#include "ns3/basic-simulation.h"
+#include "ns3/topology.h"
+#include "ns3/fmu-incremental-device.h"
+
+using namespace ns3;
+
+namespace ns3 {
+
+class FmuIncrementalDeviceFactory
+{
+
+public:
+    FmuIncrementalDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology);
+    FmuIncrementalDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+        FmuIncrementalDevice::DoStepCallbackType doStepCallback);
+    FmuIncrementalDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+        FmuIncrementalDevice::InitCallbackType initCallback, FmuIncrementalDevice::DoStepCallbackType doStepCallback);
+
+    void WriteResults();
+
+protected:
+    Ptr<BasicSimulation> m_basicSimulation;
+    Ptr<Topology> m_topology = nullptr;
+    bool m_enabled;
+
+    NodeContainer m_nodes;
+    std::vector<ApplicationContainer> m_apps;
+
+private:
+
+    void initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+        FmuIncrementalDevice::InitCallbackType initCallback, FmuIncrementalDevice::DoStepCallbackType doStepCallback);
+};
+
+}
+
+#endif /* FMU_INCREMENTAL_DEVICE_FACTORY_H */
@@ -0,0 +1,266 @@
+#include "fmu-pooled-device-factory.h"
+#include "fmu-device-helper.h"
+#include "factory-util.h"
+
+#include "ns3/exp-util.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-startup-profiler.h"
+
+#include <common/FMIPPConfig.h>
+#include <import/base/include/ModelManager.h>
+#include <import/base/include/FMUModelExchange_v2.h>
+
+#include <boost/filesystem.hpp>
+#include <sstream>
+
+using namespace std;
+using namespace fmi_2_0;
+using namespace boost::filesystem;
+
+namespace {
+
+string getFileUriFromPath(const path& path)
+{
+    stringstream str;
+    str << "file://" << path.string();
+	return str.str();
+}
+
+bool toBoolean(const std::string & v)
+{
+    return !v.empty () &&
+        (strcasecmp (v.c_str (), "true") == 0 ||
+         atoi (v.c_str ()) != 0);
+}
+
+void checkEndpointPairs(
+    const std::vector<std::pair<int64_t, int64_t>>& endpoint_pairs,
+    const std::set<int64_t>& pooled_endpoints
+) {
+    for (auto p : endpoint_pairs)
+    {
+        std::set<int64_t>::const_iterator find = pooled_endpoints.find(p.first);
+        NS_ABORT_MSG_UNLESS(
+            find != pooled_endpoints.end(),
+            format_string("Not a pooled endpoint: %ld", p.first)
+        );
+    }
+}
+
+}
+
+namespace ns3 {
+
+FmuPooledDeviceFactory::FmuPooledDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology
+) {
+    initFmuDeviceFactory(basicSimulation, topology, 
+        MakeCallback(&FmuPooledDevice::defaultInitCallbackImpl), 
+        MakeCallback(&FmuPooledDevice::defaultDoStepCallbackImpl));
+}
+
+FmuPooledDeviceFactory::FmuPooledDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+    FmuPooledDevice::DoStepCallbackType doStepCallback
+) {
+    initFmuDeviceFactory(basicSimulation, topology, 
+        MakeCallback(&FmuPooledDevice::defaultInitCallbackImpl), doStepCallback);
+}
+
+FmuPooledDeviceFactory::FmuPooledDeviceFactory(
+    Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+    FmuPooledDevice::InitCallbackType initCallback, 
+    FmuPooledDevice::DoStepCallbackType doStepCallback
+) {
+    initFmuDeviceFactory(basicSimulation, topology, initCallback, doStepCallback);
+}
+
+void
+FmuPooledDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology, 
+        FmuPooledDevice::InitCallbackType initCallback, FmuPooledDevice::DoStepCallbackType doStepCallback)
+{
+    printf("FMU POOLED DEVICE FACTORY\n");
+
+    m_basicSimulation = basicSimulation;
+    m_topology = topology;
+
+    // Check if it is enabled explicitly
+    m_enabled = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_fmu_pooled_devices", "false"));
+    if (!m_enabled) {
+        std::cout << "  > Not enabled explicitly, so disabled" << std::endl;
+
+    } else {
+        std::cout << "  > FMU pooled device factory is enabled" << std::endl;
+
+        m_nodes = m_topology->GetNodes();
+
+        setup_fmu_startup_profiler(m_basicSimulation);
+        setup_fmu_checkpoints(m_basicSimulation);
+
+        bool asyncLogging = setup_fmu_async_logging(m_basicSimulation);
+        std::cout << "  > Asynchronous logging of FMU messages: " << (asyncLogging ? "enabled" : "disabled") << std::endl;
+
+        bool autoUnload = setup_fmu_auto_unload(m_basicSimulation);
+        std::cout << "  > Automatic unloading of unused FMUs: " << (autoUnload ? "enabled" : "disabled") << std::endl;
+
+        string fmuConfigRaw = basicSimulation->GetConfigParamOrFail("fmu_config_files");
+        vector<pair<string, string>> fmuConfigList = parse_map_string(fmuConfigRaw);
+        for (auto const& config: fmuConfigList)
+        {
+            string fmuConfigFileName = basicSimulation->GetRunDir() + "/" + config.second;
+
+            printf("  > Read FMU configuration from %s\n", fmuConfigFileName.c_str());
+            map<string, string> fmuConfig = read_config(fmuConfigFileName);
+
+            path fmuDir = get_param_or_fail("fmu_dir", fmuConfig);
+            path fmuDirAbs = fmuDir.is_absolute() ? fmuDir :
+                canonical(absolute(fmuDir, basicSimulation->GetRunDir()));
+
+            printf("    >> Load extracted FMU from %s\n", fmuDirAbs.string().c_str());
+
+            NS_ABORT_MSG_UNLESS(dir_exists(fmuDirAbs.string().c_str()), 
+                format_string("Not a directory: %s", fmuDirAbs.string().c_str()));
+            NS_ABORT_MSG_UNLESS(file_exists((fmuDirAbs / "/modelDescription.xml").string().c_str()),
+                "Not a valid FMU: no model descritpion found");
+            NS_ABORT_MSG_UNLESS(dir_exists((fmuDirAbs / "/binaries").string().c_str()), 
+                "Not a valid FMU: no binaries folder found");
+
+            double fmuStartTimeInS = parse_positive_double(get_param_or_default("start_time_in_s", "0.0", fmuConfig));
+            double fmuCommStepSizeInS = parse_positive_double(get_param_or_fail("comm_step_size_in_s", fmuConfig));
+            bool loggingOn = toBoolean(get_param_or_fail("logging_on", fmuConfig));
+            string modelIdentifier = get_param_or_fail("model_identifier", fmuConfig);
+            string poolName = get_param_or_fail("pool_name", fmuConfig);
+            int64_t poolSize = parse_positive_int64(get_param_or_default("pool_size", "1", fmuConfig));
+            NS_ABORT_MSG_UNLESS(poolSize > 0, "Pool size must be positive");
+            string assignmentPolicy = get_param_or_default("pool_assignment_policy", "round_robin", fmuConfig);
+            NS_ABORT_MSG_UNLESS(assignmentPolicy == "round_robin" || assignmentPolicy == "hash",
+                format_string("Unknown pool assignment policy: %s", assignmentPolicy.c_str()));
+            string libraryIsolation = get_param_or_default("library_isolation", "", fmuConfig);
+            double proc_time_const_ns = parse_positive_double(get_param_or_fail("processing_time_const_ns", fmuConfig));
+            double proc_time_mean_ns = parse_positive_double(get_param_or_fail("processing_time_mean_ns", fmuConfig));
+            double proc_time_std_dev_ns = parse_positive_double(get_param_or_fail("processing_time_std_dev_ns", fmuConfig));
+            Time::Unit proc_time_base = parse_time_unit(get_param_or_default("processing_time_base", "MS", fmuConfig));
+
+            string fmuDirUri = getFileUriFromPath(fmuDirAbs);
+            ModelManager::LoadFMUStatus status = ModelManager::failed;
+            FMUType type = invalid;
+            {
+                // The load times of the FMU are nested in phase load_fmu of the startup profile.
+                FmuStartupProfiler::Scope profile(modelIdentifier, "load_fmu");
+                status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+                if (status == ModelManager::success) {
+                    add_fmu_load_timings_to_startup_profile(modelIdentifier);
+                }
+            }
+            
+            NS_ABORT_MSG_UNLESS(status == ModelManager::success || status == ModelManager::duplicate, "Loading of FMU failed");
+            NS_ABORT_MSG_UNLESS(type == fmi_2_0_cs, "Wrong FMU type");
+
+            printf("    >> FMU loaded successfully\n");
+
+            std::string config_pooled_endpoints = basicSimulation->GetConfigParamOrFail(config.first);
+            std::set<int64_t> pooled_endpoints = parse_set_positive_int64(config_pooled_endpoints);
+
+            bool sendData = parse_boolean(get_param_or_default("send_data", "false", fmuConfig));
+            double sendDataInterval = parse_positive_double(get_param_or_default("send_data_interval_s", "1.0", fmuConfig));
+
+            string outputSubscriptions = get_param_or_default("output_subscriptions", "", fmuConfig);
+            bool sendOnOutputChange = parse_boolean(get_param_or_default("send_on_output_change", "false", fmuConfig));
+
+            // Parse pairs of connected endpoints.
+            std::vector<std::pair<int64_t, int64_t>> send_data_endpoints =
+                parse_endpoint_pairs(get_param_or_default("send_data_endpoints", "set()", fmuConfig), topology);
+            checkEndpointPairs(send_data_endpoints, pooled_endpoints);
+
+            for (int64_t endpoint : pooled_endpoints)
+            {
+                printf("  > Attach FMU to enpoint %ld\n", endpoint);
+
+                // Helper to install the application.
+                FmuDeviceHelper<FmuPooledDevice> fmuDevice(1025, endpoint, modelIdentifier, fmuStartTimeInS,
+                    fmuCommStepSizeInS, loggingOn, initCallback, doStepCallback,
+                    NanoSeconds(proc_time_const_ns), NanoSeconds(proc_time_mean_ns), 
+                    NanoSeconds(proc_time_std_dev_ns), proc_time_base);
+                fmuDevice.SetAttribute("PoolName", StringValue(poolName));
+                fmuDevice.SetAttribute("PoolSize", UintegerValue(poolSize));
+                fmuDevice.SetAttribute("AssignmentPolicy", EnumValue(assignmentPolicy == "hash" ?
+                    FmuPooledDevice::HASH : FmuPooledDevice::ROUND_ROBIN));
+
+                printf("    >> Pool of %ld FMU instances (%s) successfully attached to device\n", poolSize, assignmentPolicy.c_str());
+
+                if (!libraryIsolation.empty()) {
+                    fmuDevice.SetAttribute("LibraryIsolation", StringValue(libraryIsolation));
+                    printf("    >> isolated loading of FMU shared library (group: %s)\n", libraryIsolation.c_str());
+                }
+
+                // Results are only written by the first device assigned to each instance of the pool.
+                bool fmuResultsWrite = toBoolean(get_param_or_fail("fmu_res_write", fmuConfig));
+                if (fmuResultsWrite)
+                {
+                    printf("  > Read FMU configuration for writing results\n");
+                    fmuDevice.SetAttribute("ResultsWrite", BooleanValue(fmuResultsWrite));
+
+                    double fmuResWritePeriodInS = parse_positive_double(get_param_or_fail("fmu_res_write_period_in_s", fmuConfig));
+                    fmuDevice.SetAttribute("ResultsWritePeriodInS", DoubleValue(fmuResWritePeriodInS));
+                    printf("    >> writing results every %f seconds\n", fmuResWritePeriodInS);
+
+                    string fmuResultsFilename = get_param_or_fail("fmu_res_filename", fmuConfig);
+                    fmuResultsFilename = basicSimulation->GetLogsDir() + "/" + fmuResultsFilename;
+                    fmuDevice.SetAttribute("ResultsFilename", StringValue(fmuResultsFilename));
+                    printf("    >> writing results to: %s\n", fmuResultsFilename.c_str());
+
+                    string fmuResultsVarnamesList = get_param_or_fail("fmu_res_varnames", fmuConfig);
+                    fmuDevice.SetAttribute("ResultsVariableNamesList", StringValue(fmuResultsVarnamesList));
+                    printf("    >> writing values of the following variables: %s\n", fmuResultsVarnamesList.c_str());
+                } else {
+                    printf("    >> not writing any results\n");
+                }
+
+                if (!outputSubscriptions.empty()) {
+                    fmuDevice.SetAttribute("OutputSubscriptions", StringValue(outputSubscriptions));
+                    printf("    >> reporting changes of the following outputs: %s\n", outputSubscriptions.c_str());
+                }
+
+                if (sendData)
+                {
+                    if (sendOnOutputChange) {
+                        fmuDevice.SetAttribute("SendOnOutputChange", BooleanValue(sendOnOutputChange));
+                        printf("    >> sending data only if a subscribed output has changed\n");
+                    }
+
+                    for (std::pair<int64_t, int64_t>& p : send_data_endpoints)
+                    {
+                        if (endpoint != p.first) { continue; }
+
+                        int64_t sendDataEndpoint = p.second;
+                        uint32_t sendDataPort = 1025;
+    
+                        fmuDevice.SetAttribute("SendData", BooleanValue (sendData));
+                        fmuDevice.SetAttribute("SendInterval", TimeValue(Seconds(sendDataInterval)));
+                        fmuDevice.SetAttribute("RemoteAddress", AddressValue (m_nodes.Get(sendDataEndpoint)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()));
+                        fmuDevice.SetAttribute("RemotePort", UintegerValue (sendDataPort));
+                        
+                        printf("    >> sending data every %f seconds to endpoint %ld (port %d)\n", sendDataInterval, sendDataEndpoint, sendDataPort);
+                    }
+                }
+                
+                // Install it on the node and start it right now
+                ApplicationContainer app = fmuDevice.Install(m_nodes.Get(endpoint));
+                app.Start(FmuCheckpointManager::GetStartTime());
+                m_apps.push_back(app);
+
+            }
+        }
+        m_basicSimulation->RegisterTimestamp("Setup devices attached to a pool of FMUs");
+
+    }
+
+    std::cout << std::endl;
+}
+
+void
+FmuPooledDeviceFactory::WriteResults() {
+    write_fmu_factory_results(m_basicSimulation, m_enabled);
+}
+
+}
@@ -3,6 +3,8 @@
 #include "factory-util.h"
 
 #include "ns3/exp-util.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-startup-profiler.h"
 
 #include <common/FMIPPConfig.h>
 #include <import/base/include/ModelManager.h>
@@ -92,6 +94,15 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
 
         m_nodes = m_topology->GetNodes();
 
+        setup_fmu_startup_profiler(m_basicSimulation);
+        setup_fmu_checkpoints(m_basicSimulation);
+
+        bool asyncLogging = setup_fmu_async_logging(m_basicSimulation);
+        std::cout << "  > Asynchronous logging of FMU messages: " << (asyncLogging ? "enabled" : "disabled") << std::endl;
+
+        bool autoUnload = setup_fmu_auto_unload(m_basicSimulation);
+        std::cout << "  > Automatic unloading of unused FMUs: " << (autoUnload ? "enabled" : "disabled") << std::endl;
+
         string fmuConfigRaw = basicSimulation->GetConfigParamOrFail("fmu_config_files");
         vector<pair<string, string>> fmuConfigList = parse_map_string(fmuConfigRaw);
         for (auto const& config: fmuConfigList)
@@ -127,7 +138,14 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
             string fmuDirUri = getFileUriFromPath(fmuDirAbs);
             ModelManager::LoadFMUStatus status = ModelManager::failed;
             FMUType type = invalid;
-            status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+            {
+                // The load times of the FMU are nested in phase load_fmu of the startup profile.
+                FmuStartupProfiler::Scope profile(modelIdentifier, "load_fmu");
+                status = ModelManager::loadFMU(fmuDirUri, loggingOn, type, modelIdentifier);
+                if (status == ModelManager::success) {
+                    add_fmu_load_timings_to_startup_profile(modelIdentifier);
+                }
+            }
             
             NS_ABORT_MSG_UNLESS(status == ModelManager::success || status == ModelManager::duplicate, "Loading of FMU failed");
             NS_ABORT_MSG_UNLESS(type == fmi_2_0_cs, "Wrong FMU type");
@@ -140,6 +158,9 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
             bool sendData = parse_boolean(get_param_or_default("send_data", "false", fmuConfig));
             double sendDataInterval = parse_positive_double(get_param_or_default("send_data_interval_s", "1.0", fmuConfig));
 
+            string outputSubscriptions = get_param_or_default("output_subscriptions", "", fmuConfig);
+            bool sendOnOutputChange = parse_boolean(get_param_or_default("send_on_output_change", "false", fmuConfig));
+
             // Parse pairs of connected endpoints.
             std::vector<std::pair<int64_t, int64_t>> send_data_endpoints =
                 parse_endpoint_pairs(get_param_or_default("send_data_endpoints", "set()", fmuConfig), topology);
@@ -181,8 +202,18 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
                     printf("    >> not writing any results\n");
                 }
 
+                if (!outputSubscriptions.empty()) {
+                    fmuDevice.SetAttribute("OutputSubscriptions", StringValue(outputSubscriptions));
+                    printf("    >> reporting changes of the following outputs: %s\n", outputSubscriptions.c_str());
+                }
+
                 if (sendData)
                 {
+                    if (sendOnOutputChange) {
+                        fmuDevice.SetAttribute("SendOnOutputChange", BooleanValue(sendOnOutputChange));
+                        printf("    >> sending data only if a subscribed output has changed\n");
+                    }
+
                     for (std::pair<int64_t, int64_t>& p : send_data_endpoints)
                     {
                         if (endpoint != p.first) { continue; }
@@ -201,7 +232,7 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
                 
                 // Install it on the node and start it right now
                 ApplicationContainer app = fmuDevice.Install(m_nodes.Get(endpoint));
-                app.Start(Seconds(0.0));
+                app.Start(FmuCheckpointManager::GetStartTime());
                 m_apps.push_back(app);
 
                 firstEndpoint = false;
@@ -214,4 +245,9 @@ FmuSharedDeviceFactory::initFmuDeviceFactory(Ptr<BasicSimulation> basicSimulatio
     std::cout << std::endl;
 }
 
+void
+FmuSharedDeviceFactory::WriteResults() {
+    write_fmu_factory_results(m_basicSimulation, m_enabled);
+}
+
 }
@@ -1,11 +1,21 @@
 #ifndef FMU_UTIL_H
 #define FMU_UTIL_H
 
+#include "ns3/abort.h"
 #include "ns3/object.h"
+#include "ns3/fmu-startup-profiler.h"
 
+#include <import/base/include/CallbackFunctions.h>
 #include <import/base/include/FMUCoSimulation_v2.h>
+#include <import/utility/include/FMUMemoryPool.h>
+#include <import/utility/include/IncrementalFMU.h>
+#include <import/utility/include/IOPlan.h>
 
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -13,20 +23,184 @@ class RefFMU: public fmi_2_0::FMUCoSimulation, public Object
 {
 public:
     RefFMU(const std::string& modelIdentifier, const std::string& instanceName, const bool loggingOn):
-        FMUCoSimulation(modelIdentifier, loggingOn), Object(), m_instanceName(instanceName) {}
+        FMUCoSimulation(modelIdentifier, loggingOn), Object(), m_modelIdentifier(modelIdentifier), m_instanceName(instanceName) {}
+
+    // Use a bare FMU with an isolated copy of the shared library (see ModelManager::getIsolatedInstance).
+    RefFMU(BareFMU2Ptr bareFMU, const std::string& modelIdentifier, const std::string& instanceName, const bool loggingOn):
+        FMUCoSimulation(bareFMU, loggingOn), Object(), m_modelIdentifier(modelIdentifier), m_instanceName(instanceName) {}
     
+    // Free the FMU instance before its memory pool (if any) is destroyed.
+    virtual ~RefFMU() { terminate(); }
+
     inline const std::string& instanceName() const { return m_instanceName; }
 
+    // Serve the allocations of the FMU instance from its own memory pool. This has to be done
+    // before instantiation. Returns false if no pool is available (too many pools in use).
+    bool enableMemoryPool() {
+        std::unique_ptr<FMUMemoryPool> pool(new FMUMemoryPool());
+        if (!pool->hasCallbacks()) { return false; }
+        fmippStatus status = setCallbacks(loggingOn_ ? callback2::verboseLogger : callback2::succinctLogger,
+            pool->getAllocateMemoryCallback(), pool->getFreeMemoryCallback(), callback2::stepFinished);
+        if (status != fmippOK) { return false; }
+        m_memoryPool = std::move(pool);
+        return true;
+    }
+
+    // Memory pool of the FMU instance (null if not enabled).
+    inline const FMUMemoryPool* memoryPool() const { return m_memoryPool.get(); }
+
+    // Instantiation and initialization are included in the startup profile (if enabled).
+    virtual fmippStatus instantiate(const fmippString& name, const fmippReal timeout,
+            const fmippBoolean visible, const fmippBoolean interactive) {
+        FmuStartupProfiler::Scope profile(m_instanceName, "instantiate");
+        return FMUCoSimulation::instantiate(name, timeout, visible, interactive);
+    }
+
+    virtual fmippStatus initialize(const fmippReal startTime, const fmippBoolean stopTimeDefined,
+            const fmippReal stopTime) {
+        FmuStartupProfiler::Scope profile(m_instanceName, "initialize");
+        return FMUCoSimulation::initialize(startTime, stopTimeDefined, stopTime);
+    }
+
+    // Retrieve an IO plan for batched access to inputs and outputs. Plans are identified by
+    // their variables. The variables are resolved only once per model (when first requested),
+    // each instance gets its own copy of the plan with its own value buffers.
+    std::shared_ptr<IOPlan> getIOPlan(const std::vector<std::string>& inputNames,
+            const std::vector<std::string>& outputNames) {
+        IOPlanKey key(inputNames, outputNames);
+        std::shared_ptr<IOPlan>& plan = m_ioPlans[key];
+        if (!plan) {
+            std::shared_ptr<const IOPlan>& compiled = compiledIOPlans()[std::make_pair(m_modelIdentifier, key)];
+            if (!compiled) { compiled.reset(new IOPlan(*this, inputNames, outputNames)); }
+            plan.reset(new IOPlan(*compiled));
+        }
+        return plan;
+    }
+
     // Provide a mutex to avoid race conditions.
     // This should not be necessary, but better safe than sorry ...
     inline void lock() { m_mtx.lock(); }
     inline void unlock() { m_mtx.unlock(); }
 
 private:
+    // Names of the input and output variables of an IO plan.
+    typedef std::pair<std::vector<std::string>, std::vector<std::string>> IOPlanKey;
+
+    // Plans compiled for each model (only used for creating the plans of the instances).
+    static std::map<std::pair<std::string, IOPlanKey>, std::shared_ptr<const IOPlan>>& compiledIOPlans() {
+        static std::map<std::pair<std::string, IOPlanKey>, std::shared_ptr<const IOPlan>> plans;
+        return plans;
+    }
+
+    const std::string m_modelIdentifier;
     const std::string m_instanceName;
+    std::unique_ptr<FMUMemoryPool> m_memoryPool;
+    std::map<IOPlanKey, std::shared_ptr<IOPlan>> m_ioPlans; //!< Plans of this instance.
     std::mutex m_mtx;
 };
 
+// Model exchange FMU with lookahead predictions (see IncrementalFMU). Queries within the
+// current prediction horizon are answered by interpolating the predictions, new predictions
+// are only computed when the inputs change or the horizon runs out.
+class RefIncrementalFMU: public IncrementalFMU, public Object
+{
+public:
+    RefIncrementalFMU(const std::string& modelIdentifier, const std::string& instanceName, const bool loggingOn,
+            const double& lookAheadHorizon, const double& lookAheadStepSize, const double& integratorStepSize):
+        IncrementalFMU(modelIdentifier, loggingOn), Object(), m_instanceName(instanceName),
+        m_lookAheadHorizon(lookAheadHorizon), m_lookAheadStepSize(lookAheadStepSize), m_integratorStepSize(integratorStepSize),
+        m_inputsChanged(false), m_predictions(0), m_interpolations(0) {}
+
+    inline const std::string& instanceName() const { return m_instanceName; }
+
+    // Define the real inputs and outputs. This has to be done before initialization.
+    void defineRealInputs(const std::vector<std::string>& names) {
+        IncrementalFMU::defineRealInputs(names.data(), names.size());
+        m_realInputNames = names;
+        m_realInputs.assign(names.size(), 0.);
+    }
+
+    inline const std::vector<std::string>& realInputNames() const { return m_realInputNames; }
+
+    // Current values of the real inputs (in the order of their names).
+    inline const std::vector<fmippReal>& realInputs() const { return m_realInputs; }
+
+    void defineRealOutputs(const std::vector<std::string>& names) {
+        IncrementalFMU::defineRealOutputs(names.data(), names.size());
+        m_realOutputNames = names;
+    }
+
+    inline const std::vector<std::string>& realOutputNames() const { return m_realOutputNames; }
+
+    // Instantiate and initialize the FMU, then compute the first predictions.
+    // Initialization is included in the startup profile (if enabled).
+    bool initialize(const double& startTime) {
+        FmuStartupProfiler::Scope profile(m_instanceName, "initialize");
+        if (0 == init(m_instanceName, 0, 0, 0, startTime,
+                m_lookAheadHorizon, m_lookAheadStepSize, m_integratorStepSize)) { return false; }
+        updateState(startTime);
+        if (!m_realInputs.empty()) { syncState(startTime, m_realInputs.data(), 0, 0, 0); }
+        m_inputsChanged = false;
+        return predict(startTime);
+    }
+
+    // Set new values for the real inputs, they are applied with the next call to advance().
+    void setRealInputs(const std::vector<double>& values) {
+        NS_ABORT_MSG_UNLESS(values.size() == m_realInputs.size(), "Wrong number of real inputs for FMU " << m_instanceName);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] != m_realInputs[i]) { m_realInputs[i] = values[i]; m_inputsChanged = true; }
+        }
+    }
+
+    // Update the state of the FMU to time t (the outputs are available via getRealOutputs()).
+    // Returns false if the state cannot be updated.
+    bool advance(const double& t) {
+        // Move the lookahead forward until it covers time t.
+        while (t > predictionsEnd() + getTimeDiffResolution()) {
+            const double tEnd = predictionsEnd();
+            if (INVALID_FMI_TIME == updateState(tEnd) || !predict(tEnd)) { return false; }
+            if (predictionsEnd() <= tEnd) { return false; } // No progress.
+        }
+
+        // Interpolate the state from the predictions.
+        if (INVALID_FMI_TIME == updateState(t)) { return false; }
+
+        // Predictions made with the old inputs are no longer valid.
+        if (m_inputsChanged) {
+            syncState(t, m_realInputs.data(), 0, 0, 0);
+            m_inputsChanged = false;
+            return predict(t);
+        }
+
+        ++m_interpolations;
+        return true;
+    }
+
+    // End of the current prediction horizon.
+    inline double predictionsEnd() const { return predictions_.empty() ? INVALID_FMI_TIME : predictions_.backTime(); }
+
+    // Number of computed lookaheads (integrations) and of state updates answered by interpolation.
+    inline uint64_t predictions() const { return m_predictions; }
+    inline uint64_t interpolations() const { return m_interpolations; }
+
+private:
+    bool predict(const double& t) {
+        ++m_predictions;
+        return INVALID_FMI_TIME != predictState(t);
+    }
+
+    const std::string m_instanceName;
+    const double m_lookAheadHorizon;
+    const double m_lookAheadStepSize;
+    const double m_integratorStepSize;
+    std::vector<std::string> m_realInputNames;
+    std::vector<std::string> m_realOutputNames;
+    std::vector<fmippReal> m_realInputs;
+    bool m_inputsChanged;
+    uint64_t m_predictions;
+    uint64_t m_interpolations;
+};
+
 }
 
 #endif // FMU_UTIL_H
\ No newline at end of file
@@ -113,12 +113,28 @@ DeviceClient::~DeviceClient() {
 void
 DeviceClient::DoDispose(void) {
     NS_LOG_FUNCTION(this);
+    FmuCheckpointManager::Unregister(this);
     Application::DoDispose();
 }
 
 void
 DeviceClient::StartApplication(void) {
     NS_LOG_FUNCTION(this);
+
+    // Restore bookkeeping when resuming from a checkpoint.
+    string checkpoint;
+    bool restore = FmuCheckpointManager::GetEntry(GetCheckpointKey(), checkpoint);
+    uint64_t draws = 0;
+    Time firstProcessing = Seconds(0.);
+    if (restore) {
+        int64_t nextProcessing;
+        FmuCheckpointManager::Reader(checkpoint)
+            .Read(m_sent).Read(m_sentPayloadIds)
+            .Read(m_sendRequestTimestamps).Read(m_replyTimestamps).Read(m_receiveReplyTimestamps)
+            .Read(draws).Read(nextProcessing);
+        if (nextProcessing >= 0) { firstProcessing = TimeStep(nextProcessing - Simulator::Now().GetTimeStep()); }
+    }
+
     static uint16_t port = 1025; 
     if (m_socket == 0)
     {
@@ -140,13 +156,16 @@ DeviceClient::StartApplication(void) {
                 NS_ASSERT_MSG(false, "Incompatible address type: " << m_peerAddress);
             }
 
-            ScheduleProcessing(Seconds(0.)); 
+            ScheduleProcessing(firstProcessing); 
         }
     }
     m_socket->SetRecvCallback(MakeCallback(&DeviceClient::HandleRead, this));
     m_socket->SetAllowBroadcast(true);
 
     m_processingTime = CreateObject<ProcessingTime>(m_processingTimeConstant, m_processingTimeMean, m_processingTimeStdDev, m_processingTimeBase);
+    m_processingTime->SkipDraws(draws);
+
+    FmuCheckpointManager::Register(this);
 }
 
 void
@@ -158,6 +177,22 @@ DeviceClient::StopApplication() {
         m_socket = 0;
     }
     Simulator::Cancel(m_sendEvent);
+    FmuCheckpointManager::Unregister(this);
+}
+
+std::string
+DeviceClient::GetCheckpointKey() const {
+    return "client/" + to_string(m_fromNodeId) + "/" + to_string(m_toNodeId);
+}
+
+void
+DeviceClient::SaveCheckpoint(FmuCheckpointManager::Snapshot& snapshot) {
+    FmuCheckpointManager::Writer entry;
+    entry.Write(m_sent).Write(m_sentPayloadIds)
+        .Write(m_sendRequestTimestamps).Write(m_replyTimestamps).Write(m_receiveReplyTimestamps)
+        .Write(m_processingTime->GetNumberOfDraws())
+        .Write(FmuCheckpointManager::GetPendingTimeStep(m_processEvent));
+    snapshot[GetCheckpointKey()] = entry.GetData();
 }
 
 void
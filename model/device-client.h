@@ -4,6 +4,7 @@
 #include "ns3/application.h"
 #include "ns3/callback.h"
 #include "ns3/event-id.h"
+#include "ns3/fmu-checkpoint-manager.h"
 // #include "ns3/ipv4-address.h"
 #include "ns3/payload.h"
 #include "ns3/processing-time.h"
@@ -19,7 +20,7 @@ namespace ns3 {
 class Socket;
 class Packet;
 
-class DeviceClient : public Application 
+class DeviceClient : public Application, public FmuCheckpointable
 {
 public:
   typedef Callback<Payload, uint64_t, int64_t> MessageSendCallbackType;
@@ -39,6 +40,8 @@ public:
   static Payload defaultSendCallbackImpl(uint64_t from, int64_t to) { return Payload(0); }
   static void defaultReceiveCallbackImpl(std::string str, uint32_t payloadId, bool isReply, uint64_t from, int64_t to) {}
 
+  virtual void SaveCheckpoint(FmuCheckpointManager::Snapshot& snapshot);
+
 protected:
   virtual void DoDispose (void);
 
@@ -50,6 +53,7 @@ private:
   void Process (void);
   void Send (Ptr<Packet> p);
   void HandleRead (Ptr<Socket> socket);
+  std::string GetCheckpointKey (void) const;
 
   Time m_interval; //!< Packet inter-send time
   Ptr<Socket> m_socket; //!< Socket
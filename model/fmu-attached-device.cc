@@ -16,10 +16,13 @@
 #include "ns3/enum.h"
 #include "ns3/exp-util.h"
 #include "ns3/fmu-util.h"
+#include "ns3/fmu-startup-profiler.h"
 
 #include "fmu-attached-device.h"
 #include "send-context.h"
 
+#include <import/base/include/ModelManager.h>
+
 #include <cmath>
 #include <fstream>
 
@@ -32,6 +35,9 @@ namespace ns3 {
 
     NS_OBJECT_ENSURE_REGISTERED (FmuAttachedDevice);
 
+    // Initialize empty collection of warm start templates.
+    FmuAttachedDevice::WarmStartTemplateCollection FmuAttachedDevice::m_warmStartTemplates = FmuAttachedDevice::WarmStartTemplateCollection();
+
     TypeId
     FmuAttachedDevice::GetTypeId(void) {
         static TypeId tid = TypeId("ns3::FmuAttachedDevice")
@@ -82,6 +88,44 @@ namespace ns3 {
                           BooleanValue(false),
                           MakeBooleanAccessor(&FmuAttachedDevice::m_loggingOn),
                           MakeBooleanChecker())
+            .AddAttribute("LazyInstantiation",
+                          "Create and initialize the FMU when it is used for the first time (instead of when the application starts).",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuAttachedDevice::m_lazyInstantiation),
+                          MakeBooleanChecker())
+            .AddAttribute("Hibernation",
+                          "Allow hibernating the FMU (serialize its state and free it) when it is idle.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuAttachedDevice::m_hibernation),
+                          MakeBooleanChecker())
+            .AddAttribute("LibraryIsolation",
+                          "Load the FMU's shared library separately from other instances: empty for no isolation, \"instance\" for a separate copy per FMU instance, or the name of a group of instances sharing a copy.",
+                          StringValue(""),
+                          MakeStringAccessor(&FmuAttachedDevice::m_libraryIsolation),
+                          MakeStringChecker())
+            .AddAttribute("MemoryPool",
+                          "Serve the allocations of the FMU instance from its own memory pool (with memory accounting).",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuAttachedDevice::m_memoryPool),
+                          MakeBooleanChecker())
+            .AddAttribute("FmuLiveBytes",
+                          "Number of bytes currently allocated by the FMU instance (requires a memory pool).",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuAttachedDevice::GetFmuLiveBytes),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("FmuPeakBytes",
+                          "Maximum number of bytes allocated by the FMU instance at the same time (requires a memory pool).",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuAttachedDevice::GetFmuPeakBytes),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("FmuAllocationCount",
+                          "Total number of allocations of the FMU instance (requires a memory pool).",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuAttachedDevice::GetFmuAllocationCount),
+                          MakeUintegerChecker<uint64_t>())
             .AddAttribute("InitCallback",
                           "Callback for instantiating and initializing the FMU model.",
                           CallbackValue(MakeCallback(&FmuAttachedDevice::defaultInitCallbackImpl)),
@@ -92,6 +136,16 @@ namespace ns3 {
                           CallbackValue(MakeCallback(&FmuAttachedDevice::defaultDoStepCallbackImpl)),
                           MakeCallbackAccessor(&FmuAttachedDevice::m_doStepCallback),
                           MakeCallbackChecker())
+            .AddAttribute("WarmStartKey",
+                          "Devices with the same (non-empty) key are cloned from the state of the first initialized device.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuAttachedDevice::m_warmStartKey),
+                          MakeStringChecker())
+            .AddAttribute("WarmStartCallback",
+                          "Callback for applying node-specific settings to the FMU model after a warm start.",
+                          CallbackValue(MakeNullCallback<void, Ptr<RefFMU>, uint64_t, const std::string&, const double&>()),
+                          MakeCallbackAccessor(&FmuAttachedDevice::m_warmStartCallback),
+                          MakeCallbackChecker())
             .AddAttribute("ResultsWrite",
                           "Flag to indicate if results file should be written.",
                           BooleanValue(false),
@@ -112,6 +166,16 @@ namespace ns3 {
                           StringValue(),
                           MakeStringAccessor (&FmuAttachedDevice::m_resVarnamesList),
                           MakeStringChecker())
+            .AddAttribute("OutputSubscriptions",
+                          "List of output variables to be monitored for changes, optionally with an absolute (e.g., \"P:0.5\") or relative (e.g., \"P:2%\") deadband.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuAttachedDevice::m_outputSubscriptionsList),
+                          MakeStringChecker())
+            .AddAttribute("SendOnOutputChange",
+                          "Only send data if at least one subscribed output has changed since it was last sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuAttachedDevice::m_sendOnOutputChange),
+                          MakeBooleanChecker())
             .AddAttribute("ProcessingTimeConstant",
                           "Constant term of processing time",
                           TimeValue(Seconds(0)),
@@ -131,7 +195,11 @@ namespace ns3 {
                           "Time base of stochastic term of processing time",
                           EnumValue(Time::MS),
                           MakeEnumAccessor(&FmuAttachedDevice::m_processingTimeBase),
-                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"));
+                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"))
+            .AddTraceSource("OutputChanged",
+                            "A subscribed FMU output has changed by more than its deadband since it was last sent.",
+                            MakeTraceSourceAccessor(&FmuAttachedDevice::m_outputChangedTrace),
+                            "ns3::FmuAttachedDevice::OutputChangedTracedCallback");
         return tid;
     }
 
@@ -139,6 +207,13 @@ namespace ns3 {
         NS_LOG_FUNCTION(this);
         m_socket = 0;
         m_fmu = 0;
+        m_lazyInstantiation = false;
+        m_hibernation = false;
+        m_hibernated = false;
+        m_fmuStateSize = 0;
+        m_memoryPool = false;
+        m_sendOnOutputChange = false;
+        m_outputChanges = 0;
         m_writeDataEvent = EventId();
         m_sendEvent = EventId();
         m_processEvent = EventId();
@@ -196,6 +271,8 @@ namespace ns3 {
     void
     FmuAttachedDevice::DoDispose(void) {
         NS_LOG_FUNCTION(this);
+        FmuCheckpointManager::Unregister(this);
+        FmuHibernationManager::Remove(this);
         Application::DoDispose();
     }
 
@@ -215,7 +292,10 @@ namespace ns3 {
             }
         }
 
-        if (m_fmu == 0 && !m_modelIdentifier.empty()) { initFmu(); }
+        if (m_fmu == 0 && !m_modelIdentifier.empty() && !m_lazyInstantiation) { initFmu(); }
+
+        // Track the FMU instance for hibernation.
+        if (m_hibernation && m_fmu != 0) { EnsureFmu(); }
 
         m_socket->SetRecvCallback(MakeCallback(&FmuAttachedDevice::HandleRead, this));
 
@@ -223,20 +303,41 @@ namespace ns3 {
             m_processingTimeConstant, m_processingTimeMean, m_processingTimeStdDev, m_processingTimeBase
         );
 
+        // Restore bookkeeping when resuming from a checkpoint.
+        string checkpoint;
+        Time firstProcessing = Seconds(0);
+        Time firstWriteData = Seconds(0);
+        if (FmuCheckpointManager::GetEntry(GetCheckpointKey(), checkpoint)) {
+            uint64_t draws;
+            int64_t nextProcessing, nextWriteData;
+            FmuCheckpointManager::Reader(checkpoint).Read(draws).Read(nextProcessing).Read(nextWriteData);
+
+            m_processingTime->SkipDraws(draws);
+            int64_t now = Simulator::Now().GetTimeStep();
+            if (nextProcessing >= 0) { firstProcessing = TimeStep(nextProcessing - now); }
+            if (nextWriteData >= 0) { firstWriteData = TimeStep(nextWriteData - now); }
+        }
+        FmuCheckpointManager::Register(this);
+
+        ParseOutputSubscriptions();
+
         if (m_sendData) {
-            ScheduleProcessing(Seconds(0));
+            ScheduleProcessing(firstProcessing);
         }
 
         // Initialize periodic writing of FMU model data.
         if (m_resWrite) {
-            // Clean-up previously written results.
-            remove_file_if_exists(m_resFilename);
+            // Clean-up previously written results (unless resuming from a checkpoint).
+            if (!FmuCheckpointManager::IsRestoring()) { remove_file_if_exists(m_resFilename); }
 
             // Parse list to vector.
             m_resVarnames = parse_list_string(m_resVarnamesList);
 
+            // Resolve variable names only once (deferred with lazy instantiation).
+            if (m_fmu != 0) { ResolveResultsVariables(); }
+
             // Schedule the next write event.
-            m_writeDataEvent = Simulator::Schedule(Simulator::Now(), &FmuAttachedDevice::WriteData, this);
+            m_writeDataEvent = Simulator::Schedule(firstWriteData, &FmuAttachedDevice::WriteData, this);
         }
     }
 
@@ -248,6 +349,253 @@ namespace ns3 {
             m_socket->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
         }
         Simulator::Cancel(m_writeDataEvent);
+        FmuCheckpointManager::Unregister(this);
+        FmuHibernationManager::Remove(this);
+    }
+
+    void
+    FmuAttachedDevice::EnsureFmu() {
+        if (m_modelIdentifier.empty()) { return; }
+
+        if (m_fmu == 0 && m_hibernated) {
+            RehydrateFmu();
+        } else if (m_fmu == 0) {
+            // Deferred creation and initialization of the FMU, which is then
+            // fast-forwarded from the model start time to the current time.
+            const string instanceName = m_modelIdentifier + to_string(m_nodeId);
+            FmuStartupProfiler::Scope profile(instanceName, "deferred_init");
+
+            initFmu();
+
+            double t = Simulator::Now().GetSeconds();
+            if (m_fmu->getTime() < t) {
+                defaultDoStepCallbackImpl(m_fmu, m_nodeId, "", Payload::INVALID, false, t, m_commStepSizeInS);
+            }
+
+            if (m_resWrite) { ResolveResultsVariables(); }
+
+            NS_LOG_INFO("FMU " << m_fmu->instanceName() << " instantiated on first use at t = " << t << " s");
+        }
+
+        if (m_hibernation) {
+            // The memory of the instance is given by its memory pool (if any). Otherwise, it is
+            // estimated from the size of the serialized state, which is only needed (and hence
+            // only determined) if the memory of live instances is limited.
+            uint64_t sizeInBytes = GetFmuLiveBytes();
+            if (0 == sizeInBytes) {
+                if (0 == m_fmuStateSize && FmuHibernationManager::GetMaxLiveBytes() > 0 && m_fmu->canSerializeFMUstate()) {
+                    vector<fmippByte> state;
+                    if (fmippWarning >= m_fmu->serializeState(state)) { m_fmuStateSize = state.size(); }
+                }
+                sizeInBytes = m_fmuStateSize;
+            }
+
+            FmuHibernationManager::Touch(this, sizeInBytes);
+        }
+    }
+
+    bool
+    FmuAttachedDevice::Hibernate() {
+        if (m_fmu == 0) { return false; }
+
+        vector<fmippByte> state;
+        if (!m_fmu->canSerializeFMUstate() || fmippWarning < m_fmu->serializeState(state)) {
+            NS_LOG_WARN("FMU " << m_fmu->instanceName() << " does not support serialization of its state, no hibernation");
+            return false;
+        }
+
+        FmuHibernationManager::Store(m_fmu->instanceName(), m_fmu->getTime(), state);
+        m_fmuStateSize = state.size();
+        m_hibernated = true;
+
+        NS_LOG_INFO("FMU " << m_fmu->instanceName() << " hibernated at t = " << Simulator::Now().GetSeconds() << " s");
+
+        // Free the FMU instance.
+        m_fmu = 0;
+        return true;
+    }
+
+    void
+    FmuAttachedDevice::RehydrateFmu() {
+        const string instanceName = m_modelIdentifier + to_string(m_nodeId);
+
+        double time;
+        vector<fmippByte> state;
+        NS_ABORT_MSG_UNLESS(FmuHibernationManager::Load(instanceName, time, state),
+            "No hibernated state available for FMU " << instanceName);
+
+        m_fmu = CreateFmu(instanceName);
+        InstantiateFromState(state, time);
+        m_hibernated = false;
+
+        NS_LOG_INFO("FMU " << instanceName << " rehydrated at t = " << Simulator::Now().GetSeconds() << " s");
+    }
+
+    Ptr<RefFMU>
+    FmuAttachedDevice::CreateFmu(const std::string& instanceName) {
+        Ptr<RefFMU> fmu;
+        if (m_libraryIsolation.empty()) {
+            fmu = CreateObject<RefFMU>(m_modelIdentifier, instanceName, m_loggingOn);
+        } else {
+            // Instances of the same isolation group share a separately loaded copy of the shared library.
+            // The prefixes keep the groups per instance apart from named groups (e.g., an instance named like a group).
+            const string group = (m_libraryIsolation == "instance") ? "instance:" + instanceName : "group:" + m_libraryIsolation;
+            BareFMU2Ptr bareFmu = ModelManager::getIsolatedInstance(m_modelIdentifier, group);
+            NS_ABORT_MSG_UNLESS(bareFmu, "Isolated loading of FMU " << m_modelIdentifier << " failed (group: " << group << ")");
+
+            fmu = CreateObject<RefFMU>(bareFmu, m_modelIdentifier, instanceName, m_loggingOn);
+        }
+
+        if (m_memoryPool && !fmu->enableMemoryPool()) {
+            NS_LOG_WARN("No memory pool available for FMU " << instanceName << ", using the default allocator");
+        }
+        return fmu;
+    }
+
+    uint64_t
+    FmuAttachedDevice::GetFmuLiveBytes() const {
+        const FMUMemoryPool* pool = (m_fmu != 0) ? m_fmu->memoryPool() : 0;
+        return pool ? pool->getLiveBytes() : 0;
+    }
+
+    uint64_t
+    FmuAttachedDevice::GetFmuPeakBytes() const {
+        const FMUMemoryPool* pool = (m_fmu != 0) ? m_fmu->memoryPool() : 0;
+        return pool ? pool->getPeakBytes() : 0;
+    }
+
+    uint64_t
+    FmuAttachedDevice::GetFmuAllocationCount() const {
+        const FMUMemoryPool* pool = (m_fmu != 0) ? m_fmu->memoryPool() : 0;
+        return pool ? pool->getAllocationCount() : 0;
+    }
+
+    void
+    FmuAttachedDevice::ResolveResultsVariables() {
+        m_resVarHandles.clear();
+        for (const string& name : m_resVarnames) {
+            m_resVarHandles.push_back(m_fmu->getVariableHandle(name));
+        }
+    }
+
+    void
+    FmuAttachedDevice::ParseOutputSubscriptions() {
+        m_outputSubscriptions.clear();
+        m_outputPlan.reset();
+        if (m_outputSubscriptionsList.empty()) { return; }
+
+        // Entries are of the form "name", "name:deadband" or "name:deadband%".
+        for (const string& entry : parse_list_string(m_outputSubscriptionsList)) {
+            vector<string> spl = split_string(entry, ":");
+            NS_ABORT_MSG_UNLESS(spl.size() <= 2, "Invalid output subscription: " << entry);
+
+            OutputSubscription subscription;
+            subscription.name = trim(spl[0]);
+            subscription.deadband = 0.;
+            subscription.relative = false;
+            subscription.reported = false;
+            subscription.lastSentValue = 0.;
+
+            if (spl.size() == 2) {
+                string deadband = trim(spl[1]);
+                subscription.relative = (!deadband.empty() && deadband.back() == '%');
+                if (subscription.relative) { deadband.pop_back(); }
+                subscription.deadband = parse_positive_double(deadband) / (subscription.relative ? 100. : 1.);
+            }
+
+            m_outputSubscriptions.push_back(subscription);
+        }
+    }
+
+    bool
+    FmuAttachedDevice::UpdateOutputSubscription(OutputSubscription& subscription, double value) {
+        if (subscription.reported) {
+            double threshold = subscription.relative ? subscription.deadband * std::fabs(subscription.lastSentValue) : subscription.deadband;
+            if (std::fabs(value - subscription.lastSentValue) <= threshold) { return false; }
+        }
+
+        subscription.reported = true;
+        subscription.lastSentValue = value;
+        return true;
+    }
+
+    uint32_t
+    FmuAttachedDevice::CheckOutputSubscriptions() {
+        m_outputChanges = 0;
+        if (m_outputSubscriptions.empty() || m_fmu == 0) { return 0; }
+
+        // The variables of the plan are resolved once for all devices of the same model with the same subscriptions.
+        if (!m_outputPlan) {
+            vector<string> names;
+            for (const OutputSubscription& subscription : m_outputSubscriptions) { names.push_back(subscription.name); }
+            m_outputPlan = m_fmu->getIOPlan(vector<string>(), names);
+            NS_ABORT_MSG_UNLESS(m_outputPlan->isValid(), "Unknown output variable in subscriptions: " << m_outputSubscriptionsList);
+        }
+
+        fmippStatus status = m_outputPlan->fetchOutputs(*m_fmu);
+        NS_ABORT_MSG_UNLESS(status <= fmippWarning, "Fetching the subscribed outputs of FMU " << m_fmu->instanceName() << " failed");
+
+        const double time = m_fmu->getTime();
+        for (size_t i = 0; i < m_outputSubscriptions.size(); ++i) {
+            double value = 0.;
+            switch (m_outputPlan->getOutputType(i)) {
+            case fmippTypeReal: {
+                fmippReal val;
+                m_outputPlan->getOutput(i, val);
+                value = val;
+                break;
+            }
+            case fmippTypeInteger: {
+                fmippInteger val;
+                m_outputPlan->getOutput(i, val);
+                value = val;
+                break;
+            }
+            case fmippTypeBoolean: {
+                fmippBoolean val;
+                m_outputPlan->getOutput(i, val);
+                value = val ? 1. : 0.;
+                break;
+            }
+            default:
+                NS_ABORT_MSG("Only outputs of type real, integer or boolean can be subscribed: " << m_outputSubscriptions[i].name);
+                break;
+            }
+
+            OutputSubscription& subscription = m_outputSubscriptions[i];
+            if (!UpdateOutputSubscription(subscription, value)) { continue; }
+
+            ++m_outputChanges;
+            m_outputChangedTrace(m_nodeId, subscription.name, value, time);
+        }
+
+        return m_outputChanges;
+    }
+
+    std::string
+    FmuAttachedDevice::GetCheckpointKey() const {
+        return "device/" + to_string(m_nodeId) + "/" + to_string(m_port);
+    }
+
+    void
+    FmuAttachedDevice::SaveCheckpoint(FmuCheckpointManager::Snapshot& snapshot) {
+        if (m_fmu != 0) {
+            FmuCheckpointManager::SaveFmu(m_fmu, snapshot);
+        } else if (m_hibernated) {
+            // Take the state of a hibernated FMU directly from the store.
+            const string instanceName = m_modelIdentifier + to_string(m_nodeId);
+            double time;
+            vector<fmippByte> state;
+            if (FmuHibernationManager::Peek(instanceName, time, state)) {
+                FmuCheckpointManager::SaveFmuState(instanceName, time, state, snapshot);
+            }
+        }
+
+        FmuCheckpointManager::Writer entry;
+        entry.Write(m_processingTime->GetNumberOfDraws())
+            .Write(FmuCheckpointManager::GetPendingTimeStep(m_processEvent))
+            .Write(FmuCheckpointManager::GetPendingTimeStep(m_writeDataEvent));
+        snapshot[GetCheckpointKey()] = entry.GetData();
     }
 
     void
@@ -264,8 +612,22 @@ namespace ns3 {
             NS_LOG_WARN("Send event not expired: "  << m_sendEvent.GetTs());
         }
 
+        EnsureFmu();
+
         double t = Simulator::Now().GetSeconds();
         Payload pl = stepFmu("", Payload::INVALID, false, t);
+
+        // Subscriptions are only evaluated here, replies to requests (see HandleRead) neither
+        // update the last sent values nor suppress the next periodic send.
+        CheckOutputSubscriptions();
+
+        // Skip sending if none of the subscribed outputs has changed.
+        if (m_sendOnOutputChange && !m_outputSubscriptions.empty() && 0 == m_outputChanges) {
+            NS_LOG_DEBUG("No output changes, nothing sent at " << Simulator::Now());
+            ScheduleProcessing(m_sendInterval);
+            return;
+        }
+
         Ptr<Packet> p = pl.GetTransmitBuffer() ? 
             Create<Packet>((uint8_t*) pl.GetBuffer().c_str(), pl.GetBufferSize()) :
             Create<Packet>(pl.GetBufferSize());
@@ -314,6 +676,8 @@ namespace ns3 {
             NS_LOG_DEBUG ("Buffer: size = " << packetIn->GetSize() << " - content: " << payload);
             delete buffer;
 
+            EnsureFmu();
+
             double t = Simulator::Now().GetSeconds();
             Payload pl = stepFmu(payload, payloadId, true, t);
             packetOut = pl.GetTransmitBuffer() ? 
@@ -347,6 +711,8 @@ namespace ns3 {
     FmuAttachedDevice::WriteData() {
         NS_ASSERT(m_writeDataEvent.IsExpired());
 
+        EnsureFmu();
+
         // Sync FMU model with current time step.
         double t = Simulator::Now().GetSeconds();
         double tt = m_fmu->getTime();
@@ -384,21 +750,34 @@ namespace ns3 {
         if (m_resVarnames.size()) { file << sep; }
 
         // Write all other rows.
-        for (size_t i = 0; i < m_resVarnames.size(); ++i)
+        for (size_t i = 0; i < m_resVarHandles.size(); ++i)
         {
-            switch(m_fmu->getType(m_resVarnames[i])) {
-            case fmippTypeReal:
-                file << m_fmu->getRealValue(m_resVarnames[i]);
+            const VariableHandle& handle = m_resVarHandles[i];
+            switch(handle.type) {
+            case fmippTypeReal: {
+                fmippReal val;
+                m_fmu->getValue(handle, val);
+                file << val;
                 break;
-            case fmippTypeInteger:
-                file << m_fmu->getIntegerValue(m_resVarnames[i]);
+            }
+            case fmippTypeInteger: {
+                fmippInteger val;
+                m_fmu->getValue(handle, val);
+                file << val;
                 break;
-            case fmippTypeBoolean:
-                file << m_fmu->getBooleanValue(m_resVarnames[i]);
+            }
+            case fmippTypeBoolean: {
+                fmippBoolean val;
+                m_fmu->getValue(handle, val);
+                file << val;
                 break;
-            case fmippTypeString:
-                file << m_fmu->getStringValue(m_resVarnames[i]);
+            }
+            case fmippTypeString: {
+                fmippString val;
+                m_fmu->getValue(handle, val);
+                file << val;
                 break;
+            }
             case fmippTypeUnknown:
                 break;
             }
@@ -426,10 +805,80 @@ namespace ns3 {
         const string instanceName = m_modelIdentifier + to_string(m_nodeId);
 
         // Load FMU.
-        m_fmu = CreateObject<RefFMU>(m_modelIdentifier, instanceName, m_loggingOn);
+        {
+            FmuStartupProfiler::Scope profile(instanceName, "create_instance");
+            m_fmu = CreateFmu(instanceName);
+        }
+
+        // Clone the state of an already initialized FMU instance (if available).
+        // Otherwise instantiate and initialize FMU via callback.
+        if (m_warmStartKey.empty() || !WarmStartFmu()) {
+            {
+                FmuStartupProfiler::Scope profile(instanceName, "init_callback");
+                m_initCallback(m_fmu, m_nodeId, instanceName, m_startTimeInS);
+            }
+
+            if (!m_warmStartKey.empty()) { StoreWarmStartTemplate(); }
+        }
+
+        // Apply node-specific settings.
+        if (!m_warmStartKey.empty() && !m_warmStartCallback.IsNull()) {
+            FmuStartupProfiler::Scope profile(instanceName, "warm_start_callback");
+            m_warmStartCallback(m_fmu, m_nodeId, instanceName, m_fmu->getTime());
+        }
+
+        // Restore FMU state when resuming from a checkpoint.
+        FmuCheckpointManager::RestoreFmu(m_fmu);
+    }
+
+    bool
+    FmuAttachedDevice::WarmStartFmu() {
+        WarmStartTemplateCollection::const_iterator itFind = m_warmStartTemplates.find(m_warmStartKey);
+        if (itFind == m_warmStartTemplates.end()) { return false; }
+
+        const WarmStartTemplate& templ = itFind->second;
+        NS_ABORT_MSG_UNLESS(templ.modelIdentifier == m_modelIdentifier,
+            "Warm start key " << m_warmStartKey << " is used for different models ("
+            << templ.modelIdentifier << ", " << m_modelIdentifier << ")");
+
+        if (!templ.available) { return false; }
+
+        // Restore the state of the initialized template instead of initializing again.
+        FmuStartupProfiler::Scope profile(m_fmu->instanceName(), "warm_start");
+        InstantiateFromState(templ.state, templ.time);
+
+        NS_LOG_INFO("FMU " << m_fmu->instanceName() << " cloned from warm start template " << m_warmStartKey);
+        return true;
+    }
 
-        // Instantiate and initialize FMU via callback.
-        m_initCallback(m_fmu, m_nodeId, instanceName, m_startTimeInS);
+    void
+    FmuAttachedDevice::InstantiateFromState(const std::vector<fmippByte>& state, double time) {
+        fmippStatus status = fmippFatal;
+
+        // Instantiate the FMU model (same as the default init callback).
+        status = m_fmu->instantiate(m_fmu->instanceName(), 0., false, false);
+        NS_ABORT_MSG_UNLESS(status == fmippOK, "instantiation of FMU failed");
+
+        status = m_fmu->deSerializeState(state, time);
+        NS_ABORT_MSG_UNLESS(status == fmippOK || status == fmippWarning,
+            "Restoring the state of FMU " << m_fmu->instanceName() << " failed");
+    }
+
+    void
+    FmuAttachedDevice::StoreWarmStartTemplate() {
+        if (m_warmStartTemplates.count(m_warmStartKey)) { return; }
+
+        WarmStartTemplate& templ = m_warmStartTemplates[m_warmStartKey];
+        templ.modelIdentifier = m_modelIdentifier;
+        templ.time = m_fmu->getTime();
+        templ.available = m_fmu->canSerializeFMUstate() &&
+            (fmippWarning >= m_fmu->serializeState(templ.state));
+
+        if (!templ.available) {
+            templ.state.clear();
+            NS_LOG_WARN("FMU " << m_fmu->instanceName() << " does not support serialization of its state, "
+                << "no warm start for key " << m_warmStartKey);
+        }
     }
 
     Payload
@@ -5,6 +5,8 @@
 #include "ns3/application.h"
 #include "ns3/callback.h"
 #include "ns3/event-id.h"
+#include "ns3/fmu-checkpoint-manager.h"
+#include "ns3/fmu-hibernation-manager.h"
 #include "ns3/fmu-util.h"
 #include "ns3/payload.h"
 #include "ns3/processing-time.h"
@@ -12,6 +14,7 @@
 #include "ns3/seq-ts-header.h"
 #include "ns3/traced-callback.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -20,12 +23,41 @@ namespace ns3 {
 class Socket;
 struct SendContext;
 
-class FmuAttachedDevice : public Application 
+class FmuAttachedDevice : public Application, public FmuCheckpointable, public FmuHibernatable
 {
 public:
   typedef Callback<void, Ptr<RefFMU>, uint64_t, const std::string&, const double&> InitCallbackType;
   typedef Callback<Payload, Ptr<RefFMU>, uint64_t, const std::string&, uint32_t, bool, const double&, const double&> DoStepCallbackType;
 
+  /**
+   * TracedCallback signature for changes of subscribed FMU outputs.
+   *
+   * \param [in] nodeId Node identifier.
+   * \param [in] name Name of the output variable.
+   * \param [in] value New value of the output variable.
+   * \param [in] time Current FMU model time (in seconds).
+   */
+  typedef void (* OutputChangedTracedCallback)(uint64_t nodeId, const std::string& name, double value, double time);
+
+  /// Output variable whose changes are reported (if they exceed the deadband).
+  struct OutputSubscription {
+    std::string name;
+    double deadband; //!< Minimum change to be reported (absolute, or fraction of the last sent value if relative).
+    bool relative;
+    bool reported; //!< False until the first value has been reported.
+    double lastSentValue; //!< Value reported with the last periodic send (replies to requests are not tracked).
+  };
+
+  /**
+   * Check a new value of a subscribed output against the deadband. If the change is to be
+   * reported, the value is stored as the last sent value.
+   *
+   * \param [in,out] subscription Output subscription.
+   * \param [in] value Current value of the output variable.
+   * \return True if the change is to be reported.
+   */
+  static bool UpdateOutputSubscription(OutputSubscription& subscription, double value);
+
   static TypeId GetTypeId (void);
   FmuAttachedDevice ();
   virtual ~FmuAttachedDevice ();
@@ -33,6 +65,13 @@ public:
   static void defaultInitCallbackImpl(Ptr<RefFMU> fmu, uint64_t nodeId, const std::string& modelIdentifier, const double& startTime);
   static Payload defaultDoStepCallbackImpl(Ptr<RefFMU> fmu, uint64_t nodeId, const std::string& payload, uint32_t payloadId, bool isReply, const double& time, const double& commStepSize);
 
+  uint64_t GetFmuLiveBytes (void) const;
+  uint64_t GetFmuPeakBytes (void) const;
+  uint64_t GetFmuAllocationCount (void) const;
+
+  virtual void SaveCheckpoint(FmuCheckpointManager::Snapshot& snapshot);
+  virtual bool Hibernate();
+
 protected:
 
   virtual void DoDispose (void);
@@ -43,6 +82,16 @@ protected:
   void HandleRead (Ptr<Socket> socket);
   void Send(Ptr<SendContext> reply);
   void WriteData (void);
+  std::string GetCheckpointKey (void) const;
+  bool WarmStartFmu (void);
+  void InstantiateFromState (const std::vector<fmippByte>& state, double time);
+  void EnsureFmu (void);
+  void RehydrateFmu (void);
+  void ResolveResultsVariables (void);
+  void StoreWarmStartTemplate (void);
+  Ptr<RefFMU> CreateFmu (const std::string& instanceName);
+  void ParseOutputSubscriptions (void);
+  uint32_t CheckOutputSubscriptions (void);
 
   uint16_t m_port;      //!< Port on which we listen for incoming packets.
   uint64_t m_nodeId;      //!< Node identifier.
@@ -66,6 +115,12 @@ protected:
 
   std::string m_modelIdentifier;
   bool m_loggingOn;
+  bool m_lazyInstantiation; //!< Defer the creation of the FMU instance until it is used for the first time.
+  bool m_hibernation; //!< Allow the hibernation manager to free the FMU instance when idle.
+  bool m_hibernated; //!< Flag to indicate that the FMU state has been moved to the hibernation store.
+  uint64_t m_fmuStateSize; //!< Size of the serialized FMU state (estimate of the instance's memory).
+  std::string m_libraryIsolation; //!< Isolation group for the FMU's shared library (empty: not isolated).
+  bool m_memoryPool; //!< Serve the allocations of the FMU instance from its own memory pool.
   double m_commStepSizeInS;
   double m_startTimeInS;
   Ptr<RefFMU> m_fmu;
@@ -73,6 +128,9 @@ protected:
   InitCallbackType m_initCallback;
   DoStepCallbackType m_doStepCallback;
 
+  std::string m_warmStartKey; //!< Devices with the same key are cloned from the same initialized template.
+  InitCallbackType m_warmStartCallback; //!< Callback for applying node-specific settings after a warm start.
+
   EventId m_writeDataEvent; //!< Event to write FMU model data.
   EventId m_sendEvent; //!< Event to send back data.
   EventId m_processEvent; //!< Event to process the next packet.
@@ -82,6 +140,26 @@ protected:
   std::string m_resFilename; 
   std::string m_resVarnamesList;
   std::vector<std::string> m_resVarnames;
+  std::vector<VariableHandle> m_resVarHandles; //!< Resolved handles of variables in results file.
+
+  std::string m_outputSubscriptionsList; //!< Output variables (with deadbands) to be monitored for changes.
+  bool m_sendOnOutputChange; //!< Only send data if at least one subscribed output has changed.
+  std::vector<OutputSubscription> m_outputSubscriptions;
+  std::shared_ptr<IOPlan> m_outputPlan; //!< Plan for fetching all subscribed outputs at once.
+  uint32_t m_outputChanges; //!< Number of subscribed outputs that changed since the last periodic send.
+  TracedCallback<uint64_t, const std::string&, double, double> m_outputChangedTrace;
+
+private:
+  /// Serialized state of an initialized FMU instance, used for cloning.
+  struct WarmStartTemplate {
+    std::string modelIdentifier;
+    bool available; //!< False if the FMU does not support serialization of its state.
+    double time;
+    std::vector<fmippByte> state;
+  };
+
+  typedef std::map<std::string, WarmStartTemplate> WarmStartTemplateCollection;
+  static WarmStartTemplateCollection m_warmStartTemplates;
 };
 
 } // namespace ns3
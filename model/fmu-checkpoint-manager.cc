@@ -0,0 +1,206 @@
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/fmu-util.h"
+#include "ns3/payload.h"
+
+#include "fmu-checkpoint-manager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE ("FmuCheckpointManager");
+
+std::set<FmuCheckpointable*> FmuCheckpointManager::m_registered = std::set<FmuCheckpointable*>();
+
+std::string FmuCheckpointManager::m_filename = std::string();
+Time FmuCheckpointManager::m_interval = Time();
+
+bool FmuCheckpointManager::m_restoring = false;
+Time FmuCheckpointManager::m_restoreTime = Time();
+FmuCheckpointManager::Snapshot FmuCheckpointManager::m_restoredSnapshot = FmuCheckpointManager::Snapshot();
+
+const char FmuCheckpointManager::m_magic[8] = { 'F', 'M', 'U', 'C', 'K', 'P', 'T', '\0' };
+const uint32_t FmuCheckpointManager::m_version = 1;
+
+void
+FmuCheckpointManager::EnableCheckpoints(const std::string& filename, Time interval) {
+    NS_ABORT_MSG_UNLESS(interval.IsStrictlyPositive(), "Checkpoint interval must be positive");
+    m_filename = filename;
+    m_interval = interval;
+    ScheduleNextCheckpoint();
+}
+
+void
+FmuCheckpointManager::ScheduleNextCheckpoint() {
+    // Checkpoints are aligned to multiples of the interval. When restoring, no
+    // checkpoints are written before the applications have been started again.
+    int64_t now = Simulator::Now().GetTimeStep();
+    int64_t start = std::max(now, GetStartTime().GetTimeStep());
+    int64_t interval = m_interval.GetTimeStep();
+    int64_t next = (start / interval + 1) * interval;
+    Simulator::Schedule(TimeStep(next - now), &FmuCheckpointManager::PeriodicCheckpoint);
+}
+
+void
+FmuCheckpointManager::PeriodicCheckpoint() {
+    WriteCheckpoint(m_filename);
+    ScheduleNextCheckpoint();
+}
+
+void
+FmuCheckpointManager::WriteCheckpoint(const std::string& filename) {
+    Snapshot snapshot;
+    for (FmuCheckpointable* obj : m_registered) {
+        obj->SaveCheckpoint(snapshot);
+    }
+
+    // Write to a temporary file first, so that a crash while writing does
+    // not destroy the previous checkpoint.
+    const string tmpFilename = filename + ".tmp";
+    ofstream file(tmpFilename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        NS_FATAL_ERROR ("Failed to open file: " << tmpFilename);
+    }
+
+    Writer header;
+    header.Write(m_version)
+        .Write(Simulator::Now().GetTimeStep())
+        .Write(Payload::GetGlobalPayloadId())
+        .Write<uint64_t>(snapshot.size());
+    file.write(m_magic, sizeof(m_magic));
+    file.write(header.GetData().data(), header.GetData().size());
+
+    for (Snapshot::const_iterator it = snapshot.begin(); it != snapshot.end(); ++it) {
+        Writer entry;
+        entry.Write(it->first).Write(it->second);
+        file.write(entry.GetData().data(), entry.GetData().size());
+    }
+
+    file.close();
+    if (!file) {
+        NS_FATAL_ERROR ("Error occurred while writing to file: " << tmpFilename);
+    }
+
+    NS_ABORT_MSG_UNLESS(0 == rename(tmpFilename.c_str(), filename.c_str()),
+        "Failed to rename checkpoint file " << tmpFilename << " to " << filename);
+
+    NS_LOG_INFO("Checkpoint with " << snapshot.size() << " entries written to "
+        << filename << " at t = " << Simulator::Now().GetSeconds() << " s");
+}
+
+void
+FmuCheckpointManager::Restore(const std::string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        NS_FATAL_ERROR ("Failed to open file: " << filename);
+    }
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    NS_ABORT_MSG_UNLESS(data.size() >= sizeof(m_magic) && 0 == data.compare(0, sizeof(m_magic), m_magic, sizeof(m_magic)),
+        "Not a valid checkpoint file: " << filename);
+    string content = data.substr(sizeof(m_magic));
+
+    try {
+        Reader reader(content);
+
+        uint32_t version;
+        reader.Read(version);
+        NS_ABORT_MSG_UNLESS(m_version == version, "Unsupported checkpoint version: " << version);
+
+        int64_t timeStep;
+        uint32_t globalPayloadId;
+        uint64_t nEntries;
+        reader.Read(timeStep).Read(globalPayloadId).Read(nEntries);
+
+        m_restoredSnapshot.clear();
+        for (uint64_t i = 0; i < nEntries; ++i) {
+            string key;
+            reader.Read(key);
+            reader.Read(m_restoredSnapshot[key]);
+        }
+
+        m_restoreTime = TimeStep(timeStep);
+        Payload::SetGlobalPayloadId(globalPayloadId);
+    } catch (const std::out_of_range& e) {
+        NS_FATAL_ERROR ("Checkpoint file is truncated: " << filename);
+    }
+
+    m_restoring = true;
+
+    NS_LOG_INFO("Restored checkpoint with " << m_restoredSnapshot.size() << " entries from "
+        << filename << " (t = " << m_restoreTime.GetSeconds() << " s)");
+}
+
+bool
+FmuCheckpointManager::GetEntry(const std::string& key, std::string& data) {
+    if (!m_restoring) { return false; }
+
+    Snapshot::const_iterator it = m_restoredSnapshot.find(key);
+    if (it == m_restoredSnapshot.end()) { return false; }
+
+    data = it->second;
+    return true;
+}
+
+void
+FmuCheckpointManager::SaveFmu(Ptr<RefFMU> fmu, Snapshot& snapshot) {
+    const string key = "fmu/" + fmu->instanceName();
+    if (snapshot.count(key)) { return; } // Shared FMU instance.
+
+    NS_ABORT_MSG_UNLESS(fmu->canSerializeFMUstate(),
+        "FMU " << fmu->instanceName() << " does not support serialization of its state, no checkpoint possible");
+
+    vector<fmippByte> state;
+    fmippStatus status = fmu->serializeState(state);
+    NS_ABORT_MSG_UNLESS(status == fmippOK || status == fmippWarning,
+        "Serialization of state of FMU " << fmu->instanceName() << " failed");
+
+    SaveFmuState(fmu->instanceName(), fmu->getTime(), state, snapshot);
+}
+
+void
+FmuCheckpointManager::SaveFmuState(const std::string& instanceName, double time, const std::vector<uint8_t>& state, Snapshot& snapshot) {
+    Writer entry;
+    entry.Write(time).Write(state);
+    snapshot["fmu/" + instanceName] = entry.GetData();
+}
+
+bool
+FmuCheckpointManager::RestoreFmu(Ptr<RefFMU> fmu) {
+    string data;
+    if (!GetEntry("fmu/" + fmu->instanceName(), data)) { return false; }
+
+    fmippTime time;
+    vector<fmippByte> state;
+    Reader(data).Read(time).Read(state);
+
+    fmippStatus status = fmu->deSerializeState(state, time);
+    NS_ABORT_MSG_UNLESS(status == fmippOK || status == fmippWarning,
+        "Restoring the state of FMU " << fmu->instanceName() << " failed");
+
+    return true;
+}
+
+void
+FmuCheckpointManager::Reader::Check(uint64_t n) const {
+    if (n > m_data.size() - m_pos) {
+        throw std::out_of_range("checkpoint entry is truncated");
+    }
+}
+
+void
+FmuCheckpointManager::Reader::ReadCount(uint64_t& n, uint64_t elementSize) {
+    Read(n);
+    if (n > (m_data.size() - m_pos) / elementSize) {
+        throw std::out_of_range("checkpoint entry is truncated");
+    }
+}
+
+} // namespace ns3
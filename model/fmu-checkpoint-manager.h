@@ -0,0 +1,146 @@
+#ifndef FMU_CHECKPOINT_MANAGER_H
+#define FMU_CHECKPOINT_MANAGER_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class RefFMU;
+class FmuCheckpointable;
+
+class FmuCheckpointManager {
+/**
+ * This class writes checkpoints of all FMU states together with the bookkeeping
+ * of devices and clients (payload counters, RNG stream positions, pending events)
+ * to a snapshot file, and provides the means to resume a simulation from it.
+ *
+ * A snapshot is a collection of named binary entries (e.g., "fmu/<instance name>").
+ * Objects taking part in checkpointing implement interface FmuCheckpointable and
+ * register themselves. When restoring, all applications are started at the time of
+ * the checkpoint and retrieve their entries from the snapshot when they start.
+ * Packets in flight at the time of the checkpoint are not part of the snapshot.
+ **/
+public:
+
+    typedef std::map<std::string, std::string> Snapshot;
+
+    /// Enable writing checkpoints periodically to the given file (first checkpoint after one interval).
+    static void EnableCheckpoints(const std::string& filename, Time interval);
+
+    /// Load a snapshot from file to resume the simulation from it.
+    static void Restore(const std::string& filename);
+
+    static bool IsRestoring() { return m_restoring; }
+
+    /// Simulation time at which the applications should start (time of checkpoint when restoring, zero otherwise).
+    static Time GetStartTime() { return m_restoring ? m_restoreTime : Time(); }
+
+    static void Register(FmuCheckpointable* obj) { m_registered.insert(obj); }
+    static void Unregister(FmuCheckpointable* obj) { m_registered.erase(obj); }
+
+    /// Write a checkpoint of all registered objects right now.
+    static void WriteCheckpoint(const std::string& filename);
+
+    /// Retrieve an entry of the restored snapshot (returns false if not available).
+    static bool GetEntry(const std::string& key, std::string& data);
+
+    /// Add the state of an FMU to a snapshot (nothing happens if the snapshot already contains it).
+    static void SaveFmu(Ptr<RefFMU> fmu, Snapshot& snapshot);
+
+    /// Add an already serialized state of an FMU (e.g., of a hibernated instance) to a snapshot.
+    static void SaveFmuState(const std::string& instanceName, double time, const std::vector<uint8_t>& state, Snapshot& snapshot);
+
+    /// Restore the state of an FMU from the restored snapshot (returns false if not available).
+    static bool RestoreFmu(Ptr<RefFMU> fmu);
+
+    /// Time step of a pending event (negative if the event is not pending).
+    static int64_t GetPendingTimeStep(const EventId& event) {
+        return event.IsRunning() ? static_cast<int64_t>(event.GetTs()) : -1;
+    }
+
+    /// Helper for writing plain values and containers to snapshot entries.
+    class Writer {
+    public:
+        template<typename T>
+        Writer& Write(const T& val) { m_data.append(reinterpret_cast<const char*>(&val), sizeof(T)); return *this; }
+        Writer& Write(const std::string& str) { Write<uint64_t>(str.size()); m_data.append(str); return *this; }
+        template<typename T>
+        Writer& Write(const std::vector<T>& vec) { Write<uint64_t>(vec.size()); for (const T& v : vec) { Write(v); } return *this; }
+        Writer& Write(const std::vector<uint8_t>& vec) { Write<uint64_t>(vec.size()); m_data.append(reinterpret_cast<const char*>(vec.data()), vec.size()); return *this; }
+        template<typename K, typename V>
+        Writer& Write(const std::map<K, V>& m) { Write<uint64_t>(m.size()); for (const auto& kv : m) { Write(kv.first); Write(kv.second); } return *this; }
+        const std::string& GetData() const { return m_data; }
+    private:
+        std::string m_data;
+    };
+
+    /// Helper for reading plain values and containers from snapshot entries.
+    class Reader {
+    public:
+        Reader(const std::string& data) : m_data(data), m_pos(0) {}
+        template<typename T>
+        Reader& Read(T& val) { Check(sizeof(T)); std::memcpy(&val, m_data.data() + m_pos, sizeof(T)); m_pos += sizeof(T); return *this; }
+        Reader& Read(std::string& str) { uint64_t n; Read(n); Check(n); str.assign(m_data, m_pos, n); m_pos += n; return *this; }
+        template<typename T>
+        Reader& Read(std::vector<T>& vec) { uint64_t n; ReadCount(n, MinSize(static_cast<T*>(0))); vec.resize(n); for (T& v : vec) { Read(v); } return *this; }
+        Reader& Read(std::vector<uint8_t>& vec) { uint64_t n; Read(n); Check(n); vec.assign(m_data.begin() + m_pos, m_data.begin() + m_pos + n); m_pos += n; return *this; }
+        template<typename K, typename V>
+        Reader& Read(std::map<K, V>& m) { uint64_t n; ReadCount(n, MinSize(static_cast<K*>(0)) + MinSize(static_cast<V*>(0))); m.clear(); for (uint64_t i = 0; i < n; ++i) { K k; V v; Read(k); Read(v); m[k] = v; } return *this; }
+    private:
+        void Check(uint64_t n) const;
+        // Read the number of elements of a container and check that the remaining data can hold them.
+        void ReadCount(uint64_t& n, uint64_t elementSize);
+        // Minimum number of bytes a value takes in an entry (containers and strings start with their size).
+        template<typename T>
+        static uint64_t MinSize(const T*) { return sizeof(T); }
+        static uint64_t MinSize(const std::string*) { return sizeof(uint64_t); }
+        template<typename T>
+        static uint64_t MinSize(const std::vector<T>*) { return sizeof(uint64_t); }
+        template<typename K, typename V>
+        static uint64_t MinSize(const std::map<K, V>*) { return sizeof(uint64_t); }
+        const std::string& m_data;
+        size_t m_pos;
+    };
+
+private:
+
+    static void ScheduleNextCheckpoint();
+    static void PeriodicCheckpoint();
+
+    static std::set<FmuCheckpointable*> m_registered;
+
+    static std::string m_filename;
+    static Time m_interval;
+
+    static bool m_restoring;
+    static Time m_restoreTime;
+    static Snapshot m_restoredSnapshot;
+
+    static const char m_magic[8];
+    static const uint32_t m_version;
+};
+
+class FmuCheckpointable {
+/**
+ * Interface for objects whose state is included in checkpoints.
+ **/
+public:
+    virtual ~FmuCheckpointable() {}
+
+    /// Add all entries describing the current state of the object to the snapshot.
+    virtual void SaveCheckpoint(FmuCheckpointManager::Snapshot& snapshot) = 0;
+};
+
+} // namespace ns3
+
+#endif // FMU_CHECKPOINT_MANAGER_H
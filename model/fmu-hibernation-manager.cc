@@ -0,0 +1,171 @@
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "fmu-hibernation-manager.h"
+#include "fmu-checkpoint-manager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE ("FmuHibernationManager");
+
+std::list<FmuHibernatable*> FmuHibernationManager::m_lru = std::list<FmuHibernatable*>();
+std::map<FmuHibernatable*, FmuHibernationManager::Entry> FmuHibernationManager::m_entries = std::map<FmuHibernatable*, FmuHibernationManager::Entry>();
+std::map<std::string, std::string> FmuHibernationManager::m_store = std::map<std::string, std::string>();
+
+uint64_t FmuHibernationManager::m_maxLiveInstances = 0;
+uint64_t FmuHibernationManager::m_maxLiveBytes = 0;
+uint64_t FmuHibernationManager::m_liveBytes = 0;
+uint64_t FmuHibernationManager::m_nHibernations = 0;
+Time FmuHibernationManager::m_idleTimeout = Time();
+std::string FmuHibernationManager::m_storageDir = std::string();
+
+void
+FmuHibernationManager::SetBudget(uint64_t maxLiveInstances, uint64_t maxLiveBytes) {
+    m_maxLiveInstances = maxLiveInstances;
+    m_maxLiveBytes = maxLiveBytes;
+}
+
+void
+FmuHibernationManager::SetIdleTimeout(Time timeout) {
+    NS_ABORT_MSG_IF(timeout.IsStrictlyNegative(), "Idle timeout must not be negative");
+    bool scheduled = m_idleTimeout.IsStrictlyPositive();
+    m_idleTimeout = timeout;
+    if (!scheduled && m_idleTimeout.IsStrictlyPositive()) {
+        Simulator::Schedule(m_idleTimeout, &FmuHibernationManager::HibernateIdle);
+    }
+}
+
+void
+FmuHibernationManager::Touch(FmuHibernatable* obj, uint64_t sizeInBytes) {
+    map<FmuHibernatable*, Entry>::iterator it = m_entries.find(obj);
+    if (it == m_entries.end()) {
+        m_lru.push_front(obj);
+        Entry& entry = m_entries[obj];
+        entry.pos = m_lru.begin();
+        entry.sizeInBytes = sizeInBytes;
+        entry.lastUse = Simulator::Now();
+        m_liveBytes += sizeInBytes;
+    } else {
+        Entry& entry = it->second;
+        m_lru.splice(m_lru.begin(), m_lru, entry.pos);
+        m_liveBytes += sizeInBytes;
+        m_liveBytes -= entry.sizeInBytes;
+        entry.sizeInBytes = sizeInBytes;
+        entry.lastUse = Simulator::Now();
+    }
+
+    EnforceBudget(obj);
+}
+
+void
+FmuHibernationManager::Remove(FmuHibernatable* obj) {
+    map<FmuHibernatable*, Entry>::iterator it = m_entries.find(obj);
+    if (it == m_entries.end()) { return; }
+
+    m_liveBytes -= it->second.sizeInBytes;
+    m_lru.erase(it->second.pos);
+    m_entries.erase(it);
+}
+
+void
+FmuHibernationManager::Evict(FmuHibernatable* obj) {
+    // Stop tracking the instance first, it is only tracked again when it is used.
+    // Instances that cannot be hibernated are not tracked again either.
+    Remove(obj);
+    if (obj->Hibernate()) { ++m_nHibernations; }
+}
+
+void
+FmuHibernationManager::EnforceBudget(FmuHibernatable* keep) {
+    // The least recently used instances are hibernated first, the instance
+    // that has just been used is always kept alive.
+    while (m_lru.size() > 1 &&
+        ((m_maxLiveInstances > 0 && m_lru.size() > m_maxLiveInstances) ||
+         (m_maxLiveBytes > 0 && m_liveBytes > m_maxLiveBytes))) {
+        FmuHibernatable* victim = m_lru.back();
+        if (victim == keep) { break; }
+        Evict(victim);
+    }
+}
+
+void
+FmuHibernationManager::HibernateIdle() {
+    const Time now = Simulator::Now();
+    while (!m_lru.empty() && m_entries[m_lru.back()].lastUse + m_idleTimeout <= now) {
+        Evict(m_lru.back());
+    }
+
+    NS_LOG_DEBUG("Live FMU instances at t = " << now.GetSeconds() << " s: " << m_lru.size()
+        << " (" << m_liveBytes << " bytes), hibernations: " << m_nHibernations);
+
+    Simulator::Schedule(m_idleTimeout, &FmuHibernationManager::HibernateIdle);
+}
+
+std::string
+FmuHibernationManager::GetStorageFilename(const std::string& instanceName) {
+    return m_storageDir + "/" + instanceName + ".fmustate";
+}
+
+void
+FmuHibernationManager::Store(const std::string& instanceName, double time, const std::vector<fmippByte>& state) {
+    FmuCheckpointManager::Writer blob;
+    blob.Write(time).Write(state);
+
+    if (m_storageDir.empty()) {
+        m_store[instanceName] = blob.GetData();
+        return;
+    }
+
+    const string filename = GetStorageFilename(instanceName);
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        NS_FATAL_ERROR ("Failed to open file: " << filename);
+    }
+    file.write(blob.GetData().data(), blob.GetData().size());
+    file.close();
+    if (!file) {
+        NS_FATAL_ERROR ("Error occurred while writing to file: " << filename);
+    }
+}
+
+bool
+FmuHibernationManager::Peek(const std::string& instanceName, double& time, std::vector<fmippByte>& state) {
+    string data;
+    if (m_storageDir.empty()) {
+        map<string, string>::const_iterator it = m_store.find(instanceName);
+        if (it == m_store.end()) { return false; }
+        data = it->second;
+    } else {
+        ifstream file(GetStorageFilename(instanceName), ios::binary);
+        if (!file.is_open()) { return false; }
+        data.assign((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    }
+
+    try {
+        FmuCheckpointManager::Reader(data).Read(time).Read(state);
+    } catch (const std::out_of_range& e) {
+        NS_FATAL_ERROR ("Hibernated state of FMU " << instanceName << " is truncated");
+    }
+    return true;
+}
+
+bool
+FmuHibernationManager::Load(const std::string& instanceName, double& time, std::vector<fmippByte>& state) {
+    if (!Peek(instanceName, time, state)) { return false; }
+
+    if (m_storageDir.empty()) {
+        m_store.erase(instanceName);
+    } else {
+        remove(GetStorageFilename(instanceName).c_str());
+    }
+    return true;
+}
+
+} // namespace ns3
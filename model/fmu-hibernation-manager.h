@@ -0,0 +1,100 @@
+#ifndef FMU_HIBERNATION_MANAGER_H
+#define FMU_HIBERNATION_MANAGER_H
+
+#include "ns3/nstime.h"
+
+#include <common/FMIPPConfig.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class FmuHibernatable;
+
+class FmuHibernationManager {
+/**
+ * This class limits the number of live FMU instances (and their estimated memory)
+ * by hibernating the least recently used ones. A hibernated FMU instance has its
+ * state serialized to a store (in memory or on disk) and is freed. The device it
+ * belongs to rehydrates it from the store as soon as it is needed again.
+ *
+ * Optionally, instances that have not been used for a given (simulated) time are
+ * hibernated regardless of the budget. Devices taking part in hibernation implement
+ * interface FmuHibernatable and report every use of their FMU instance via Touch().
+ **/
+public:
+
+    /// Set the budget for live FMU instances (zero means no limit).
+    static void SetBudget(uint64_t maxLiveInstances, uint64_t maxLiveBytes);
+
+    /// Hibernate instances that have not been used for the given time (zero means never).
+    static void SetIdleTimeout(Time timeout);
+
+    /// Store hibernated FMU states as files in the given directory (empty for in-memory store).
+    static void SetStorageDir(const std::string& dir) { m_storageDir = dir; }
+
+    static uint64_t GetMaxLiveBytes() { return m_maxLiveBytes; }
+
+    /// Mark an FMU instance as live and most recently used, hibernate other instances if the budget is exceeded.
+    static void Touch(FmuHibernatable* obj, uint64_t sizeInBytes);
+
+    /// Stop tracking an FMU instance (e.g., when the device is stopped).
+    static void Remove(FmuHibernatable* obj);
+
+    /// Put the serialized state of an FMU instance into the store.
+    static void Store(const std::string& instanceName, double time, const std::vector<fmippByte>& state);
+
+    /// Take the serialized state of an FMU instance from the store (returns false if not available).
+    static bool Load(const std::string& instanceName, double& time, std::vector<fmippByte>& state);
+
+    /// Retrieve the serialized state of an FMU instance without removing it from the store.
+    static bool Peek(const std::string& instanceName, double& time, std::vector<fmippByte>& state);
+
+    static uint64_t GetNumberOfLiveInstances() { return m_lru.size(); }
+    static uint64_t GetLiveBytes() { return m_liveBytes; }
+    static uint64_t GetNumberOfHibernations() { return m_nHibernations; }
+
+private:
+
+    struct Entry {
+        std::list<FmuHibernatable*>::iterator pos; //!< Position in the LRU list.
+        uint64_t sizeInBytes; //!< Estimated memory of the FMU instance.
+        Time lastUse;
+    };
+
+    static void Evict(FmuHibernatable* obj);
+    static void EnforceBudget(FmuHibernatable* keep);
+    static void HibernateIdle();
+    static std::string GetStorageFilename(const std::string& instanceName);
+
+    static std::list<FmuHibernatable*> m_lru; //!< Live instances, most recently used first.
+    static std::map<FmuHibernatable*, Entry> m_entries;
+    static std::map<std::string, std::string> m_store; //!< In-memory store of serialized states.
+
+    static uint64_t m_maxLiveInstances;
+    static uint64_t m_maxLiveBytes;
+    static uint64_t m_liveBytes;
+    static uint64_t m_nHibernations;
+    static Time m_idleTimeout;
+    static std::string m_storageDir;
+};
+
+class FmuHibernatable {
+/**
+ * Interface for devices whose FMU instance can be hibernated.
+ **/
+public:
+    virtual ~FmuHibernatable() {}
+
+    /// Serialize the state of the FMU instance to the store and free it (returns false if not possible).
+    virtual bool Hibernate() = 0;
+};
+
+} // namespace ns3
+
+#endif // FMU_HIBERNATION_MANAGER_H
@@ -0,0 +1,547 @@
+#include "ns3/log.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/address-utils.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/exp-util.h"
+#include "ns3/fmu-util.h"
+#include "ns3/fmu-startup-profiler.h"
+
+#include "fmu-incremental-device.h"
+#include "send-context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+using namespace std;
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE ("FmuIncrementalDevice");
+
+    NS_OBJECT_ENSURE_REGISTERED (FmuIncrementalDevice);
+
+    TypeId
+    FmuIncrementalDevice::GetTypeId(void) {
+        static TypeId tid = TypeId("ns3::FmuIncrementalDevice")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<FmuIncrementalDevice>()
+            .AddAttribute("Port", "Port on which we listen for incoming packets.",
+                          UintegerValue(9),
+                          MakeUintegerAccessor(&FmuIncrementalDevice::m_port),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("NodeId", "Node identifier",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuIncrementalDevice::m_nodeId),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("SendData",
+                          "Flag to indicate if data should be sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuIncrementalDevice::m_sendData),
+                          MakeBooleanChecker())
+            .AddAttribute("SendInterval",
+                          "The time to wait between sending packets",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&FmuIncrementalDevice::m_sendInterval),
+                          MakeTimeChecker())
+            .AddAttribute("RemoteAddress",
+                          "The destination address of the outbound packets",
+                          AddressValue(),
+                          MakeAddressAccessor(&FmuIncrementalDevice::m_peerAddress),
+                          MakeAddressChecker())
+            .AddAttribute("RemotePort",
+                          "The destination port of the outbound packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuIncrementalDevice::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("ModelIdentifier", "FMU model identifier.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuIncrementalDevice::m_modelIdentifier),
+                          MakeStringChecker())
+            .AddAttribute("ModelStepSize", "Set the step size of the lookahead predictions for the FMU (in seconds).",
+                          DoubleValue(1e-3),
+                          MakeDoubleAccessor(&FmuIncrementalDevice::m_lookAheadStepSizeInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("LookAheadHorizon", "Set the horizon of the lookahead predictions for the FMU (in seconds).",
+                          DoubleValue(1.),
+                          MakeDoubleAccessor(&FmuIncrementalDevice::m_lookAheadHorizonInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("IntegratorStepSize", "Set the (initial) step size of the integrator for the FMU (in seconds).",
+                          DoubleValue(1e-4),
+                          MakeDoubleAccessor(&FmuIncrementalDevice::m_integratorStepSizeInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("ModelStartTime", "Set the start time for the FMU (in seconds).",
+                          DoubleValue(0.),
+                          MakeDoubleAccessor(&FmuIncrementalDevice::m_startTimeInS),
+                          MakeDoubleChecker<double>(0.))
+            .AddAttribute("LoggingOn", "Turn on logging for FMU.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuIncrementalDevice::m_loggingOn),
+                          MakeBooleanChecker())
+            .AddAttribute("RealInputs",
+                          "List of names of real inputs of the FMU (changing them triggers new predictions).",
+                          StringValue(),
+                          MakeStringAccessor(&FmuIncrementalDevice::m_realInputsList),
+                          MakeStringChecker())
+            .AddAttribute("RealOutputs",
+                          "List of names of real outputs of the FMU (interpolated between predictions).",
+                          StringValue(),
+                          MakeStringAccessor(&FmuIncrementalDevice::m_realOutputsList),
+                          MakeStringChecker())
+            .AddAttribute("NumberOfPredictions",
+                          "Number of lookahead predictions (integrations) computed by the FMU.",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuIncrementalDevice::GetNumberOfPredictions),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("NumberOfInterpolations",
+                          "Number of state updates answered by interpolating the predictions (without integration).",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuIncrementalDevice::GetNumberOfInterpolations),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("InitCallback",
+                          "Callback for instantiating and initializing the FMU model.",
+                          CallbackValue(MakeCallback(&FmuIncrementalDevice::defaultInitCallbackImpl)),
+                          MakeCallbackAccessor(&FmuIncrementalDevice::m_initCallback),
+                          MakeCallbackChecker())
+            .AddAttribute("DoStepCallback",
+                          "Callback for updating the FMU model and returning a payload message.",
+                          CallbackValue(MakeCallback(&FmuIncrementalDevice::defaultDoStepCallbackImpl)),
+                          MakeCallbackAccessor(&FmuIncrementalDevice::m_doStepCallback),
+                          MakeCallbackChecker())
+            .AddAttribute("ResultsWrite",
+                          "Flag to indicate if results file should be written.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuIncrementalDevice::m_resWrite),
+                          MakeBooleanChecker())
+            .AddAttribute("ResultsWritePeriodInS",
+                          "Time period to write the values of the real outputs to results file.",
+                          DoubleValue(1.),
+                          MakeDoubleAccessor(&FmuIncrementalDevice::m_resWritePeriodInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("ResultsFilename",
+                          "Name of results file.",
+                          StringValue(),
+                          MakeStringAccessor (&FmuIncrementalDevice::m_resFilename),
+                          MakeStringChecker())
+            .AddAttribute("IntegratorStatistics",
+                          "Flag to indicate if the performance counters of the integrator are collected and reported at the end of the run.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuIncrementalDevice::m_integratorStatistics),
+                          MakeBooleanChecker())
+            .AddAttribute("IntegratorStatisticsFilename",
+                          "Name of the file the performance counters of the integrator are written to (only logged if empty).",
+                          StringValue(),
+                          MakeStringAccessor(&FmuIncrementalDevice::m_integratorStatisticsFilename),
+                          MakeStringChecker())
+            .AddAttribute("ProcessingTimeConstant",
+                          "Constant term of processing time",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&FmuIncrementalDevice::m_processingTimeConstant),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeMean",
+                          "Average of stochastic term of processing time",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&FmuIncrementalDevice::m_processingTimeMean),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeStdDev",
+                          "Standard deviation of stochastic term of processing time",
+                          TimeValue(MicroSeconds(50)),
+                          MakeTimeAccessor(&FmuIncrementalDevice::m_processingTimeStdDev),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeBase",
+                          "Time base of stochastic term of processing time",
+                          EnumValue(Time::MS),
+                          MakeEnumAccessor(&FmuIncrementalDevice::m_processingTimeBase),
+                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"));
+        return tid;
+    }
+
+    FmuIncrementalDevice::FmuIncrementalDevice() {
+        NS_LOG_FUNCTION(this);
+        m_socket = 0;
+        m_fmu = 0;
+        m_writeDataEvent = EventId();
+        m_sendEvent = EventId();
+        m_processEvent = EventId();
+        m_processingTimeBase = Time::MS;
+        m_processingTime = 0;
+    }
+
+    FmuIncrementalDevice::~FmuIncrementalDevice() {
+        NS_LOG_FUNCTION(this);
+        m_socket = 0;
+        m_fmu = 0;
+    }
+
+    void
+    FmuIncrementalDevice::defaultInitCallbackImpl(
+        Ptr<RefIncrementalFMU> fmu, uint64_t nodeId,
+        const std::string& modelIdentifier, const double& startTime
+    ) {
+        // Instantiate and initialize the FMU model, then compute the first predictions.
+        bool success = fmu->initialize(startTime);
+        NS_ABORT_MSG_UNLESS(success, "initialization of FMU failed");
+    }
+
+    Payload
+    FmuIncrementalDevice::defaultDoStepCallbackImpl(
+        Ptr<RefIncrementalFMU> fmu, uint64_t nodeId, const std::string& payload, uint32_t payloadId, bool isReply, const double& time, const double& lookAheadStepSize
+    ) {
+        const uint64_t predictions = fmu->predictions();
+
+        // Apply the real inputs sent with the payload as "name=value" pairs (e.g., "u1=0.5,u2=1").
+        // Payloads without any assignment (e.g., empty or dummy payloads) leave the inputs unchanged.
+        vector<double> values = fmu->realInputs();
+        if (ApplyRealInputAssignments(payload, fmu->realInputNames(), values) > 0) {
+            fmu->setRealInputs(values);
+        }
+
+        // Update the FMU model to the current simulation time. Within the prediction
+        // horizon, this is done by interpolation (no integration needed).
+        bool success = fmu->advance(time);
+        NS_ABORT_MSG_UNLESS(success, "updating the state of FMU failed");
+
+        if (isReply) {
+            // Return default message.
+            string msg = string("FMU model updated until t=") + to_string(time) +
+                string(" with ") + to_string(fmu->predictions() - predictions) + string(" new predictions");
+            return Payload(msg);
+        } else {
+            return Payload();
+        }
+    }
+
+    size_t
+    FmuIncrementalDevice::ApplyRealInputAssignments(
+        const std::string& payload, const std::vector<std::string>& names, std::vector<double>& values
+    ) {
+        size_t applied = 0;
+        const string assignments = payload.substr(0, payload.find('\0'));
+        if (assignments.find('=') == string::npos) { return applied; }
+
+        for (const string& entry : split_string(assignments, ",")) {
+            const size_t pos = entry.find('=');
+            if (pos == string::npos) {
+                NS_LOG_LOGIC("Ignoring payload entry without assignment: " << entry);
+                continue;
+            }
+
+            vector<string>::const_iterator itFind = find(names.begin(), names.end(), trim(entry.substr(0, pos)));
+            if (itFind == names.end()) {
+                NS_LOG_LOGIC("Ignoring payload entry that is no assignment to a real input: " << entry);
+                continue;
+            }
+
+            const string value = trim(entry.substr(pos + 1));
+            char* end = 0;
+            const double parsed = strtod(value.c_str(), &end);
+            if (value.empty() || *end != '\0') {
+                NS_LOG_WARN("Ignoring invalid value for real input " << *itFind << " in payload: " << entry);
+                continue;
+            }
+
+            values[itFind - names.begin()] = parsed;
+            ++applied;
+        }
+        return applied;
+    }
+
+    uint64_t
+    FmuIncrementalDevice::GetNumberOfPredictions() const {
+        return (m_fmu != 0) ? m_fmu->predictions() : 0;
+    }
+
+    uint64_t
+    FmuIncrementalDevice::GetNumberOfInterpolations() const {
+        return (m_fmu != 0) ? m_fmu->interpolations() : 0;
+    }
+
+    void
+    FmuIncrementalDevice::DoDispose(void) {
+        NS_LOG_FUNCTION(this);
+        if (m_fmu != 0 && m_integratorStatistics) { WriteIntegratorStatistics(); }
+        Application::DoDispose();
+    }
+
+    void
+    FmuIncrementalDevice::StartApplication(void) {
+        NS_LOG_FUNCTION(this);
+
+        if (m_socket == 0) {
+            TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+            m_socket = Socket::CreateSocket(GetNode(), tid);
+            InetSocketAddress local = InetSocketAddress(Ipv4Address::GetAny(), m_port);
+            if (m_socket->Bind(local) == -1) {
+                NS_FATAL_ERROR("Failed to bind socket");
+            }
+            if (addressUtils::IsMulticast(m_local)) {
+                NS_FATAL_ERROR("Multi-cast is not supported.");
+            }
+        }
+
+        if (m_fmu == 0 && !m_modelIdentifier.empty()) { initFmu(); }
+
+        m_socket->SetRecvCallback(MakeCallback(&FmuIncrementalDevice::HandleRead, this));
+
+        m_processingTime = CreateObject<ProcessingTime>(
+            m_processingTimeConstant, m_processingTimeMean, m_processingTimeStdDev, m_processingTimeBase
+        );
+
+        if (m_sendData) {
+            ScheduleProcessing(Seconds(0));
+        }
+
+        // Initialize periodic writing of FMU model data.
+        if (m_resWrite) {
+            // Clean-up previously written results.
+            remove_file_if_exists(m_resFilename);
+
+            // Schedule the next write event.
+            m_writeDataEvent = Simulator::Schedule(Seconds(0), &FmuIncrementalDevice::WriteData, this);
+        }
+
+        // Clean-up previously written integrator statistics (they are written at the end of the run).
+        if (m_integratorStatistics && !m_integratorStatisticsFilename.empty()) {
+            remove_file_if_exists(m_integratorStatisticsFilename);
+        }
+    }
+
+    void
+    FmuIncrementalDevice::StopApplication() {
+        NS_LOG_FUNCTION(this);
+        if (m_socket != 0) {
+            m_socket->Close();
+            m_socket->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
+        }
+        Simulator::Cancel(m_writeDataEvent);
+    }
+
+    void
+    FmuIncrementalDevice::ScheduleProcessing(Time dt) {
+        NS_LOG_FUNCTION(this << dt);
+        m_processEvent = Simulator::Schedule(dt, &FmuIncrementalDevice::Process, this);
+    }
+
+    void
+    FmuIncrementalDevice::Process(void) {
+        NS_LOG_FUNCTION(this << " - start processing at " << Simulator::Now());
+        NS_ABORT_MSG_UNLESS(m_processEvent.IsExpired(), "Previous processing has not finished yet.");
+        if (!m_sendEvent.IsExpired()) {
+            NS_LOG_WARN("Send event not expired: "  << m_sendEvent.GetTs());
+        }
+
+        double t = Simulator::Now().GetSeconds();
+        Payload pl = stepFmu("", Payload::INVALID, false, t);
+
+        Ptr<Packet> p = pl.GetTransmitBuffer() ?
+            Create<Packet>((uint8_t*) pl.GetBuffer().c_str(), pl.GetBufferSize()) :
+            Create<Packet>(pl.GetBufferSize());
+
+        // Creates one with the current timestamp
+        SeqTsHeader seqTs;
+        seqTs.SetSeq(pl.GetId());
+        p->AddHeader(seqTs);
+
+        // Send out
+        m_sendEvent = Simulator::Schedule(
+            m_processingTime->GetValue(), &FmuIncrementalDevice::Send, this,
+            Create<SendContext>(m_socket, p, InetSocketAddress(Ipv4Address::ConvertFrom(m_peerAddress), m_peerPort))
+        );
+
+        // Schedule next transmit
+        ScheduleProcessing(m_sendInterval);
+    }
+
+    void
+    FmuIncrementalDevice::HandleRead(Ptr<Socket> socket) {
+        NS_LOG_FUNCTION(this << socket);
+        if (!m_sendEvent.IsExpired()) {
+            NS_LOG_WARN("Event not expired: "  << m_sendEvent.GetTs());
+        }
+
+        Time processingTime = m_processingTime->GetValue();
+        Ptr<Packet> packetIn;
+        Ptr<Packet> packetOut;
+        Address from;
+        while ((packetIn = socket->RecvFrom(from)))
+        {
+            NS_LOG_DEBUG ("At time " << Simulator::Now ().GetSeconds () << "s " <<
+                "device received " << packetIn->GetSize () << " bytes from " <<
+                InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
+                InetSocketAddress::ConvertFrom (from).GetPort ());
+
+            // What we receive
+            SeqTsHeader incomingSeqTs;
+            packetIn->RemoveHeader(incomingSeqTs);
+            uint32_t payloadId = incomingSeqTs.GetSeq();
+
+            string payload(packetIn->GetSize(), '\0');
+            packetIn->CopyData((uint8_t*) &payload[0], packetIn->GetSize());
+            NS_LOG_DEBUG ("Buffer: size = " << packetIn->GetSize() << " - content: " << payload);
+
+            double t = Simulator::Now().GetSeconds();
+            Payload pl = stepFmu(payload, payloadId, true, t);
+            packetOut = pl.GetTransmitBuffer() ?
+                Create<Packet>((uint8_t*) pl.GetBuffer().c_str(), pl.GetBufferSize()) :
+                Create<Packet>(pl.GetBufferSize());
+
+            // Add header
+            SeqTsHeader outgoingSeqTs; // Creates one with the current timestamp
+            outgoingSeqTs.SetSeq(payloadId);
+            packetOut->AddHeader(outgoingSeqTs);
+
+            // Send back with the new timestamp on it.
+            m_sendEvent = Simulator::Schedule(
+                processingTime, &FmuIncrementalDevice::Send, this, Create<SendContext>(socket, packetOut, from)
+            );
+        }
+    }
+
+    void
+    FmuIncrementalDevice::Send(Ptr<SendContext> reply) {
+        NS_LOG_DEBUG ("At time " << Simulator::Now ().GetSeconds () << "s " <<
+        "send " << reply->m_packet->GetSize () << " bytes to " <<
+        InetSocketAddress::ConvertFrom (reply->m_address).GetIpv4 () << " port " <<
+        InetSocketAddress::ConvertFrom (reply->m_address).GetPort ());
+
+        reply->m_socket->SendTo(reply->m_packet, 0, reply->m_address);
+    }
+
+    void
+    FmuIncrementalDevice::WriteData() {
+        NS_ASSERT(m_writeDataEvent.IsExpired());
+
+        // Sync FMU model with current time step (interpolated from the predictions).
+        double t = Simulator::Now().GetSeconds();
+        bool success = m_fmu->advance(t);
+        NS_ABORT_MSG_UNLESS(success, "updating the state of FMU " << m_fmu->instanceName() << " failed");
+
+        // Open the file in append mode.
+        ofstream file(m_resFilename, ios::app);
+
+        if (!file.is_open()) {
+            NS_FATAL_ERROR ("Failed to open file: " << m_resFilename);
+        }
+
+        string sep(","); // Separator character.
+        const vector<string>& names = m_fmu->realOutputNames();
+
+        // If the file is empty, write the column names.
+        file.seekp(0, ios::end);
+        if (0 == file.tellp()) {
+            file << "instance" << sep << "time";
+            for (size_t i = 0; i < names.size(); ++i) { file << sep << names[i]; }
+            file << "\n";
+        }
+
+        // Write current timestamp (simulation in seconds) and the values of the real outputs.
+        file << m_fmu->instanceName() << sep << t;
+        const fmippReal* values = m_fmu->getRealOutputs();
+        for (size_t i = 0; i < names.size(); ++i) { file << sep << values[i]; }
+        file << "\n";
+
+        // Close the file.
+        file.close();
+
+        if (!file) {
+            NS_FATAL_ERROR ("Error occurred while writing to file: " << m_resFilename);
+        } else {
+            NS_LOG_DEBUG ("Data successfully written to " << m_resFilename);
+        }
+
+        // Schedule the next write event.
+        m_writeDataEvent = Simulator::Schedule(Time(Seconds(m_resWritePeriodInS)), &FmuIncrementalDevice::WriteData, this);
+    }
+
+    void
+    FmuIncrementalDevice::WriteIntegratorStatistics() {
+        NS_LOG_FUNCTION(this);
+
+        const Integrator::Statistics* statistics = m_fmu->getIntegratorStatistics();
+        if (0 == statistics) { return; }
+
+        NS_LOG_INFO("Integrator statistics of FMU " << m_fmu->instanceName() << ":\n" << *statistics);
+        if (m_integratorStatisticsFilename.empty()) { return; }
+
+        // Open the file in append mode (one line per device).
+        ofstream file(m_integratorStatisticsFilename, ios::app);
+
+        if (!file.is_open()) {
+            NS_FATAL_ERROR ("Failed to open file: " << m_integratorStatisticsFilename);
+        }
+
+        string sep(","); // Separator character.
+
+        // If the file is empty, write the column names.
+        file.seekp(0, ios::end);
+        if (0 == file.tellp()) {
+            file << "instance" << sep << "integrate_calls" << sep << "derivative_evaluations" << sep
+                 << "jacobian_evaluations" << sep << "accepted_steps" << sep << "rejected_steps" << sep
+                 << "state_events" << sep << "step_events" << sep << "time_events" << sep
+                 << "event_iterations" << sep << "integrate_time_in_s" << sep << "step_over_event_time_in_s" << "\n";
+        }
+
+        file << m_fmu->instanceName() << sep << statistics->integrateCalls << sep
+             << statistics->derivativeEvaluations << sep << statistics->jacobianEvaluations << sep
+             << statistics->acceptedSteps << sep << statistics->rejectedSteps << sep
+             << statistics->stateEvents << sep << statistics->stepEvents << sep << statistics->timeEvents << sep
+             << statistics->eventIterations << sep << statistics->integrateTime << sep
+             << statistics->stepOverEventTime << "\n";
+
+        // Close the file.
+        file.close();
+
+        if (!file) {
+            NS_FATAL_ERROR ("Error occurred while writing to file: " << m_integratorStatisticsFilename);
+        } else {
+            NS_LOG_DEBUG ("Integrator statistics successfully written to " << m_integratorStatisticsFilename);
+        }
+    }
+
+    void
+    FmuIncrementalDevice::initFmu() {
+        // Create node-specific instance name.
+        const string instanceName = m_modelIdentifier + to_string(m_nodeId);
+
+        // Create the FMU instance (the model has to be loaded via the ModelManager before).
+        {
+            FmuStartupProfiler::Scope profile(instanceName, "create_instance");
+            m_fmu = CreateObject<RefIncrementalFMU>(m_modelIdentifier, instanceName, m_loggingOn,
+                m_lookAheadHorizonInS, m_lookAheadStepSizeInS, m_integratorStepSizeInS);
+        }
+        NS_ABORT_MSG_UNLESS(m_fmu->getLastStatus() == fmippOK, "Creating model exchange FMU " << instanceName << " failed");
+
+        // Collect the performance counters of the integrator (including initialization).
+        if (m_integratorStatistics) { m_fmu->enableIntegratorStatistics(); }
+
+        // Inputs and outputs have to be defined before initialization.
+        if (!m_realInputsList.empty()) { m_fmu->defineRealInputs(parse_list_string(m_realInputsList)); }
+        if (!m_realOutputsList.empty()) { m_fmu->defineRealOutputs(parse_list_string(m_realOutputsList)); }
+
+        // Instantiate and initialize FMU via callback.
+        FmuStartupProfiler::Scope profile(instanceName, "init_callback");
+        m_initCallback(m_fmu, m_nodeId, m_modelIdentifier, m_startTimeInS);
+    }
+
+    Payload
+    FmuIncrementalDevice::stepFmu(const std::string& payload, uint32_t payloadId, bool isReply, const double& t) {
+        return m_doStepCallback(m_fmu, m_nodeId, payload, payloadId, isReply, t, m_lookAheadStepSizeInS);
+    }
+
+} // Namespace ns3
@@ -0,0 +1,108 @@
+#ifndef FMU_INCREMENTAL_DEVICE_H
+#define FMU_INCREMENTAL_DEVICE_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/fmu-util.h"
+#include "ns3/payload.h"
+#include "ns3/processing-time.h"
+#include "ns3/ptr.h"
+#include "ns3/seq-ts-header.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+struct SendContext;
+
+/**
+ * Device attached to a model exchange FMU, which is simulated with lookahead predictions
+ * (see RefIncrementalFMU). Requests within the current prediction horizon are answered by
+ * interpolating the predictions (without any integration), new predictions are only computed
+ * when the inputs change or the horizon runs out.
+ */
+class FmuIncrementalDevice : public Application
+{
+public:
+  typedef Callback<void, Ptr<RefIncrementalFMU>, uint64_t, const std::string&, const double&> InitCallbackType;
+  typedef Callback<Payload, Ptr<RefIncrementalFMU>, uint64_t, const std::string&, uint32_t, bool, const double&, const double&> DoStepCallbackType;
+
+  static TypeId GetTypeId (void);
+  FmuIncrementalDevice ();
+  virtual ~FmuIncrementalDevice ();
+
+  static void defaultInitCallbackImpl(Ptr<RefIncrementalFMU> fmu, uint64_t nodeId, const std::string& modelIdentifier, const double& startTime);
+  static Payload defaultDoStepCallbackImpl(Ptr<RefIncrementalFMU> fmu, uint64_t nodeId, const std::string& payload, uint32_t payloadId, bool isReply, const double& time, const double& lookAheadStepSize);
+
+  /// Apply the real input assignments ("name=value" pairs separated by commas) contained in a payload
+  /// to the given input values. Entries that are no assignment to one of the named inputs (e.g., status
+  /// messages like "FMU model updated until t=1") are skipped. Returns the number of applied assignments.
+  static size_t ApplyRealInputAssignments(const std::string& payload, const std::vector<std::string>& names, std::vector<double>& values);
+
+  uint64_t GetNumberOfPredictions (void) const;
+  uint64_t GetNumberOfInterpolations (void) const;
+
+protected:
+
+  virtual void DoDispose (void);
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+  void ScheduleProcessing (Time dt);
+  void Process (void);
+  void HandleRead (Ptr<Socket> socket);
+  void Send(Ptr<SendContext> reply);
+  void WriteData (void);
+  void WriteIntegratorStatistics (void);
+
+  virtual void initFmu();
+  virtual Payload stepFmu(const std::string& payload, uint32_t payloadId, bool isReply, const double& t);
+
+  uint16_t m_port;      //!< Port on which we listen for incoming packets.
+  uint64_t m_nodeId;      //!< Node identifier.
+
+  Ptr<Socket> m_socket; //!< IPv4 Socket
+  Address m_local;      //!< local multicast address
+
+  bool m_sendData;
+  Time m_sendInterval;
+  Address m_peerAddress; //!< Remote peer address
+  uint16_t m_peerPort; //!< Remote peer port
+
+  Time m_processingTimeConstant; //!< Constant term of processing time.
+  Time m_processingTimeMean; //!< Average of stochastic term of processing time.
+  Time m_processingTimeStdDev; //!< Standard deviation of stochastic term of processing time.
+  Time::Unit m_processingTimeBase; //!< Time base deviation of stochastic term of processing time.
+  Ptr<ProcessingTime> m_processingTime;
+
+  std::string m_modelIdentifier;
+  bool m_loggingOn;
+  double m_lookAheadStepSizeInS; //!< Step size of the lookahead predictions.
+  double m_lookAheadHorizonInS; //!< Length of the lookahead predictions.
+  double m_integratorStepSizeInS; //!< (Initial) step size of the integrator.
+  double m_startTimeInS;
+  std::string m_realInputsList; //!< Names of the real inputs of the FMU.
+  std::string m_realOutputsList; //!< Names of the real outputs of the FMU (interpolated between predictions).
+  Ptr<RefIncrementalFMU> m_fmu;
+
+  InitCallbackType m_initCallback;
+  DoStepCallbackType m_doStepCallback;
+
+  EventId m_writeDataEvent; //!< Event to write FMU model data.
+  EventId m_sendEvent; //!< Event to send back data.
+  EventId m_processEvent; //!< Event to process the next packet.
+
+  bool m_resWrite;
+  double m_resWritePeriodInS;
+  std::string m_resFilename;
+
+  bool m_integratorStatistics; //!< Collect the performance counters of the integrator.
+  std::string m_integratorStatisticsFilename; //!< File the performance counters are written to at the end of the run.
+};
+
+} // namespace ns3
+
+#endif /* FMU_INCREMENTAL_DEVICE_H */
@@ -0,0 +1,246 @@
+#include "ns3/log.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/address-utils.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/exp-util.h"
+#include "ns3/fmu-util.h"
+#include "ns3/fmu-startup-profiler.h"
+
+#include "fmu-pooled-device.h"
+
+#include <cmath>
+#include <fstream>
+
+using namespace fmi_2_0;
+using namespace std;
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE ("FmuPooledDevice");
+
+    NS_OBJECT_ENSURE_REGISTERED (FmuPooledDevice);
+
+    // Initialize empty collection of FMU pools.
+    FmuPooledDevice::PoolCollection FmuPooledDevice::m_pools = FmuPooledDevice::PoolCollection();
+
+    TypeId
+    FmuPooledDevice::GetTypeId(void) {
+        static TypeId tid = TypeId("ns3::FmuPooledDevice")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<FmuPooledDevice>()
+            .AddAttribute("Port", "Port on which we listen for incoming packets.",
+                          UintegerValue(9),
+                          MakeUintegerAccessor(&FmuPooledDevice::m_port),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("NodeId", "Node identifier",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuPooledDevice::m_nodeId),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("SendData",
+                          "Flag to indicate if data should be sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuPooledDevice::m_sendData),
+                          MakeBooleanChecker())
+            .AddAttribute("SendInterval",
+                          "The time to wait between sending packets",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&FmuPooledDevice::m_sendInterval),
+                          MakeTimeChecker())
+            .AddAttribute("RemoteAddress",
+                          "The destination address of the outbound packets",
+                          AddressValue(),
+                          MakeAddressAccessor(&FmuPooledDevice::m_peerAddress),
+                          MakeAddressChecker())
+            .AddAttribute("RemotePort",
+                          "The destination port of the outbound packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FmuPooledDevice::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("ModelIdentifier", "FMU model identifier.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuPooledDevice::m_modelIdentifier),
+                          MakeStringChecker())
+            .AddAttribute("ModelStepSize", "Set the communication step size for the FMU (in seconds).",
+                          DoubleValue(1e-5),
+                          MakeDoubleAccessor(&FmuPooledDevice::m_commStepSizeInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("ModelStartTime", "Set the start time for the FMU (in seconds).",
+                          DoubleValue(0.),
+                          MakeDoubleAccessor(&FmuPooledDevice::m_startTimeInS),
+                          MakeDoubleChecker<double>(0.))
+            .AddAttribute("LoggingOn", "Turn on logging for FMU.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuPooledDevice::m_loggingOn),
+                          MakeBooleanChecker())
+            .AddAttribute("InitCallback",
+                          "Callback for instantiating and initializing the FMU model.",
+                          CallbackValue(MakeCallback(&FmuPooledDevice::defaultInitCallbackImpl)),
+                          MakeCallbackAccessor(&FmuPooledDevice::m_initCallback),
+                          MakeCallbackChecker())
+            .AddAttribute("DoStepCallback",
+                          "Callback for performing a simulation step and returning a payload message.",
+                          CallbackValue(MakeCallback(&FmuPooledDevice::defaultDoStepCallbackImpl)),
+                          MakeCallbackAccessor(&FmuPooledDevice::m_doStepCallback),
+                          MakeCallbackChecker())
+            .AddAttribute("ResultsWrite",
+                          "Flag to indicate if results file should be written.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuPooledDevice::m_resWrite),
+                          MakeBooleanChecker())
+            .AddAttribute("ResultsWritePeriodInS",
+                          "Time period to write values to results file.",
+                          DoubleValue(1.),
+                          MakeDoubleAccessor(&FmuPooledDevice::m_resWritePeriodInS),
+                          MakeDoubleChecker<double>(numeric_limits<double>::min()))
+            .AddAttribute("ResultsFilename",
+                          "Name of results file.",
+                          StringValue(),
+                          MakeStringAccessor (&FmuPooledDevice::m_resFilename),
+                          MakeStringChecker())
+            .AddAttribute("ResultsVariableNamesList",
+                          "List of names of variables whose values should be written to the results file.",
+                          StringValue(),
+                          MakeStringAccessor (&FmuPooledDevice::m_resVarnamesList),
+                          MakeStringChecker())
+            .AddAttribute("PoolName",
+                          "Common name of the pool of FMU instances.",
+                          StringValue(),
+                          MakeStringAccessor (&FmuPooledDevice::m_poolName),
+                          MakeStringChecker())
+            .AddAttribute("PoolSize",
+                          "Number of FMU instances in the pool.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor (&FmuPooledDevice::m_poolSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("AssignmentPolicy",
+                          "Policy for assigning devices to the FMU instances of the pool.",
+                          EnumValue(FmuPooledDevice::ROUND_ROBIN),
+                          MakeEnumAccessor (&FmuPooledDevice::m_assignmentPolicy),
+                          MakeEnumChecker(FmuPooledDevice::ROUND_ROBIN, "RoundRobin", FmuPooledDevice::HASH, "Hash"))
+            .AddAttribute("OutputSubscriptions",
+                          "List of output variables to be monitored for changes, optionally with an absolute (e.g., \"P:0.5\") or relative (e.g., \"P:2%\") deadband.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuPooledDevice::m_outputSubscriptionsList),
+                          MakeStringChecker())
+            .AddAttribute("SendOnOutputChange",
+                          "Only send data if at least one subscribed output has changed since it was last sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuPooledDevice::m_sendOnOutputChange),
+                          MakeBooleanChecker())
+            .AddAttribute("ProcessingTimeConstant",
+                          "Constant term of processing time",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&FmuPooledDevice::m_processingTimeConstant),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeMean",
+                          "Average of stochastic term of processing time",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&FmuPooledDevice::m_processingTimeMean),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeStdDev",
+                          "Standard deviation of stochastic term of processing time",
+                          TimeValue(MicroSeconds(50)),
+                          MakeTimeAccessor(&FmuPooledDevice::m_processingTimeStdDev),
+                          MakeTimeChecker())
+            .AddAttribute("ProcessingTimeBase",
+                          "Time base of stochastic term of processing time",
+                          EnumValue(Time::MS),
+                          MakeEnumAccessor(&FmuPooledDevice::m_processingTimeBase),
+                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"))
+            .AddTraceSource("OutputChanged",
+                            "A subscribed FMU output has changed by more than its deadband since it was last sent.",
+                            MakeTraceSourceAccessor(&FmuPooledDevice::m_outputChangedTrace),
+                            "ns3::FmuAttachedDevice::OutputChangedTracedCallback");
+        return tid;
+    }
+
+    FmuPooledDevice::FmuPooledDevice() {
+        m_poolSize = 1;
+        m_assignmentPolicy = ROUND_ROBIN;
+    }
+
+    uint32_t
+    FmuPooledDevice::AssignSlot() {
+        Pool& pool = m_pools[m_poolName];
+        if (pool.instances.empty()) {
+            pool.instances.resize(m_poolSize);
+            pool.nextSlot = 0;
+        }
+        NS_ABORT_MSG_UNLESS(pool.instances.size() == m_poolSize,
+            "Inconsistent size of FMU pool " << m_poolName << ": " << pool.instances.size() << " vs. " << m_poolSize);
+
+        if (m_assignmentPolicy == HASH) {
+            // Multiplicative hashing of the node ID (Fibonacci hashing), such that
+            // consecutive node IDs are spread over the pool.
+            uint64_t h = m_nodeId * 0x9E3779B97F4A7C15ULL;
+            return static_cast<uint32_t>((h >> 32) % m_poolSize);
+        }
+
+        uint32_t slot = pool.nextSlot;
+        pool.nextSlot = (pool.nextSlot + 1) % m_poolSize;
+        return slot;
+    }
+
+    void
+    FmuPooledDevice::initFmu() {
+        NS_ABORT_MSG_UNLESS(false == m_poolName.empty(), "No common name for pool of FMU instances provided.");
+
+        const uint32_t slot = AssignSlot();
+        Ptr<RefFMU>& instance = m_pools[m_poolName].instances[slot];
+
+        if (instance != 0) {
+            m_fmu = instance;
+
+            // Results are only written by the first device assigned to an instance (avoid duplicate results).
+            m_resWrite = false;
+        } else {
+            const string instanceName = m_poolName + "_" + to_string(slot);
+
+            // Load FMU.
+            {
+                FmuStartupProfiler::Scope profile(instanceName, "create_instance");
+                m_fmu = CreateFmu(instanceName);
+            }
+
+            // Instantiate and initialize FMU via callback.
+            {
+                FmuStartupProfiler::Scope profile(instanceName, "init_callback");
+                m_initCallback(m_fmu, m_nodeId, m_modelIdentifier, m_startTimeInS);
+            }
+
+            // Restore FMU state when resuming from a checkpoint.
+            FmuCheckpointManager::RestoreFmu(m_fmu);
+
+            instance = m_fmu;
+        }
+
+        NS_LOG_INFO("Device on node " << m_nodeId << " uses FMU instance " << m_fmu->instanceName());
+    }
+
+    Payload
+    FmuPooledDevice::stepFmu(const std::string& payload, uint32_t payloadId, bool isReply, const double& t) {
+        // Lock the mutex of the assigned instance, devices assigned
+        // to other instances of the pool are not affected.
+        m_fmu->lock();
+
+        Payload pl = m_doStepCallback(m_fmu, m_nodeId, payload, payloadId, isReply, t, m_commStepSizeInS);
+
+        m_fmu->unlock();
+
+        return pl;
+    }
+
+} // Namespace ns3
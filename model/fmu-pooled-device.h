@@ -0,0 +1,47 @@
+#ifndef FMU_POOLED_DEVICE_H
+#define FMU_POOLED_DEVICE_H
+
+#include "fmu-attached-device.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class FmuPooledDevice : public FmuAttachedDevice
+{
+public:
+
+  /// Policy for assigning devices to the FMU instances of a pool.
+  enum AssignmentPolicy {
+    ROUND_ROBIN, //!< Assign devices to instances in the order in which they start.
+    HASH //!< Assign devices to instances according to the hash of their node ID.
+  };
+
+  static TypeId GetTypeId (void);
+  FmuPooledDevice ();
+  virtual ~FmuPooledDevice () {}
+
+private:
+  virtual void initFmu();
+  virtual Payload stepFmu(const std::string& payload, uint32_t payloadId, bool isReply, const double& t);
+
+  uint32_t AssignSlot(void);
+
+  std::string m_poolName;
+  uint32_t m_poolSize;
+  AssignmentPolicy m_assignmentPolicy;
+
+  /// Collection of FMU instances used by a set of devices.
+  struct Pool {
+    std::vector<Ptr<RefFMU> > instances;
+    uint32_t nextSlot; //!< Next slot for round-robin assignment.
+  };
+
+  typedef std::map<std::string, Pool> PoolCollection;
+  static PoolCollection m_pools;
+};
+
+} // namespace ns3
+
+#endif /* FMU_POOLED_DEVICE_H */
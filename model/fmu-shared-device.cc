@@ -16,6 +16,7 @@
 #include "ns3/enum.h"
 #include "ns3/exp-util.h"
 #include "ns3/fmu-util.h"
+#include "ns3/fmu-startup-profiler.h"
 
 #include "fmu-shared-device.h"
 
@@ -119,6 +120,16 @@ namespace ns3 {
                           StringValue(),
                           MakeStringAccessor (&FmuSharedDevice::m_sharedFmuInstanceName),
                           MakeStringChecker())
+            .AddAttribute("OutputSubscriptions",
+                          "List of output variables to be monitored for changes, optionally with an absolute (e.g., \"P:0.5\") or relative (e.g., \"P:2%\") deadband.",
+                          StringValue(),
+                          MakeStringAccessor(&FmuSharedDevice::m_outputSubscriptionsList),
+                          MakeStringChecker())
+            .AddAttribute("SendOnOutputChange",
+                          "Only send data if at least one subscribed output has changed since it was last sent.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FmuSharedDevice::m_sendOnOutputChange),
+                          MakeBooleanChecker())
             .AddAttribute("ProcessingTimeConstant",
                           "Constant term of processing time",
                           TimeValue(Seconds(0)),
@@ -138,7 +149,11 @@ namespace ns3 {
                           "Time base of stochastic term of processing time",
                           EnumValue(Time::MS),
                           MakeEnumAccessor(&FmuSharedDevice::m_processingTimeBase),
-                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"));
+                          MakeEnumChecker(Time::S, "S", Time::MS, "MS", Time::US, "US", Time::NS, "NS"))
+            .AddTraceSource("OutputChanged",
+                            "A subscribed FMU output has changed by more than its deadband since it was last sent.",
+                            MakeTraceSourceAccessor(&FmuSharedDevice::m_outputChangedTrace),
+                            "ns3::FmuAttachedDevice::OutputChangedTracedCallback");
         return tid;
     }
 
@@ -153,10 +168,19 @@ namespace ns3 {
             m_fmu = itFind->second;
         } else {
             // Load FMU.
-            m_fmu = CreateObject<RefFMU>(m_modelIdentifier, m_sharedFmuInstanceName, m_loggingOn);
+            {
+                FmuStartupProfiler::Scope profile(m_sharedFmuInstanceName, "create_instance");
+                m_fmu = CreateFmu(m_sharedFmuInstanceName);
+            }
 
             // Instantiate and initialize FMU via callback.
-            m_initCallback(m_fmu, m_nodeId, m_modelIdentifier, m_startTimeInS);
+            {
+                FmuStartupProfiler::Scope profile(m_sharedFmuInstanceName, "init_callback");
+                m_initCallback(m_fmu, m_nodeId, m_modelIdentifier, m_startTimeInS);
+            }
+
+            // Restore FMU state when resuming from a checkpoint.
+            FmuCheckpointManager::RestoreFmu(m_fmu);
 
             m_sharedFmuCollection[m_sharedFmuInstanceName] = m_fmu;
         }
@@ -0,0 +1,189 @@
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "fmu-startup-profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace std;
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE ("FmuStartupProfiler");
+
+bool FmuStartupProfiler::m_enabled = false;
+std::vector<FmuStartupProfiler::Record> FmuStartupProfiler::m_records = std::vector<FmuStartupProfiler::Record>();
+FmuStartupProfiler::Scope* FmuStartupProfiler::m_currentScope = 0;
+
+namespace {
+
+string
+escapeJson(const string& str) {
+    string res;
+    res.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+            case '"': res += "\\\""; break;
+            case '\\': res += "\\\\"; break;
+            case '\n': res += "\\n"; break;
+            case '\t': res += "\\t"; break;
+            default: res += c;
+        }
+    }
+    return res;
+}
+
+void
+writeRecord(ofstream& file, const FmuStartupProfiler::Record& r) {
+    file << "{\"subject\": \"" << escapeJson(r.subject) << "\", "
+         << "\"phase\": \"" << escapeJson(r.phase) << "\", "
+         << "\"sim_time_s\": " << r.simTimeInS << ", "
+         << "\"wall_time_s\": " << r.wallTimeInS << ", "
+         << "\"self_time_s\": " << r.selfTimeInS;
+    if (r.hasRssDelta) {
+        file << ", \"rss_delta_kb\": " << r.rssDeltaInKb
+             << ", \"self_rss_delta_kb\": " << r.selfRssDeltaInKb;
+    }
+    file << "}";
+}
+
+}
+
+FmuStartupProfiler::Scope::Scope(const std::string& subject, const std::string& phase) :
+    m_active(FmuStartupProfiler::IsEnabled()), m_parent(0), m_nestedTimeInS(0.), m_nestedRssInKb(0)
+{
+    if (!m_active) { return; }
+
+    m_subject = subject;
+    m_phase = phase;
+    m_parent = m_currentScope;
+    m_currentScope = this;
+    m_rssInKb = GetResidentSetSizeInKb();
+    m_start = chrono::steady_clock::now();
+}
+
+FmuStartupProfiler::Scope::~Scope() {
+    if (!m_active) { return; }
+
+    Record r;
+    r.subject = m_subject;
+    r.phase = m_phase;
+    r.simTimeInS = Simulator::Now().GetSeconds();
+    r.wallTimeInS = chrono::duration<double>(chrono::steady_clock::now() - m_start).count();
+
+    r.selfTimeInS = r.wallTimeInS - m_nestedTimeInS;
+
+    int64_t rss = GetResidentSetSizeInKb();
+    r.hasRssDelta = (m_rssInKb >= 0 && rss >= 0);
+    r.rssDeltaInKb = r.hasRssDelta ? rss - m_rssInKb : 0;
+    r.selfRssDeltaInKb = r.rssDeltaInKb - m_nestedRssInKb;
+
+    m_currentScope = m_parent;
+    AddRecord(r);
+}
+
+void
+FmuStartupProfiler::AddRecord(const std::string& subject, const std::string& phase, double wallTimeInS) {
+    if (!m_enabled) { return; }
+
+    Record r;
+    r.subject = subject;
+    r.phase = phase;
+    r.simTimeInS = Simulator::Now().GetSeconds();
+    r.wallTimeInS = wallTimeInS;
+    r.selfTimeInS = wallTimeInS;
+    r.hasRssDelta = false;
+    r.rssDeltaInKb = 0;
+    r.selfRssDeltaInKb = 0;
+
+    AddRecord(r);
+}
+
+void
+FmuStartupProfiler::AddRecord(const Record& record) {
+    NS_LOG_DEBUG("startup phase '" << record.phase << "' of " << record.subject
+        << " took " << record.wallTimeInS << " s");
+
+    // The enclosing phase only counts the time not spent in this phase.
+    if (m_currentScope != 0) {
+        m_currentScope->m_nestedTimeInS += record.wallTimeInS;
+        if (record.hasRssDelta) { m_currentScope->m_nestedRssInKb += record.rssDeltaInKb; }
+    }
+
+    m_records.push_back(record);
+}
+
+void
+FmuStartupProfiler::WriteJson(const std::string& filename, size_t topN) {
+    ofstream file(filename, ios::trunc);
+    if (!file.is_open()) {
+        NS_FATAL_ERROR ("Failed to open file: " << filename);
+    }
+
+    // Total wall-clock time and memory per phase (exclusive, i.e., without nested phases).
+    map<string, double> phaseTimes;
+    map<string, int64_t> phaseRss;
+    for (const Record& r : m_records) {
+        phaseTimes[r.phase] += r.selfTimeInS;
+        if (r.hasRssDelta) { phaseRss[r.phase] += r.selfRssDeltaInKb; }
+    }
+
+    // Sort records by duration (slowest first).
+    vector<const Record*> sorted;
+    sorted.reserve(m_records.size());
+    for (const Record& r : m_records) { sorted.push_back(&r); }
+    stable_sort(sorted.begin(), sorted.end(),
+        [](const Record* a, const Record* b) { return a->wallTimeInS > b->wallTimeInS; });
+    if (sorted.size() > topN) { sorted.resize(topN); }
+
+    file << "{\n";
+
+    file << "  \"phase_totals\": [";
+    for (map<string, double>::const_iterator it = phaseTimes.begin(); it != phaseTimes.end(); ++it) {
+        file << (it == phaseTimes.begin() ? "\n" : ",\n");
+        file << "    {\"phase\": \"" << escapeJson(it->first) << "\", \"wall_time_s\": " << it->second;
+        map<string, int64_t>::const_iterator itRss = phaseRss.find(it->first);
+        if (itRss != phaseRss.end()) {
+            file << ", \"rss_delta_kb\": " << itRss->second;
+        }
+        file << "}";
+    }
+    file << "\n  ],\n";
+
+    file << "  \"top_slowest\": [";
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        file << (i == 0 ? "\n    " : ",\n    ");
+        writeRecord(file, *sorted[i]);
+    }
+    file << "\n  ],\n";
+
+    file << "  \"records\": [";
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        file << (i == 0 ? "\n    " : ",\n    ");
+        writeRecord(file, m_records[i]);
+    }
+    file << "\n  ]\n";
+
+    file << "}\n";
+
+    file.close();
+    if (!file) {
+        NS_FATAL_ERROR ("Error occurred while writing to file: " << filename);
+    }
+}
+
+int64_t
+FmuStartupProfiler::GetResidentSetSizeInKb() {
+    // Second entry of /proc/self/statm is the number of resident pages.
+    ifstream statm("/proc/self/statm");
+    int64_t size = 0;
+    int64_t resident = 0;
+    if (!(statm >> size >> resident)) { return -1; }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+} // namespace ns3
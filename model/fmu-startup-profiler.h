@@ -0,0 +1,84 @@
+#ifndef FMU_STARTUP_PROFILER_H
+#define FMU_STARTUP_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class FmuStartupProfiler {
+/**
+ * This class collects fine-grained timing and memory figures for the startup
+ * phases of FMUs (loading, parsing, instantiation, initialization) and of the
+ * devices they are attached to. All figures are collected in one process-wide
+ * list of records, which can be written to a JSON file at the end of a run.
+ * Profiling is off by default, in which case recording a phase is a no-op.
+ **/
+public:
+
+    struct Record {
+        std::string subject; //!< FMU model identifier or FMU instance name.
+        std::string phase; //!< Name of the profiled startup phase.
+        double simTimeInS; //!< Simulation time at which the phase was recorded.
+        double wallTimeInS; //!< Wall-clock duration of the phase (including nested phases).
+        double selfTimeInS; //!< Wall-clock duration of the phase without nested phases.
+        bool hasRssDelta; //!< Flag to indicate if the memory figure is available.
+        int64_t rssDeltaInKb; //!< Change of the resident set size during the phase.
+        int64_t selfRssDeltaInKb; //!< Change of the resident set size without nested phases.
+    };
+
+    /// Measures the duration and memory footprint of a phase during its lifetime.
+    /// Phases recorded while a scope is active (scopes or added records) are nested in it.
+    class Scope {
+    public:
+        Scope(const std::string& subject, const std::string& phase);
+        ~Scope();
+    private:
+        friend class FmuStartupProfiler;
+
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        bool m_active;
+        std::string m_subject;
+        std::string m_phase;
+        int64_t m_rssInKb;
+        std::chrono::steady_clock::time_point m_start;
+        Scope* m_parent; //!< Enclosing scope (null for top-level phases).
+        double m_nestedTimeInS; //!< Total duration of the nested phases.
+        int64_t m_nestedRssInKb; //!< Total change of the resident set size of the nested phases.
+    };
+
+    static void Enable(bool enable) { m_enabled = enable; }
+    static bool IsEnabled() { return m_enabled; }
+
+    /// Add a record for a phase that has been measured elsewhere (no memory figure), the phase
+    /// is nested in the innermost active scope (if any).
+    static void AddRecord(const std::string& subject, const std::string& phase, double wallTimeInS);
+
+    static const std::vector<Record>& GetRecords() { return m_records; }
+    static void Clear() { m_records.clear(); }
+
+    /// Write all records, the total time per phase and the topN slowest records to a JSON file.
+    /// The totals per phase count exclusive time, i.e., nested phases are only counted once.
+    static void WriteJson(const std::string& filename, size_t topN);
+
+    /// Get the current resident set size in kB (negative if not available).
+    static int64_t GetResidentSetSizeInKb();
+
+private:
+
+    static void AddRecord(const Record& record);
+
+    static bool m_enabled;
+    static std::vector<Record> m_records;
+    static Scope* m_currentScope; //!< Innermost active scope.
+};
+
+} // namespace ns3
+
+#endif // FMU_STARTUP_PROFILER_H
@@ -19,6 +19,10 @@ public:
     uint32_t GetBufferSize() const { return m_buffer_size; }
     bool GetTransmitBuffer() const { return m_transmit_buffer; }
 
+    // Access to the global payload ID counter (for checkpointing).
+    static uint32_t GetGlobalPayloadId() { return m_global_payload_id; }
+    static void SetGlobalPayloadId(uint32_t id) { m_global_payload_id = id; }
+
     enum PayloadId {
         INVALID = 0,
         FIRST = 1
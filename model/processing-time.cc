@@ -15,7 +15,7 @@ int64_t ProcessingTime::m_nextStreamId = 4611686018427387904;
 
 ProcessingTime::ProcessingTime(
     Time constant, Time mean, Time stdDev, Time::Unit unit
-) {
+) : m_draws(0) {
     // Get mean and standard deviation in seconds.
     double c = constant.GetSeconds();
     double m = mean.GetSeconds();
@@ -55,8 +55,16 @@ ProcessingTime::GetValue() const {
     if (m_fixed) {
         return Seconds(m_fixedValue);
     } else {
+        ++m_draws;
         return Seconds(m_constant + m_randDist->GetValue());
     }
 }
 
+void
+ProcessingTime::SkipDraws(uint64_t n) {
+    if (m_fixed) { return; }
+    for (uint64_t i = 0; i < n; ++i) { m_randDist->GetValue(); }
+    m_draws += n;
+}
+
 }
\ No newline at end of file
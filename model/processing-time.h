@@ -21,6 +21,15 @@ public:
     
     Time GetValue() const;
 
+    // Number of values drawn from the random distribution so far.
+    uint64_t GetNumberOfDraws() const { return m_draws; }
+
+    // Advance the random stream by drawing (and discarding) the given number of values.
+    // Takes time proportional to n: the state of the underlying stream cannot be saved
+    // and restored directly (not exposed by ns-3, and the Gamma distribution draws a
+    // varying number of uniform values per sample).
+    void SkipDraws(uint64_t n);
+
     static void setStreamBaseId(int64_t sbid) { m_nextStreamId = sbid; }
     
 private:
@@ -45,6 +54,7 @@ private:
 
     double m_constant;
     Ptr<GammaRandomVariable> m_randDist;
+    mutable uint64_t m_draws;
 };
     
 } // namespace ns3
@@ -0,0 +1,97 @@
+#include "ns3/test.h"
+#include "ns3/fmu-attached-device.h"
+#include "ns3/fmu-incremental-device.h"
+
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+class FmuIncrementalDevicePayloadTestCase : public TestCase
+{
+public:
+    FmuIncrementalDevicePayloadTestCase() : TestCase("Apply real input assignments from payloads of the default DoStepCallback") {}
+
+private:
+    virtual void DoRun(void);
+};
+
+void
+FmuIncrementalDevicePayloadTestCase::DoRun(void) {
+    const std::vector<std::string> names = { "u1", "u2" };
+    std::vector<double> values = { 0., 0. };
+
+    // Plain assignments.
+    NS_TEST_ASSERT_MSG_EQ(FmuIncrementalDevice::ApplyRealInputAssignments("u1=0.5,u2=1", names, values), 2u, "two assignments expected");
+    NS_TEST_ASSERT_MSG_EQ(values[0], 0.5, "wrong value of u1");
+    NS_TEST_ASSERT_MSG_EQ(values[1], 1., "wrong value of u2");
+
+    // Payloads without assignments (empty, dummy or default reply messages) leave the inputs unchanged.
+    NS_TEST_ASSERT_MSG_EQ(FmuIncrementalDevice::ApplyRealInputAssignments("", names, values), 0u, "no assignment expected");
+    NS_TEST_ASSERT_MSG_EQ(FmuIncrementalDevice::ApplyRealInputAssignments(std::string(16, '\0'), names, values), 0u, "no assignment expected");
+    NS_TEST_ASSERT_MSG_EQ(FmuIncrementalDevice::ApplyRealInputAssignments(
+        "FMU model updated until t=1.000000 with 2 new predictions", names, values), 0u, "no assignment expected");
+    NS_TEST_ASSERT_MSG_EQ(values[0], 0.5, "u1 must not change");
+    NS_TEST_ASSERT_MSG_EQ(values[1], 1., "u2 must not change");
+
+    // Mixed payload: status text, unknown names and invalid values are skipped, padding is ignored.
+    const std::string mixed = std::string("status,u1=0.25,unknown=3,u2=abc,t=1=2, u2 = -1.5 ") + std::string(8, '\0');
+    NS_TEST_ASSERT_MSG_EQ(FmuIncrementalDevice::ApplyRealInputAssignments(mixed, names, values), 2u, "two assignments expected");
+    NS_TEST_ASSERT_MSG_EQ(values[0], 0.25, "wrong value of u1");
+    NS_TEST_ASSERT_MSG_EQ(values[1], -1.5, "wrong value of u2");
+}
+
+class FmuAttachedDeviceOutputSubscriptionTestCase : public TestCase
+{
+public:
+    FmuAttachedDeviceOutputSubscriptionTestCase() : TestCase("Report changes of subscribed outputs that exceed the deadband") {}
+
+private:
+    virtual void DoRun(void);
+};
+
+void
+FmuAttachedDeviceOutputSubscriptionTestCase::DoRun(void) {
+    FmuAttachedDevice::OutputSubscription subscription;
+    subscription.name = "y";
+    subscription.deadband = 0.1;
+    subscription.relative = false;
+    subscription.reported = false;
+    subscription.lastSentValue = 0.;
+
+    // The first value is always reported.
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, 1.), true, "first value must be reported");
+    NS_TEST_ASSERT_MSG_EQ(subscription.lastSentValue, 1., "wrong last sent value");
+
+    // Changes within the deadband are not reported and do not move the reference value,
+    // so that slow drifts are reported once they add up.
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, 1.05), false, "change within deadband");
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, 0.95), false, "change within deadband");
+    NS_TEST_ASSERT_MSG_EQ(subscription.lastSentValue, 1., "last sent value must not change");
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, 1.15), true, "change exceeds deadband");
+    NS_TEST_ASSERT_MSG_EQ(subscription.lastSentValue, 1.15, "wrong last sent value");
+
+    // Subscriptions are only evaluated on the send path. A reply to a request carrying the value 2
+    // in between does not touch the subscription, so the next send is compared with the value of
+    // the last send (and not with the reply's value, which would report this change).
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, 1.2), false, "change within deadband");
+
+    // Relative deadbands scale with the last sent value.
+    subscription.deadband = 0.1;
+    subscription.relative = true;
+    subscription.lastSentValue = -10.;
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, -10.9), false, "change within relative deadband");
+    NS_TEST_ASSERT_MSG_EQ(FmuAttachedDevice::UpdateOutputSubscription(subscription, -11.1), true, "change exceeds relative deadband");
+    NS_TEST_ASSERT_MSG_EQ(subscription.lastSentValue, -11.1, "wrong last sent value");
+}
+
+class FmuAttachedDeviceTestSuite : public TestSuite
+{
+public:
+    FmuAttachedDeviceTestSuite() : TestSuite("fmu-attached-device", UNIT) {
+        AddTestCase(new FmuIncrementalDevicePayloadTestCase, TestCase::QUICK);
+        AddTestCase(new FmuAttachedDeviceOutputSubscriptionTestCase, TestCase::QUICK);
+    }
+};
+
+static FmuAttachedDeviceTestSuite g_fmuAttachedDeviceTestSuite;